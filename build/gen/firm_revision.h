@@ -0,0 +1 @@
+\#define libfirm_VERSION_REVISION "992c1f8d0ec75ff907cd87d13a44bed54e74140a"
@@ -128,6 +128,10 @@ typedef struct backend_params {
 	 * purpose integer/address registers. */
 	unsigned machine_size;
 
+	/** size of the vector registers in bits, 0 if the backend does not
+	 * support vector modes. */
+	unsigned vector_size;
+
 	/**
 	 * some backends like x87 can only do arithmetic in a specific float
 	 * mode (load/store are still done in the "normal" float/double modes).
@@ -295,7 +295,13 @@ typedef enum ir_builtin_kind {
 	                                 1 otherwise */
 	ir_bk_va_start,             /**< va_start from <stdarg.h> */
 	ir_bk_va_arg,               /**< va_arg from <stdarg.h> */
-	ir_bk_last = ir_bk_va_arg,
+	ir_bk_min,                  /**< lane-wise minimum: a < b ? a : b */
+	ir_bk_max,                  /**< lane-wise maximum: a > b ? a : b */
+	ir_bk_saturating_add,       /**< lane-wise integer addition clamped to
+	                                 the range of the lane mode */
+	ir_bk_saturating_sub,       /**< lane-wise integer subtraction clamped
+	                                 to the range of the lane mode */
+	ir_bk_last = ir_bk_saturating_sub,
 } ir_builtin_kind;
 
 /**
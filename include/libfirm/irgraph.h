@@ -77,7 +77,7 @@
  * - n_loc           An int giving the number of local variables in this
  *                   procedure.  This is needed for ir construction.
  *
- * - value_table     This hash table (pset) is used for global value numbering
+ * - value_table     This hash table (cpset) is used for global value numbering
  *                   for optimizing use in iropt.c.
  *
  * - visited         A int used as flag to traverse the ir_graph.
@@ -443,6 +443,15 @@ FIRM_API void *get_irg_loc_description(ir_graph *irg, int n);
 /** Returns the last irn index for this graph. */
 FIRM_API unsigned get_irg_last_idx(const ir_graph *irg);
 
+/** Returns the number of bytes currently used by the nodes of a graph. */
+FIRM_API size_t get_irg_node_memory(const ir_graph *irg);
+
+/**
+ * Returns the maximum number of bytes used by the nodes of a graph at any
+ * time since it was created.
+ */
+FIRM_API size_t get_irg_node_memory_peak(const ir_graph *irg);
+
 /**
  * Ensures that a graph fulfills all properties stated in @p state.
  * Performs graph transformations if necessary.
@@ -5,7 +5,7 @@
 
 /**
  * @file
- * @brief   Input/Output textual representation of firm.
+ * @brief   Input/Output textual and binary representation of firm.
  * @author  Moritz Kroll
  */
 #ifndef FIRM_IR_IRIO_H
@@ -52,6 +52,36 @@ FIRM_API int ir_import(const char *filename);
  */
 FIRM_API int ir_import_file(FILE *input, const char *inputname);
 
+/**
+ * Exports the whole irp to the given file in a compact binary form.
+ * The binary form contains the same information as the textual one but is
+ * considerably smaller and faster to read.
+ *
+ * @param filename  the name of the resulting file
+ * @return  0 if no errors occured, other values in case of errors
+ */
+FIRM_API int ir_export_binary(const char *filename);
+
+/**
+ * same as ir_export_binary but writes to a FILE*
+ * @note As with any FILE* errors are indicated by ferror(output)
+ */
+FIRM_API void ir_export_binary_file(FILE *output);
+
+/**
+ * Imports the data stored in the given file in binary form.
+ * The file is mapped into memory where possible instead of being read.
+ *
+ * @param filename  the name of the file
+ * @returns 0 if no errors occured, other values in case of errors
+ */
+FIRM_API int ir_import_binary(const char *filename);
+
+/**
+ * same as ir_import_binary but imports from a FILE*
+ */
+FIRM_API int ir_import_binary_file(FILE *input, const char *inputname);
+
 /** @} */
 
 #include "end.h"
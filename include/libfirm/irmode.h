@@ -113,6 +113,20 @@ FIRM_API ir_mode *new_float_mode(const char *name,
  */
 FIRM_API ir_mode *new_non_arithmetic_mode(const char *name, unsigned bit_size);
 
+/**
+ * Creates a new vector mode.
+ *
+ * Values of a vector mode consist of @p n_lanes values of @p element_mode
+ * (the lanes) which are processed in parallel. Arithmetic operations on
+ * vectors are performed lane-wise with the arithmetic of the element mode.
+ *
+ * @param name          the name of the mode to be created
+ * @param element_mode  mode of the lanes, an integer or float mode
+ * @param n_lanes       number of lanes, at least 2
+ */
+FIRM_API ir_mode *new_vector_mode(const char *name, ir_mode *element_mode,
+                                  unsigned n_lanes);
+
 /** Returns the ident* of the mode */
 FIRM_API ident *get_mode_ident(const ir_mode *mode);
 
@@ -275,6 +289,9 @@ FIRM_API int mode_is_int(const ir_mode *mode);
 /** Returns 1 if @p mode is for references/pointers, 0 otherwise */
 FIRM_API int mode_is_reference(const ir_mode *mode);
 
+/** Returns 1 if @p mode is a vector mode, 0 otherwise */
+FIRM_API int mode_is_vector(const ir_mode *mode);
+
 /**
  * Returns 1 if @p mode is for numeric values, 0 otherwise.
  *
@@ -333,6 +350,25 @@ FIRM_API ir_mode *find_signed_mode(const ir_mode *mode);
  */
 FIRM_API ir_mode *find_double_bits_int_mode(const ir_mode *mode);
 
+/**
+ * Returns the mode of the lanes of vector mode @p mode.
+ * For scalar modes this is the mode itself.
+ */
+FIRM_API ir_mode *get_mode_element_mode(const ir_mode *mode);
+
+/**
+ * Returns the number of lanes of vector mode @p mode.
+ * For scalar modes this is 1.
+ */
+FIRM_API unsigned get_mode_n_lanes(const ir_mode *mode);
+
+/**
+ * Returns an existing vector mode with @p n_lanes lanes of @p element_mode.
+ * Returns NULL if no matching mode exists.
+ */
+FIRM_API ir_mode *find_vector_mode(const ir_mode *element_mode,
+                                   unsigned n_lanes);
+
 /**
  * Returns non-zero if the given mode has negative zeros, i.e. +0 and -0 exist.
  * Note that for comparisons +0 and -0 are considered equal, the sign only
@@ -181,6 +181,20 @@ FIRM_API void optimize_load_store(ir_graph *irg);
  */
 FIRM_API void combine_memops(ir_graph *irg);
 
+/**
+ * Packs isomorphic operations on adjacent memory into wide operations
+ * (superword level parallelism).
+ *
+ * Starting from Stores to adjacent addresses in a block, the trees computing
+ * the stored values are packed lane by lane into operations on vector modes,
+ * Loads from adjacent addresses into a single Load.  Where the backend has no
+ * vector registers for the element mode, the lanes are packed into word
+ * sized integers instead, which is restricted to bitwise operations.
+ *
+ * Does nothing if the backend does not support unaligned memory accesses.
+ */
+FIRM_API void slp_vectorize(ir_graph *irg);
+
 /**
  * New experimental alternative to optimize_load_store.
  * Based on a dataflow analysis, so load/stores are moved out of loops
@@ -438,6 +452,15 @@ FIRM_API void do_loop_unrolling(ir_graph *irg);
  */
 FIRM_API void do_loop_peeling(ir_graph *irg);
 
+/**
+ * Perform loop vectorization on a given graph.
+ * Simple counting loops consisting of a single block are preceded by a loop
+ * processing as many iterations at once as fit into the vector registers of
+ * the target. The original loop runs the remaining iterations. Nothing is
+ * done if the backend does not support vector modes.
+ */
+FIRM_API void do_loop_vectorization(ir_graph *irg);
+
 /**
  * Removes all entities which are unused.
  *
@@ -469,6 +492,24 @@ FIRM_API void garbage_collect_entities(void);
  */
 FIRM_API void dead_node_elimination(ir_graph *irg);
 
+/**
+ * Performs dead node elimination without copying the ir graph.
+ *
+ * Nodes not reachable from the anchors of the graph are released in place
+ * and the remaining nodes are numbered densely, so unlike
+ * dead_node_elimination() this does not need memory for a second copy of the
+ * graph.  Memory of dead nodes is reused by nodes created later, other data
+ * of dead nodes on the graph obstack is not released.  The graph is not
+ * changed otherwise.
+ *
+ * The same graph state as for dead_node_elimination() is required and
+ * invalidated.  Node indices change, so all data indexed by node indices
+ * becomes invalid.
+ *
+ * @param irg  The graph to be optimized.
+ */
+FIRM_API void dead_node_elimination_in_place(ir_graph *irg);
+
 /**
  * Code Placement.
  *
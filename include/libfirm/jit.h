@@ -10,6 +10,9 @@
 #ifndef FIRM_JIT_H
 #define FIRM_JIT_H
 
+#include <stddef.h>
+#include <stdio.h>
+
 #include "firm_types.h"
 
 #include "begin.h"
@@ -45,6 +48,12 @@ FIRM_API ir_jit_segment_t *be_new_jit_segment(void);
  */
 FIRM_API void be_destroy_jit_segment(ir_jit_segment_t *segment);
 
+/**
+ * Release all functions created in jit segment \p segment, so it can be used
+ * for further compilations. Invalidates references to these functions.
+ */
+FIRM_API void be_reset_jit_segment(ir_jit_segment_t *segment);
+
 /**
  * Set absolute address of global entities so relocations in jit compiled
  * code an be resolved.
@@ -56,12 +65,42 @@ FIRM_API void be_jit_set_entity_addr(ir_entity *entity, void const *address);
  */
 FIRM_API void const *be_jit_get_entity_addr(ir_entity const *entity);
 
+/**
+ * Compilation tiers of the jit compiler.
+ */
+typedef enum ir_jit_tier_t {
+	/**
+	 * Tier 0: produce code as fast as possible.  Nodes are scheduled with the
+	 * trivial scheduler and registers are allocated with the "linear" allocator
+	 * regardless of the backend options, and the target skips its peephole
+	 * optimizations.  Intended for code that runs only a few times or until
+	 * a tier 1 version is available.
+	 */
+	ir_jit_tier_fast,
+	/**
+	 * Tier 1: use the scheduler and register allocator selected in the
+	 * backend options.
+	 */
+	ir_jit_tier_optimize,
+} ir_jit_tier_t;
+
 /**
  * Compile graph \p irg to a sequence of machine instructions and relocations.
+ * This is the same as be_jit_compile_tier() with ir_jit_tier_optimize.
  */
 FIRM_API ir_jit_function_t *be_jit_compile(ir_jit_segment_t *segment,
                                            ir_graph *irg);
 
+/**
+ * Compile graph \p irg for the jit tier \p tier.  Both tiers estimate the
+ * block execution frequencies of \p irg, middle-end optimizations are left
+ * to the caller.  Returns NULL if the backend cannot compile \p irg, e.g.
+ * because it contains inline assembler; the reason is reported on stderr.
+ */
+FIRM_API ir_jit_function_t *be_jit_compile_tier(ir_jit_segment_t *segment,
+                                                ir_graph *irg,
+                                                ir_jit_tier_t tier);
+
 /**
  * Return the buffer size necessary to emit \p function with be_emit_function().
  */
@@ -72,6 +111,79 @@ FIRM_API unsigned be_get_function_size(ir_jit_function_t const *function);
  */
 FIRM_API void be_emit_function(char *buffer, ir_jit_function_t *function);
 
+/**
+ * Executable memory holding emitted functions.
+ *
+ * Functions are placed in blocks of whole pages with power of two size classes
+ * carved from larger chunks, and released blocks are reused for later
+ * functions of the same size class.  The memory is never writable and
+ * executable at the same time: the pages of a block are made writable while
+ * the function is emitted into it and executable afterwards.  No two functions
+ * share a page, so the other functions of the cache stay executable meanwhile.
+ * Released memory is made inaccessible until it is reused.  As a consequence
+ * even the smallest function takes a whole page.
+ * A cache must not be used by several threads at once.
+ */
+typedef struct ir_jit_code_cache_t ir_jit_code_cache_t;
+
+/** Statistics about the memory use of a \ref ir_jit_code_cache_t. */
+typedef struct ir_jit_code_cache_stats_t {
+	size_t n_functions;  /**< number of live functions */
+	size_t code_bytes;   /**< size of the code of the live functions */
+	size_t block_bytes;  /**< size of the blocks of the live functions */
+	size_t free_bytes;   /**< size of the unused memory in the chunks */
+	size_t mapped_bytes; /**< size of all mapped executable memory */
+	size_t n_added;      /**< number of functions added so far */
+	double add_usec;     /**< time spent adding functions, in microseconds */
+} ir_jit_code_cache_stats_t;
+
+/**
+ * Create a new code cache.
+ */
+FIRM_API ir_jit_code_cache_t *be_new_jit_code_cache(void);
+
+/**
+ * Destroy code cache \p cache and unmap its memory. Invalidates all functions
+ * added to the cache.
+ */
+FIRM_API void be_destroy_jit_code_cache(ir_jit_code_cache_t *cache);
+
+/**
+ * Emit \p function into executable memory of \p cache, resolving symbols and
+ * relocations like be_emit_function().
+ *
+ * @return the address of the executable code or NULL if no memory could be
+ *         mapped or made executable
+ */
+FIRM_API void *be_jit_code_cache_add(ir_jit_code_cache_t *cache,
+                                     ir_jit_function_t *function);
+
+/**
+ * Release the code at \p code, which was returned by be_jit_code_cache_add(),
+ * for reuse by later functions.
+ */
+FIRM_API void be_jit_code_cache_free(ir_jit_code_cache_t *cache, void *code);
+
+/**
+ * Release all functions of \p cache at once.  The memory stays mapped for
+ * later functions.
+ */
+FIRM_API void be_jit_code_cache_reset(ir_jit_code_cache_t *cache);
+
+/**
+ * Fill \p stats with the current statistics of \p cache.
+ */
+FIRM_API void be_jit_code_cache_get_stats(ir_jit_code_cache_t const *cache,
+                                          ir_jit_code_cache_stats_t *stats);
+
+/**
+ * Print the statistics of \p cache including the memory per live function,
+ * the fragmentation and the average time until an added function is
+ * executable to \p out.
+ */
+FIRM_API void be_jit_code_cache_print_stats(FILE *out,
+                                            ir_jit_code_cache_t const *cache);
+
 /** @} */
 
 #include "end.h"
@@ -132,6 +132,28 @@ typedef int lower_mux_callback(ir_node* mux);
  */
 FIRM_API void lower_mux(ir_graph *irg, lower_mux_callback *cb_func);
 
+/**
+ * Used as callback, whenever a lowerable vector operation is found. The
+ * return value indicates, whether the operation should be lowered.
+ *
+ * @param node  The vector operation that may be lowered.
+ * @return      A non-zero value indicates that the node should be lowered.
+ */
+typedef int lower_vector_callback(ir_node *node);
+
+/**
+ * Replaces vector operations (Add, Sub, Mul, And, Or, Eor, Minus, Not, Conv
+ * and Shuffle) in the given graph by the scalar operation on each lane. The
+ * lanes are taken apart with Extract and put back together with Insert
+ * nodes, so these and the vector Loads, Stores, Phis and Consts remain for
+ * the backend.
+ *
+ * @param irg      The graph to lower vector operations in.
+ * @param cb_func  The callback function for node selection. Can be NULL,
+ *                 to lower all vector operations.
+ */
+FIRM_API void lower_vector(ir_graph *irg, lower_vector_callback *cb_func);
+
 /**
  * An intrinsic mapper function.
  *
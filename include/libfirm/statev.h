@@ -60,6 +60,19 @@ FIRM_API void stat_ev(const char *name);
  */
 FIRM_API void stat_ev_begin(const char *filename_prefix, const char *filter);
 
+/**
+ * Initialize the stat ev machinery to produce a binary event stream.
+ * This is much cheaper than the text format: keys and context values are
+ * interned and written once, events are buffered fixed size records and the
+ * filter is evaluated once per key. Use support/statev_aggregate.py to
+ * analyse the stream.
+ * @param filename_prefix  The name of the file (.evb will be appended).
+ *                         File will be truncated!
+ * @param filter           Like the filter of stat_ev_begin().
+ */
+FIRM_API void stat_ev_begin_binary(const char *filename_prefix,
+                                   const char *filter);
+
 /**
  * Shuts down stat ev machinery
  */
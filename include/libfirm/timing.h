@@ -10,6 +10,7 @@
 #ifndef FIRM_TIMING_H
 #define FIRM_TIMING_H
 
+#include <stdio.h>
 #include "begin.h"
 
 /**
@@ -114,6 +115,69 @@ FIRM_API unsigned long ir_timer_elapsed_usec(const ir_timer_t *timer);
  */
 FIRM_API double ir_timer_elapsed_sec(const ir_timer_t *timer);
 
+/**
+ * Output formats of the compile time profile.
+ */
+typedef enum ir_timing_format_t {
+	/** Chrome trace event JSON, viewable with chrome://tracing or Perfetto */
+	ir_timing_format_trace,
+	/** comma separated values, one line per scope */
+	ir_timing_format_csv,
+} ir_timing_format_t;
+
+/**
+ * Enable or disable recording of the compile time profile.
+ *
+ * The profile consists of nested scopes, usually one per pass invocation.
+ * Each scope records its begin and duration in nanoseconds of a monotonic
+ * clock and the number of node indices in use (see get_irg_last_idx()) and
+ * the bytes used by its graph at its begin and end, as given by the caller.
+ * The time spent on this accounting is not attributed to any scope.  The
+ * middle-end passes and the backend phases record a scope each.
+ */
+FIRM_API void ir_timing_enable_scopes(int enable);
+
+/**
+ * Returns non-zero if the compile time profile is recorded.
+ */
+FIRM_API int ir_timing_scopes_enabled(void);
+
+/**
+ * Begin a scope of the compile time profile.
+ *
+ * @param name       name of the scope, must stay valid until the profile is
+ *                   cleared
+ * @param graph      name of the graph worked on in the scope or NULL for the
+ *                   graph of the enclosing scope, must stay valid until the
+ *                   profile is cleared
+ * @param n_indices  number of node indices in use at the begin
+ * @param memory     bytes used by the graph at the begin
+ * @return non-zero if a scope was begun, which has to be ended with
+ *         ir_timing_scope_end(); zero if the profile is not recorded
+ */
+FIRM_API int ir_timing_scope_begin(char const *name, char const *graph,
+                                   unsigned n_indices, size_t memory);
+
+/**
+ * End the innermost scope of the compile time profile.  Must be called
+ * exactly for the scopes, whose ir_timing_scope_begin() returned non-zero,
+ * even if the profile was disabled in between.
+ *
+ * @param n_indices  number of node indices in use at the end
+ * @param memory     bytes used by the graph at the end
+ */
+FIRM_API void ir_timing_scope_end(unsigned n_indices, size_t memory);
+
+/**
+ * Write all ended scopes of the compile time profile to @p out.
+ */
+FIRM_API void ir_timing_write_scopes(FILE *out, ir_timing_format_t format);
+
+/**
+ * Discard the compile time profile recorded so far.
+ */
+FIRM_API void ir_timing_clear_scopes(void);
+
 #include "end.h"
 
 #endif
@@ -165,6 +165,27 @@ FIRM_API ir_tarval *new_tarval_nan(ir_mode *mode, int signaling,
  */
 FIRM_API void tarval_to_bytes(unsigned char *buffer, ir_tarval const *tv);
 
+/**
+ * Construct a new vector tarval from the values of its lanes.
+ *
+ * @param mode   vector mode for the resulting tarval
+ * @param lanes  get_mode_n_lanes(mode) tarvals of the element mode of @p mode
+ * @return A newly created (or cached) tarval representing the value or
+ *         tarval_bad if one of the lanes is tarval_bad.
+ */
+FIRM_API ir_tarval *new_tarval_vector(ir_mode *mode, ir_tarval *const *lanes);
+
+/**
+ * Construct a new vector tarval of vector mode @p mode with all lanes set to
+ * @p tv.
+ */
+FIRM_API ir_tarval *tarval_broadcast(ir_tarval const *tv, ir_mode *mode);
+
+/**
+ * Returns the value of lane @p lane of the vector tarval @p tv.
+ */
+FIRM_API ir_tarval *get_tarval_lane(ir_tarval const *tv, unsigned lane);
+
 /**
  * Returns value as long if possible.
  */
@@ -378,7 +399,8 @@ FIRM_API ir_tarval *tarval_bitcast(ir_tarval const *src, ir_mode *mode);
  *   The order the arguments are given in is important, imagine postfix
  *   notation.
  *   Illegal operations will trigger an assertion.
- *   The sort member of the struct mode defines which operations are valid
+ *   The sort member of the struct mode defines which operations are valid.
+ *   Operations on vector tarvals are performed lane-wise.
  */
 
 /**
@@ -0,0 +1,160 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Arena allocator with size class free lists.
+ */
+#include "arena.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util.h"
+#include "xmalloc.h"
+
+#define MIN_CHUNK_SIZE ((size_t)4 * 1024)
+#define MAX_CHUNK_SIZE ((size_t)64 * 1024)
+/** size of a header rounded up to the arena alignment */
+#define HEADER_SIZE(type) \
+	((sizeof(type) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+struct arena_chunk_t {
+	arena_chunk_t *next;
+	size_t         size;
+};
+
+struct arena_large_t {
+	arena_large_t *prev;
+	arena_large_t *next;
+};
+
+void arena_init(arena_t *const arena)
+{
+	memset(arena, 0, sizeof(*arena));
+	arena->next_chunk_size = MIN_CHUNK_SIZE;
+}
+
+void arena_destroy(arena_t *const arena)
+{
+	for (arena_chunk_t *chunk = arena->chunks, *next; chunk != NULL;
+	     chunk = next) {
+		next = chunk->next;
+		free(chunk);
+	}
+	for (arena_large_t *large = arena->large, *next; large != NULL;
+	     large = next) {
+		next = large->next;
+		free(large);
+	}
+	arena_init(arena);
+}
+
+static void push_free(arena_t *const arena, void *const object,
+                      size_t const size_class)
+{
+	*(void**)object = arena->free_lists[size_class];
+	arena->free_lists[size_class] = object;
+}
+
+/**
+ * Puts the unused rest of the current chunk on a free list before a new chunk
+ * is allocated.  All sizes are multiples of ARENA_ALIGN and the rest is
+ * smaller than the object which did not fit, so nothing is lost.
+ */
+static void retire_chunk_rest(arena_t *const arena)
+{
+	if (arena->chunk_left > 0)
+		push_free(arena, arena->chunk_free, arena_size_class(arena->chunk_left));
+	arena->chunk_left = 0;
+}
+
+void *arena_alloc_slow(arena_t *const arena, size_t const size)
+{
+	assert(size > 0);
+	if (size > ARENA_MAX_SIZE) {
+		size_t const   header = HEADER_SIZE(arena_large_t);
+		arena_large_t *large  = (arena_large_t*)xmalloc(header + size);
+		large->prev = NULL;
+		large->next = arena->large;
+		if (arena->large != NULL)
+			arena->large->prev = large;
+		arena->large     = large;
+		arena->reserved += header + size;
+		arena->used     += size;
+		arena->peak      = MAX(arena->peak, arena->used);
+		return (char*)large + header;
+	}
+
+	size_t const rounded = (arena_size_class(size) + 1) * ARENA_ALIGN;
+	if (arena->chunk_left < rounded) {
+		retire_chunk_rest(arena);
+		size_t const   header     = HEADER_SIZE(arena_chunk_t);
+		size_t const   chunk_size = arena->next_chunk_size;
+		arena_chunk_t *chunk      = (arena_chunk_t*)xmalloc(chunk_size);
+		chunk->next       = arena->chunks;
+		chunk->size       = chunk_size;
+		arena->chunks     = chunk;
+		arena->chunk_free = (char*)chunk + header;
+		arena->chunk_left = chunk_size - header;
+		arena->reserved  += chunk_size;
+		if (chunk_size < MAX_CHUNK_SIZE)
+			arena->next_chunk_size = chunk_size * 2;
+	}
+	void *const object = arena->chunk_free;
+	arena->chunk_free += rounded;
+	arena->chunk_left -= rounded;
+	arena->used       += rounded;
+	arena->peak        = MAX(arena->peak, arena->used);
+	return object;
+}
+
+void arena_free(arena_t *const arena, void *const object, size_t const size)
+{
+	assert(size > 0);
+	if (size > ARENA_MAX_SIZE) {
+		size_t const   header = HEADER_SIZE(arena_large_t);
+		arena_large_t *large  = (arena_large_t*)((char*)object - header);
+		if (large->prev != NULL)
+			large->prev->next = large->next;
+		else
+			arena->large = large->next;
+		if (large->next != NULL)
+			large->next->prev = large->prev;
+		arena->reserved -= header + size;
+		arena->used     -= size;
+		free(large);
+		return;
+	}
+
+	size_t const size_class = arena_size_class(size);
+	size_t const rounded    = (size_class + 1) * ARENA_ALIGN;
+	assert(arena->used >= rounded);
+	arena->used -= rounded;
+#ifndef NDEBUG
+	/* make uses of released objects more likely to fail */
+	memset(object, 0xDD, rounded);
+#endif
+	push_free(arena, object, size_class);
+}
+
+bool arena_contains(arena_t const *const arena, void const *const object)
+{
+	char const *const p = (char const*)object;
+	for (arena_chunk_t const *chunk = arena->chunks; chunk != NULL;
+	     chunk = chunk->next) {
+		char const *const begin = (char const*)chunk;
+		if (begin <= p && p < begin + chunk->size)
+			return true;
+	}
+	size_t const header = HEADER_SIZE(arena_large_t);
+	for (arena_large_t const *large = arena->large; large != NULL;
+	     large = large->next) {
+		if ((char const*)large + header == p)
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Arena allocator with size class free lists.
+ *
+ * Unlike an obstack, an arena allows to release single objects.  Objects up
+ * to ARENA_MAX_SIZE bytes are rounded up to a multiple of ARENA_ALIGN and
+ * carved from chunks; released objects are put on the free list of their
+ * size class and reused by later allocations of the same class.  Larger
+ * objects are allocated separately.  The caller has to pass the size of an
+ * object when releasing it.  All memory is returned to the system when the
+ * arena is destroyed.
+ */
+#ifndef FIRM_ADT_ARENA_H
+#define FIRM_ADT_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "compiler.h"
+
+#define ARENA_ALIGN     16
+#define ARENA_MAX_SIZE  1024
+#define ARENA_N_CLASSES (ARENA_MAX_SIZE / ARENA_ALIGN)
+
+typedef struct arena_chunk_t arena_chunk_t;
+typedef struct arena_large_t arena_large_t;
+
+typedef struct arena_t {
+	void          *free_lists[ARENA_N_CLASSES]; /**< released objects */
+	char          *chunk_free;      /**< unused rest of the current chunk */
+	size_t         chunk_left;
+	size_t         next_chunk_size;
+	arena_chunk_t *chunks;          /**< all chunks */
+	arena_large_t *large;           /**< separately allocated objects */
+	size_t         used;            /**< bytes in live objects */
+	size_t         peak;            /**< maximum of used */
+	size_t         reserved;        /**< bytes allocated from the system */
+} arena_t;
+
+/** Initializes an empty arena. */
+void arena_init(arena_t *arena);
+
+/** Releases all memory of an arena. */
+void arena_destroy(arena_t *arena);
+
+/** Allocates an object of @p size bytes from the slow path. */
+void *arena_alloc_slow(arena_t *arena, size_t size);
+
+/** Releases an object of @p size bytes allocated from the same arena. */
+void arena_free(arena_t *arena, void *object, size_t size);
+
+/**
+ * Checks whether @p object lies in the memory of the arena.  This is slow and
+ * meant for verification.
+ */
+bool arena_contains(arena_t const *arena, void const *object);
+
+static inline size_t arena_size_class(size_t const size)
+{
+	return (size - 1) / ARENA_ALIGN;
+}
+
+/**
+ * Allocates an uninitialized object of @p size bytes, which must not be 0.
+ */
+static inline void *arena_alloc(arena_t *const arena, size_t const size)
+{
+	if (size <= ARENA_MAX_SIZE) {
+		size_t const c      = arena_size_class(size);
+		void  *const object = arena->free_lists[c];
+		if (LIKELY(object != NULL)) {
+			arena->free_lists[c] = *(void**)object;
+			arena->used         += (c + 1) * ARENA_ALIGN;
+			if (arena->used > arena->peak)
+				arena->peak = arena->used;
+			return object;
+		}
+	}
+	return arena_alloc_slow(arena, size);
+}
+
+#endif
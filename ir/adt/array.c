@@ -10,7 +10,7 @@
  */
 #include <stdlib.h>
 
-#include "array.h"
+#include "array_t.h"
 #include "util.h"
 #include "xmalloc.h"
 #include "fourcc.h"
@@ -45,6 +45,16 @@ void *ir_new_arr_d(struct obstack *obstack, size_t nelts, size_t elts_size)
 	return dp->elts;
 }
 
+void *ir_init_arr_d(void *memory, size_t nelts)
+{
+	ir_arr_descr *const dp = (ir_arr_descr*)memory;
+#ifndef NDEBUG
+	dp->magic = ARR_D_MAGIC;
+#endif
+	dp->allocated = dp->nelts = nelts;
+	return dp->elts;
+}
+
 void *ir_new_arr_f(size_t nelts, size_t elts_size)
 {
 	ir_arr_descr *const dp = (ir_arr_descr*)xmalloc(sizeof(*dp)+elts_size);
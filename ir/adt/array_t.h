@@ -0,0 +1,26 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Array --- dynamic & flexible arrays -- private header.
+ */
+#ifndef FIRM_ADT_ARRAY_T_H
+#define FIRM_ADT_ARRAY_T_H
+
+#include "array.h"
+
+/**
+ * Creates a dynamic array in memory provided by the caller.
+ *
+ * @param memory     Space for ARR_ELTS_OFFS bytes plus the array elements
+ * @param nelts      The number of elements
+ *
+ * @return A pointer to the dynamic array (can be used as a pointer to the
+ *         first element of this array).
+ */
+void *ir_init_arr_d(void *memory, size_t nelts);
+
+#endif
@@ -20,6 +20,13 @@
  * We then assign equally distributed probablilities for normal controlflow
  * splits, and higher probabilities for backedges.
  *
+ * Walking the blocks in reverse postorder, the frequency of each block is
+ * expressed in terms of the enclosing loop headers (targets of backedges) by
+ * substitution. Once all backedges of a loop are known, the equation of its
+ * header is solved and substituted into the following blocks, so inner loops
+ * are solved before the loops containing them. This keeps the equations
+ * sparse and takes time linear in the number of blocks times the loop depth.
+ *
  * Special case: In case of endless loops or "noreturn" calls some blocks have
  * no path to the end node, which produces undesired results (0, infinite
  * execution frequencies). We alleviate that by adding artificial edges from
@@ -29,13 +36,14 @@
 #include <string.h>
 #include <math.h>
 
-#include "gaussjordan.h"
-
 #include "set.h"
 #include "hashptr.h"
 #include "dfs_t.h"
 #include "panic.h"
 #include "xmalloc.h"
+#include "obst.h"
+#include "raw_bitset.h"
+#include "array.h"
 
 #include "irprog_t.h"
 #include "irgraph_t.h"
@@ -58,121 +66,101 @@
 
 static hook_entry_t hook;
 
-typedef struct {
-	unsigned size;
-	double   entries[];
-} square_matrix;
+/** A coefficient in the equation of a block. */
+typedef struct freq_entry_t {
+	unsigned col;   /**< index of the block the coefficient belongs to */
+	double   val;
+} freq_entry_t;
+
+/**
+ * The execution frequency of a block as a linear combination of the
+ * frequencies of loop headers and the end block.
+ */
+typedef struct freq_row_t {
+	unsigned     n_entries;
+	freq_entry_t entries[];
+} freq_row_t;
 
-static square_matrix *mat_create(int n)
+/**
+ * Sparse accumulator used to build the rows: The coefficients are summed up
+ * in a dense vector and the touched columns are remembered, so finishing a
+ * row only costs the number of its entries.
+ */
+typedef struct freq_acc_t {
+	double      *vals;
+	unsigned    *touched; /**< bitset of columns in cols */
+	unsigned    *cols;    /**< flexible array of touched columns */
+	freq_row_t **solved;  /**< solution of already solved loop headers */
+} freq_acc_t;
+
+static void acc_add(freq_acc_t *acc, unsigned col, double val)
 {
-	square_matrix *result = xmalloc(sizeof(square_matrix) + n * n * sizeof(double));
-	result->size = n;
-	return result;
+	if (!rbitset_is_set(acc->touched, col)) {
+		rbitset_set(acc->touched, col);
+		ARR_APP1(unsigned, acc->cols, col);
+	}
+	acc->vals[col] += val;
 }
 
-/*
- * Algorithm for QR decomposition taken from JAMA/C++ Linear Algebra
- * Library.
- * See http://math.nist.gov/tnt/jama_doxygen/jama_qr_h-source.html.
- * License: Public domain (U.S. government work).
+/**
+ * Adds the row @p row multiplied by @p weight to the accumulator. Loop
+ * headers which are solved already are replaced by their solution.
  */
-static inline void setm(square_matrix *a, unsigned row, unsigned col, double val)
+static void acc_add_weighted(freq_acc_t *acc, const freq_row_t *row,
+                             double weight)
 {
-	a->entries[row * a->size + col] = val;
+	for (unsigned i = 0; i < row->n_entries; ++i) {
+		const freq_entry_t *entry  = &row->entries[i];
+		const freq_row_t   *solved = acc->solved[entry->col];
+		if (solved != NULL) {
+			acc_add_weighted(acc, solved, entry->val * weight);
+		} else {
+			acc_add(acc, entry->col, entry->val * weight);
+		}
+	}
 }
 
-static inline double getm(const square_matrix *a, unsigned row, unsigned col)
+static int cmp_unsigned(const void *a, const void *b)
 {
-	return a->entries[row * a->size + col];
+	unsigned const ua = *(const unsigned*)a;
+	unsigned const ub = *(const unsigned*)b;
+	return QSORT_CMP(ua, ub);
 }
 
 /**
- * Use QR decomposition to find the nullspace of a (size n * n). This
- * function assumes that rank(a) = n-1.
+ * Turns the accumulated coefficients into a row (sorted by column) and
+ * clears the accumulator.
  */
-static void nullspace(square_matrix *a, double *result)
+static freq_row_t *acc_finish(freq_acc_t *acc, struct obstack *obst)
 {
-	// The nullspace of a is the n-th column of q, where q * r is
-	// the QR decomposition of transpose(a).
-
-	unsigned       n  = a->size;
-	square_matrix *qr = mat_create(n);
-
-	// Transpose a
-	for (unsigned x = 0; x < n; x++) {
-		for (unsigned y = 0; y < n; y++) {
-			double val = getm(a, y, x);
-			setm(qr, x, y, val);
-		}
-	}
-
-	// In-place computation of qr.
-	for (unsigned k = 0; k < n; k++) {
-		// Compute 2-norm of k-th column without under/overflow.
-		double nrm = 0;
-		for (unsigned i = k; i < n; i++) {
-			nrm = hypot(nrm, getm(qr, i, k));
-		}
-
-		if (nrm == 0.0)
-			continue;
-		// Form k-th Householder vector.
-		if (getm(qr, k, k) < 0)
-			nrm = -nrm;
-		for (unsigned i = k; i < n; i++) {
-			double val = getm(qr, i, k);
-			val /= nrm;
-			setm(qr, i, k, val);
-		}
-		double val = getm(qr, k, k);
-		val += 1.0;
-		setm(qr, k, k, val);
-
-		// Apply transformation to remaining columns.
-		for (unsigned j = k+1; j < n; j++) {
-			double s = 0.0;
-			for (unsigned i = k; i < n; i++) {
-				s += getm(qr, i, k) * getm(qr, i, j);
-			}
-			s = -s / getm(qr, k, k);
-			for (unsigned i = k; i < n; i++) {
-				double val = getm(qr, i, j);
-				val += s * getm(qr, i, k);
-				setm(qr, i, j, val);
-			}
-		}
-	}
-
-	square_matrix *q = mat_create(n);
-
-	// Computation of Q from QR.
-	for (unsigned k = n; k-- > 0; ) {
-		for (unsigned i = 0; i < n; i++) {
-			setm(q, i, k, 0.0);
-		}
-		setm(q, k, k, 1.0);
-		for (unsigned j = k; j < n; j++) {
-			if (getm(qr, k, k) == 0)
-				continue;
-			double s = 0.0;
-			for (unsigned i = k; i < n; i++) {
-				s += getm(qr, i, k) * getm(q, i, j);
-			}
-			s = -s / getm(qr, k, k);
-			for (unsigned i = k; i < n; i++) {
-				double val = getm(q, i, j);
-				val += s * getm(qr, i, k);
-				setm(q, i, j, val);
-			}
-		}
+	size_t const n = ARR_LEN(acc->cols);
+	QSORT_ARR(acc->cols, cmp_unsigned);
+
+	freq_row_t *const row = OALLOCF(obst, freq_row_t, entries, n);
+	row->n_entries = n;
+	for (size_t i = 0; i < n; ++i) {
+		unsigned const col = acc->cols[i];
+		row->entries[i].col = col;
+		row->entries[i].val = acc->vals[col];
+		acc->vals[col] = 0.0;
+		rbitset_clear(acc->touched, col);
 	}
+	ARR_SHRINKLEN(acc->cols, 0);
+	return row;
+}
 
-	// Fill nullspace with required information
-	for (unsigned i = 0; i < n; i++) {
-		result[i] = getm(q, i, n-1);
+/**
+ * Computes the dot product of @p row and the frequencies @p freqs.
+ */
+static double row_dot_freqs(const freq_row_t *row, const double *freqs)
+{
+	double acc = 0.0;
+	for (unsigned i = 0; i < row->n_entries; ++i) {
+		const freq_entry_t *entry = &row->entries[i];
+		assert(isfinite(freqs[entry->col]));
+		acc += entry->val * freqs[entry->col];
 	}
-	free(qr);
-	free(q);
+	return acc;
 }
 
 double get_block_execfreq(const ir_node *block)
@@ -362,35 +350,49 @@ static void block_walk_no_keeps(ir_node *block)
 }
 
 /**
- * Computes (matrix row r_acc) += (matrix row r_x) * weight.
+ * Solves the equation of loop header @p idx once all its predecessors are
+ * known: The equation is the weighted sum of the rows of the predecessors,
+ * which contains the header itself through the backedges, so
+ *   x = self * x + rest  =>  x = rest / (1 - self)
+ *
+ * @return false if the loop has no exit
  */
-static void add_weighted(square_matrix *mat, unsigned r_acc, unsigned r_x,
-                         double weight)
+static bool solve_header(freq_acc_t *acc, struct obstack *obst,
+                         freq_row_t *const *rows, const dfs_t *dfs,
+                         unsigned size, unsigned idx, double inv_loop_weight)
 {
-	for (unsigned c = 0; c < mat->size; c++) {
-		double val = getm(mat, r_acc, c);
-		val += getm(mat, r_x, c) * weight;
-		setm(mat, r_acc, c, val);
+	ir_node *const bb = dfs_get_post_num_node(dfs, size-idx-1);
+	for (int i = get_Block_n_cfgpreds(bb) - 1; i >= 0; --i) {
+		ir_node *const pred           = get_Block_cfgpred_block(bb, i);
+		unsigned const pred_idx       = size - dfs_get_post_num(dfs, pred) - 1;
+		double   const cf_probability = get_cf_probability(bb, i, inv_loop_weight);
+		acc_add_weighted(acc, rows[pred_idx], cf_probability);
 	}
-}
 
-/**
- * Computes the row-th entry of mat . vec.
- *
- * The elements in vec must be finite unless mat has a 0 at the
- * corresponding position.
- */
-static double mat_dot_vec_entry(square_matrix *mat, double *vec, int row)
-{
-	double acc = 0.0;
-	for (unsigned i = 0; i < mat->size; i++) {
-		double val = getm(mat, row, i);
-		if (val == 0)
-			continue;
-		assert(isfinite(vec[i]));
-		acc += val * vec[i];
+	double self = 0.0;
+	if (rbitset_is_set(acc->touched, idx)) {
+		self = acc->vals[idx];
+		acc->vals[idx] = 0.0;
 	}
-	return acc;
+	double const div = 1.0 - self;
+	if (UNDEF(div)) {
+		/* still clear the accumulator */
+		(void)acc_finish(acc, obst);
+		return false;
+	}
+	for (size_t i = 0, n = ARR_LEN(acc->cols); i < n; ++i)
+		acc->vals[acc->cols[i]] /= div;
+
+	freq_row_t *const solved = acc_finish(acc, obst);
+	/* drop the (now zero) entry of the header itself */
+	unsigned n = 0;
+	for (unsigned i = 0; i < solved->n_entries; ++i) {
+		if (solved->entries[i].col != idx)
+			solved->entries[n++] = solved->entries[i];
+	}
+	solved->n_entries = n;
+	acc->solved[idx] = solved;
+	return true;
 }
 
 void ir_estimate_execfreq(ir_graph *irg)
@@ -404,23 +406,15 @@ void ir_estimate_execfreq(ir_graph *irg)
 		| IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE);
 
 	/* compute a DFS.
-	 * using a toposort on the CFG (without back edges) will propagate
-	 * the values better for the gauss/seidel iteration.
-	 * => they can "flow" from start to end. */
+	 * using a toposort on the CFG (without back edges) allows to compute
+	 * the frequencies by substitution: they "flow" from start to end. */
 	dfs_t *const dfs = dfs_new(irg);
 
-	unsigned       size   = dfs_get_n_nodes(dfs);
-	square_matrix *in_fac = mat_create(size);
-	for (unsigned r = 0; r < size; r++) {
-		for (unsigned c = 0; c < size; c++) {
-			setm(in_fac, r, c, 0.0);
-		}
-	}
-
+	unsigned const size = dfs_get_n_nodes(dfs);
 
 	ir_node *const start_block = get_irg_start_block(irg);
 	ir_node *const end_block   = get_irg_end_block(irg);
-	const int      end_idx     = size - dfs_get_post_num(dfs, end_block) - 1;
+	unsigned const end_idx     = size - dfs_get_post_num(dfs, end_block) - 1;
 
 	ir_reserve_resources(irg, IR_RESOURCE_BLOCK_VISITED
 	                          | IR_RESOURCE_IRN_VISITED
@@ -442,150 +436,105 @@ void ir_estimate_execfreq(ir_graph *irg)
 		}
 	}
 
-	double const inv_loop_weight = 1.0 / loop_weight;
-	/* lgs_to_mat[i] is the index of the block represented by the
-	 * i-th row/column in the LGS matrix. */
-	int *lgs_to_mat = NEW_ARR_F(int, 0);
-
+	/* Blocks which are the target of a backedge are loop headers. A header
+	 * is solved as soon as the source of its last backedge is done, so
+	 * first_header[i] lists (linked by next_header) the headers to solve
+	 * after block i. */
+	int *const first_header = NEW_ARR_F(int, size);
+	int *const next_header  = NEW_ARR_F(int, size);
+	for (unsigned idx = 0; idx < size; ++idx)
+		first_header[idx] = -1;
+	unsigned *const is_header = rbitset_malloc(size);
 	for (unsigned idx = 0; idx < size; ++idx) {
-		ir_node const *const bb = dfs_get_post_num_node(dfs, size-idx-1);
-		/* The end block is handled properly later, when all the kept blocks
-		 * are done. */
-		if (bb == end_block)
-			continue;
-
+		ir_node const *const bb        = dfs_get_post_num_node(dfs, size-idx-1);
+		unsigned             last_pred = idx;
+		bool                 header    = false;
 		for (int i = get_Block_n_cfgpreds(bb) - 1; i >= 0; --i) {
-			ir_node *const pred           = get_Block_cfgpred_block(bb, i);
-			unsigned const pred_idx       = size - dfs_get_post_num(dfs, pred) - 1;
-			double   const cf_probability = get_cf_probability(bb, i, inv_loop_weight);
-			bool     const pred_visited   = pred_idx < idx;
-
-			if (pred_visited) {
-				add_weighted(in_fac, idx, pred_idx, cf_probability);
-			} else {
-				ARR_APP1(int, lgs_to_mat, pred_idx);
-				setm(in_fac, idx, pred_idx, cf_probability);
+			ir_node *const pred     = get_Block_cfgpred_block(bb, i);
+			unsigned const pred_idx = size - dfs_get_post_num(dfs, pred) - 1;
+			if (pred_idx >= idx) {
+				header    = true;
+				last_pred = MAX(last_pred, pred_idx);
 			}
 		}
-
-		if (bb == start_block)
-			setm(in_fac, idx, end_idx, 1.0);
+		if (header && bb != end_block) {
+			rbitset_set(is_header, idx);
+			next_header[idx]        = first_header[last_pred];
+			first_header[last_pred] = idx;
+		}
 	}
 
-	/* handle end block */
-	ARR_APP1(int, lgs_to_mat, end_idx);
-	for (int i = get_Block_n_cfgpreds(end_block) - 1; i >= 0; --i) {
-		ir_node *const pred           = get_Block_cfgpred_block(end_block, i);
-		int      const pred_idx       = size - dfs_get_post_num(dfs, pred) - 1;
-		double   const cf_probability = get_cf_probability(end_block, i, inv_loop_weight);
-		add_weighted(in_fac, end_idx, pred_idx, cf_probability);
-	}
+	struct obstack obst;
+	obstack_init(&obst);
+	/* rows[i] expresses the frequency of block i in terms of the loop
+	 * headers and the end block, whose frequency is fixed to 1 (the start
+	 * block is connected to it by an artificial edge). */
+	freq_row_t **const rows = XMALLOCNZ(freq_row_t*, size);
+	freq_acc_t         acc;
+	acc.vals    = XMALLOCNZ(double, size);
+	acc.touched = rbitset_malloc(size);
+	acc.cols    = NEW_ARR_F(unsigned, 0);
+	acc.solved  = XMALLOCNZ(freq_row_t*, size);
+	/* loop headers in the order they have been solved */
+	unsigned *solve_order = NEW_ARR_F(unsigned, 0);
 
-	/* add artifical edges from "kept blocks without a path to end"
-	 * to end */
-	for (unsigned k = n_keepalives; k-- > 0; ) {
-		ir_node *keep = get_End_keepalive(end, k);
-		if (!is_Block(keep) || has_path_to_end(keep))
+	double const inv_loop_weight = 1.0 / loop_weight;
+	bool         valid_freq      = true;
+	for (unsigned idx = 0; idx < size && valid_freq; ++idx) {
+		ir_node const *const bb = dfs_get_post_num_node(dfs, size-idx-1);
+		/* The end block is not needed: its frequency is fixed. */
+		if (bb == end_block)
 			continue;
 
-		double sum      = get_sum_succ_factors(keep, inv_loop_weight);
-		double fac      = KEEP_FAC/sum;
-		int    keep_idx = size - dfs_get_post_num(dfs, keep)-1;
-		add_weighted(in_fac, end_idx, keep_idx, fac);
-	}
-
-	/* mat_to_lgs[i] is the index of node i in the LGS matrix, or
-	 * -1 if the node can be solved by simple substitution. */
-	int *mat_to_lgs = NEW_ARR_F(int, size);
-	for (unsigned x = 0; x < size; x++) {
-		mat_to_lgs[x] = -1;
-	}
-	for (unsigned b = 0; b < ARR_LEN(lgs_to_mat); b++) {
-		mat_to_lgs[lgs_to_mat[b]] = b;
-	}
-
-#ifdef DEBUG
-	/* Check that all values in in_fac are only given in terms of nodes with backedges */
-	for (int y = 0; y < size; y++) {
-		if (mat_to_lgs[y] == -1)
-			continue;
-		for (int x = 0; x < size; x++) {
-			if (getm(in_fac, x, y) != 0)
-				panic("expect entry at (%d, %d) to be 0", x, y);
-		}
-	}
-#endif
-
-	/* Build the LGS matrix with only the indices in lgs_to_mat. */
-	unsigned lgs_size = ARR_LEN(lgs_to_mat);
-	square_matrix *lgs_matrix = mat_create(lgs_size);
-	double *lgs_x = NEW_ARR_F(double, size);
-
-	for (unsigned x = 0; x < lgs_size; x++) {
-		int bx = lgs_to_mat[x];
-		for (unsigned y = 0; y < lgs_size; y++) {
-			int by = lgs_to_mat[y];
-			double val = getm(in_fac, bx, by);
-			setm(lgs_matrix, x, y, val);
+		if (rbitset_is_set(is_header, idx)) {
+			acc_add(&acc, idx, 1.0);
+		} else if (bb == start_block) {
+			acc_add(&acc, end_idx, 1.0);
+		} else {
+			for (int i = get_Block_n_cfgpreds(bb) - 1; i >= 0; --i) {
+				ir_node *const pred           = get_Block_cfgpred_block(bb, i);
+				unsigned const pred_idx       = size - dfs_get_post_num(dfs, pred) - 1;
+				double   const cf_probability = get_cf_probability(bb, i, inv_loop_weight);
+				acc_add_weighted(&acc, rows[pred_idx], cf_probability);
+			}
 		}
-		/* RHS of the equation */
-		double val = getm(lgs_matrix, x, x);
-		val -= 1.0;
-		setm(lgs_matrix, x, x, val);
-	}
-
-	if (lgs_size == 1) {
-		lgs_x[0] = 1.0;
-	} else {
-		nullspace(lgs_matrix, lgs_x);
-	}
+		rows[idx] = acc_finish(&acc, &obst);
 
-	/* compute the normalization factor.
-	 * 1.0 / exec freq of end block.
-	 */
-	double  end_freq   = lgs_x[mat_to_lgs[end_idx]];
-	double  norm       = end_freq != 0.0 ? 1.0 / end_freq : 1.0;
-	double *freqs      = NEW_ARR_F(double, size);
-	bool    valid_freq = true;
-
-	/* First get the frequency for the nodes which were
-	 * explicitly computed. */
-	for (unsigned idx = size; idx-- > 0; ) {
-		ir_node *const bb = dfs_get_post_num_node(dfs, size - idx - 1);
-
-		if (mat_to_lgs[idx] != -1) {
-			double freq = lgs_x[mat_to_lgs[idx]] * norm;
-			/* Check for inf, nan and negative values. */
-			if (isinf(freq) || !(freq >= 0)) {
+		for (int h = first_header[idx]; h >= 0; h = next_header[h]) {
+			if (!solve_header(&acc, &obst, rows, dfs, size, h, inv_loop_weight)) {
 				valid_freq = false;
 				break;
 			}
-			set_block_execfreq(bb, freq);
-			freqs[idx] = freq;
-		} else {
-			freqs[idx] = nan("");
+			ARR_APP1(unsigned, solve_order, h);
 		}
 	}
 
 	if (valid_freq) {
-		/* Now get the rest of the frequencies using the factors in in_fac */
-		for (unsigned idx = size; idx-- > 0; ) {
-			ir_node *const bb = dfs_get_post_num_node(dfs, size - idx - 1);
+		/* A solved header only refers to headers solved after it. */
+		double *const freqs = NEW_ARR_F(double, size);
+		for (unsigned idx = 0; idx < size; ++idx)
+			freqs[idx] = nan("");
+		freqs[end_idx] = 1.0;
+		for (size_t i = ARR_LEN(solve_order); i-- > 0; ) {
+			unsigned const h = solve_order[i];
+			freqs[h] = row_dot_freqs(acc.solved[h], freqs);
+		}
 
-			if (mat_to_lgs[idx] == -1) {
-				double freq = mat_dot_vec_entry(in_fac, freqs, idx);
-				/* Check for inf, nan and negative values. */
-				if (isinf(freq) || !(freq >= 0)) {
-					valid_freq = false;
-					break;
-				}
-				set_block_execfreq(bb, freq);
+		for (unsigned idx = size; idx-- > 0; ) {
+			ir_node *const bb   = dfs_get_post_num_node(dfs, size - idx - 1);
+			double         freq = freqs[idx];
+			if (idx != end_idx && !rbitset_is_set(is_header, idx))
+				freq = row_dot_freqs(rows[idx], freqs);
+			/* Check for inf, nan and negative values. */
+			if (isinf(freq) || !(freq >= 0)) {
+				valid_freq = false;
+				break;
 			}
+			set_block_execfreq(bb, freq);
 		}
+		DEL_ARR_F(freqs);
 	}
 
-	DEL_ARR_F(freqs);
-
 	/* Fallback solution: Use loop weight. */
 	if (!valid_freq) {
 		valid_freq = true;
@@ -622,9 +571,14 @@ void ir_estimate_execfreq(ir_graph *irg)
 	                       | IR_RESOURCE_IRN_LINK);
 
 	dfs_free(dfs);
-	DEL_ARR_F(lgs_to_mat);
-	DEL_ARR_F(mat_to_lgs);
-	free(in_fac);
-	free(lgs_matrix);
-	DEL_ARR_F(lgs_x);
+	DEL_ARR_F(first_header);
+	DEL_ARR_F(next_header);
+	DEL_ARR_F(solve_order);
+	DEL_ARR_F(acc.cols);
+	free(acc.touched);
+	free(acc.vals);
+	free(acc.solved);
+	free(is_header);
+	free(rows);
+	obstack_free(&obst, NULL);
 }
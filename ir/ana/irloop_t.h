@@ -64,7 +64,7 @@ void add_loop_node(ir_loop *loop, ir_node *n);
 /** Add an IR graph to a loop. */
 void add_loop_irg(ir_loop *loop, ir_graph *irg);
 
-/** Sets the loop a node belonging to. */
+/** Sets the loop a block belongs to. */
 void set_irn_loop(ir_node *n, ir_loop *loop);
 
 /**
@@ -107,7 +107,9 @@ static inline unsigned _get_loop_depth(const ir_loop *loop)
 /* Uses temporary information to get the loop */
 static inline ir_loop *_get_irn_loop(const ir_node *n)
 {
-	return n->loop;
+	if (!is_Block(n))
+		return NULL;
+	return n->attr.block.loop;
 }
 
 #endif
@@ -14,7 +14,7 @@
 #include "irnode_t.h"
 #include "irgraph_t.h"
 #include "irprog_t.h"
-#include "irgwalk.h"
+#include "irgwalk_t.h"
 #include "ircons.h"
 
 unsigned get_irn_n_outs(const ir_node *node)
@@ -138,24 +138,51 @@ ir_node *get_Block_cfg_out_ka(const ir_node *bl, unsigned pos)
 	return NULL;
 }
 
+/**
+ * Marks @p node visited, calls the pre callback and pushes it onto the walk
+ * stack, starting with its first successor.
+ */
+static inline void irg_out_walk_enter(walk_stack *stack, ir_node *node,
+                                      ir_visited_t visited, irg_walk_func *pre,
+                                      void *env)
+{
+	set_irn_visited(node, visited);
+
+	if (pre != NULL)
+		pre(node, env);
+
+	walk_frame *const frame = walk_stack_push(stack, node);
+	frame->pos = 0;
+	frame->n   = get_irn_n_outs(node);
+}
+
 static void irg_out_walk_2(ir_node *node, irg_walk_func *pre,
                            irg_walk_func *post, void *env)
 {
 	ir_graph *const irg = get_irn_irg(node);
 	assert(get_irn_visited(node) < get_irg_visited(irg));
 
-	set_irn_visited(node, get_irg_visited(irg));
-
-	if (pre != NULL)
-		pre(node, env);
+	ir_visited_t const visited = get_irg_visited(irg);
+	walk_stack         stack;
+	walk_stack_init(&stack);
+	irg_out_walk_enter(&stack, node, visited, pre, env);
+
+	while (stack.len > 0) {
+		walk_frame *const frame = walk_stack_top(&stack);
+		ir_node    *const cur   = frame->node;
+		if (frame->pos == frame->n) {
+			walk_stack_pop(&stack);
+			if (post != NULL)
+				post(cur, env);
+			continue;
+		}
 
-	foreach_irn_out(node, i, succ) {
-		if (get_irn_visited(succ) < get_irg_visited(irg))
-			irg_out_walk_2(succ, pre, post, env);
+		ir_node *const succ = get_irn_out(cur, frame->pos++);
+		if (get_irn_visited(succ) < visited)
+			irg_out_walk_enter(&stack, succ, visited, pre, env);
 	}
 
-	if (post != NULL)
-		post(node, env);
+	walk_stack_free(&stack);
 }
 
 void irg_out_walk(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
@@ -169,25 +196,49 @@ void irg_out_walk(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
 	}
 }
 
+/**
+ * Marks @p bl visited, calls the pre callback and pushes it onto the walk
+ * stack, starting with its first control flow successor.
+ */
+static inline void irg_out_block_walk_enter(walk_stack *stack, ir_node *bl,
+                                            irg_walk_func *pre, void *env)
+{
+	mark_Block_block_visited(bl);
+
+	if (pre != NULL)
+		pre(bl, env);
+
+	walk_frame *const frame = walk_stack_push(stack, bl);
+	frame->pos = 0;
+	frame->n   = get_Block_n_cfg_outs(bl);
+}
+
 static void irg_out_block_walk2(ir_node *bl, irg_walk_func *pre,
                                 irg_walk_func *post, void *env)
 {
 	if (Block_block_visited(bl))
 		return;
-	mark_Block_block_visited(bl);
 
-	if (pre != NULL)
-		pre(bl, env);
+	walk_stack stack;
+	walk_stack_init(&stack);
+	irg_out_block_walk_enter(&stack, bl, pre, env);
+
+	while (stack.len > 0) {
+		walk_frame *const frame = walk_stack_top(&stack);
+		ir_node    *const block = frame->node;
+		if (frame->pos == frame->n) {
+			walk_stack_pop(&stack);
+			if (post != NULL)
+				post(block, env);
+			continue;
+		}
 
-	for (int i = 0, n = get_Block_n_cfg_outs(bl); i < n; ++i) {
-		/* find the corresponding predecessor block. */
-		ir_node *pred = get_Block_cfg_out(bl, i);
-		/* recursion */
-		irg_out_block_walk2(pred, pre, post, env);
+		ir_node *const succ = get_Block_cfg_out(block, frame->pos++);
+		if (!Block_block_visited(succ))
+			irg_out_block_walk_enter(&stack, succ, pre, env);
 	}
 
-	if (post != NULL)
-		post(bl, env);
+	walk_stack_free(&stack);
 }
 
 void irg_out_block_walk(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
@@ -226,21 +277,50 @@ void irg_out_block_walk(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
 /*--------------------------------------------------------------------*/
 
 
+/**
+ * Marks @p n visited, resets its counter and pushes it onto the walk stack,
+ * starting with its block (pos -1) unless it is a block.
+ */
+static inline void count_outs_enter(walk_stack *stack, ir_node *n)
+{
+	mark_irn_visited(n);
+
+	/* initialize our counter */
+	n->o.n_outs = 0;
+
+	walk_frame *const frame = walk_stack_push(stack, n);
+	frame->pos = is_Block(n) ? 0 : -1;
+	frame->n   = get_irn_arity(n);
+}
+
 /** Returns the amount of out edges for not yet visited successors. */
 static void count_outs_node(ir_node *n)
 {
-	if (irn_visited_else_mark(n))
+	if (irn_visited(n))
 		return;
 
-	/* initialize our counter */
-	n->o.n_outs = 0;
+	walk_stack stack;
+	walk_stack_init(&stack);
+	count_outs_enter(&stack, n);
+
+	while (stack.len > 0) {
+		walk_frame *const frame = walk_stack_top(&stack);
+		if (frame->pos == frame->n) {
+			walk_stack_pop(&stack);
+			continue;
+		}
 
-	int start = is_Block(n) ? 0 : -1;
-	for (int i = start, irn_arity = get_irn_arity(n); i < irn_arity; ++i) {
-		ir_node *def = get_irn_n(n, i);
-		count_outs_node(def);
+		ir_node *const def = get_irn_n(frame->node, frame->pos);
+		/* count the edge once the walk returns to this frame */
+		if (!irn_visited(def)) {
+			count_outs_enter(&stack, def);
+			continue;
+		}
 		++def->o.n_outs;
+		++frame->pos;
 	}
+
+	walk_stack_free(&stack);
 }
 
 
@@ -257,29 +337,59 @@ static void count_outs(ir_graph *irg)
 	}
 }
 
-static void set_out_edges_node(ir_node *node, struct obstack *obst)
+/**
+ * Marks @p node visited, allocates its out array and pushes it onto the walk
+ * stack, starting with its block (pos -1) unless it is a block.
+ */
+static inline void set_out_edges_enter(walk_stack *stack, ir_node *node,
+                                       struct obstack *obst)
 {
-	if (irn_visited_else_mark(node))
-		return;
+	mark_irn_visited(node);
 
 	/* Allocate my array */
 	unsigned n_outs = node->o.n_outs;
 	node->o.out          = OALLOCF(obst, ir_def_use_edges, edges, n_outs);
 	node->o.out->n_edges = 0;
 
-	/* add def->use edges from my predecessors to me */
-	int start = is_Block(node) ? 0 : -1;
-	for (int i = start, irn_arity = get_irn_arity(node); i < irn_arity; ++i) {
-		ir_node *def = get_irn_n(node, i);
+	walk_frame *const frame = walk_stack_push(stack, node);
+	frame->pos = is_Block(node) ? 0 : -1;
+	frame->n   = get_irn_arity(node);
+}
+
+static void set_out_edges_node(ir_node *node, struct obstack *obst)
+{
+	if (irn_visited(node))
+		return;
 
-		/* recurse, ensures that out array of pred is already allocated */
-		set_out_edges_node(def, obst);
+	walk_stack stack;
+	walk_stack_init(&stack);
+	set_out_edges_enter(&stack, node, obst);
+
+	while (stack.len > 0) {
+		walk_frame *const frame = walk_stack_top(&stack);
+		if (frame->pos == frame->n) {
+			walk_stack_pop(&stack);
+			continue;
+		}
+
+		/* add def->use edges from my predecessors to me, the walk returns
+		 * here once the out array of the predecessor is allocated */
+		ir_node *const use = frame->node;
+		int      const i   = frame->pos;
+		ir_node *const def = get_irn_n(use, i);
+		if (!irn_visited(def)) {
+			set_out_edges_enter(&stack, def, obst);
+			continue;
+		}
 
 		/* Remember this Def-Use edge */
 		unsigned pos = def->o.out->n_edges++;
-		def->o.out->edges[pos].use = node;
+		def->o.out->edges[pos].use = use;
 		def->o.out->edges[pos].pos = i;
+		++frame->pos;
 	}
+
+	walk_stack_free(&stack);
 }
 
 static void set_out_edges(ir_graph *irg)
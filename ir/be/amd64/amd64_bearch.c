@@ -579,7 +579,7 @@ static void amd64_sp_sim(ir_node *const node, stack_pointer_state_t *state)
 /**
  * Called immediately before emit phase.
  */
-static void amd64_finish_and_emit(ir_graph *irg)
+static void amd64_before_emit(ir_graph *irg)
 {
 	amd64_irg_data_t const *const irg_data = amd64_get_irg_data(irg);
 	bool                    const omit_fp  = irg_data->omit_fp;
@@ -616,16 +616,16 @@ static void amd64_finish_and_emit(ir_graph *irg)
 
 	amd64_simulate_graph_x87(irg);
 
-	amd64_peephole_optimization(irg);
-
-	/* emit code */
-	be_timer_push(T_EMIT);
-	amd64_emit_function(irg);
-	be_timer_pop(T_EMIT);
+	if (!be_birg_from_irg(irg)->fast_compile)
+		amd64_peephole_optimization(irg);
 }
 
 static void amd64_finish(void)
 {
+	if (amd64_constants != NULL) {
+		pmap_destroy(amd64_constants);
+		amd64_constants = NULL;
+	}
 	amd64_free_opcodes();
 }
 
@@ -636,39 +636,126 @@ static const regalloc_if_t amd64_regalloc_if = {
 	.new_reload  = amd64_new_reload,
 };
 
+static bool lower_for_emit(ir_graph *const irg, unsigned *const sp_is_non_ssa)
+{
+	if (!be_step_first(irg))
+		return false;
+
+	struct obstack *obst = be_get_be_obst(irg);
+	be_birg_from_irg(irg)->isa_link = OALLOCZ(obst, amd64_irg_data_t);
+
+	be_birg_from_irg(irg)->non_ssa_regs = sp_is_non_ssa;
+	amd64_select_instructions(irg);
+
+	be_step_schedule(irg);
+
+	be_timer_push(T_RA_PREPARATION);
+	be_sched_fix_flags(irg, &amd64_reg_classes[CLASS_amd64_flags], NULL,
+	                   NULL, NULL);
+	be_timer_pop(T_RA_PREPARATION);
+
+	be_step_regalloc(irg, &amd64_regalloc_if);
+
+	amd64_before_emit(irg);
+	return true;
+}
+
 static void amd64_generate_code(FILE *output, const char *cup_name)
 {
 	amd64_constants = pmap_create();
-	be_begin(output, cup_name);
+	if (amd64_emit_object) {
+		be_begin_elf(output, cup_name, &amd64_elf_target);
+	} else {
+		be_begin(output, cup_name);
+	}
 	unsigned *const sp_is_non_ssa = rbitset_alloca(N_AMD64_REGISTERS);
 	rbitset_set(sp_is_non_ssa, REG_RSP);
 
+	bool const encode = amd64_emit_object || amd64_emit_machcode;
 	foreach_irp_irg(i, irg) {
-		if (!be_step_first(irg))
+		if (encode && !amd64_check_encodable(irg))
+			continue;
+		if (!lower_for_emit(irg, sp_is_non_ssa))
 			continue;
 
-		struct obstack *obst = be_get_be_obst(irg);
-		be_birg_from_irg(irg)->isa_link = OALLOCZ(obst, amd64_irg_data_t);
+		be_timer_push(T_EMIT);
+		if (amd64_emit_object) {
+			amd64_emit_object_function(irg);
+		} else {
+			amd64_emit_function(irg);
+		}
+		be_timer_pop(T_EMIT);
 
-		be_birg_from_irg(irg)->non_ssa_regs = sp_is_non_ssa;
-		amd64_select_instructions(irg);
+		be_step_last(irg);
+	}
+
+	be_finish();
+	pmap_destroy(amd64_constants);
+	amd64_constants = NULL;
+}
 
-		be_step_schedule(irg);
+static ir_jit_function_t *amd64_jit_compile(ir_jit_segment_t *const segment,
+                                            ir_graph *const irg)
+{
+	/* Constant entities are shared by all functions compiled for the
+	 * segment; they are freed in amd64_finish(). */
+	if (amd64_constants == NULL)
+		amd64_constants = pmap_create();
+	unsigned *const sp_is_non_ssa = rbitset_alloca(N_AMD64_REGISTERS);
+	rbitset_set(sp_is_non_ssa, REG_RSP);
 
-		be_timer_push(T_RA_PREPARATION);
-		be_sched_fix_flags(irg, &amd64_reg_classes[CLASS_amd64_flags], NULL,
-		                   NULL, NULL);
-		be_timer_pop(T_RA_PREPARATION);
+	if (!amd64_check_encodable(irg))
+		return NULL;
 
-		be_step_regalloc(irg, &amd64_regalloc_if);
+	/* The code may end up anywhere in the address space, so it must neither
+	 * use absolute 32bit addresses nor rip relative references to entities
+	 * outside of the function.  Position independent code reaches them
+	 * through GOT slots and call stubs behind the function instead. */
+	be_pic_style_t const pic_style = be_options.pic_style;
+	if (pic_style == BE_PIC_NONE)
+		be_options.pic_style = BE_PIC_ELF_PLT;
 
-		amd64_finish_and_emit(irg);
+	ir_jit_function_t *res = NULL;
+	if (lower_for_emit(irg, sp_is_non_ssa)) {
+		be_timer_push(T_EMIT);
+		res = amd64_emit_jit(segment, irg);
+		be_timer_pop(T_EMIT);
 
 		be_step_last(irg);
 	}
+	be_options.pic_style = pic_style;
+	return res;
+}
 
-	be_finish();
-	pmap_destroy(amd64_constants);
+static void lower_lanewise_builtin_walker(ir_node *node, void *env)
+{
+	if (!is_Builtin(node))
+		return;
+
+	switch (get_Builtin_kind(node)) {
+	case ir_bk_min:
+	case ir_bk_max:
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub:
+		if (!amd64_can_select_builtin(node))
+			lower_lanewise_builtin(node, (pset_new_t*)env);
+		return;
+	default:
+		return;
+	}
+}
+
+/** Mux nodes created by lower_lanewise_builtin() for float lanes. */
+static pset_new_t const *lanewise_muxes;
+
+static int is_lanewise_mux(ir_node *mux)
+{
+	return pset_new_contains(lanewise_muxes, mux);
+}
+
+static int amd64_lower_vector_op(ir_node *node)
+{
+	return !amd64_can_select_vector_op(node);
 }
 
 static void amd64_lower_for_target(void)
@@ -699,7 +786,24 @@ static void amd64_lower_for_target(void)
 		be_after_transform(irg, "lower-copyb");
 	}
 
-	ir_builtin_kind supported[6];
+	/* lower the vector operations and lane-wise builtins without a packed
+	 * SSE instruction to operations on the lanes */
+	foreach_irp_irg(i, irg) {
+		pset_new_t muxes;
+		pset_new_init(&muxes);
+		irg_walk_graph(irg, NULL, lower_lanewise_builtin_walker, &muxes);
+		/* only the float lane Muxes, other Muxes are left to the backend */
+		if (pset_new_size(&muxes) > 0) {
+			lanewise_muxes = &muxes;
+			lower_mux(irg, is_lanewise_mux);
+			lanewise_muxes = NULL;
+		}
+		pset_new_destroy(&muxes);
+		lower_vector(irg, amd64_lower_vector_op);
+		be_after_transform(irg, "lower-vector");
+	}
+
+	ir_builtin_kind supported[10];
 	size_t  s = 0;
 	supported[s++] = ir_bk_ffs;
 	supported[s++] = ir_bk_clz;
@@ -707,6 +811,10 @@ static void amd64_lower_for_target(void)
 	supported[s++] = ir_bk_compare_swap;
 	supported[s++] = ir_bk_saturating_increment;
 	supported[s++] = ir_bk_va_start;
+	supported[s++] = ir_bk_min;
+	supported[s++] = ir_bk_max;
+	supported[s++] = ir_bk_saturating_add;
+	supported[s++] = ir_bk_saturating_sub;
 
 	assert(s <= ARRAY_SIZE(supported));
 	lower_builtins(s, supported);
@@ -741,6 +849,7 @@ static backend_params amd64_backend_params = {
 	.dep_param                     = &amd64_arch_dep,
 	.allow_ifconv                  = amd64_is_mux_allowed,
 	.machine_size                  = 64,
+	.vector_size                   = 128,
 	.mode_float_arithmetic         = NULL,  /* will be set later */
 	.type_long_long                = NULL,  /* will be set later */
 	.type_unsigned_long_long       = NULL,  /* will be set later */
@@ -801,6 +910,8 @@ static arch_isa_if_t const amd64_isa_if = {
 	.finish                = amd64_finish,
 	.get_params            = amd64_get_backend_params,
 	.generate_code         = amd64_generate_code,
+	.jit_compile           = amd64_jit_compile,
+	.emit_function         = amd64_emit_jit_function,
 	.lower_for_target      = amd64_lower_for_target,
 	.is_valid_clobber      = amd64_is_valid_clobber,
 	.handle_intrinsics     = amd64_handle_intrinsics,
@@ -814,8 +925,10 @@ void be_init_arch_amd64(void)
 	FIRM_DBG_REGISTER(dbg, "firm.be.amd64.cg");
 
 	static const lc_opt_table_entry_t options[] = {
-		LC_OPT_ENT_BOOL("x64abi",      "Use x64 ABI (otherwise system V)", &amd64_use_x64_abi),
-		LC_OPT_ENT_BOOL("no-red-zone", "gcc compatibility",                &amd64_use_red_zone),
+		LC_OPT_ENT_BOOL("x64abi",      "Use x64 ABI (otherwise system V)",             &amd64_use_x64_abi),
+		LC_OPT_ENT_BOOL("no-red-zone", "gcc compatibility",                            &amd64_use_red_zone),
+		LC_OPT_ENT_BOOL("machcode",    "output machine code instead of assembler",     &amd64_emit_machcode),
+		LC_OPT_ENT_BOOL("object",      "write an ELF object file instead of assembler", &amd64_emit_object),
 		LC_OPT_LAST
 	};
 	lc_opt_entry_t *be_grp    = lc_opt_get_grp(firm_opt_get_root(), "be");
@@ -25,6 +25,8 @@ extern ir_mode *amd64_mode_xmm;
 
 extern bool amd64_use_red_zone;
 extern bool amd64_use_x64_abi;
+extern bool amd64_emit_machcode;
+extern bool amd64_emit_object;
 
 #define AMD64_REGISTER_SIZE   8
 /** power of two stack alignment on calls */
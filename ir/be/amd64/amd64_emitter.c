@@ -7,8 +7,7 @@
  * @file
  * @brief   emit assembler for a backend graph
  */
-#include <inttypes.h>
-
+#include "amd64_bearch_t.h"
 #include "amd64_emitter.h"
 #include "amd64_new_nodes.h"
 #include "amd64_nodes_attr.h"
@@ -19,6 +18,7 @@
 #include "beemithlp.h"
 #include "beemitter.h"
 #include "begnuas.h"
+#include "bejit.h"
 #include "beirg.h"
 #include "benode.h"
 #include "besched.h"
@@ -28,6 +28,8 @@
 #include "irgwalk.h"
 #include "panic.h"
 
+bool amd64_emit_machcode;
+
 static char get_gp_size_suffix(x86_insn_size_t const size)
 {
 	switch (size) {
@@ -66,6 +68,20 @@ static void amd64_emit_xmm_size_suffix(x86_insn_size_t const size)
 	be_emit_char(get_xmm_size_suffix(size));
 }
 
+static char get_vector_lane_suffix(x86_insn_size_t const size)
+{
+	switch (size) {
+	case X86_SIZE_8:  return 'b';
+	case X86_SIZE_16: return 'w';
+	case X86_SIZE_32: return 'd';
+	case X86_SIZE_64: return 'q';
+	case X86_SIZE_80:
+	case X86_SIZE_128:
+		break;
+	}
+	panic("invalid lane size");
+}
+
 static char get_x87_size_suffix(x86_insn_size_t const size)
 {
 	switch (size) {
@@ -215,12 +231,13 @@ static void amd64_emit_immediate64(const amd64_imm64_t *const imm)
 {
 	if (imm->kind == X86_IMM_VALUE) {
 		assert(imm->entity == NULL);
-		be_emit_irprintf("0x%" PRIX64, imm->offset);
+		be_emit_cstring("0x");
+		be_emit_hex(imm->offset);
 		return;
 	}
 	x86_emit_relocation_no_offset(imm->kind, imm->entity);
 	if (imm->offset != 0)
-		be_emit_irprintf("%+" PRId64, imm->offset);
+		be_emit_offset(imm->offset);
 }
 
 static void amd64_emit_am(const ir_node *const node, bool indirect_star)
@@ -306,7 +323,9 @@ static void emit_shiftop(const ir_node *const node)
 
 	switch (attr->base.op_mode) {
 	case AMD64_OP_SHIFT_IMM: {
-		be_emit_irprintf("$0x%X, ", attr->immediate);
+		be_emit_cstring("$0x");
+		be_emit_hex(attr->immediate);
+		be_emit_cstring(", ");
 		const arch_register_t *reg = arch_get_irn_register_in(node, 0);
 		emit_register_mode(reg, attr->base.size);
 		return;
@@ -505,6 +524,9 @@ emit_R:
 				if (*fmt == 'X') {
 					++fmt;
 					amd64_emit_xmm_size_suffix(attr->size);
+				} else if (*fmt == 'V') {
+					++fmt;
+					be_emit_char(get_vector_lane_suffix(attr->size));
 				} else {
 					amd64_emit_insn_size_suffix(attr->size);
 				}
@@ -513,7 +535,7 @@ emit_R:
 
 			case 'd': {
 				int const num = va_arg(ap, int);
-				be_emit_irprintf("%d", num);
+				be_emit_int(num);
 				break;
 			}
 
@@ -525,7 +547,7 @@ emit_R:
 
 			case 'u': {
 				unsigned const num = va_arg(ap, unsigned);
-				be_emit_irprintf("%u", num);
+				be_emit_uint(num);
 				break;
 			}
 
@@ -683,8 +705,8 @@ static void emit_amd64_jmp_switch(const ir_node *node)
 	                   emit_jumptable_target);
 }
 
-static x86_condition_code_t determine_final_cc(ir_node const *const flags,
-                                               x86_condition_code_t cc)
+x86_condition_code_t amd64_determine_final_cc(ir_node const *const flags,
+                                              x86_condition_code_t cc)
 {
 	if (is_amd64_fucomi(flags)) {
 		amd64_x87_attr_t const *const attr = get_amd64_x87_attr_const(flags);
@@ -703,7 +725,7 @@ static void emit_amd64_jcc(const ir_node *irn)
 	const ir_node         *proj_false = NULL;
 	const ir_node         *flags = get_irn_n(irn, n_amd64_jcc_eflags);
 	const amd64_cc_attr_t *attr  = get_amd64_cc_attr_const(irn);
-	x86_condition_code_t   cc    = determine_final_cc(flags, attr->cc);
+	x86_condition_code_t   cc    = amd64_determine_final_cc(flags, attr->cc);
 
 	foreach_out_edge(irn, edge) {
 		ir_node *proj = get_edge_src_irn(edge);
@@ -856,17 +878,61 @@ static void amd64_gen_block(ir_node *block)
 	}
 }
 
-void amd64_emit_function(ir_graph *irg)
+static unsigned emit_jit_entity_relocation_asm(char *const buffer,
+                                               uint8_t const be_kind,
+                                               ir_entity *const entity,
+                                               int32_t const offset)
 {
-	ir_entity *entity = get_irg_entity(irg);
+	(void)buffer;
+	assert(buffer == NULL);
+	if (entity == NULL) {
+		switch (be_kind) {
+		case AMD64_RELOCATION_REL32:
+			be_emit_cstring("\t.long ");
+			be_emit_int(offset);
+			be_emit_char('\n');
+			be_emit_write_line();
+			return 4;
+		case AMD64_RELOCATION_ABS64:
+			/* absolute address of another fragment */
+			be_emit_cstring("\t.quad .");
+			be_emit_offset(offset);
+			be_emit_char('\n');
+			be_emit_write_line();
+			return 8;
+		default:
+			assert(be_kind == X86_IMM_ADDR);
+			be_emit_cstring("\t.long .");
+			be_emit_offset(offset);
+			be_emit_char('\n');
+			be_emit_write_line();
+			return 4;
+		}
+	}
 
-	/* register all emitter functions */
+	unsigned res = 4;
+	if (be_kind == AMD64_RELOCATION_ABS64) {
+		be_emit_cstring("\t.quad ");
+		res = 8;
+	} else {
+		be_emit_cstring("\t.long ");
+	}
+	be_gas_emit_entity(entity);
+	if (offset != 0)
+		be_emit_offset(offset);
+	if (be_kind == X86_IMM_PCREL || be_kind == X86_IMM_PLT)
+		be_emit_cstring("-.");
+	be_emit_char('\n');
+	be_emit_write_line();
+	return res;
+}
+
+static void emit_function_text(ir_graph *const irg)
+{
 	amd64_register_emitters();
 
 	ir_node **blk_sched = be_create_block_schedule(irg);
 
-	be_gas_emit_function_prolog(entity, 4, NULL);
-
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
 
 	be_emit_init_cf_links(blk_sched);
@@ -876,6 +942,22 @@ void amd64_emit_function(ir_graph *irg)
 		amd64_gen_block(block);
 	}
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
+}
+
+void amd64_emit_function(ir_graph *irg)
+{
+	ir_entity *entity = get_irg_entity(irg);
+
+	be_gas_emit_function_prolog(entity, 4, NULL);
+
+	if (amd64_emit_machcode) {
+		ir_jit_segment_t  *const segment  = be_new_jit_segment();
+		ir_jit_function_t *const function = amd64_emit_jit(segment, irg);
+		be_jit_emit_as_asm(function, emit_jit_entity_relocation_asm);
+		be_destroy_jit_segment(segment);
+	} else {
+		emit_function_text(irg);
+	}
 
 	be_gas_emit_function_epilog(entity);
 }
@@ -10,7 +10,9 @@
 #ifndef FIRM_BE_AMD64_AMD64_EMITTER_H
 #define FIRM_BE_AMD64_AMD64_EMITTER_H
 
+#include "amd64_encode.h"
 #include "firm_types.h"
+#include "../ia32/x86_node.h"
 
 /**
  * fmt  parameter               output
@@ -33,4 +35,7 @@ void amd64_emitf(ir_node const *node, char const *fmt, ...);
 
 void amd64_emit_function(ir_graph *irg);
 
+x86_condition_code_t amd64_determine_final_cc(ir_node const *flags,
+                                              x86_condition_code_t cc);
+
 #endif
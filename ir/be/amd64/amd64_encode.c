@@ -0,0 +1,1595 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       amd64 binary encoding/emission
+ */
+#include "amd64_encode.h"
+
+#include <stdint.h>
+#include "amd64_bearch_t.h"
+#include "amd64_emitter.h"
+#include "amd64_new_nodes.h"
+#include "array.h"
+#include "be_t.h"
+#include "bearch.h"
+#include "beblocksched.h"
+#include "bediagnostic.h"
+#include "beemithlp.h"
+#include "begnuas.h"
+#include "beelf.h"
+#include "bejit.h"
+#include "benode.h"
+#include "besched.h"
+#include "beutil.h"
+#include "bitfiddle.h"
+#include "entity_t.h"
+#include "gen_amd64_emitter.h"
+#include "gen_amd64_regalloc_if.h"
+#include "iredges_t.h"
+#include "irgwalk.h"
+#include "irnodehashmap.h"
+#include "panic.h"
+#include "pmap.h"
+#include "tv.h"
+#include "../ia32/x86_node.h"
+
+static ir_nodehashmap_t block_fragmentnum;
+
+/**
+ * Kinds of data placed behind the code of a function.  Each of them gets a
+ * fragment of its own, so the code can reach it relative to the instruction
+ * pointer.
+ */
+typedef enum data_kind_t {
+	DATA_CONSTANT,  /**< contents of a private constant entity */
+	DATA_GOT_SLOT,  /**< 64bit address of an entity */
+	DATA_CALL_STUB, /**< indirect jump to an entity */
+	DATA_KIND_LAST = DATA_CALL_STUB
+} data_kind_t;
+
+typedef struct data_fragment_t {
+	data_kind_t kind;
+	ir_entity  *entity;
+} data_fragment_t;
+
+static unsigned         first_data_fragment;
+static data_fragment_t *data_fragments;
+/** maps entities to their data fragment number, one map per data_kind_t */
+static pmap            *data_fragment_nums[DATA_KIND_LAST + 1];
+/** maps jump table entities to their jmp_switch node */
+static pmap            *jump_tables;
+/**
+ * Set while encoding for an object file, where the linker resolves
+ * references to entities.
+ */
+static bool             encoding_object;
+
+bool amd64_emit_object;
+
+/** Relocation types of the x86_64 ELF ABI */
+enum {
+	R_X86_64_64       = 1,
+	R_X86_64_PC32     = 2,
+	R_X86_64_PLT32    = 4,
+	R_X86_64_GOTPCREL = 9,
+	R_X86_64_32       = 10,
+	R_X86_64_32S      = 11,
+};
+
+be_elf_target_t const amd64_elf_target = {
+	.machine     = 62, /* EM_X86_64 */
+	.reloc_abs32 = R_X86_64_32,
+	.reloc_abs64 = R_X86_64_64,
+};
+
+enum {
+	REX   = 0x40, /**< REX prefix without any bits set */
+	REX_W = 0x48, /**< REX prefix for 64bit operand size */
+};
+
+enum OpSize {
+	OP_8       = 0x00, /* 8bit operation. */
+	OP_16_32   = 0x01, /* 16/32/64bit operation. */
+	OP_MEM_SRC = 0x02, /* The memory operand is in the source position. */
+};
+
+/** The mod encoding of the ModR/M */
+enum Mod {
+	MOD_IND          = 0x00, /**< [reg1] */
+	MOD_IND_BYTE_OFS = 0x40, /**< [reg1 + byte ofs] */
+	MOD_IND_WORD_OFS = 0x80, /**< [reg1 + word ofs] */
+	MOD_REG          = 0xC0  /**< reg1 */
+};
+
+/** create R/M encoding for ModR/M */
+static uint8_t ENC_RM(unsigned const regnum)
+{
+	return regnum & 0x07;
+}
+
+/** create REG encoding for ModR/M */
+static uint8_t ENC_REG(unsigned const regnum)
+{
+	return (regnum & 0x07) << 3;
+}
+
+/** create encoding for a SIB byte */
+static uint8_t ENC_SIB(uint8_t scale, unsigned index, unsigned base)
+{
+	return scale << 6 | (index & 0x07) << 3 | (base & 0x07);
+}
+
+static bool is_8bit_val(int32_t const value)
+{
+	return -128 <= value && value < 128;
+}
+
+static bool fits_int32(int64_t const value)
+{
+	return (int32_t)value == value;
+}
+
+static uint8_t size_prefix(x86_insn_size_t const size)
+{
+	return size == X86_SIZE_16 ? 0x66 : 0;
+}
+
+static uint8_t size_rex(x86_insn_size_t const size)
+{
+	return size == X86_SIZE_64 ? REX_W : 0;
+}
+
+/**
+ * Byte accesses to spl, bpl, sil and dil need a REX prefix, otherwise the
+ * encoding means ah, ch, dh and bh.
+ */
+static uint8_t rex_byte_reg(x86_insn_size_t const size,
+                            arch_register_t const *const reg)
+{
+	if (size != X86_SIZE_8 || reg->cls != &amd64_reg_classes[CLASS_amd64_gp])
+		return 0;
+	return (reg->encoding & 0x0C) == 0x04 ? REX : 0;
+}
+
+/**
+ * Private constant data without a JIT address (floating point constants,
+ * jump tables) is placed behind the code of the function.  Object files
+ * only keep jump tables there.
+ */
+static bool is_local_constant(ir_entity const *const entity)
+{
+	if (get_entity_visibility(entity) != ir_visibility_private
+	 || !(get_entity_linkage(entity) & IR_LINKAGE_CONSTANT))
+		return false;
+	/* jump tables are owned by the dummy type and never have an address */
+	if (!is_global_entity(entity))
+		return true;
+	return !encoding_object && be_jit_get_entity_addr(entity) == (void const*)-1;
+}
+
+static unsigned get_data_fragment(data_kind_t const kind,
+                                  ir_entity *const entity)
+{
+	/* Block fragments come first, so data fragment numbers are never 0. */
+	pmap *const map = data_fragment_nums[kind];
+	void *const num = pmap_get(void, map, entity);
+	if (num != NULL)
+		return PTR_TO_INT(num);
+
+	unsigned const fragment_num = first_data_fragment + ARR_LEN(data_fragments);
+	data_fragment_t const fragment = { .kind = kind, .entity = entity };
+	ARR_APP1(data_fragment_t, data_fragments, fragment);
+	pmap_insert(map, entity, INT_TO_PTR(fragment_num));
+	return fragment_num;
+}
+
+static unsigned get_block_fragment_num(ir_node const *const block)
+{
+	return PTR_TO_INT(ir_nodehashmap_get(void, &block_fragmentnum, block));
+}
+
+/**
+ * Emit a 32bit immediate or displacement.
+ *
+ * @param insn_rest  number of instruction bytes following the field, needed
+ *                   for addresses relative to the instruction pointer
+ */
+static void enc_imm32(x86_imm32_t const *const imm, unsigned const insn_rest)
+{
+	ir_entity *const entity = imm->entity;
+	int32_t    const offset = imm->offset;
+	if (entity == NULL) {
+		be_emit32(offset);
+		return;
+	}
+
+	int32_t const rel_offset = offset - 4 - (int32_t)insn_rest;
+	switch ((x86_immediate_kind_t)imm->kind) {
+	case X86_IMM_ADDR:
+		if (is_local_constant(entity)) {
+			unsigned const fragment_num
+				= get_data_fragment(DATA_CONSTANT, entity);
+			be_emit_reloc_fragment(4, X86_IMM_ADDR, fragment_num, offset);
+		} else {
+			be_emit_reloc_entity(4, X86_IMM_ADDR, entity, offset);
+		}
+		return;
+	case X86_IMM_PCREL:
+	case X86_IMM_PLT:
+		if (is_local_constant(entity)) {
+			unsigned const fragment_num
+				= get_data_fragment(DATA_CONSTANT, entity);
+			be_emit_reloc_fragment(4, AMD64_RELOCATION_REL32, fragment_num,
+			                       rel_offset);
+		} else {
+			be_emit_reloc_entity(4, imm->kind, entity, rel_offset);
+		}
+		return;
+	case X86_IMM_GOTPCREL: {
+		if (encoding_object) {
+			be_emit_reloc_entity(4, X86_IMM_GOTPCREL, entity, rel_offset);
+			return;
+		}
+		unsigned const fragment_num = get_data_fragment(DATA_GOT_SLOT, entity);
+		be_emit_reloc_fragment(4, AMD64_RELOCATION_REL32, fragment_num,
+		                       rel_offset);
+		return;
+	}
+	default:
+		break;
+	}
+	panic("unsupported relocation for %+F", entity);
+}
+
+static void enc_imm(x86_imm32_t const *const imm, unsigned const imm_size)
+{
+	switch (imm_size) {
+	case 1: be_emit8(imm->offset);  return;
+	case 2: be_emit16(imm->offset); return;
+	case 4: enc_imm32(imm, 0);      return;
+	}
+	panic("invalid immediate size");
+}
+
+static void enc_jmp_destination(ir_node const *const cfop)
+{
+	assert(get_irn_mode(cfop) == mode_X);
+	ir_node const *const dest_block = be_emit_get_cfop_target(cfop);
+	unsigned const fragment_num = get_block_fragment_num(dest_block);
+	be_emit_reloc_fragment(4, AMD64_RELOCATION_REL32, fragment_num, -4);
+}
+
+/**
+ * Emit the mandatory prefix, the REX prefix and the opcode.
+ *
+ * @param rex     0, REX or REX_W; the extension bits of @p reg, @p index and
+ *                @p base are added
+ * @param opcode  1 to 3 opcode bytes
+ */
+static void enc_opcode(uint8_t const prefix, uint8_t rex, uint32_t const opcode,
+                       unsigned const reg, unsigned const index,
+                       unsigned const base)
+{
+	if (prefix != 0)
+		be_emit8(prefix);
+	rex |= (reg & 0x08) >> 1 | (index & 0x08) >> 2 | (base & 0x08) >> 3;
+	if (rex != 0)
+		be_emit8(REX | rex);
+	if (opcode > 0xFFFF)
+		be_emit8(opcode >> 16);
+	if (opcode > 0xFF)
+		be_emit8(opcode >> 8);
+	be_emit8(opcode);
+}
+
+/**
+ * Emit an instruction with a register in the r/m field.
+ *
+ * @param reg  content of the reg field: either a register encoding or an
+ *             opcode extension
+ */
+static void enc_rr(uint8_t const prefix, uint8_t const rex,
+                   uint32_t const opcode, unsigned const reg, unsigned const rm)
+{
+	enc_opcode(prefix, rex, opcode, reg, 0, rm);
+	be_emit8(MOD_REG | ENC_REG(reg) | ENC_RM(rm));
+}
+
+static void enc_segment(x86_segment_selector_t const segment)
+{
+	switch (segment) {
+	case X86_SEGMENT_DEFAULT:                  return;
+	case X86_SEGMENT_CS:      be_emit8(0x2E); return;
+	case X86_SEGMENT_SS:      be_emit8(0x36); return;
+	case X86_SEGMENT_DS:      be_emit8(0x3E); return;
+	case X86_SEGMENT_ES:      be_emit8(0x26); return;
+	case X86_SEGMENT_FS:      be_emit8(0x64); return;
+	case X86_SEGMENT_GS:      be_emit8(0x65); return;
+	}
+	panic("invalid segment");
+}
+
+/**
+ * Emit an instruction with a memory operand.
+ *
+ * @param reg       content of the reg field: either a register encoding or an
+ *                  opcode extension
+ * @param imm_size  size of an immediate following the address
+ */
+static void enc_am(uint8_t const prefix, uint8_t const rex,
+                   uint32_t const opcode, unsigned const reg,
+                   ir_node const *const node, x86_addr_t const *const addr,
+                   unsigned const imm_size)
+{
+	x86_addr_variant_t variant = addr->variant;
+	x86_imm32_t        imm     = addr->immediate;
+	if (variant == X86_ADDR_JUST_IMM && imm.entity != NULL
+	 && is_local_constant(imm.entity)) {
+		/* local constants are addressed relative to the instruction pointer */
+		assert(imm.kind == X86_IMM_ADDR);
+		variant  = X86_ADDR_RIP;
+		imm.kind = X86_IMM_PCREL;
+	}
+
+	unsigned   base      = 0;
+	unsigned   index     = 0;
+	bool const has_base  = x86_addr_variant_has_base(variant);
+	bool const has_index = x86_addr_variant_has_index(variant);
+	if (has_base)
+		base = arch_get_irn_register_in(node, addr->base_input)->encoding;
+	if (has_index)
+		index = arch_get_irn_register_in(node, addr->index_input)->encoding;
+
+	enc_segment(addr->segment);
+	enc_opcode(prefix, rex, opcode, reg, index, base);
+
+	switch (variant) {
+	case X86_ADDR_RIP:
+		assert(imm.kind == X86_IMM_PCREL || imm.kind == X86_IMM_GOTPCREL);
+		be_emit8(MOD_IND | ENC_REG(reg) | ENC_RM(0x05));
+		enc_imm32(&imm, imm_size);
+		return;
+
+	case X86_ADDR_JUST_IMM:
+	case X86_ADDR_INDEX: {
+		/* A SIB byte with the RBP encoding as base and MOD_IND means no base
+		 * register and a 32bit displacement, RSP as index means no index. */
+		unsigned const log_scale = has_index ? addr->log_scale : 0;
+		be_emit8(MOD_IND | ENC_REG(reg) | ENC_RM(0x04));
+		be_emit8(ENC_SIB(log_scale, has_index ? index : 0x04, 0x05));
+		enc_imm32(&imm, imm_size);
+		return;
+	}
+
+	case X86_ADDR_BASE:
+	case X86_ADDR_BASE_INDEX: {
+		/* set the mod part depending on displacement */
+		unsigned modrm;
+		unsigned emitoffs;
+		if (imm.entity != NULL) {
+			modrm    = MOD_IND_WORD_OFS;
+			emitoffs = 32;
+		} else if (imm.offset == 0 && (base & 0x07) != 0x05) {
+			/* RBP and R13 as base without offset would mean RIP relative or
+			 * no base, so these need an 8bit offset. */
+			modrm    = MOD_IND;
+			emitoffs = 0;
+		} else if (is_8bit_val(imm.offset)) {
+			modrm    = MOD_IND_BYTE_OFS;
+			emitoffs = 8;
+		} else {
+			modrm    = MOD_IND_WORD_OFS;
+			emitoffs = 32;
+		}
+		modrm |= ENC_REG(reg);
+
+		if (has_index || (base & 0x07) == 0x04) {
+			/* R/M set to RSP means SIB, so RSP and R12 as base need one, too. */
+			unsigned const log_scale = has_index ? addr->log_scale : 0;
+			be_emit8(modrm | ENC_RM(0x04));
+			be_emit8(ENC_SIB(log_scale, has_index ? index : 0x04, base));
+		} else {
+			be_emit8(modrm | ENC_RM(base));
+		}
+
+		/* emit displacement */
+		if (emitoffs == 8) {
+			be_emit8(imm.offset);
+		} else if (emitoffs == 32) {
+			enc_imm32(&imm, imm_size);
+		}
+		return;
+	}
+
+	case X86_ADDR_REG:
+	case X86_ADDR_INVALID:
+		break;
+	}
+	panic("invalid address variant in %+F", node);
+}
+
+/**
+ * Emit an instruction whose r/m operand is the register or memory operand of
+ * @p node.
+ */
+static void enc_rm(uint8_t const prefix, uint8_t rex, uint32_t const opcode,
+                   unsigned const reg, ir_node const *const node,
+                   unsigned const imm_size)
+{
+	amd64_addr_attr_t const *const attr = get_amd64_addr_attr_const(node);
+	switch ((amd64_op_mode_t)attr->base.op_mode) {
+	case AMD64_OP_REG: {
+		assert(attr->addr.variant == X86_ADDR_REG);
+		arch_register_t const *const rm
+			= arch_get_irn_register_in(node, attr->addr.base_input);
+		rex |= rex_byte_reg(attr->base.size, rm);
+		enc_rr(prefix, rex, opcode, reg, rm->encoding);
+		return;
+	}
+	case AMD64_OP_ADDR:
+	case AMD64_OP_X87_ADDR_REG:
+		enc_am(prefix, rex, opcode, reg, node, &attr->addr, imm_size);
+		return;
+	default:
+		break;
+	}
+	panic("invalid op_mode for %+F", node);
+}
+
+/** Emit an instruction with the first result register in the reg field. */
+static void enc_to_reg(ir_node const *const node, uint8_t const prefix,
+                       uint8_t const rex, uint32_t const opcode)
+{
+	arch_register_t const *const out = arch_get_irn_register_out(node, 0);
+	enc_rm(prefix, rex, opcode, out->encoding, node, 0);
+}
+
+/**
+ * Emit a binary operation with register or memory operands.
+ *
+ * @param opcode  the 8bit "op reg, r/m" form of the instruction
+ */
+static void enc_binop_reg(ir_node const *const node, uint32_t opcode)
+{
+	amd64_binop_addr_attr_t const *const attr
+		= get_amd64_binop_addr_attr_const(node);
+	x86_insn_size_t const size   = attr->base.base.size;
+	uint8_t         const prefix = size_prefix(size);
+	uint8_t         const rex    = size_rex(size);
+	if (size != X86_SIZE_8)
+		opcode |= OP_16_32;
+
+	switch ((amd64_op_mode_t)attr->base.base.op_mode) {
+	case AMD64_OP_REG_REG: {
+		arch_register_t const *const dst
+			= arch_get_irn_register_in(node, attr->base.addr.base_input);
+		arch_register_t const *const src = arch_get_irn_register_in(node, 1);
+		uint8_t const byte_rex = rex_byte_reg(size, dst) | rex_byte_reg(size, src);
+		enc_rr(prefix, rex | byte_rex, opcode, src->encoding, dst->encoding);
+		return;
+	}
+	case AMD64_OP_ADDR_REG: {
+		arch_register_t const *const src
+			= arch_get_irn_register_in(node, attr->u.reg_input);
+		enc_am(prefix, rex | rex_byte_reg(size, src), opcode, src->encoding,
+		       node, &attr->base.addr, 0);
+		return;
+	}
+	case AMD64_OP_REG_ADDR: {
+		arch_register_t const *const dst
+			= arch_get_irn_register_in(node, attr->u.reg_input);
+		enc_am(prefix, rex | rex_byte_reg(size, dst), opcode | OP_MEM_SRC,
+		       dst->encoding, node, &attr->base.addr, 0);
+		return;
+	}
+	default:
+		break;
+	}
+	panic("invalid op_mode for %+F", node);
+}
+
+/** Emit a binary operation with an immediate operand. */
+static void enc_binop_imm(ir_node const *const node, uint8_t const opcode,
+                          unsigned const ext, unsigned const imm_size)
+{
+	amd64_binop_addr_attr_t const *const attr
+		= get_amd64_binop_addr_attr_const(node);
+	x86_insn_size_t const size   = attr->base.base.size;
+	uint8_t         const prefix = size_prefix(size);
+	uint8_t         const rex    = size_rex(size);
+
+	switch ((amd64_op_mode_t)attr->base.base.op_mode) {
+	case AMD64_OP_REG_IMM: {
+		arch_register_t const *const reg
+			= arch_get_irn_register_in(node, attr->base.addr.base_input);
+		enc_rr(prefix, rex | rex_byte_reg(size, reg), opcode, ext,
+		       reg->encoding);
+		break;
+	}
+	case AMD64_OP_ADDR_IMM:
+		enc_am(prefix, rex, opcode, ext, node, &attr->base.addr, imm_size);
+		break;
+	default:
+		panic("invalid op_mode for %+F", node);
+	}
+	enc_imm(&attr->u.immediate, imm_size);
+}
+
+/** Returns the size of a 16/32bit immediate for an operation size. */
+static unsigned get_imm_size(x86_insn_size_t const size)
+{
+	switch (size) {
+	case X86_SIZE_8:  return 1;
+	case X86_SIZE_16: return 2;
+	default:          return 4;
+	}
+}
+
+void amd64_enc_binop(ir_node const *const node, unsigned const code)
+{
+	amd64_binop_addr_attr_t const *const attr
+		= get_amd64_binop_addr_attr_const(node);
+	amd64_op_mode_t const op_mode = (amd64_op_mode_t)attr->base.base.op_mode;
+	if (op_mode == AMD64_OP_REG_IMM || op_mode == AMD64_OP_ADDR_IMM) {
+		x86_insn_size_t    const size = attr->base.base.size;
+		x86_imm32_t const *const imm  = &attr->u.immediate;
+		if (size == X86_SIZE_8) {
+			enc_binop_imm(node, 0x80, code, 1);
+		} else if (imm->entity == NULL && is_8bit_val(imm->offset)) {
+			/* short form with 8bit sign extended immediate */
+			enc_binop_imm(node, 0x83, code, 1);
+		} else {
+			enc_binop_imm(node, 0x81, code, get_imm_size(size));
+		}
+	} else {
+		enc_binop_reg(node, code << 3);
+	}
+}
+
+void amd64_enc_unop(ir_node const *const node, uint8_t const ext)
+{
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	uint8_t const opcode = size == X86_SIZE_8 ? 0xF6 : 0xF6 | OP_16_32;
+	enc_rm(size_prefix(size), size_rex(size), opcode, ext, node, 0);
+}
+
+void amd64_enc_shiftop(ir_node const *const node, uint8_t const ext)
+{
+	amd64_shift_attr_t const *const attr = get_amd64_shift_attr_const(node);
+	x86_insn_size_t        const size   = attr->base.size;
+	arch_register_t const *const reg    = arch_get_irn_register_in(node, 0);
+	uint8_t                const prefix = size_prefix(size);
+	uint8_t                const rex    = size_rex(size) | rex_byte_reg(size, reg);
+	uint8_t                const op     = size == X86_SIZE_8 ? OP_8 : OP_16_32;
+
+	switch ((amd64_op_mode_t)attr->base.op_mode) {
+	case AMD64_OP_SHIFT_IMM:
+		if (attr->immediate == 1) {
+			enc_rr(prefix, rex, 0xD0 | op, ext, reg->encoding);
+		} else {
+			enc_rr(prefix, rex, 0xC0 | op, ext, reg->encoding);
+			be_emit8(attr->immediate);
+		}
+		return;
+	case AMD64_OP_SHIFT_REG:
+		enc_rr(prefix, rex, 0xD2 | op, ext, reg->encoding);
+		return;
+	default:
+		break;
+	}
+	panic("invalid op_mode for shiftop");
+}
+
+void amd64_enc_bitscan(ir_node const *const node, uint8_t const opcode)
+{
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	enc_to_reg(node, size_prefix(size), size_rex(size), 0x0F00 | opcode);
+}
+
+void amd64_enc_xmm_binop(ir_node const *const node, uint8_t const prefix,
+                         uint32_t const opcode)
+{
+	amd64_binop_addr_attr_t const *const attr
+		= get_amd64_binop_addr_attr_const(node);
+	switch ((amd64_op_mode_t)attr->base.base.op_mode) {
+	case AMD64_OP_REG_REG: {
+		arch_register_t const *const dst
+			= arch_get_irn_register_in(node, attr->base.addr.base_input);
+		arch_register_t const *const src = arch_get_irn_register_in(node, 1);
+		enc_rr(prefix, 0, opcode, dst->encoding, src->encoding);
+		return;
+	}
+	case AMD64_OP_REG_ADDR: {
+		arch_register_t const *const dst
+			= arch_get_irn_register_in(node, attr->u.reg_input);
+		enc_am(prefix, 0, opcode, dst->encoding, node, &attr->base.addr, 0);
+		return;
+	}
+	default:
+		break;
+	}
+	panic("invalid op_mode for %+F", node);
+}
+
+void amd64_enc_sse_scalar(ir_node const *const node, uint32_t const opcode)
+{
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	amd64_enc_xmm_binop(node, size == X86_SIZE_32 ? 0xF3 : 0xF2, opcode);
+}
+
+void amd64_enc_sse_packed(ir_node const *const node, uint32_t const opcode)
+{
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	amd64_enc_xmm_binop(node, size == X86_SIZE_32 ? 0 : 0x66, opcode);
+}
+
+void amd64_enc_sse_lanes(ir_node const *const node, uint32_t const op8,
+                         uint32_t const op16, uint32_t const op32,
+                         uint32_t const op64)
+{
+	uint32_t opcode;
+	switch (get_amd64_attr_const(node)->size) {
+	case X86_SIZE_8:  opcode = op8;  break;
+	case X86_SIZE_16: opcode = op16; break;
+	case X86_SIZE_32: opcode = op32; break;
+	case X86_SIZE_64: opcode = op64; break;
+	default:          opcode = 0;    break;
+	}
+	if (opcode == 0)
+		panic("invalid lane size for %+F", node);
+	amd64_enc_xmm_binop(node, 0x66, opcode);
+}
+
+void amd64_enc_xmm_unop(ir_node const *const node, uint8_t const prefix,
+                        uint32_t const opcode)
+{
+	enc_to_reg(node, prefix, 0, opcode);
+}
+
+void amd64_enc_cvt(ir_node const *const node, uint8_t const prefix,
+                   uint32_t const opcode)
+{
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	enc_to_reg(node, prefix, size_rex(size), opcode);
+}
+
+void amd64_enc_xmm_shift(ir_node const *const node, uint8_t const ext)
+{
+	amd64_shift_attr_t const *const attr = get_amd64_shift_attr_const(node);
+	arch_register_t    const *const reg  = arch_get_irn_register_in(node, 0);
+	enc_rr(0x66, 0, 0x0F73, ext, reg->encoding);
+	be_emit8(attr->immediate);
+}
+
+void amd64_enc_fsimple(uint8_t const opcode)
+{
+	be_emit8(0xD9);
+	be_emit8(opcode);
+}
+
+void amd64_enc_fbinop(ir_node const *const node, uint8_t const op,
+                      uint8_t const op_rev)
+{
+	x87_attr_t const *const x87 = amd64_get_x87_attr_const(node);
+	assert(!x87->pop || x87->res_in_reg);
+
+	uint8_t op0 = 0xD8;
+	if (x87->res_in_reg) op0 |= 0x04;
+	if (x87->pop)        op0 |= 0x02;
+	be_emit8(op0);
+	uint8_t const ext = x87->reverse ? op_rev : op;
+	be_emit8(MOD_REG | ENC_REG(ext) | ENC_RM(x87->reg->encoding));
+}
+
+void amd64_enc_fop_reg(ir_node const *const node, uint8_t const op0,
+                       uint8_t const op1)
+{
+	be_emit8(op0);
+	be_emit8(op1 + amd64_get_x87_attr_const(node)->reg->encoding);
+}
+
+void amd64_enc_simple(uint8_t const opcode)
+{
+	be_emit8(opcode);
+}
+
+static void enc_mov(arch_register_t const *const src,
+                    arch_register_t const *const dst)
+{
+	enc_rr(0, REX_W, 0x89, src->encoding, dst->encoding); // movq %src, %dst
+}
+
+static void enc_xchg(arch_register_t const *const src,
+                     arch_register_t const *const dst)
+{
+	if (src->index == REG_GP_RAX) {
+		enc_opcode(0, REX_W, 0x90 + ENC_RM(dst->encoding), 0, 0, dst->encoding);
+	} else if (dst->index == REG_GP_RAX) {
+		enc_opcode(0, REX_W, 0x90 + ENC_RM(src->encoding), 0, 0, src->encoding);
+	} else {
+		enc_rr(0, REX_W, 0x87, src->encoding, dst->encoding);
+	}
+}
+
+static void enc_copy(ir_node const *const node)
+{
+	arch_register_t const *const in  = arch_get_irn_register_in(node, 0);
+	arch_register_t const *const out = arch_get_irn_register_out(node, 0);
+	if (in == out)
+		return;
+
+	arch_register_class_t const *const cls = out->cls;
+	if (cls == &amd64_reg_classes[CLASS_amd64_gp]) {
+		enc_mov(in, out);
+	} else if (cls == &amd64_reg_classes[CLASS_amd64_xmm]) {
+		enc_rr(0x66, 0, 0x0F28, out->encoding, in->encoding); // movapd
+	} else if (cls == &amd64_reg_classes[CLASS_amd64_x87]) {
+		/* nothing to do */
+	} else {
+		panic("move not supported for this register class");
+	}
+}
+
+static void enc_perm(ir_node const *const node)
+{
+	arch_register_t const *const reg0 = arch_get_irn_register_out(node, 0);
+	arch_register_t const *const reg1 = arch_get_irn_register_out(node, 1);
+
+	arch_register_class_t const* const cls = reg0->cls;
+	assert(cls == reg1->cls && "Register class mismatch at Perm");
+
+	if (cls == &amd64_reg_classes[CLASS_amd64_gp]) {
+		enc_xchg(reg0, reg1);
+	} else if (cls == &amd64_reg_classes[CLASS_amd64_xmm]) {
+		unsigned const enc0 = reg0->encoding;
+		unsigned const enc1 = reg1->encoding;
+		enc_rr(0x66, 0, 0x0FEF, enc1, enc0); // pxor %reg0, %reg1
+		enc_rr(0x66, 0, 0x0FEF, enc0, enc1); // pxor %reg1, %reg0
+		enc_rr(0x66, 0, 0x0FEF, enc1, enc0); // pxor %reg0, %reg1
+	} else {
+		panic("unexpected register class in be_Perm (%+F)", node);
+	}
+}
+
+static void enc_incsp(ir_node const *const node)
+{
+	int offs = be_get_IncSP_offset(node);
+	if (offs == 0)
+		return;
+
+	unsigned ext;
+	if (offs > 0) {
+		ext = 5; /* sub */
+	} else {
+		ext = 0; /* add */
+		offs = -offs;
+	}
+
+	arch_register_t const *const reg = arch_get_irn_register_out(node, 0);
+	if (is_8bit_val(offs)) {
+		enc_rr(0, REX_W, 0x83, ext, reg->encoding);
+		be_emit8(offs);
+	} else {
+		enc_rr(0, REX_W, 0x81, ext, reg->encoding);
+		be_emit32(offs);
+	}
+}
+
+static void enc_asm(ir_node const *const node)
+{
+	/* amd64_check_encodable() rejects graphs with inline assembler */
+	panic("inline assembler not supported in machine code output (%+F)", node);
+}
+
+static void enc_xor_0(ir_node const *const node)
+{
+	arch_register_t const *const out = arch_get_irn_register_out(node, 0);
+	enc_rr(0, 0, 0x31, out->encoding, out->encoding); // xorl %out, %out
+}
+
+static void enc_lea(ir_node const *const node)
+{
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	enc_to_reg(node, 0, size_rex(size), 0x8D);
+}
+
+static void enc_mov_imm(ir_node const *const node)
+{
+	amd64_movimm_attr_t const *const attr = get_amd64_movimm_attr_const(node);
+	amd64_imm64_t       const *const imm  = &attr->immediate;
+	x86_insn_size_t            const size = attr->base.size;
+	unsigned                   const reg
+		= arch_get_irn_register_out(node, 0)->encoding;
+	ir_entity *const entity = imm->entity;
+	if (entity != NULL) {
+		if (imm->kind != X86_IMM_ADDR || !fits_int32(imm->offset))
+			panic("unsupported immediate in %+F", node);
+		if (is_local_constant(entity)) {
+			/* leaq entity(%rip), %reg */
+			x86_addr_t const addr = {
+				.immediate = {
+					.kind   = X86_IMM_PCREL,
+					.entity = entity,
+					.offset = imm->offset,
+				},
+				.variant = X86_ADDR_RIP,
+			};
+			enc_am(0, REX_W, 0x8D, reg, node, &addr, 0);
+		} else if (size == X86_SIZE_64) {
+			/* movabsq $entity, %reg */
+			enc_opcode(0, REX_W, 0xB8 + ENC_RM(reg), 0, 0, reg);
+			be_emit_reloc_entity(8, AMD64_RELOCATION_ABS64, entity,
+			                     imm->offset);
+		} else {
+			enc_opcode(0, 0, 0xB8 + ENC_RM(reg), 0, 0, reg);
+			be_emit_reloc_entity(4, X86_IMM_ADDR, entity, imm->offset);
+		}
+		return;
+	}
+
+	int64_t const offset = imm->offset;
+	if (size != X86_SIZE_64) {
+		enc_opcode(0, 0, 0xB8 + ENC_RM(reg), 0, 0, reg); // movl $imm32, %reg
+		be_emit32(offset);
+	} else if (fits_int32(offset)) {
+		enc_rr(0, REX_W, 0xC7, 0, reg); // movq $simm32, %reg
+		be_emit32(offset);
+	} else {
+		enc_opcode(0, REX_W, 0xB8 + ENC_RM(reg), 0, 0, reg); // movabsq
+		be_emit32((uint64_t)offset);
+		be_emit32((uint64_t)offset >> 32);
+	}
+}
+
+static void enc_mov_gp(ir_node const *const node)
+{
+	switch (get_amd64_attr_const(node)->size) {
+	case X86_SIZE_8:  enc_to_reg(node, 0, REX_W, 0x0FB6); return; // movzbq
+	case X86_SIZE_16: enc_to_reg(node, 0, REX_W, 0x0FB7); return; // movzwq
+	case X86_SIZE_32: enc_to_reg(node, 0, 0,     0x8B);   return; // movl
+	case X86_SIZE_64: enc_to_reg(node, 0, REX_W, 0x8B);   return; // movq
+	case X86_SIZE_80:
+	case X86_SIZE_128:
+		break;
+	}
+	panic("invalid insn mode");
+}
+
+static void enc_movs(ir_node const *const node)
+{
+	switch (get_amd64_attr_const(node)->size) {
+	case X86_SIZE_8:  enc_to_reg(node, 0, REX_W, 0x0FBE); return; // movsbq
+	case X86_SIZE_16: enc_to_reg(node, 0, REX_W, 0x0FBF); return; // movswq
+	case X86_SIZE_32: enc_to_reg(node, 0, REX_W, 0x63);   return; // movslq
+	case X86_SIZE_64:
+	case X86_SIZE_80:
+	case X86_SIZE_128:
+		break;
+	}
+	panic("invalid insn mode");
+}
+
+static void enc_mov_store(ir_node const *const node)
+{
+	amd64_binop_addr_attr_t const *const attr
+		= get_amd64_binop_addr_attr_const(node);
+	if (attr->base.base.op_mode == AMD64_OP_ADDR_IMM) {
+		x86_insn_size_t const size = attr->base.base.size;
+		uint8_t const opcode = size == X86_SIZE_8 ? 0xC6 : 0xC6 | OP_16_32;
+		enc_binop_imm(node, opcode, 0, get_imm_size(size));
+	} else {
+		enc_binop_reg(node, 0x88);
+	}
+}
+
+static void enc_imul(ir_node const *const node)
+{
+	amd64_binop_addr_attr_t const *const attr
+		= get_amd64_binop_addr_attr_const(node);
+	x86_insn_size_t const size   = attr->base.base.size;
+	uint8_t         const prefix = size_prefix(size);
+	uint8_t         const rex    = size_rex(size);
+
+	switch ((amd64_op_mode_t)attr->base.base.op_mode) {
+	case AMD64_OP_REG_REG: {
+		arch_register_t const *const dst
+			= arch_get_irn_register_in(node, attr->base.addr.base_input);
+		arch_register_t const *const src = arch_get_irn_register_in(node, 1);
+		enc_rr(prefix, rex, 0x0FAF, dst->encoding, src->encoding);
+		return;
+	}
+	case AMD64_OP_REG_ADDR: {
+		arch_register_t const *const dst
+			= arch_get_irn_register_in(node, attr->u.reg_input);
+		enc_am(prefix, rex, 0x0FAF, dst->encoding, node, &attr->base.addr, 0);
+		return;
+	}
+	case AMD64_OP_REG_IMM: {
+		arch_register_t const *const dst
+			= arch_get_irn_register_in(node, attr->base.addr.base_input);
+		x86_imm32_t const *const imm = &attr->u.immediate;
+		if (imm->entity == NULL && is_8bit_val(imm->offset)) {
+			enc_rr(prefix, rex, 0x6B, dst->encoding, dst->encoding);
+			enc_imm(imm, 1);
+		} else {
+			enc_rr(prefix, rex, 0x69, dst->encoding, dst->encoding);
+			enc_imm(imm, get_imm_size(size));
+		}
+		return;
+	}
+	default:
+		break;
+	}
+	panic("invalid op_mode for %+F", node);
+}
+
+static void enc_cmpxchg(ir_node const *const node)
+{
+	be_emit8(0xF0); // lock
+	enc_binop_reg(node, 0x0FB0);
+}
+
+static void enc_sub_sp(ir_node const *const node)
+{
+	/* subq %in, %rsp */
+	amd64_enc_binop(node, 5);
+	/* movq %rsp, %out */
+	arch_register_t const *const out
+		= arch_get_irn_register_out(node, pn_amd64_sub_sp_addr);
+	enc_mov(&amd64_registers[REG_RSP], out);
+}
+
+static void enc_setcc(ir_node const *const node)
+{
+	x86_condition_code_t   const cc  = get_amd64_cc_attr_const(node)->cc;
+	arch_register_t const *const out = arch_get_irn_register_out(node, 0);
+	enc_rr(0, rex_byte_reg(X86_SIZE_8, out), 0x0F90 | (cc & 0x0F), 0,
+	       out->encoding);
+}
+
+static void enc_push_am(ir_node const *const node)
+{
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	enc_rm(size_prefix(size), 0, 0xFF, 6, node, 0);
+}
+
+static void enc_push_reg(ir_node const *const node)
+{
+	arch_register_t const *const reg
+		= arch_get_irn_register_in(node, n_amd64_push_reg_val);
+	enc_opcode(0, 0, 0x50 + ENC_RM(reg->encoding), 0, 0, reg->encoding);
+}
+
+static void enc_pop_am(ir_node const *const node)
+{
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	enc_rm(size_prefix(size), 0, 0x8F, 0, node, 0);
+}
+
+static void enc_ijmp(ir_node const *const node)
+{
+	enc_rm(0, 0, 0xFF, 4, node, 0);
+}
+
+static void enc_call(ir_node const *const node)
+{
+	amd64_addr_attr_t const *const attr = get_amd64_addr_attr_const(node);
+	if (attr->base.op_mode != AMD64_OP_IMM32) {
+		enc_rm(0, 0, 0xFF, 2, node, 0);
+		return;
+	}
+
+	/* Direct calls go through a stub behind the function, as the callee may
+	 * be further away than 2GiB.  The linker takes care of this in object
+	 * files. */
+	x86_imm32_t const *const imm = &attr->addr.immediate;
+	be_emit8(0xE8);
+	if (imm->entity == NULL || imm->offset != 0 || encoding_object) {
+		enc_imm32(imm, 0);
+	} else {
+		unsigned const fragment_num
+			= get_data_fragment(DATA_CALL_STUB, imm->entity);
+		be_emit_reloc_fragment(4, AMD64_RELOCATION_REL32, fragment_num, -4);
+	}
+}
+
+static void enc_jmp(ir_node const *const cfop)
+{
+	be_emit8(0xE9);
+	enc_jmp_destination(cfop);
+}
+
+static bool fallthrough_possible(ir_node const *const block,
+                                 ir_node const *const target)
+{
+	return be_emit_get_prev_block(target) == block;
+}
+
+static void enc_jump(ir_node const *const node)
+{
+	ir_node const *const block  = get_nodes_block(node);
+	ir_node const *const target = be_emit_get_cfop_target(node);
+	if (fallthrough_possible(block, target))
+		return;
+
+	enc_jmp(node);
+}
+
+static void enc_jcc_cc(x86_condition_code_t const cc,
+                       ir_node const *const cfop)
+{
+	be_emit8(0x0F);
+	be_emit8(0x80 + (cc & 0x0F));
+	enc_jmp_destination(cfop);
+}
+
+static void enc_jcc(ir_node const *const node)
+{
+	ir_node         const *const flags = get_irn_n(node, n_amd64_jcc_eflags);
+	amd64_cc_attr_t const *const attr  = get_amd64_cc_attr_const(node);
+	x86_condition_code_t cc = amd64_determine_final_cc(flags, attr->cc);
+
+	ir_node const *proj_true  = NULL;
+	ir_node const *proj_false = NULL;
+	foreach_out_edge(node, edge) {
+		ir_node *const proj = get_edge_src_irn(edge);
+		if (get_Proj_num(proj) == pn_Cond_true) {
+			proj_true = proj;
+		} else {
+			proj_false = proj;
+		}
+	}
+
+	ir_node const *const block       = get_nodes_block(node);
+	ir_node const *const true_target = be_emit_get_cfop_target(proj_true);
+	if (fallthrough_possible(block, true_target)) {
+		/* exchange both proj's so the second one can be omitted */
+		ir_node const *const t = proj_true;
+		proj_true  = proj_false;
+		proj_false = t;
+		cc         = x86_negate_condition_code(cc);
+	}
+
+	if (cc & x86_cc_float_parity_cases) {
+		/* Some floating point comparisons require a test of the parity flag,
+		 * which indicates that the result is unordered */
+		enc_jcc_cc(x86_cc_parity,
+		           cc & x86_cc_negated ? proj_true : proj_false);
+	}
+
+	enc_jcc_cc(cc, proj_true);
+
+	/* the second Proj might be a fallthrough */
+	ir_node const *const false_target = be_emit_get_cfop_target(proj_false);
+	if (!fallthrough_possible(block, false_target))
+		enc_jmp(proj_false);
+}
+
+static void enc_jmp_switch(ir_node const *const node)
+{
+	enc_rm(0, 0, 0xFF, 4, node, 0); // jmp *%reg
+
+	amd64_switch_jmp_attr_t const *const attr
+		= get_amd64_switch_jmp_attr_const(node);
+	pmap_insert(jump_tables, attr->table_entity, (void*)node);
+}
+
+static void enc_movs_xmm(ir_node const *const node)
+{
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	amd64_enc_xmm_unop(node, size == X86_SIZE_32 ? 0xF3 : 0xF2, 0x0F10);
+}
+
+static void enc_movs_store_xmm(ir_node const *const node)
+{
+	amd64_addr_attr_t const *const attr = get_amd64_addr_attr_const(node);
+	arch_register_t   const *const val  = arch_get_irn_register_in(node, 0);
+	uint8_t const prefix = attr->base.size == X86_SIZE_32 ? 0xF3 : 0xF2;
+	enc_am(prefix, 0, 0x0F11, val->encoding, node, &attr->addr, 0);
+}
+
+static void enc_movdqu_store(ir_node const *const node)
+{
+	amd64_addr_attr_t const *const attr = get_amd64_addr_attr_const(node);
+	arch_register_t   const *const val  = arch_get_irn_register_in(node, 0);
+	enc_am(0xF3, 0, 0x0F7F, val->encoding, node, &attr->addr, 0);
+}
+
+static void enc_movq(ir_node const *const node)
+{
+	amd64_addr_attr_t const *const attr = get_amd64_addr_attr_const(node);
+	if (attr->base.op_mode == AMD64_OP_REG) {
+		arch_register_t const *const in
+			= arch_get_irn_register_in(node, attr->addr.base_input);
+		if (in->cls == &amd64_reg_classes[CLASS_amd64_gp]) {
+			arch_register_t const *const out
+				= arch_get_irn_register_out(node, 0);
+			enc_rr(0x66, REX_W, 0x0F6E, out->encoding, in->encoding);
+			return;
+		}
+	}
+	amd64_enc_xmm_unop(node, 0xF3, 0x0F7E);
+}
+
+static void enc_movd_xmm_gp(ir_node const *const node)
+{
+	x86_insn_size_t        const size = get_amd64_attr_const(node)->size;
+	arch_register_t const *const in   = arch_get_irn_register_in(node, 0);
+	arch_register_t const *const out  = arch_get_irn_register_out(node, 0);
+	enc_rr(0x66, size_rex(size), 0x0F7E, in->encoding, out->encoding);
+}
+
+static void enc_movd_gp_xmm(ir_node const *const node)
+{
+	x86_insn_size_t        const size = get_amd64_attr_const(node)->size;
+	arch_register_t const *const in   = arch_get_irn_register_in(node, 0);
+	arch_register_t const *const out  = arch_get_irn_register_out(node, 0);
+	enc_rr(0x66, size_rex(size), 0x0F6E, out->encoding, in->encoding);
+}
+
+static void enc_pshufd(ir_node const *const node)
+{
+	amd64_shift_attr_t const *const attr = get_amd64_shift_attr_const(node);
+	arch_register_t    const *const in   = arch_get_irn_register_in(node, 0);
+	arch_register_t    const *const out  = arch_get_irn_register_out(node, 0);
+	enc_rr(0x66, 0, 0x0F70, out->encoding, in->encoding);
+	be_emit8(attr->immediate);
+}
+
+static void enc_xorp_0(ir_node const *const node)
+{
+	x86_insn_size_t        const size = get_amd64_attr_const(node)->size;
+	arch_register_t const *const out  = arch_get_irn_register_out(node, 0);
+	uint8_t const prefix = size == X86_SIZE_32 ? 0 : 0x66;
+	enc_rr(prefix, 0, 0x0F57, out->encoding, out->encoding);
+}
+
+static void enc_pcmpeqd_1(ir_node const *const node)
+{
+	arch_register_t const *const out = arch_get_irn_register_out(node, 0);
+	enc_rr(0x66, 0, 0x0F76, out->encoding, out->encoding);
+}
+
+static void enc_fld(ir_node const *const node)
+{
+	switch (get_amd64_attr_const(node)->size) {
+	case X86_SIZE_32: enc_rm(0, 0, 0xD9, 0, node, 0); return; // flds
+	case X86_SIZE_64: enc_rm(0, 0, 0xDD, 0, node, 0); return; // fldl
+	case X86_SIZE_80: enc_rm(0, 0, 0xDB, 5, node, 0); return; // fldt
+	case X86_SIZE_8:
+	case X86_SIZE_16:
+	case X86_SIZE_128:
+		break;
+	}
+	panic("unexpected mode size");
+}
+
+static void enc_fild(ir_node const *const node)
+{
+	switch (get_amd64_attr_const(node)->size) {
+	case X86_SIZE_16: enc_rm(0, 0, 0xDF, 0, node, 0); return; // filds
+	case X86_SIZE_32: enc_rm(0, 0, 0xDB, 0, node, 0); return; // fildl
+	case X86_SIZE_64: enc_rm(0, 0, 0xDF, 5, node, 0); return; // fildll
+	case X86_SIZE_8:
+	case X86_SIZE_80:
+	case X86_SIZE_128:
+		break;
+	}
+	panic("unexpected mode size");
+}
+
+static void enc_fisttp(ir_node const *const node)
+{
+	switch (get_amd64_attr_const(node)->size) {
+	case X86_SIZE_16: enc_rm(0, 0, 0xDF, 1, node, 0); return; // fisttps
+	case X86_SIZE_32: enc_rm(0, 0, 0xDB, 1, node, 0); return; // fisttpl
+	case X86_SIZE_64: enc_rm(0, 0, 0xDD, 1, node, 0); return; // fisttpll
+	case X86_SIZE_8:
+	case X86_SIZE_80:
+	case X86_SIZE_128:
+		break;
+	}
+	panic("unexpected mode size");
+}
+
+static void enc_fst_pop(ir_node const *const node, bool const pop)
+{
+	x86_insn_size_t const size = get_amd64_attr_const(node)->size;
+	switch (size) {
+	case X86_SIZE_32: enc_rm(0, 0, 0xD9, 2 + pop, node, 0); return; // fst[p]s
+	case X86_SIZE_64: enc_rm(0, 0, 0xDD, 2 + pop, node, 0); return; // fst[p]l
+	case X86_SIZE_80:
+		/* There is only a pop variant for long double store. */
+		assert(pop);
+		enc_rm(0, 0, 0xDB, 7, node, 0); // fstpt
+		return;
+	case X86_SIZE_8:
+	case X86_SIZE_16:
+	case X86_SIZE_128:
+		break;
+	}
+	panic("unexpected mode size");
+}
+
+static void enc_fst(ir_node const *const node)
+{
+	enc_fst_pop(node, amd64_get_x87_attr_const(node)->pop);
+}
+
+static void enc_fstp(ir_node const *const node)
+{
+	enc_fst_pop(node, true);
+}
+
+static void enc_fucomi(ir_node const *const node)
+{
+	x87_attr_t const *const attr = amd64_get_x87_attr_const(node);
+	be_emit8(attr->pop ? 0xDF : 0xDB); // fucom[p]i
+	be_emit8(0xE8 + attr->reg->encoding);
+}
+
+static void amd64_register_binary_emitters(void)
+{
+	be_init_emitters();
+
+	amd64_register_spec_binary_emitters();
+
+	be_set_emitter(op_amd64_call,           enc_call);
+	be_set_emitter(op_amd64_cmpxchg,        enc_cmpxchg);
+	be_set_emitter(op_amd64_fild,           enc_fild);
+	be_set_emitter(op_amd64_fisttp,         enc_fisttp);
+	be_set_emitter(op_amd64_fld,            enc_fld);
+	be_set_emitter(op_amd64_fst,            enc_fst);
+	be_set_emitter(op_amd64_fstp,           enc_fstp);
+	be_set_emitter(op_amd64_fucomi,         enc_fucomi);
+	be_set_emitter(op_amd64_ijmp,           enc_ijmp);
+	be_set_emitter(op_amd64_imul,           enc_imul);
+	be_set_emitter(op_amd64_jcc,            enc_jcc);
+	be_set_emitter(op_amd64_jmp,            enc_jump);
+	be_set_emitter(op_amd64_jmp_switch,     enc_jmp_switch);
+	be_set_emitter(op_amd64_lea,            enc_lea);
+	be_set_emitter(op_amd64_mov_gp,         enc_mov_gp);
+	be_set_emitter(op_amd64_mov_imm,        enc_mov_imm);
+	be_set_emitter(op_amd64_mov_store,      enc_mov_store);
+	be_set_emitter(op_amd64_movd_gp_xmm,    enc_movd_gp_xmm);
+	be_set_emitter(op_amd64_movd_xmm_gp,    enc_movd_xmm_gp);
+	be_set_emitter(op_amd64_movdqu_store,   enc_movdqu_store);
+	be_set_emitter(op_amd64_movq,           enc_movq);
+	be_set_emitter(op_amd64_movs,           enc_movs);
+	be_set_emitter(op_amd64_movs_store_xmm, enc_movs_store_xmm);
+	be_set_emitter(op_amd64_movs_xmm,       enc_movs_xmm);
+	be_set_emitter(op_amd64_pcmpeqd_1,      enc_pcmpeqd_1);
+	be_set_emitter(op_amd64_pop_am,         enc_pop_am);
+	be_set_emitter(op_amd64_pshufd,         enc_pshufd);
+	be_set_emitter(op_amd64_push_am,        enc_push_am);
+	be_set_emitter(op_amd64_push_reg,       enc_push_reg);
+	be_set_emitter(op_amd64_setcc,          enc_setcc);
+	be_set_emitter(op_amd64_sub_sp,         enc_sub_sp);
+	be_set_emitter(op_amd64_xor_0,          enc_xor_0);
+	be_set_emitter(op_amd64_xorp_0,         enc_xorp_0);
+	be_set_emitter(op_be_Asm,               enc_asm);
+	be_set_emitter(op_be_Copy,              enc_copy);
+	be_set_emitter(op_be_CopyKeep,          enc_copy);
+	be_set_emitter(op_be_IncSP,             enc_incsp);
+	be_set_emitter(op_be_Perm,              enc_perm);
+}
+
+/** Serializes the initializer of a constant entity. */
+static void enc_initializer(ir_entity const *const entity)
+{
+	ir_type            const *const type = get_entity_type(entity);
+	unsigned                  const size = get_type_size(type);
+	ir_initializer_t   const *const init = get_entity_initializer(entity);
+	unsigned                        done = 0;
+	if (init != NULL) {
+		ir_tarval *tv;
+		switch (get_initializer_kind(init)) {
+		case IR_INITIALIZER_NULL:
+			goto pad;
+		case IR_INITIALIZER_TARVAL:
+			tv = get_initializer_tarval_value(init);
+			goto tarval;
+		case IR_INITIALIZER_CONST: {
+			ir_node *const value = get_initializer_const_value(init);
+			if (!is_Const(value))
+				break;
+			tv = get_Const_tarval(value);
+			goto tarval;
+		}
+		case IR_INITIALIZER_COMPOUND:
+			break;
+		}
+		panic("unsupported initializer for %+F", entity);
+tarval:
+		for (unsigned const n = get_mode_size_bytes(get_tarval_mode(tv));
+		     done < n; ++done) {
+			be_emit8(get_tarval_sub_bits(tv, done));
+		}
+	}
+pad:
+	for (; done < size; ++done)
+		be_emit8(0);
+}
+
+static void enc_jump_table(ir_node const *const node)
+{
+	amd64_switch_jmp_attr_t const *const attr
+		= get_amd64_switch_jmp_attr_const(node);
+	unsigned long         length;
+	ir_node const **const targets
+		= be_get_jump_table_targets(node, attr->table, &length);
+	for (unsigned long i = 0; i < length; ++i) {
+		ir_node const *const block        = be_emit_get_cfop_target(targets[i]);
+		unsigned       const fragment_num = get_block_fragment_num(block);
+		if (be_options.pic_style != BE_PIC_NONE) {
+			/* entries are relative to the start of the table */
+			be_emit_reloc_fragment(4, AMD64_RELOCATION_REL32, fragment_num,
+			                       4 * i);
+		} else {
+			be_emit_reloc_fragment(8, AMD64_RELOCATION_ABS64, fragment_num, 0);
+		}
+	}
+	free(targets);
+}
+
+static void gen_data_fragment(data_fragment_t const fragment)
+{
+	ir_entity *const entity = fragment.entity;
+	switch (fragment.kind) {
+	case DATA_CONSTANT: {
+		ir_node const *const jump_table
+			= pmap_get(ir_node const, jump_tables, entity);
+		if (jump_table != NULL) {
+			if (be_options.pic_style != BE_PIC_NONE) {
+				be_begin_fragment(2, 3);
+			} else {
+				be_begin_fragment(3, 7);
+			}
+			enc_jump_table(jump_table);
+		} else {
+			unsigned const align = get_type_alignment(get_entity_type(entity));
+			be_begin_fragment(log2_floor(align), align - 1);
+			enc_initializer(entity);
+		}
+		break;
+	}
+	case DATA_GOT_SLOT:
+		be_begin_fragment(3, 7);
+		be_emit_reloc_entity(8, AMD64_RELOCATION_ABS64, entity, 0);
+		break;
+	case DATA_CALL_STUB:
+		/* jmp *0(%rip) followed by the address */
+		be_begin_fragment(0, 0);
+		be_emit8(0xFF);
+		be_emit8(0x25);
+		be_emit32(0);
+		be_emit_reloc_entity(8, AMD64_RELOCATION_ABS64, entity, 0);
+		break;
+	}
+	be_finish_fragment();
+}
+
+static void assign_block_fragment_num(ir_node *const block, unsigned const num)
+{
+	assert(ir_nodehashmap_get(void, &block_fragmentnum, block) == NULL);
+	ir_nodehashmap_insert(&block_fragmentnum, block, INT_TO_PTR(num));
+}
+
+static void gen_binary_block(ir_node *const block)
+{
+	unsigned fragment_num = be_begin_fragment(0, 0);
+	assert(fragment_num == get_block_fragment_num(block));
+	(void)fragment_num;
+
+	/* emit the contents of the block */
+	sched_foreach(block, node) {
+		be_emit_node(node);
+	}
+
+	be_finish_fragment();
+}
+
+static void check_encodable_walker(ir_node *const node, void *const data)
+{
+	bool *const encodable = (bool*)data;
+	if (is_ASM(node)) {
+		be_errorf(node, "inline assembler is not supported in machine code output");
+		*encodable = false;
+	} else if (is_Address(node) && is_tls_entity(get_Address_entity(node))) {
+		be_errorf(node, "thread local storage is not supported in machine code output");
+		*encodable = false;
+	}
+}
+
+bool amd64_check_encodable(ir_graph *const irg)
+{
+	bool encodable = true;
+	irg_walk_graph(irg, check_encodable_walker, NULL, &encodable);
+	return encodable;
+}
+
+ir_jit_function_t *amd64_emit_jit(ir_jit_segment_t *const segment,
+                                  ir_graph *const irg)
+{
+	amd64_register_binary_emitters();
+
+	ir_node **const blk_sched = be_create_block_schedule(irg);
+
+	be_jit_begin_function(segment);
+
+	/* we use links to point to target blocks */
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
+
+	be_emit_init_cf_links(blk_sched);
+
+	ir_nodehashmap_init(&block_fragmentnum);
+	size_t const n = ARR_LEN(blk_sched);
+	for (size_t i = 0; i < n; ++i) {
+		ir_node *block = blk_sched[i];
+		assign_block_fragment_num(block, (unsigned)i);
+	}
+
+	first_data_fragment = n;
+	data_fragments      = NEW_ARR_F(data_fragment_t, 0);
+	for (data_kind_t k = DATA_CONSTANT; k <= DATA_KIND_LAST; ++k)
+		data_fragment_nums[k] = pmap_create();
+	jump_tables = pmap_create();
+
+	for (size_t i = 0; i < n; ++i) {
+		ir_node *block = blk_sched[i];
+		gen_binary_block(block);
+	}
+	/* Data does not reference further data, so the array does not grow. */
+	for (size_t i = 0, n_data = ARR_LEN(data_fragments); i < n_data; ++i) {
+		gen_data_fragment(data_fragments[i]);
+	}
+
+	pmap_destroy(jump_tables);
+	for (data_kind_t k = DATA_CONSTANT; k <= DATA_KIND_LAST; ++k)
+		pmap_destroy(data_fragment_nums[k]);
+	DEL_ARR_F(data_fragments);
+	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
+	ir_nodehashmap_destroy(&block_fragmentnum);
+
+	return be_jit_finish_function();
+}
+
+static void enc_nop_callback(char *buffer, unsigned size)
+{
+	memset(buffer, 0, size);
+	while (size > 0) {
+		switch (size) {
+		case 1: buffer[0] = 0x90; return;
+		case 2:
+			buffer[0] = 0x66;
+			++buffer;
+			--size;
+			continue;
+		case 3:
+		sequence_0f1f:
+			buffer[0] = 0x0F;
+			buffer[1] = 0x1F;
+			return;
+		case 4: buffer[2] = 0x40; goto sequence_0f1f;
+		case 5: buffer[2] = 0x44; goto sequence_0f1f;
+		case 6:
+			buffer[0] = 0x66;
+			++buffer;
+			--size;
+			continue;
+		case 7: buffer[2] = 0x80; goto sequence_0f1f;
+		case 8: buffer[2] = 0x84; goto sequence_0f1f;
+		default:
+			buffer[0] = 0x66;
+			buffer[1] = 0x0F;
+			buffer[2] = 0x1F;
+			buffer[3] = 0x84;
+			buffer += 9;
+			size   -= 9;
+			continue;
+		}
+	}
+}
+
+static unsigned enc_relocation_callback(char *const buffer,
+                                        uint8_t const be_kind,
+                                        ir_entity *const entity,
+                                        int32_t const offset)
+{
+	intptr_t addr;
+	if (entity == NULL) {
+		if (be_kind == AMD64_RELOCATION_REL32) {
+			memcpy(buffer, &offset, 4);
+			return 4;
+		}
+		/* absolute address of another fragment */
+		addr = (intptr_t)buffer + offset;
+	} else {
+		intptr_t const entity_addr = (intptr_t)be_jit_get_entity_addr(entity);
+		if (entity_addr == (intptr_t)-1)
+			panic("Could not resolve address of entity %+F", entity);
+		addr = entity_addr + offset;
+	}
+	if (be_kind == AMD64_RELOCATION_ABS64) {
+		uint64_t const value = (uint64_t)addr;
+		memcpy(buffer, &value, 8);
+		return 8;
+	}
+
+	if (be_kind == X86_IMM_PCREL || be_kind == X86_IMM_PLT)
+		addr -= (intptr_t)buffer;
+	int32_t const value = (int32_t)addr;
+	if (value != addr) {
+		if (entity == NULL)
+			panic("Overflow in relocation to code at %p", (void*)buffer);
+		panic("Overflow in relocation to %+F", entity);
+	}
+	memcpy(buffer, &value, 4);
+	return 4;
+}
+
+void amd64_emit_jit_function(char *const buffer,
+                             ir_jit_function_t *const function)
+{
+	static const be_jit_emit_interface_t jit_emit_interface = {
+		.nops       = enc_nop_callback,
+		.relocation = enc_relocation_callback,
+	};
+	be_jit_emit_memory(buffer, function, &jit_emit_interface);
+}
+
+/**
+ * Leaves references to entities and absolute addresses of code to the
+ * linker.
+ */
+static unsigned enc_object_relocation_callback(char *const buffer,
+                                               uint8_t const be_kind,
+                                               ir_entity *const entity,
+                                               int32_t const offset)
+{
+	unsigned size = 4;
+	uint32_t type;
+	switch (be_kind) {
+	case AMD64_RELOCATION_REL32:
+		assert(entity == NULL);
+		memcpy(buffer, &offset, 4);
+		return 4;
+	case AMD64_RELOCATION_ABS64:
+		type = R_X86_64_64;
+		size = 8;
+		break;
+	case X86_IMM_ADDR:     type = R_X86_64_32S;      break;
+	case X86_IMM_PCREL:    type = R_X86_64_PC32;     break;
+	case X86_IMM_PLT:      type = R_X86_64_PLT32;    break;
+	case X86_IMM_GOTPCREL: type = R_X86_64_GOTPCREL; break;
+	default:
+		panic("unexpected relocation kind %u", (unsigned)be_kind);
+	}
+
+	memset(buffer, 0, size);
+	if (entity == NULL) {
+		be_elf_add_local_relocation(buffer, type, offset);
+	} else {
+		be_elf_add_relocation(buffer, type, entity, offset);
+	}
+	return size;
+}
+
+void amd64_emit_object_function(ir_graph *const irg)
+{
+	static const be_jit_emit_interface_t object_emit_interface = {
+		.nops       = enc_nop_callback,
+		.relocation = enc_object_relocation_callback,
+	};
+	ir_jit_segment_t *const segment = be_new_jit_segment();
+	encoding_object = true;
+	ir_jit_function_t *const function = amd64_emit_jit(segment, irg);
+	encoding_object = false;
+	be_elf_emit_function(get_irg_entity(irg), 4, function,
+	                     &object_emit_interface);
+	be_destroy_jit_segment(segment);
+}
@@ -0,0 +1,76 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       amd64 binary encoding/emission
+ */
+#ifndef FIRM_BE_AMD64_AMD64_ENCODE_H
+#define FIRM_BE_AMD64_AMD64_ENCODE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "be_types.h"
+#include "firm_types.h"
+#include "jit.h"
+
+enum {
+	/** 32bit offset relative to the end of the field to another fragment */
+	AMD64_RELOCATION_REL32 = 128,
+	/** 64bit absolute address of an entity */
+	AMD64_RELOCATION_ABS64,
+};
+
+extern be_elf_target_t const amd64_elf_target;
+
+/**
+ * Reports an error for each construct of @p irg, which the encoder does not
+ * support, i.e. inline assembler and thread local storage.  Must be called
+ * before the code selection.
+ * @return true if @p irg can be encoded
+ */
+bool amd64_check_encodable(ir_graph *irg);
+
+ir_jit_function_t *amd64_emit_jit(ir_jit_segment_t *segment, ir_graph *irg);
+
+void amd64_emit_jit_function(char *buffer, ir_jit_function_t *function);
+
+/**
+ * Encode @p irg and append it to the object file started by be_begin_elf().
+ */
+void amd64_emit_object_function(ir_graph *irg);
+
+void amd64_enc_binop(ir_node const *node, unsigned code);
+
+void amd64_enc_unop(ir_node const *node, uint8_t ext);
+
+void amd64_enc_shiftop(ir_node const *node, uint8_t ext);
+
+void amd64_enc_bitscan(ir_node const *node, uint8_t opcode);
+
+void amd64_enc_xmm_binop(ir_node const *node, uint8_t prefix, uint32_t opcode);
+
+void amd64_enc_sse_scalar(ir_node const *node, uint32_t opcode);
+
+void amd64_enc_sse_packed(ir_node const *node, uint32_t opcode);
+
+void amd64_enc_sse_lanes(ir_node const *node, uint32_t op8, uint32_t op16,
+                         uint32_t op32, uint32_t op64);
+
+void amd64_enc_xmm_unop(ir_node const *node, uint8_t prefix, uint32_t opcode);
+
+void amd64_enc_cvt(ir_node const *node, uint8_t prefix, uint32_t opcode);
+
+void amd64_enc_xmm_shift(ir_node const *node, uint8_t ext);
+
+void amd64_enc_fsimple(uint8_t opcode);
+
+void amd64_enc_fbinop(ir_node const *node, uint8_t op, uint8_t op_rev);
+
+void amd64_enc_fop_reg(ir_node const *node, uint8_t op0, uint8_t op1);
+
+void amd64_enc_simple(uint8_t opcode);
+
+#endif
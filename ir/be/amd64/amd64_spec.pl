@@ -7,22 +7,22 @@ $mode_x87   = "x86_mode_E";
 
 %reg_classes = (
 	gp => [
-		{ name => "rax", dwarf => 0 },
-		{ name => "rcx", dwarf => 2 },
-		{ name => "rdx", dwarf => 1 },
-		{ name => "rsi", dwarf => 4 },
-		{ name => "rdi", dwarf => 5 },
-		{ name => "rbx", dwarf => 3 },
-		{ name => "rbp", dwarf => 6 },
-		{ name => "rsp", dwarf => 7 },
-		{ name => "r8",  dwarf => 8 },
-		{ name => "r9",  dwarf => 9 },
-		{ name => "r10", dwarf => 10 },
-		{ name => "r11", dwarf => 11 },
-		{ name => "r12", dwarf => 12 },
-		{ name => "r13", dwarf => 13 },
-		{ name => "r14", dwarf => 14 },
-		{ name => "r15", dwarf => 15 },
+		{ name => "rax", encoding =>  0, dwarf => 0 },
+		{ name => "rcx", encoding =>  1, dwarf => 2 },
+		{ name => "rdx", encoding =>  2, dwarf => 1 },
+		{ name => "rsi", encoding =>  6, dwarf => 4 },
+		{ name => "rdi", encoding =>  7, dwarf => 5 },
+		{ name => "rbx", encoding =>  3, dwarf => 3 },
+		{ name => "rbp", encoding =>  5, dwarf => 6 },
+		{ name => "rsp", encoding =>  4, dwarf => 7 },
+		{ name => "r8",  encoding =>  8, dwarf => 8 },
+		{ name => "r9",  encoding =>  9, dwarf => 9 },
+		{ name => "r10", encoding => 10, dwarf => 10 },
+		{ name => "r11", encoding => 11, dwarf => 11 },
+		{ name => "r12", encoding => 12, dwarf => 12 },
+		{ name => "r13", encoding => 13, dwarf => 13 },
+		{ name => "r14", encoding => 14, dwarf => 14 },
+		{ name => "r15", encoding => 15, dwarf => 15 },
 		{ mode => $mode_gp }
 	],
 	flags => [
@@ -30,22 +30,22 @@ $mode_x87   = "x86_mode_E";
 		{ mode => $mode_flags, flags => "manual_ra" }
 	],
 	xmm => [
-		{ name => "xmm0",  dwarf => 17 },
-		{ name => "xmm1",  dwarf => 18 },
-		{ name => "xmm2",  dwarf => 19 },
-		{ name => "xmm3",  dwarf => 20 },
-		{ name => "xmm4",  dwarf => 21 },
-		{ name => "xmm5",  dwarf => 22 },
-		{ name => "xmm6",  dwarf => 23 },
-		{ name => "xmm7",  dwarf => 24 },
-		{ name => "xmm8",  dwarf => 25 },
-		{ name => "xmm9",  dwarf => 26 },
-		{ name => "xmm10", dwarf => 27 },
-		{ name => "xmm11", dwarf => 28 },
-		{ name => "xmm12", dwarf => 29 },
-		{ name => "xmm13", dwarf => 30 },
-		{ name => "xmm14", dwarf => 31 },
-		{ name => "xmm15", dwarf => 32 },
+		{ name => "xmm0",  encoding =>  0, dwarf => 17 },
+		{ name => "xmm1",  encoding =>  1, dwarf => 18 },
+		{ name => "xmm2",  encoding =>  2, dwarf => 19 },
+		{ name => "xmm3",  encoding =>  3, dwarf => 20 },
+		{ name => "xmm4",  encoding =>  4, dwarf => 21 },
+		{ name => "xmm5",  encoding =>  5, dwarf => 22 },
+		{ name => "xmm6",  encoding =>  6, dwarf => 23 },
+		{ name => "xmm7",  encoding =>  7, dwarf => 24 },
+		{ name => "xmm8",  encoding =>  8, dwarf => 25 },
+		{ name => "xmm9",  encoding =>  9, dwarf => 26 },
+		{ name => "xmm10", encoding => 10, dwarf => 27 },
+		{ name => "xmm11", encoding => 11, dwarf => 28 },
+		{ name => "xmm12", encoding => 12, dwarf => 29 },
+		{ name => "xmm13", encoding => 13, dwarf => 30 },
+		{ name => "xmm14", encoding => 14, dwarf => 31 },
+		{ name => "xmm15", encoding => 15, dwarf => 32 },
 		{ mode => $mode_xmm }
 	],
 	x87 => [
@@ -225,6 +225,16 @@ my $movopx = {
 	attr      => "amd64_op_mode_t op_mode, x86_addr_t addr",
 };
 
+my $xmmimmop = {
+	irn_flags => [ "rematerializable" ],
+	in_reqs   => [ "xmm" ],
+	out_reqs  => [ "xmm" ],
+	ins       => [ "val" ],
+	outs      => [ "res" ],
+	attr_type => "amd64_shift_attr_t",
+	attr      => "const amd64_shift_attr_t *attr_init",
+};
+
 my $x87const = {
 	op_flags  => [ "constlike" ],
 	irn_flags => [ "rematerializable" ],
@@ -324,26 +334,31 @@ leave => {
 	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_NONE;\n"
 	            ."x86_insn_size_t size    = X86_SIZE_64;\n",
 	emit      => "leave",
+	encode    => "amd64_enc_simple(0xC9)",
 },
 
 add => {
 	template => $binop_commutative,
 	emit     => "add%M %AM",
+	encode   => "amd64_enc_binop(node, 0)",
 },
 
 and => {
 	template => $binop_commutative,
 	emit     => "and%M %AM",
+	encode   => "amd64_enc_binop(node, 4)",
 },
 
 div => {
 	template => $divop,
 	emit     => "div%M %AM",
+	encode   => "amd64_enc_unop(node, 6)",
 },
 
 idiv => {
 	template => $divop,
 	emit     => "idiv%M %AM",
+	encode   => "amd64_enc_unop(node, 7)",
 },
 
 imul => {
@@ -354,57 +369,68 @@ imul => {
 imul_1op => {
 	template => $mulop,
 	emit     => "imul%M %AM",
+	encode   => "amd64_enc_unop(node, 5)",
 },
 
 mul => {
 	template => $mulop,
 	emit     => "mul%M %AM",
+	encode   => "amd64_enc_unop(node, 4)",
 },
 
 or => {
 	template => $binop_commutative,
 	emit     => "or%M %AM",
+	encode   => "amd64_enc_binop(node, 1)",
 },
 
 shl => {
 	template => $shiftop,
 	emit     => "shl%M %SO",
+	encode   => "amd64_enc_shiftop(node, 4)",
 },
 
 shr => {
 	template => $shiftop,
 	emit     => "shr%M %SO",
+	encode   => "amd64_enc_shiftop(node, 5)",
 },
 
 sar => {
 	template => $shiftop,
 	emit     => "sar%M %SO",
+	encode   => "amd64_enc_shiftop(node, 7)",
 },
 
 sub => {
 	template  => $binop,
 	irn_flags => [ "modify_flags", "rematerializable" ],
 	emit      => "sub%M %AM",
+	encode    => "amd64_enc_binop(node, 5)",
 },
 
 sbb => {
 	template => $binop,
 	emit     => "sbb%M %AM",
+	encode   => "amd64_enc_binop(node, 3)",
 },
 
 neg => {
 	template => $unop,
 	emit     => "neg%M %AM",
+	encode   => "amd64_enc_unop(node, 3)",
 },
 
 not => {
 	template => $unop,
 	emit     => "not%M %AM",
+	encode   => "amd64_enc_unop(node, 2)",
 },
 
 xor => {
 	template => $binop_commutative,
 	emit     => "xor%M %AM",
+	encode   => "amd64_enc_binop(node, 6)",
 },
 
 xor_0 => {
@@ -474,6 +500,7 @@ cmp => {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "cmp%M %AM",
+	encode    => "amd64_enc_binop(node, 7)",
 },
 
 cmpxchg => {
@@ -563,16 +590,19 @@ ret => {
 	fixed    => "amd64_op_mode_t op_mode = AMD64_OP_NONE;\n"
 	           ."x86_insn_size_t size    = X86_SIZE_64;\n",
 	emit     => "ret",
+	encode   => "amd64_enc_simple(0xC3)",
 },
 
 bsf => {
 	template => $unop_out,
 	emit => "bsf%M %AM, %D0",
+	encode => "amd64_enc_bitscan(node, 0xBC)",
 },
 
 bsr => {
 	template => $unop_out,
 	emit => "bsr%M %AM, %D0",
+	encode => "amd64_enc_bitscan(node, 0xBD)",
 },
 
 # SSE
@@ -580,11 +610,13 @@ bsr => {
 adds => {
 	template => $binopx_commutative,
 	emit     => "adds%MX %AM",
+	encode   => "amd64_enc_sse_scalar(node, 0x0F58)",
 },
 
 divs => {
 	template => $binopx,
 	emit     => "divs%MX %AM",
+	encode   => "amd64_enc_sse_scalar(node, 0x0F5E)",
 },
 
 movs_xmm => {
@@ -596,6 +628,7 @@ movs_xmm => {
 muls => {
 	template => $binopx_commutative,
 	emit     => "muls%MX %AM",
+	encode   => "amd64_enc_sse_scalar(node, 0x0F59)",
 },
 
 movs_store_xmm => {
@@ -612,6 +645,7 @@ movs_store_xmm => {
 subs => {
 	template => $binopx,
 	emit     => "subs%MX %AM",
+	encode   => "amd64_enc_sse_scalar(node, 0x0F5C)",
 },
 
 ucomis => {
@@ -623,6 +657,7 @@ ucomis => {
 	attr_type => "amd64_binop_addr_attr_t",
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 	emit      => "ucomis%MX %AM",
+	encode    => "amd64_enc_sse_packed(node, 0x0F2E)",
 },
 
 xorp_0 => {
@@ -638,6 +673,7 @@ xorp_0 => {
 xorp => {
 	template => $binopx_commutative,
 	emit     => "xorp%MX %AM",
+	encode   => "amd64_enc_sse_packed(node, 0x0F57)",
 },
 
 movd_xmm_gp => {
@@ -667,6 +703,7 @@ movd_gp_xmm => {
 cvtss2sd => {
 	template => $cvtop2x,
 	emit     => "cvtss2sd %AM, %^D0",
+	encode   => "amd64_enc_xmm_unop(node, 0xF3, 0x0F5A)",
 },
 
 cvtsd2ss => {
@@ -674,26 +711,31 @@ cvtsd2ss => {
 	attr     => "amd64_op_mode_t op_mode, x86_addr_t addr",
 	fixed    => "x86_insn_size_t size = X86_SIZE_64;\n",
 	emit     => "cvtsd2ss %AM, %^D0",
+	encode   => "amd64_enc_xmm_unop(node, 0xF2, 0x0F5A)",
 },
 
 cvttsd2si => {
 	template => $cvtopx2i,
 	emit     => "cvttsd2si %AM, %D0",
+	encode   => "amd64_enc_cvt(node, 0xF2, 0x0F2C)",
 },
 
 cvttss2si => {
 	template => $cvtopx2i,
 	emit     => "cvttss2si %AM, %D0",
+	encode   => "amd64_enc_cvt(node, 0xF3, 0x0F2C)",
 },
 
 cvtsi2ss => {
 	template => $cvtop2x,
 	emit     => "cvtsi2ss %AM, %^D0",
+	encode   => "amd64_enc_cvt(node, 0xF3, 0x0F2A)",
 },
 
 cvtsi2sd => {
 	template => $cvtop2x,
 	emit     => "cvtsi2sd %AM, %^D0",
+	encode   => "amd64_enc_cvt(node, 0xF2, 0x0F2A)",
 },
 
 movq => {
@@ -706,12 +748,14 @@ movdqa => {
 	template => $movopx,
 	fixed    => "x86_insn_size_t size = X86_SIZE_128;\n",
 	emit     => "movdqa %AM, %D0",
+	encode   => "amd64_enc_xmm_unop(node, 0x66, 0x0F6F)",
 },
 
 movdqu => {
 	template => $movopx,
 	fixed    => "x86_insn_size_t size = X86_SIZE_128;\n",
 	emit     => "movdqu %AM, %D0",
+	encode   => "amd64_enc_xmm_unop(node, 0xF3, 0x0F6F)",
 },
 
 movdqu_store => {
@@ -752,26 +796,220 @@ l_haddpd => {
 punpckldq => {
 	template => $binopx,
 	emit     => "punpckldq %AM",
+	encode   => "amd64_enc_xmm_binop(node, 0x66, 0x0F62)",
 },
 
 subpd => {
 	template => $binopx,
 	emit     => "subpd %AM",
+	encode   => "amd64_enc_xmm_binop(node, 0x66, 0x0F5C)",
 },
 
 haddpd => {
 	template => $binopx,
 	emit     => "haddpd %AM",
+	encode   => "amd64_enc_xmm_binop(node, 0x66, 0x0F7C)",
+},
+
+# Packed SSE2 operations on vector modes. The size attribute is the size of
+# a lane. Memory operands of legacy SSE encodings must be aligned, so these
+# only work on registers.
+
+addp => {
+	template => $binopx_commutative,
+	emit     => "addp%MX %AM",
+	encode   => "amd64_enc_sse_packed(node, 0x0F58)",
+},
+
+subp => {
+	template => $binopx,
+	emit     => "subp%MX %AM",
+	encode   => "amd64_enc_sse_packed(node, 0x0F5C)",
+},
+
+mulp => {
+	template => $binopx_commutative,
+	emit     => "mulp%MX %AM",
+	encode   => "amd64_enc_sse_packed(node, 0x0F59)",
+},
+
+minp => {
+	template => $binopx,
+	emit     => "minp%MX %AM",
+	encode   => "amd64_enc_sse_packed(node, 0x0F5D)",
+},
+
+maxp => {
+	template => $binopx,
+	emit     => "maxp%MX %AM",
+	encode   => "amd64_enc_sse_packed(node, 0x0F5F)",
+},
+
+mins => {
+	template => $binopx,
+	emit     => "mins%MX %AM",
+	encode   => "amd64_enc_sse_scalar(node, 0x0F5D)",
+},
+
+maxs => {
+	template => $binopx,
+	emit     => "maxs%MX %AM",
+	encode   => "amd64_enc_sse_scalar(node, 0x0F5F)",
+},
+
+padd => {
+	template => $binopx_commutative,
+	emit     => "padd%MV %AM",
+	encode   => "amd64_enc_sse_lanes(node, 0x0FFC, 0x0FFD, 0x0FFE, 0x0FD4)",
+},
+
+padds => {
+	template => $binopx_commutative,
+	emit     => "padds%MV %AM",
+	encode   => "amd64_enc_sse_lanes(node, 0x0FEC, 0x0FED, 0, 0)",
+},
+
+paddus => {
+	template => $binopx_commutative,
+	emit     => "paddus%MV %AM",
+	encode   => "amd64_enc_sse_lanes(node, 0x0FDC, 0x0FDD, 0, 0)",
+},
+
+psub => {
+	template => $binopx,
+	emit     => "psub%MV %AM",
+	encode   => "amd64_enc_sse_lanes(node, 0x0FF8, 0x0FF9, 0x0FFA, 0x0FFB)",
+},
+
+psubs => {
+	template => $binopx,
+	emit     => "psubs%MV %AM",
+	encode   => "amd64_enc_sse_lanes(node, 0x0FE8, 0x0FE9, 0, 0)",
+},
+
+psubus => {
+	template => $binopx,
+	emit     => "psubus%MV %AM",
+	encode   => "amd64_enc_sse_lanes(node, 0x0FD8, 0x0FD9, 0, 0)",
+},
+
+pmullw => {
+	template => $binopx_commutative,
+	emit     => "pmullw %AM",
+	encode   => "amd64_enc_xmm_binop(node, 0x66, 0x0FD5)",
+},
+
+pmuludq => {
+	template => $binopx_commutative,
+	emit     => "pmuludq %AM",
+	encode   => "amd64_enc_xmm_binop(node, 0x66, 0x0FF4)",
+},
+
+pmins => {
+	template => $binopx_commutative,
+	emit     => "pmins%MV %AM",
+	encode   => "amd64_enc_sse_lanes(node, 0x0F3838, 0x0FEA, 0x0F3839, 0)",
+},
+
+pmaxs => {
+	template => $binopx_commutative,
+	emit     => "pmaxs%MV %AM",
+	encode   => "amd64_enc_sse_lanes(node, 0x0F383C, 0x0FEE, 0x0F383D, 0)",
+},
+
+pminu => {
+	template => $binopx_commutative,
+	emit     => "pminu%MV %AM",
+	encode   => "amd64_enc_sse_lanes(node, 0x0FDA, 0x0F383A, 0x0F383B, 0)",
+},
+
+pmaxu => {
+	template => $binopx_commutative,
+	emit     => "pmaxu%MV %AM",
+	encode   => "amd64_enc_sse_lanes(node, 0x0FDE, 0x0F383E, 0x0F383F, 0)",
+},
+
+pand => {
+	template => $binopx_commutative,
+	emit     => "pand %AM",
+	encode   => "amd64_enc_xmm_binop(node, 0x66, 0x0FDB)",
+},
+
+por => {
+	template => $binopx_commutative,
+	emit     => "por %AM",
+	encode   => "amd64_enc_xmm_binop(node, 0x66, 0x0FEB)",
+},
+
+pxor => {
+	template => $binopx_commutative,
+	emit     => "pxor %AM",
+	encode   => "amd64_enc_xmm_binop(node, 0x66, 0x0FEF)",
+},
+
+punpcklbw => {
+	template => $binopx,
+	emit     => "punpcklbw %AM",
+	encode   => "amd64_enc_xmm_binop(node, 0x66, 0x0F60)",
+},
+
+punpcklwd => {
+	template => $binopx,
+	emit     => "punpcklwd %AM",
+	encode   => "amd64_enc_xmm_binop(node, 0x66, 0x0F61)",
+},
+
+pshufd => {
+	template => $xmmimmop,
+	emit     => "pshufd %SO, %^D0",
+},
+
+pslldq => {
+	template => $xmmimmop,
+	out_reqs => [ "in_r0" ],
+	emit     => "pslldq %SO",
+	encode   => "amd64_enc_xmm_shift(node, 7)",
+},
+
+psrldq => {
+	template => $xmmimmop,
+	out_reqs => [ "in_r0" ],
+	emit     => "psrldq %SO",
+	encode   => "amd64_enc_xmm_shift(node, 3)",
+},
+
+pcmpeqd_1 => {
+	op_flags  => [ "constlike" ],
+	irn_flags => [ "rematerializable" ],
+	out_reqs  => [ "xmm" ],
+	outs      => [ "res" ],
+	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_NONE;\n"
+	            ."x86_insn_size_t size    = X86_SIZE_128;\n",
+	emit      => "pcmpeqd %^D0, %^D0",
+},
+
+cvtdq2ps => {
+	template => $cvtop2x,
+	emit     => "cvtdq2ps %AM, %^D0",
+	encode   => "amd64_enc_xmm_unop(node, 0, 0x0F5B)",
+},
+
+cvttps2dq => {
+	template => $cvtop2x,
+	emit     => "cvttps2dq %AM, %^D0",
+	encode   => "amd64_enc_xmm_unop(node, 0xF3, 0x0F5B)",
 },
 
 fldz => {
 	template => $x87const,
 	emit     => "fldz",
+	encode   => "amd64_enc_fsimple(0xEE)",
 },
 
 fld1 => {
 	template => $x87const,
 	emit     => "fld1",
+	encode   => "amd64_enc_fsimple(0xE8)",
 },
 
 fld => {
@@ -816,26 +1054,31 @@ fstp => {
 fadd => {
 	template => $x87binop,
 	emit     => "fadd%FP %AF",
+	encode   => "amd64_enc_fbinop(node, 0, 0)",
 },
 
 fdiv => {
 	template => $x87binop,
 	emit     => "fdiv%FR%FP %AF",
+	encode   => "amd64_enc_fbinop(node, 6, 7)",
 },
 
 fmul => {
 	template => $x87binop,
 	emit     => "fmul%FP %AF",
+	encode   => "amd64_enc_fbinop(node, 1, 1)",
 },
 
 fsub => {
 	template => $x87binop,
 	emit     => "fsub%FR%FP %AF",
+	encode   => "amd64_enc_fbinop(node, 4, 5)",
 },
 
 fchs => {
 	template => $x87unop,
 	emit     => "fchs",
+	encode   => "amd64_enc_fsimple(0xE0)",
 },
 
 fucomi => {
@@ -857,6 +1100,7 @@ fdup => {
 	attr        => "const arch_register_t *reg",
 	init        => "attr->x87.reg = reg;",
 	emit        => "fld %F0",
+	encode      => "amd64_enc_fop_reg(node, 0xD9, 0xC0)",
 },
 
 fxch => {
@@ -867,6 +1111,7 @@ fxch => {
 	attr        => "const arch_register_t *reg",
 	init        => "attr->x87.reg = reg;",
 	emit        => "fxch %F0",
+	encode      => "amd64_enc_fop_reg(node, 0xD9, 0xC8)",
 },
 
 fpop => {
@@ -877,6 +1122,7 @@ fpop => {
 	attr        => "const arch_register_t *reg",
 	init        => "attr->x87.reg = reg;",
 	emit        => "fstp %F0",
+	encode      => "amd64_enc_fop_reg(node, 0xDD, 0xD8)",
 },
 
 );
@@ -443,6 +443,8 @@ static ir_node *gen_Const(ir_node *const node)
 			return gen_x87_Const(block, tv);
 		} else if (tarval_is_null(tv)) {
 			return new_bd_amd64_xorp_0(dbgi, block, X86_SIZE_64);
+		} else if (mode_is_vector(mode) && tarval_is_all_one(tv)) {
+			return new_bd_amd64_pcmpeqd_1(dbgi, block);
 		}
 		return create_float_const(dbgi, block, tv);
 	}
@@ -925,6 +927,377 @@ static ir_node *gen_binop_xmm(ir_node *node, ir_node *op0, ir_node *op1,
 	return be_new_Proj(new_node, pn_amd64_subs_res);
 }
 
+typedef ir_node* (*create_mov_func)(dbg_info *dbgi, ir_node *block, int arity,
+	ir_node *const *in, arch_register_req_t const **in_reqs,
+	x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr);
+
+static x86_insn_size_t get_lane_size(ir_mode *const mode)
+{
+	return x86_size_from_mode(get_mode_element_mode(mode));
+}
+
+/** Creates a packed operation on the already transformed vectors @p op0 and
+ * @p op1, the result overwrites @p op0. */
+static ir_node *create_vector_binop(dbg_info *const dbgi, ir_node *const block,
+                                    construct_binop_func const cons,
+                                    x86_insn_size_t const lane_size,
+                                    ir_node *const op0, ir_node *const op1)
+{
+	amd64_binop_addr_attr_t const attr = {
+		.base = {
+			.base = {
+				.op_mode = AMD64_OP_REG_REG,
+				.size    = lane_size,
+			},
+			.addr = {
+				.base_input = 0,
+				.variant    = X86_ADDR_REG,
+			},
+		},
+		.u.reg_input = 1,
+	};
+	ir_node *const in[]     = { op0, op1 };
+	ir_node *const new_node = cons(dbgi, block, ARRAY_SIZE(in), in,
+	                               amd64_xmm_xmm_reqs, &attr);
+	arch_set_irn_register_req_out(new_node, 0, &amd64_requirement_xmm_same_0);
+	return be_new_Proj(new_node, pn_amd64_padd_res);
+}
+
+typedef ir_node *(*construct_xmm_imm_func)(dbg_info *dbgi, ir_node *block,
+		ir_node *val, amd64_shift_attr_t const *attr_init);
+
+static ir_node *create_vector_imm(dbg_info *const dbgi, ir_node *const block,
+                                  construct_xmm_imm_func const cons,
+                                  ir_node *const op, uint8_t const immediate)
+{
+	amd64_shift_attr_t const attr = {
+		.base = {
+			.op_mode = AMD64_OP_SHIFT_IMM,
+			.size    = X86_SIZE_128,
+		},
+		.immediate = immediate,
+	};
+	return cons(dbgi, block, op, &attr);
+}
+
+/** Transforms a vector binop into the packed integer or floating point
+ * instruction. */
+static ir_node *gen_vector_binop(ir_node *const node,
+                                 construct_binop_func const int_cons,
+                                 construct_binop_func const float_cons)
+{
+	dbg_info *const dbgi      = get_irn_dbg_info(node);
+	ir_node  *const new_block = be_transform_nodes_block(node);
+	ir_node  *const op0       = be_transform_node(get_binop_left(node));
+	ir_node  *const op1       = be_transform_node(get_binop_right(node));
+	ir_mode  *const mode      = get_irn_mode(node);
+	construct_binop_func const cons
+		= mode_is_float(get_mode_element_mode(mode)) ? float_cons : int_cons;
+	return create_vector_binop(dbgi, new_block, cons, get_lane_size(mode),
+	                           op0, op1);
+}
+
+/** Multiplies 32bit lanes with pmuludq, which multiplies the even lanes into
+ * 64bit products. */
+static ir_node *create_vector_mul_32(dbg_info *const dbgi,
+                                     ir_node *const block,
+                                     ir_node *const op0, ir_node *const op1)
+{
+	ir_node *const even = create_vector_binop(dbgi, block, new_bd_amd64_pmuludq,
+	                                          X86_SIZE_32, op0, op1);
+	ir_node *const odd0 = create_vector_imm(dbgi, block, new_bd_amd64_psrldq,
+	                                        op0, 4);
+	ir_node *const odd1 = create_vector_imm(dbgi, block, new_bd_amd64_psrldq,
+	                                        op1, 4);
+	ir_node *const odd  = create_vector_binop(dbgi, block, new_bd_amd64_pmuludq,
+	                                          X86_SIZE_32, odd0, odd1);
+	/* gather the low halves of the products and interleave them */
+	ir_node *const low_even = create_vector_imm(dbgi, block,
+	                                            new_bd_amd64_pshufd, even, 0x08);
+	ir_node *const low_odd  = create_vector_imm(dbgi, block,
+	                                            new_bd_amd64_pshufd, odd, 0x08);
+	return create_vector_binop(dbgi, block, new_bd_amd64_punpckldq,
+	                           X86_SIZE_32, low_even, low_odd);
+}
+
+static ir_node *gen_vector_Mul(ir_node *const node)
+{
+	ir_mode *const mode      = get_irn_mode(node);
+	ir_mode *const lane_mode = get_mode_element_mode(mode);
+	if (mode_is_float(lane_mode))
+		return gen_vector_binop(node, NULL, new_bd_amd64_mulp);
+
+	switch (get_mode_size_bits(lane_mode)) {
+	case 16:
+		return gen_vector_binop(node, new_bd_amd64_pmullw, NULL);
+	case 32: {
+		dbg_info *const dbgi      = get_irn_dbg_info(node);
+		ir_node  *const new_block = be_transform_nodes_block(node);
+		ir_node  *const op0       = be_transform_node(get_Mul_left(node));
+		ir_node  *const op1       = be_transform_node(get_Mul_right(node));
+		return create_vector_mul_32(dbgi, new_block, op0, op1);
+	}
+	default:
+		panic("%+F should have been lowered", node);
+	}
+}
+
+static ir_node *gen_vector_Minus(ir_node *const node)
+{
+	dbg_info *const dbgi      = get_irn_dbg_info(node);
+	ir_node  *const new_block = be_transform_nodes_block(node);
+	ir_node  *const op        = be_transform_node(get_Minus_op(node));
+	ir_mode  *const mode      = get_irn_mode(node);
+	ir_mode  *const lane_mode = get_mode_element_mode(mode);
+	x86_insn_size_t const size = get_lane_size(mode);
+	if (mode_is_float(lane_mode)) {
+		/* flip the sign bits */
+		ir_tarval *const sign = tarval_broadcast(create_sign_tv(lane_mode),
+		                                         mode);
+		ir_node   *const mask = create_float_const(dbgi, new_block, sign);
+		return create_vector_binop(dbgi, new_block, new_bd_amd64_xorp, size,
+		                           op, mask);
+	}
+	ir_node *const zero = new_bd_amd64_xorp_0(dbgi, new_block, X86_SIZE_64);
+	return create_vector_binop(dbgi, new_block, new_bd_amd64_psub, size, zero,
+	                           op);
+}
+
+static ir_node *gen_vector_Not(ir_node *const node)
+{
+	dbg_info *const dbgi      = get_irn_dbg_info(node);
+	ir_node  *const new_block = be_transform_nodes_block(node);
+	ir_node  *const op        = be_transform_node(get_Not_op(node));
+	ir_node  *const ones      = new_bd_amd64_pcmpeqd_1(dbgi, new_block);
+	return create_vector_binop(dbgi, new_block, new_bd_amd64_pxor,
+	                           X86_SIZE_128, op, ones);
+}
+
+static bool is_cvtdq2ps(ir_mode *const src_lane, ir_mode *const dst_lane)
+{
+	return mode_is_int(src_lane) && mode_is_signed(src_lane)
+	    && get_mode_size_bits(src_lane) == 32 && dst_lane == mode_F;
+}
+
+static bool is_cvttps2dq(ir_mode *const src_lane, ir_mode *const dst_lane)
+{
+	return is_cvtdq2ps(dst_lane, src_lane);
+}
+
+static ir_node *gen_vector_Conv(ir_node *const node)
+{
+	ir_node *const op       = get_Conv_op(node);
+	ir_node *const new_op   = be_transform_node(op);
+	ir_mode *const src_lane = get_mode_element_mode(get_irn_mode(op));
+	ir_mode *const dst_lane = get_mode_element_mode(get_irn_mode(node));
+	if (mode_is_int(src_lane) && mode_is_int(dst_lane)
+	    && get_mode_size_bits(src_lane) == get_mode_size_bits(dst_lane))
+		return new_op;
+
+	create_mov_func cons;
+	if (is_cvtdq2ps(src_lane, dst_lane)) {
+		cons = new_bd_amd64_cvtdq2ps;
+	} else if (is_cvttps2dq(src_lane, dst_lane)) {
+		cons = new_bd_amd64_cvttps2dq;
+	} else {
+		panic("%+F should have been lowered", node);
+	}
+	dbg_info  *const dbgi      = get_irn_dbg_info(node);
+	ir_node   *const new_block = be_transform_nodes_block(node);
+	ir_node   *const in[]      = { new_op };
+	x86_addr_t const addr      = {
+		.base_input = 0,
+		.variant    = X86_ADDR_REG,
+	};
+	ir_node *const conv = cons(dbgi, new_block, ARRAY_SIZE(in), in,
+	                           amd64_xmm_reqs, X86_SIZE_32, AMD64_OP_REG, addr);
+	return be_new_Proj(conv, pn_amd64_cvtdq2ps_res);
+}
+
+/** Moves the scalar @p value into the lowest lane of an xmm register. */
+static ir_node *create_move_to_xmm(dbg_info *const dbgi, ir_node *const block,
+                                   ir_node *const value)
+{
+	ir_node *const new_value = be_transform_node(value);
+	ir_mode *const mode      = get_irn_mode(value);
+	if (mode_is_float(mode))
+		return new_value;
+
+	x86_insn_size_t const size = get_mode_size_bits(mode) > 32 ? X86_SIZE_64
+	                                                           : X86_SIZE_32;
+	x86_addr_t const addr = {
+		.base_input = 0,
+		.variant    = X86_ADDR_REG,
+	};
+	return new_bd_amd64_movd_gp_xmm(dbgi, block, new_value, size, AMD64_OP_REG,
+	                                addr);
+}
+
+static ir_node *gen_Broadcast(ir_node *const node)
+{
+	dbg_info *const dbgi      = get_irn_dbg_info(node);
+	ir_node  *const new_block = be_transform_nodes_block(node);
+	ir_node  *const op        = get_Broadcast_op(node);
+	ir_node        *value     = create_move_to_xmm(dbgi, new_block, op);
+
+	/* widen small lanes to 32bit, then copy them with pshufd */
+	switch (get_mode_size_bytes(get_irn_mode(op))) {
+	case 1:
+		value = create_vector_binop(dbgi, new_block, new_bd_amd64_punpcklbw,
+		                            X86_SIZE_8, value, value);
+		/* FALLTHROUGH */
+	case 2:
+		value = create_vector_binop(dbgi, new_block, new_bd_amd64_punpcklwd,
+		                            X86_SIZE_16, value, value);
+		/* FALLTHROUGH */
+	case 4:
+		return create_vector_imm(dbgi, new_block, new_bd_amd64_pshufd, value,
+		                         0x00);
+	case 8:
+		return create_vector_imm(dbgi, new_block, new_bd_amd64_pshufd, value,
+		                         0x44);
+	default:
+		panic("unexpected lane mode in %+F", node);
+	}
+}
+
+static ir_node *gen_Extract(ir_node *const node)
+{
+	dbg_info *const dbgi       = get_irn_dbg_info(node);
+	ir_node  *const new_block  = be_transform_nodes_block(node);
+	ir_node        *vector     = be_transform_node(get_Extract_vector(node));
+	ir_mode  *const mode       = get_irn_mode(node);
+	unsigned  const lane_bytes = get_mode_size_bytes(mode);
+	unsigned  const lane       = get_Extract_lane(node);
+
+	/* shift the lane down to the lowest position */
+	if (lane != 0) {
+		vector = create_vector_imm(dbgi, new_block, new_bd_amd64_psrldq,
+		                           vector, lane * lane_bytes);
+	}
+	if (mode_is_float(mode))
+		return vector;
+
+	x86_insn_size_t const size = lane_bytes > 4 ? X86_SIZE_64 : X86_SIZE_32;
+	x86_addr_t const addr = {
+		.base_input = 0,
+		.variant    = X86_ADDR_REG,
+	};
+	return new_bd_amd64_movd_xmm_gp(dbgi, new_block, vector, size,
+	                                AMD64_OP_REG, addr);
+}
+
+static ir_node *gen_Insert(ir_node *const node)
+{
+	dbg_info  *const dbgi       = get_irn_dbg_info(node);
+	ir_node   *const new_block  = be_transform_nodes_block(node);
+	ir_node   *const vector     = be_transform_node(get_Insert_vector(node));
+	ir_node   *const value      = get_Insert_value(node);
+	unsigned   const lane_bytes = get_mode_size_bytes(get_irn_mode(value));
+	unsigned   const lane       = get_Insert_lane(node);
+
+	/* move the value to its lane and clear all other bits */
+	ir_node *moved = create_move_to_xmm(dbgi, new_block, value);
+	unsigned const high = 16 - lane_bytes;
+	moved = create_vector_imm(dbgi, new_block, new_bd_amd64_pslldq, moved,
+	                          high);
+	if (high != lane * lane_bytes) {
+		moved = create_vector_imm(dbgi, new_block, new_bd_amd64_psrldq, moved,
+		                          high - lane * lane_bytes);
+	}
+
+	/* clear the lane in the vector and combine both */
+	ir_tarval *const one   = get_mode_one(amd64_mode_xmm);
+	ir_tarval *const ones  = tarval_sub(tarval_shl_unsigned(one, lane_bytes * 8),
+	                                    one);
+	ir_tarval *const lanes = tarval_shl_unsigned(ones, lane * lane_bytes * 8);
+	ir_node   *const mask  = create_float_const(dbgi, new_block,
+	                                            tarval_not(lanes));
+	ir_node   *const other = create_vector_binop(dbgi, new_block,
+	                                             new_bd_amd64_pand,
+	                                             X86_SIZE_128, vector, mask);
+	return create_vector_binop(dbgi, new_block, new_bd_amd64_por,
+	                           X86_SIZE_128, other, moved);
+}
+
+/**
+ * Computes the pshufd immediate for a Shuffle selecting 32 or 64bit lanes
+ * from a single operand. Returns false if pshufd cannot implement the
+ * Shuffle.
+ */
+static bool get_pshufd_immediate(ir_node const *const node,
+                                 uint8_t *const immediate,
+                                 bool *const from_right)
+{
+	ir_mode   *const mode       = get_irn_mode(node);
+	unsigned   const n_lanes    = get_mode_n_lanes(mode);
+	unsigned   const lane_bytes = get_mode_size_bytes(get_mode_element_mode(mode));
+	ir_tarval *const mask       = get_Shuffle_mask(node);
+	if (get_mode_size_bits(mode) != 128 || (lane_bytes != 4 && lane_bytes != 8))
+		return false;
+
+	unsigned const dwords = lane_bytes / 4;
+	unsigned       imm    = 0;
+	for (unsigned i = 0; i < n_lanes; ++i) {
+		unsigned const from  = get_tarval_long(get_tarval_lane(mask, i));
+		bool     const right = from >= n_lanes;
+		if (i == 0) {
+			*from_right = right;
+		} else if (right != *from_right) {
+			return false;
+		}
+		for (unsigned d = 0; d < dwords; ++d) {
+			unsigned const dword = (from % n_lanes) * dwords + d;
+			imm |= dword << (2 * (i * dwords + d));
+		}
+	}
+	*immediate = imm;
+	return true;
+}
+
+static ir_node *gen_Shuffle(ir_node *const node)
+{
+	uint8_t immediate;
+	bool    from_right;
+	if (!get_pshufd_immediate(node, &immediate, &from_right))
+		panic("%+F should have been lowered", node);
+
+	dbg_info *const dbgi      = get_irn_dbg_info(node);
+	ir_node  *const new_block = be_transform_nodes_block(node);
+	ir_node  *const op        = from_right ? get_Shuffle_right(node)
+	                                       : get_Shuffle_left(node);
+	ir_node  *const new_op    = be_transform_node(op);
+	return create_vector_imm(dbgi, new_block, new_bd_amd64_pshufd, new_op,
+	                         immediate);
+}
+
+bool amd64_can_select_vector_op(ir_node const *const node)
+{
+	ir_mode *const mode      = get_irn_mode(node);
+	ir_mode *const lane_mode = get_mode_element_mode(mode);
+	switch (get_irn_opcode(node)) {
+	case iro_Mul: {
+		unsigned const lane_bits = get_mode_size_bits(lane_mode);
+		return mode_is_float(lane_mode) || lane_bits == 16 || lane_bits == 32;
+	}
+	case iro_Conv: {
+		ir_mode *const src_lane
+			= get_mode_element_mode(get_irn_mode(get_Conv_op(node)));
+		if (mode_is_int(src_lane) && mode_is_int(lane_mode))
+			return get_mode_size_bits(src_lane) == get_mode_size_bits(lane_mode);
+		return is_cvtdq2ps(src_lane, lane_mode)
+		    || is_cvttps2dq(src_lane, lane_mode);
+	}
+	case iro_Shuffle: {
+		uint8_t immediate;
+		bool    from_right;
+		return get_pshufd_immediate(node, &immediate, &from_right);
+	}
+	default:
+		return true;
+	}
+}
+
 typedef ir_node *(*construct_x87_binop_func)(
 		dbg_info *dbgi, ir_node *block, ir_node *op0, ir_node *op1);
 
@@ -1041,6 +1414,8 @@ static ir_node *gen_Add(ir_node *const node)
 	ir_mode *const mode  = get_irn_mode(node);
 	ir_node *const block = get_nodes_block(node);
 
+	if (mode_is_vector(mode))
+		return gen_vector_binop(node, new_bd_amd64_padd, new_bd_amd64_addp);
 	if (mode_is_float(mode)) {
 		if (mode == x86_mode_E)
 			return gen_binop_x87(node, op1, op2, new_bd_amd64_fadd);
@@ -1077,6 +1452,8 @@ static ir_node *gen_Sub(ir_node *const node)
 	ir_node *const op2  = get_Sub_right(node);
 	ir_mode *const mode = get_irn_mode(node);
 
+	if (mode_is_vector(mode))
+		return gen_vector_binop(node, new_bd_amd64_psub, new_bd_amd64_subp);
 	if (mode_is_float(mode)) {
 		if (mode == x86_mode_E)
 			return gen_binop_x87(node, op1, op2, new_bd_amd64_fsub);
@@ -1094,6 +1471,8 @@ static ir_node *gen_And(ir_node *const node)
 {
 	ir_node *const op1 = get_And_left(node);
 	ir_node *const op2 = get_And_right(node);
+	if (mode_is_vector(get_irn_mode(node)))
+		return gen_vector_binop(node, new_bd_amd64_pand, new_bd_amd64_pand);
 	return gen_binop_am(node, op1, op2, new_bd_amd64_and, pn_amd64_and_res,
 	                    match_immediate | match_am | match_mode_neutral
 	                    | match_commutative);
@@ -1103,6 +1482,8 @@ static ir_node *gen_Eor(ir_node *const node)
 {
 	ir_node *const op1 = get_Eor_left(node);
 	ir_node *const op2 = get_Eor_right(node);
+	if (mode_is_vector(get_irn_mode(node)))
+		return gen_vector_binop(node, new_bd_amd64_pxor, new_bd_amd64_pxor);
 	return gen_binop_am(node, op1, op2, new_bd_amd64_xor, pn_amd64_xor_res,
 	                    match_immediate | match_am | match_mode_neutral
 	                    | match_commutative);
@@ -1112,6 +1493,8 @@ static ir_node *gen_Or(ir_node *const node)
 {
 	ir_node *const op1 = get_Or_left(node);
 	ir_node *const op2 = get_Or_right(node);
+	if (mode_is_vector(get_irn_mode(node)))
+		return gen_vector_binop(node, new_bd_amd64_por, new_bd_amd64_por);
 	return gen_binop_am(node, op1, op2, new_bd_amd64_or, pn_amd64_or_res,
 	                    match_immediate | match_am | match_mode_neutral
 	                    | match_commutative);
@@ -1123,7 +1506,9 @@ static ir_node *gen_Mul(ir_node *const node)
 	ir_node *const op2  = get_Mul_right(node);
 	ir_mode *const mode = get_irn_mode(node);
 
-	if (get_mode_size_bits(mode) < 16) {
+	if (mode_is_vector(mode)) {
+		return gen_vector_Mul(node);
+	} else if (get_mode_size_bits(mode) < 16) {
 		/* imulb only supports rax - reg form */
 		ir_node *new_node
 			= gen_binop_rax(node, op1, op2, new_bd_amd64_imul_1op,
@@ -1434,7 +1819,9 @@ static ir_node *gen_Minus(ir_node *const node)
 {
 	ir_mode *mode = get_irn_mode(node);
 
-	if (mode_is_float(mode)) {
+	if (mode_is_vector(mode)) {
+		return gen_vector_Minus(node);
+	} else if (mode_is_float(mode)) {
 		if (mode == x86_mode_E) {
 			dbg_info *dbgi   = get_irn_dbg_info(node);
 			ir_node  *block  = be_transform_node(get_nodes_block(node));
@@ -1450,6 +1837,8 @@ static ir_node *gen_Minus(ir_node *const node)
 
 static ir_node *gen_Not(ir_node *const node)
 {
+	if (mode_is_vector(get_irn_mode(node)))
+		return gen_vector_Not(node);
 	return gen_unop(node, n_Not_op, &new_bd_amd64_not, pn_amd64_not_res);
 }
 
@@ -1720,7 +2109,10 @@ static ir_node *make_store_for_mode(ir_mode *const mode, dbg_info *const dbgi, i
 {
 	construct_binop_func               cons;
 	arch_register_req_t const **const *reqs;
-	if (!mode_is_float(mode)) {
+	if (mode_is_vector(mode)) {
+		cons = &new_bd_amd64_movdqu_store;
+		reqs = xmm_am_reqs;
+	} else if (!mode_is_float(mode)) {
 		cons = &new_bd_amd64_mov_store;
 		reqs = gp_am_reqs;
 	} else if (mode == x86_mode_E) {
@@ -2109,7 +2501,7 @@ static ir_node *gen_Phi(ir_node *const node)
 	if (mode_needs_gp_reg(mode)) {
 		/* all integer operations are on 64bit registers now */
 		req = amd64_reg_classes[CLASS_amd64_gp].class_req;
-	} else if (mode_is_float(mode)) {
+	} else if (mode_is_float(mode) || mode_is_vector(mode)) {
 		req = mode == x86_mode_E
 		    ? amd64_reg_classes[CLASS_amd64_x87].class_req
 		    : amd64_reg_classes[CLASS_amd64_xmm].class_req;
@@ -2120,10 +2512,6 @@ static ir_node *gen_Phi(ir_node *const node)
 	return be_transform_phi(node, req);
 }
 
-typedef ir_node* (*create_mov_func)(dbg_info *dbgi, ir_node *block, int arity,
-	ir_node *const *in, arch_register_req_t const **in_reqs,
-	x86_insn_size_t size, amd64_op_mode_t op_mode, x86_addr_t addr);
-
 static ir_node *match_mov(dbg_info *dbgi, ir_node *block, ir_node *value,
                           x86_insn_size_t size, create_mov_func create_mov,
                           unsigned pn_res)
@@ -2370,7 +2758,9 @@ static ir_node *gen_Conv(ir_node *const node)
 
 	/* ad-hoc assumption until libfirm has vector modes:
 	 * we assume 128bit modes are two packed doubles. */
-	if (dst_bits == 128) {
+	if (mode_is_vector(dst_mode)) {
+		return gen_vector_Conv(node);
+	} else if (dst_bits == 128) {
 		/* int -> 2xdouble */
 		assert(get_mode_arithmetic(src_mode) == irma_twos_complement);
 		assert(dst_mode == amd64_mode_xmm);
@@ -2624,13 +3014,13 @@ ir_node *amd64_new_spill(ir_node *const value, ir_node *const after)
 	return store;
 }
 
-static ir_node *create_sse_spill(dbg_info *const dbgi, ir_node *const block,
+static ir_node *create_movdqu(dbg_info *const dbgi, ir_node *const block,
 		int const arity, ir_node *const *const in,
 		arch_register_req_t const **const in_reqs,
 		x86_insn_size_t const size, amd64_op_mode_t const op_mode,
 		x86_addr_t const addr)
 {
-	(void)size; /* TODO */
+	(void)size; /* always moves 128 bits */
 	return new_bd_amd64_movdqu(dbgi, block, arity, in, in_reqs, op_mode, addr);
 }
 
@@ -2659,7 +3049,7 @@ ir_node *amd64_new_reload(ir_node *value, ir_node *spill, ir_node *before)
 			pn_res = pn_amd64_fld_res;
 		} else {
 			size   = X86_SIZE_128;
-			cons   = &create_sse_spill;
+			cons   = &create_movdqu;
 			pn_res = pn_amd64_movdqu_res;
 		}
 	} else {
@@ -2699,6 +3089,7 @@ static ir_node *gen_Load(ir_node *const node)
 	assert((size_t)arity <= ARRAY_SIZE(in));
 
 	create_mov_func   const cons      =
+		mode_is_vector(mode)                                  ? &create_movdqu         :
 		mode_is_float(mode)                                   ?
 			(mode == x86_mode_E ? new_bd_amd64_fld : &new_bd_amd64_movs_xmm) :
 		get_mode_size_bits(mode) < 64 && mode_is_signed(mode) ? &new_bd_amd64_movs     :
@@ -2715,7 +3106,8 @@ static ir_node *gen_Unknown(ir_node *const node)
 	/* for now, there should be more efficient ways to do this */
 	ir_node *const block = be_transform_nodes_block(node);
 
-	if (mode_is_float(get_irn_mode(node))) {
+	ir_mode *const mode = get_irn_mode(node);
+	if (mode_is_float(mode) || mode_is_vector(mode)) {
 		return new_bd_amd64_xorp_0(NULL, block, X86_SIZE_64);
 	} else {
 		ir_node *res = new_bd_amd64_xor_0(NULL, block, X86_SIZE_32);
@@ -2746,6 +3138,13 @@ static ir_node *gen_Proj_Load(ir_node *const node)
 
 	/* renumber the proj */
 	switch (get_amd64_irn_opcode(new_load)) {
+	case iro_amd64_movdqu:
+		if (pn == pn_Load_res) {
+			return be_new_Proj(new_load, pn_amd64_movdqu_res);
+		} else if (pn == pn_Load_M) {
+			return be_new_Proj(new_load, pn_amd64_movdqu_M);
+		}
+		break;
 	case iro_amd64_movs_xmm:
 		if (pn == pn_Load_res) {
 			return be_new_Proj(new_load, pn_amd64_movs_xmm_res);
@@ -3085,6 +3484,74 @@ static ir_node *gen_va_start(ir_node *const node)
 	return amd64_initialize_va_list(dbgi, block, current_cconv, mem, ap, fp);
 }
 
+/**
+ * Returns the instruction for a lane-wise builtin or NULL if there is none
+ * for the lane mode.
+ */
+static construct_binop_func get_lanewise_builtin_cons(ir_builtin_kind kind,
+                                                      ir_mode *const mode)
+{
+	ir_mode *const lane_mode = get_mode_element_mode(mode);
+	unsigned const lane_bits = get_mode_size_bits(lane_mode);
+	bool     const is_signed = mode_is_signed(lane_mode);
+	if (mode_is_float(lane_mode)) {
+		if (lane_mode == x86_mode_E)
+			return NULL;
+		bool const vector = mode_is_vector(mode);
+		switch (kind) {
+		case ir_bk_min: return vector ? new_bd_amd64_minp : new_bd_amd64_mins;
+		case ir_bk_max: return vector ? new_bd_amd64_maxp : new_bd_amd64_maxs;
+		default:        return NULL;
+		}
+	}
+	if (!mode_is_vector(mode))
+		return NULL;
+
+	switch (kind) {
+	case ir_bk_min:
+		return lane_bits == 16 &&  is_signed ? new_bd_amd64_pmins
+		     : lane_bits == 8  && !is_signed ? new_bd_amd64_pminu
+		     : NULL;
+	case ir_bk_max:
+		return lane_bits == 16 &&  is_signed ? new_bd_amd64_pmaxs
+		     : lane_bits == 8  && !is_signed ? new_bd_amd64_pmaxu
+		     : NULL;
+	case ir_bk_saturating_add:
+		if (lane_bits > 16)
+			return NULL;
+		return is_signed ? new_bd_amd64_padds : new_bd_amd64_paddus;
+	case ir_bk_saturating_sub:
+		if (lane_bits > 16)
+			return NULL;
+		return is_signed ? new_bd_amd64_psubs : new_bd_amd64_psubus;
+	default:
+		return NULL;
+	}
+}
+
+bool amd64_can_select_builtin(ir_node const *const node)
+{
+	ir_type *const type = get_Builtin_type(node);
+	ir_mode *const mode = get_type_mode(get_method_res_type(type, 0));
+	return get_lanewise_builtin_cons(get_Builtin_kind(node), mode) != NULL;
+}
+
+static ir_node *gen_lanewise_builtin(ir_node *const node)
+{
+	dbg_info *const dbgi      = get_irn_dbg_info(node);
+	ir_node  *const new_block = be_transform_nodes_block(node);
+	ir_node  *const op0       = be_transform_node(get_Builtin_param(node, 0));
+	ir_node  *const op1       = be_transform_node(get_Builtin_param(node, 1));
+	ir_type  *const type      = get_Builtin_type(node);
+	ir_mode  *const mode      = get_type_mode(get_method_res_type(type, 0));
+	construct_binop_func const cons
+		= get_lanewise_builtin_cons(get_Builtin_kind(node), mode);
+	if (cons == NULL)
+		panic("%+F should have been lowered", node);
+	return create_vector_binop(dbgi, new_block, cons, get_lane_size(mode), op0,
+	                           op1);
+}
+
 static ir_node *gen_Builtin(ir_node *const node)
 {
 	ir_builtin_kind const kind = get_Builtin_kind(node);
@@ -3101,6 +3568,11 @@ static ir_node *gen_Builtin(ir_node *const node)
 		return gen_saturating_increment(node);
 	case ir_bk_va_start:
 		return gen_va_start(node);
+	case ir_bk_min:
+	case ir_bk_max:
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub:
+		return gen_lanewise_builtin(node);
 	default:
 		break;
 	}
@@ -3132,6 +3604,13 @@ static ir_node *gen_Proj_Builtin(ir_node *const proj)
 	case ir_bk_va_start:
 		assert(get_Proj_num(proj) == pn_Builtin_M);
 		return new_node;
+	case ir_bk_min:
+	case ir_bk_max:
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub:
+		if (get_Proj_num(proj) == pn_Builtin_M)
+			return be_transform_node(get_Builtin_mem(node));
+		return new_node;
 	default:
 		break;
 	}
@@ -3154,7 +3633,9 @@ static ir_node *gen_Bitcast(ir_node *const node)
 		.variant    = X86_ADDR_REG,
 	};
 
-	if (src_float && !dst_float) {
+	if (mode_is_vector(src_mode) && mode_is_vector(dst_mode)) {
+		return be_op;
+	} else if (src_float && !dst_float) {
 		return new_bd_amd64_movd_xmm_gp(dbgi, be_block, be_op, X86_SIZE_64, AMD64_OP_REG, addr);
 	} else if (!src_float && dst_float) {
 		return new_bd_amd64_movd_gp_xmm(dbgi, be_block, be_op, X86_SIZE_64, AMD64_OP_REG, addr);
@@ -3196,6 +3677,7 @@ static void amd64_register_transformers(void)
 	be_set_transform_function(op_And,               gen_And);
 	be_set_transform_function(op_ASM,               gen_ASM);
 	be_set_transform_function(op_Bitcast,           gen_Bitcast);
+	be_set_transform_function(op_Broadcast,         gen_Broadcast);
 	be_set_transform_function(op_Builtin,           gen_Builtin);
 	be_set_transform_function(op_Call,              gen_Call);
 	be_set_transform_function(op_Cmp,               gen_Cmp);
@@ -3204,7 +3686,9 @@ static void amd64_register_transformers(void)
 	be_set_transform_function(op_Conv,              gen_Conv);
 	be_set_transform_function(op_Div,               gen_Div);
 	be_set_transform_function(op_Eor,               gen_Eor);
+	be_set_transform_function(op_Extract,           gen_Extract);
 	be_set_transform_function(op_IJmp,              gen_IJmp);
+	be_set_transform_function(op_Insert,            gen_Insert);
 	be_set_transform_function(op_Jmp,               gen_Jmp);
 	be_set_transform_function(op_Load,              gen_Load);
 	be_set_transform_function(op_Member,            gen_Member);
@@ -3219,6 +3703,7 @@ static void amd64_register_transformers(void)
 	be_set_transform_function(op_Shl,               gen_Shl);
 	be_set_transform_function(op_Shr,               gen_Shr);
 	be_set_transform_function(op_Shrs,              gen_Shrs);
+	be_set_transform_function(op_Shuffle,           gen_Shuffle);
 	be_set_transform_function(op_Start,             gen_Start);
 	be_set_transform_function(op_Store,             gen_Store);
 	be_set_transform_function(op_Sub,               gen_Sub);
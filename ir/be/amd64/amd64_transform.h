@@ -52,4 +52,15 @@ void init_lconst_addr(x86_addr_t *addr, ir_entity *entity);
   */
 ir_tarval *create_sign_tv(ir_mode *mode);
 
+/**
+ * Returns true if the vector operation @p node can be selected directly,
+ * otherwise it has to be lowered to operations on the lanes.
+ */
+bool amd64_can_select_vector_op(ir_node const *node);
+
+/**
+ * Returns true if there is an instruction for the lane-wise builtin @p node.
+ */
+bool amd64_can_select_builtin(ir_node const *node);
+
 #endif
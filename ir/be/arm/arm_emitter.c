@@ -312,19 +312,19 @@ void arm_emitf(const ir_node *node, const char *format, ...)
 
 		case 'X': {
 			int num = va_arg(ap, int);
-			be_emit_irprintf("%X", num);
+			be_emit_hex((unsigned)num);
 			break;
 		}
 
 		case 'u': {
 			unsigned num = va_arg(ap, unsigned);
-			be_emit_irprintf("%u", num);
+			be_emit_uint(num);
 			break;
 		}
 
 		case 'd': {
 			int num = va_arg(ap, int);
-			be_emit_irprintf("%d", num);
+			be_emit_int(num);
 			break;
 		}
 
@@ -1377,6 +1377,10 @@ static ir_node *gen_Builtin(ir_node *node)
 	case ir_bk_may_alias:
 	case ir_bk_va_start:
 	case ir_bk_va_arg:
+	case ir_bk_min:
+	case ir_bk_max:
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub:
 		break;
 	}
 	panic("Builtin %s not implemented", get_builtin_kind_name(kind));
@@ -1414,6 +1418,10 @@ static ir_node *gen_Proj_Builtin(ir_node *proj)
 	case ir_bk_may_alias:
 	case ir_bk_va_start:
 	case ir_bk_va_arg:
+	case ir_bk_min:
+	case ir_bk_max:
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub:
 		break;
 	}
 	panic("Builtin %s not implemented", get_builtin_kind_name(kind));
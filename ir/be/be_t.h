@@ -50,6 +50,7 @@ struct be_options_t {
 	bool do_verify;            /**< backend verify option */
 	char ilp_solver[128];      /**< the ilp solver name */
 	bool verbose_asm;          /**< dump verbose assembler */
+	bool graph_buffers;        /**< emit each graph into its own buffer */
 	be_pic_style_t pic_style;
 };
 extern be_options_t be_options;
@@ -114,9 +115,32 @@ typedef enum {
 ENUM_COUNTABLE(be_timer_id_t)
 extern ir_timer_t *be_timers[T_LAST+1];
 
+/**
+ * Returns the name of a backend timer, which is also the name of its scope in
+ * the compile time profile.
+ */
+char const *be_get_timer_name(be_timer_id_t id);
+
+/** Set for the timers whose be_timer_push() began a scope of the profile. */
+extern bool be_timer_scoped[T_LAST+1];
+
+/**
+ * Begins a scope of the compile time profile for the graph currently
+ * compiled by the backend.  Returns true if a scope was begun, which has to
+ * be ended with be_timing_scope_end().
+ */
+bool be_timing_scope_begin(char const *name);
+
+/**
+ * Ends the scope of the compile time profile begun by be_timing_scope_begin()
+ * if @p begun is set.
+ */
+void be_timing_scope_end(bool begun);
+
 static inline void be_timer_push(be_timer_id_t id)
 {
 	assert(id <= T_LAST);
+	be_timer_scoped[id] = be_timing_scope_begin(be_get_timer_name(id));
 	if (!be_timing)
 		return;
 	ir_timer_push(be_timers[id]);
@@ -125,9 +149,10 @@ static inline void be_timer_push(be_timer_id_t id)
 static inline void be_timer_pop(be_timer_id_t id)
 {
 	assert(id <= T_LAST);
-	if (!be_timing)
-		return;
-	ir_timer_pop(be_timers[id]);
+	if (be_timing)
+		ir_timer_pop(be_timers[id]);
+	be_timing_scope_end(be_timer_scoped[id]);
+	be_timer_scoped[id] = false;
 }
 
 /**
@@ -148,8 +173,21 @@ static inline void be_dump(be_dump_flags_t const mask, ir_graph *const irg, char
  * @{
  */
 void be_begin(FILE *output, const char *cup_name);
+/**
+ * Like be_begin(), but be_finish() writes an ELF object file instead of
+ * assembler, see beelf.h.
+ */
+void be_begin_elf(FILE *output, const char *cup_name,
+                  be_elf_target_t const *target);
 void be_finish(void);
 
+/*
+ * The be_step_* functions compile a single graph.  They are not reentrant:
+ * graphs have to be compiled one after another on one thread, because the
+ * backend shares process-wide state between them, e.g. irp, the obstack and
+ * environment of bemain.c, the timers, the emitter, the optimization flags
+ * and the ident, tarval, mode and type tables.
+ */
 bool be_step_first(ir_graph *irg);
 void be_step_regalloc(ir_graph *irg, const regalloc_if_t *regif);
 void be_step_schedule(ir_graph *irg);
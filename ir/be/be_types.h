@@ -54,6 +54,7 @@ typedef struct reg_out_info_t  reg_out_info_t;
 typedef struct be_ifg_t        be_ifg_t;
 typedef struct copy_opt_t      copy_opt_t;
 typedef struct be_main_env_t   be_main_env_t;
+typedef struct be_elf_target_t be_elf_target_t;
 typedef struct be_options_t    be_options_t;
 typedef struct regalloc_if_t   regalloc_if_t;
 
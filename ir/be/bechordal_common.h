@@ -32,4 +32,14 @@ void create_borders(ir_node *block, void *env_ptr);
  */
 ir_node *pre_process_constraints(be_chordal_env_t *_env, be_insn_t **the_insn);
 
+/**
+ * Handle the constrained nodes of a block.
+ * A Perm over all values live at a constrained node is inserted right in
+ * front of it and registers are assigned to the constrained operands and the
+ * results of the Perm by a bipartite matching.
+ * @param block The block to do it for.
+ * @param env_ptr The environment.
+ */
+void handle_constraints(ir_node *block, void *env_ptr);
+
 #endif
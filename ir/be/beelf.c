@@ -0,0 +1,707 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Writes relocatable ELF object files.
+ */
+#include "beelf.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "array.h"
+#include "be.h"
+#include "begnuas.h"
+#include "bitfiddle.h"
+#include "entity_t.h"
+#include "irprog_t.h"
+#include "obst.h"
+#include "panic.h"
+#include "pmap.h"
+#include "util.h"
+
+/* constants from the ELF specification */
+enum {
+	ELFCLASS64    = 2,
+	ELFDATA2LSB   = 1,
+	ELFDATA2MSB   = 2,
+	EV_CURRENT    = 1,
+	ET_REL        = 1,
+
+	SHT_NULL      = 0,
+	SHT_PROGBITS  = 1,
+	SHT_SYMTAB    = 2,
+	SHT_STRTAB    = 3,
+	SHT_RELA      = 4,
+	SHT_NOBITS    = 8,
+
+	SHF_WRITE     = 0x1,
+	SHF_ALLOC     = 0x2,
+	SHF_EXECINSTR = 0x4,
+	SHF_INFO_LINK = 0x40,
+
+	SHN_UNDEF     = 0,
+	SHN_COMMON    = 0xFFF2,
+
+	STB_LOCAL     = 0,
+	STB_GLOBAL    = 1,
+	STB_WEAK      = 2,
+
+	STT_NOTYPE    = 0,
+	STT_OBJECT    = 1,
+	STT_FUNC      = 2,
+	STT_SECTION   = 3,
+
+	STV_DEFAULT   = 0,
+	STV_HIDDEN    = 2,
+	STV_PROTECTED = 3,
+
+	EHDR_SIZE     = 64, /**< size of an Elf64_Ehdr */
+	SHDR_SIZE     = 64, /**< size of an Elf64_Shdr */
+	SYM_SIZE      = 24, /**< size of an Elf64_Sym */
+	RELA_SIZE     = 24, /**< size of an Elf64_Rela */
+};
+
+/** The sections with contents, in the order they appear in the object. */
+typedef enum elf_section_id_t {
+	ELF_SECTION_TEXT,
+	ELF_SECTION_DATA,
+	ELF_SECTION_BSS,
+	ELF_SECTION_RODATA,
+	ELF_SECTION_REL_RO_LOCAL,
+	ELF_SECTION_REL_RO,
+	ELF_SECTION_CTORS,
+	ELF_SECTION_DTORS,
+	ELF_SECTION_JCR,
+	ELF_SECTION_LAST = ELF_SECTION_JCR,
+	ELF_SECTION_UNDEF,  /**< symbol is defined by another object */
+	ELF_SECTION_COMMON, /**< symbol is a common block */
+} elf_section_id_t;
+
+typedef struct elf_symbol_t elf_symbol_t;
+struct elf_symbol_t {
+	ir_entity        *entity;
+	elf_symbol_t     *alias;   /**< aliased symbol, NULL if none */
+	elf_section_id_t  section;
+	uint8_t           type;    /**< STT_* */
+	uint64_t          value;   /**< offset in the section, alignment of commons */
+	uint64_t          size;
+	unsigned          index;   /**< index in the symbol table */
+};
+
+typedef struct elf_relocation_t {
+	uint64_t      offset; /**< offset of the field in its section */
+	uint32_t      type;
+	elf_symbol_t *symbol; /**< NULL for addresses in the same section */
+	int64_t       addend;
+} elf_relocation_t;
+
+typedef struct elf_section_t {
+	char const       *name;
+	uint32_t          type;
+	uint64_t          flags;
+	uint64_t          alignment;
+	uint64_t          size;
+	unsigned char    *data;        /**< contents, NULL for SHT_NOBITS */
+	elf_relocation_t *relocations;
+	unsigned          index;       /**< section header index, 0 if omitted */
+	unsigned          symbol;      /**< index of the section symbol */
+} elf_section_t;
+
+/** An entry of the section header table. */
+typedef struct elf_header_t {
+	uint32_t             name;
+	uint32_t             type;
+	uint64_t             flags;
+	uint64_t             offset;
+	uint64_t             size;
+	uint32_t             link;
+	uint32_t             info;
+	uint64_t             alignment;
+	uint64_t             entry_size;
+	unsigned char const *data;  /**< contents, NULL if nothing to write */
+} elf_header_t;
+
+static FILE                  *output;
+static be_elf_target_t const *target;
+static bool                   big_endian;
+static struct obstack         obst;
+static elf_section_t          sections[ELF_SECTION_LAST + 1];
+/** symbols in order of creation */
+static elf_symbol_t         **symbols;
+static pmap                  *symbol_map;
+/** section receiving relocations */
+static elf_section_t         *current_section;
+/** offset of the entity whose initializer is currently encoded */
+static uint64_t               data_offset;
+
+static void init_section(elf_section_id_t const id, char const *const name,
+                         uint32_t const type, uint64_t const flags)
+{
+	sections[id] = (elf_section_t) {
+		.name        = name,
+		.type        = type,
+		.flags       = flags,
+		.alignment   = 1,
+		.data        = type != SHT_NOBITS ? NEW_ARR_F(unsigned char, 0) : NULL,
+		.relocations = NEW_ARR_F(elf_relocation_t, 0),
+	};
+}
+
+void be_elf_begin(FILE *const file, be_elf_target_t const *const elf_target)
+{
+	if (get_irp_n_asms() > 0)
+		panic("global assembler is not supported in ELF object output");
+
+	output     = file;
+	target     = elf_target;
+	big_endian = be_get_backend_param()->byte_order_big_endian;
+	obstack_init(&obst);
+	symbols    = NEW_ARR_F(elf_symbol_t*, 0);
+	symbol_map = pmap_create();
+
+	uint64_t const aw = SHF_ALLOC | SHF_WRITE;
+	init_section(ELF_SECTION_TEXT, ".text", SHT_PROGBITS,
+	             SHF_ALLOC | SHF_EXECINSTR);
+	init_section(ELF_SECTION_DATA,         ".data",              SHT_PROGBITS, aw);
+	init_section(ELF_SECTION_BSS,          ".bss",               SHT_NOBITS,   aw);
+	init_section(ELF_SECTION_RODATA,       ".rodata",            SHT_PROGBITS, SHF_ALLOC);
+	init_section(ELF_SECTION_REL_RO_LOCAL, ".data.rel.ro.local", SHT_PROGBITS, aw);
+	init_section(ELF_SECTION_REL_RO,       ".data.rel.ro",       SHT_PROGBITS, aw);
+	init_section(ELF_SECTION_CTORS,        ".ctors",             SHT_PROGBITS, aw);
+	init_section(ELF_SECTION_DTORS,        ".dtors",             SHT_PROGBITS, aw);
+	init_section(ELF_SECTION_JCR,          ".jcr",               SHT_PROGBITS, aw);
+}
+
+/**
+ * Reserve @p size zeroed bytes at the end of @p section.
+ *
+ * @return the offset of the reserved bytes
+ */
+static uint64_t section_append(elf_section_t *const section,
+                               uint64_t const size, unsigned const alignment)
+{
+	uint64_t const offset = round_up2(section->size, alignment);
+	uint64_t const end    = offset + size;
+	if (section->type != SHT_NOBITS) {
+		ARR_RESIZE(unsigned char, section->data, end);
+		memset(section->data + section->size, 0, end - section->size);
+	}
+	section->size      = end;
+	section->alignment = MAX(section->alignment, alignment);
+	return offset;
+}
+
+static elf_symbol_t *get_symbol(ir_entity *const entity)
+{
+	elf_symbol_t *symbol = pmap_get(elf_symbol_t, symbol_map, entity);
+	if (symbol == NULL) {
+		symbol          = OALLOCZ(&obst, elf_symbol_t);
+		symbol->entity  = entity;
+		symbol->section = ELF_SECTION_UNDEF;
+		pmap_insert(symbol_map, entity, symbol);
+		ARR_APP1(elf_symbol_t*, symbols, symbol);
+	}
+	return symbol;
+}
+
+static void define_symbol(ir_entity *const entity,
+                          elf_section_id_t const section, uint8_t const type,
+                          uint64_t const value, uint64_t const size)
+{
+	elf_symbol_t *const symbol = get_symbol(entity);
+	if (symbol->section != ELF_SECTION_UNDEF || symbol->alias != NULL)
+		panic("%+F defined twice", entity);
+	symbol->section = section;
+	symbol->type    = type;
+	symbol->value   = value;
+	symbol->size    = size;
+}
+
+static void add_relocation(uint64_t const offset, uint32_t const type,
+                           elf_symbol_t *const symbol, int64_t const addend)
+{
+	elf_relocation_t const relocation = {
+		.offset = offset,
+		.type   = type,
+		.symbol = symbol,
+		.addend = addend,
+	};
+	ARR_APP1(elf_relocation_t, current_section->relocations, relocation);
+}
+
+static uint64_t get_field_offset(char const *const field)
+{
+	unsigned char const *const data = current_section->data;
+	assert((unsigned char const*)field >= data);
+	assert((unsigned char const*)field < data + current_section->size);
+	return (unsigned char const*)field - data;
+}
+
+void be_elf_add_relocation(char const *const field, uint32_t const type,
+                           ir_entity *const entity, int64_t const addend)
+{
+	add_relocation(get_field_offset(field), type, get_symbol(entity), addend);
+}
+
+void be_elf_add_local_relocation(char const *const field, uint32_t const type,
+                                 int64_t const offset)
+{
+	uint64_t const field_offset = get_field_offset(field);
+	add_relocation(field_offset, type, NULL, field_offset + offset);
+}
+
+void be_elf_emit_function(ir_entity *const entity, unsigned const p2align,
+                          ir_jit_function_t *const function,
+                          be_jit_emit_interface_t const *const emitter)
+{
+	elf_section_t *const text  = &sections[ELF_SECTION_TEXT];
+	uint64_t       const end   = text->size;
+	unsigned       const size  = be_get_function_size(function);
+	uint64_t       const begin = section_append(text, size, 1U << p2align);
+	if (begin > end)
+		emitter->nops((char*)text->data + end, begin - end);
+	define_symbol(entity, ELF_SECTION_TEXT, STT_FUNC, begin, size);
+
+	current_section = text;
+	be_jit_emit_memory((char*)text->data + begin, function, emitter);
+	current_section = NULL;
+}
+
+static void add_data_relocation(unsigned long const offset, unsigned const size,
+                                ir_entity *const entity, int64_t const addend)
+{
+	uint32_t type;
+	switch (size) {
+	case 4: type = target->reloc_abs32; break;
+	case 8: type = target->reloc_abs64; break;
+	default: panic("cannot encode %u byte address of %+F", size, entity);
+	}
+	add_relocation(data_offset + offset, type, get_symbol(entity), addend);
+}
+
+static elf_section_id_t get_elf_section(ir_entity const *const entity)
+{
+	switch (be_gas_get_entity_section(entity) & GAS_SECTION_TYPE_MASK) {
+	case GAS_SECTION_TEXT:         return ELF_SECTION_TEXT;
+	case GAS_SECTION_DATA:         return ELF_SECTION_DATA;
+	case GAS_SECTION_RODATA:       return ELF_SECTION_RODATA;
+	case GAS_SECTION_REL_RO:       return ELF_SECTION_REL_RO;
+	case GAS_SECTION_REL_RO_LOCAL: return ELF_SECTION_REL_RO_LOCAL;
+	case GAS_SECTION_BSS:          return ELF_SECTION_BSS;
+	case GAS_SECTION_CONSTRUCTORS: return ELF_SECTION_CTORS;
+	case GAS_SECTION_DESTRUCTORS:  return ELF_SECTION_DTORS;
+	case GAS_SECTION_JCR:          return ELF_SECTION_JCR;
+	default:                       break;
+	}
+	panic("no ELF section for %+F", entity);
+}
+
+static bool is_external(ir_entity const *const entity)
+{
+	ir_visibility const visibility = get_entity_visibility(entity);
+	return visibility != ir_visibility_local
+	    && visibility != ir_visibility_private;
+}
+
+/**
+ * Place a global entity in its section, like emit_global() in begnuas.c.
+ */
+static void emit_global(ir_entity *const entity)
+{
+	/* Block labels are resolved in the code and functions are emitted by
+	 * be_elf_emit_function(). */
+	ir_entity_kind const kind = get_entity_kind(entity);
+	if (kind == IR_ENTITY_LABEL || kind == IR_ENTITY_METHOD)
+		return;
+
+	if (be_gas_get_entity_section(entity) & GAS_SECTION_FLAG_TLS) {
+		if (entity_has_definition(entity))
+			panic("thread local %+F is not supported in ELF object output",
+			      entity);
+		return;
+	}
+
+	unsigned long size = be_gas_get_entity_size(entity);
+	if (size == 0)
+		size = 1;
+	unsigned const alignment = be_gas_get_entity_alignment(entity);
+	if (!is_po2_or_zero(alignment))
+		panic("alignment not a power of 2");
+
+	if (get_entity_linkage(entity) & IR_LINKAGE_MERGE && is_external(entity)) {
+		define_symbol(entity, ELF_SECTION_COMMON, STT_OBJECT, alignment, size);
+		return;
+	}
+
+	/* nothing left to do without an initializer */
+	if (!entity_has_definition(entity))
+		return;
+
+	if (kind == IR_ENTITY_ALIAS) {
+		elf_symbol_t *const symbol = get_symbol(entity);
+		symbol->alias = get_symbol(get_entity_alias(entity));
+		return;
+	}
+
+	elf_section_id_t const id      = get_elf_section(entity);
+	elf_section_t   *const section = &sections[id];
+	uint64_t         const offset  = section_append(section, size, alignment);
+	define_symbol(entity, id, STT_OBJECT, offset, size);
+	if (section->type == SHT_NOBITS)
+		return;
+
+	current_section = section;
+	data_offset     = offset;
+	be_encode_initializer(entity, size, section->data + offset,
+	                      add_data_relocation);
+	current_section = NULL;
+}
+
+static void emit_globals(ir_type *const type)
+{
+	for (size_t i = 0, n = get_compound_n_members(type); i < n; ++i) {
+		ir_entity *const entity = get_compound_member(type, i);
+		if (!(get_entity_linkage(entity) & IR_LINKAGE_NO_CODEGEN))
+			emit_global(entity);
+	}
+}
+
+static void resolve_alias(elf_symbol_t *const symbol)
+{
+	elf_symbol_t const *target_symbol = symbol->alias;
+	while (target_symbol->alias != NULL) {
+		if (target_symbol == symbol)
+			panic("cyclic alias %+F", symbol->entity);
+		target_symbol = target_symbol->alias;
+	}
+	if (target_symbol->section == ELF_SECTION_UNDEF
+	 || target_symbol->section == ELF_SECTION_COMMON)
+		panic("alias %+F needs a defined target", symbol->entity);
+	symbol->section = target_symbol->section;
+	symbol->type    = target_symbol->type;
+	symbol->value   = target_symbol->value;
+	symbol->size    = target_symbol->size;
+}
+
+static uint8_t get_symbol_binding(elf_symbol_t const *const symbol)
+{
+	ir_entity const *const entity = symbol->entity;
+	if (!is_external(entity)) {
+		if (symbol->section == ELF_SECTION_UNDEF)
+			panic("local %+F is not defined", entity);
+		return STB_LOCAL;
+	}
+	ir_linkage const linkage = get_entity_linkage(entity);
+	if (linkage & IR_LINKAGE_WEAK)
+		return STB_WEAK;
+	/* without section groups, comdat definitions are merged as weak symbols */
+	if ((linkage & IR_LINKAGE_MERGE) && (linkage & IR_LINKAGE_GARBAGE_COLLECT)
+	 && symbol->section != ELF_SECTION_UNDEF)
+		return STB_WEAK;
+	return STB_GLOBAL;
+}
+
+static uint8_t get_symbol_visibility(ir_entity const *const entity)
+{
+	switch (get_entity_visibility(entity)) {
+	case ir_visibility_external_private:   return STV_HIDDEN;
+	case ir_visibility_external_protected: return STV_PROTECTED;
+	default:                               return STV_DEFAULT;
+	}
+}
+
+/** Append @p size bytes of @p value in target byte order. */
+static void put(unsigned char **const buffer, unsigned const size,
+                uint64_t const value)
+{
+	for (unsigned i = 0; i < size; ++i) {
+		unsigned const shift = 8 * (big_endian ? size - 1 - i : i);
+		ARR_APP1(unsigned char, *buffer, (unsigned char)(value >> shift));
+	}
+}
+
+static uint32_t add_string(unsigned char **const table,
+                           char const *const prefix, char const *const string)
+{
+	uint32_t const offset = ARR_LEN(*table);
+	size_t   const prefix_len = strlen(prefix);
+	size_t   const len        = strlen(string);
+	ARR_RESIZE(unsigned char, *table, offset + prefix_len + len + 1);
+	memcpy(*table + offset, prefix, prefix_len);
+	memcpy(*table + offset + prefix_len, string, len + 1);
+	return offset;
+}
+
+static void put_symbol(unsigned char **const symtab, uint32_t const name,
+                       uint8_t const info, uint8_t const other,
+                       uint16_t const shndx, uint64_t const value,
+                       uint64_t const size)
+{
+	put(symtab, 4, name);
+	put(symtab, 1, info);
+	put(symtab, 1, other);
+	put(symtab, 2, shndx);
+	put(symtab, 8, value);
+	put(symtab, 8, size);
+}
+
+static void put_entity_symbol(unsigned char **const symtab,
+                              unsigned char **const strtab,
+                              elf_symbol_t *const symbol, uint8_t const binding)
+{
+	ir_entity const *const entity = symbol->entity;
+	char      const *const prefix = get_entity_visibility(entity)
+		== ir_visibility_private ? be_gas_get_private_prefix() : "";
+	uint32_t const name = add_string(strtab, prefix, get_entity_ld_name(entity));
+
+	uint16_t shndx;
+	switch (symbol->section) {
+	case ELF_SECTION_UNDEF:  shndx = SHN_UNDEF;  break;
+	case ELF_SECTION_COMMON: shndx = SHN_COMMON; break;
+	default:                 shndx = sections[symbol->section].index; break;
+	}
+	symbol->index = ARR_LEN(*symtab) / SYM_SIZE;
+	put_symbol(symtab, name, binding << 4 | symbol->type,
+	           get_symbol_visibility(entity), shndx, symbol->value,
+	           symbol->size);
+}
+
+static void put_header(unsigned char **const buffer,
+                       elf_header_t const *const header)
+{
+	put(buffer, 4, header->name);
+	put(buffer, 4, header->type);
+	put(buffer, 8, header->flags);
+	put(buffer, 8, 0);
+	put(buffer, 8, header->offset);
+	put(buffer, 8, header->size);
+	put(buffer, 4, header->link);
+	put(buffer, 4, header->info);
+	put(buffer, 8, header->alignment);
+	put(buffer, 8, header->entry_size);
+}
+
+static void write_padding(uint64_t const size)
+{
+	for (uint64_t i = 0; i < size; ++i)
+		fputc(0, output);
+}
+
+static void write_object(void)
+{
+	/* The text, data and bss sections always exist, like in the output of
+	 * the assembler. */
+	unsigned n_headers = 1;
+	for (elf_section_id_t i = ELF_SECTION_TEXT; i <= ELF_SECTION_LAST; ++i) {
+		elf_section_t *const section = &sections[i];
+		if (i <= ELF_SECTION_BSS || section->size > 0)
+			section->index = n_headers++;
+	}
+
+	/* Local symbols precede global ones. */
+	unsigned char *symtab = NEW_ARR_F(unsigned char, 0);
+	unsigned char *strtab = NEW_ARR_F(unsigned char, 0);
+	add_string(&strtab, "", "");
+	put_symbol(&symtab, 0, 0, 0, SHN_UNDEF, 0, 0);
+	for (elf_section_id_t i = ELF_SECTION_TEXT; i <= ELF_SECTION_LAST; ++i) {
+		elf_section_t *const section = &sections[i];
+		if (section->index == 0)
+			continue;
+		section->symbol = ARR_LEN(symtab) / SYM_SIZE;
+		put_symbol(&symtab, 0, STB_LOCAL << 4 | STT_SECTION, STV_DEFAULT,
+		           section->index, 0, 0);
+	}
+	for (size_t i = 0, n = ARR_LEN(symbols); i < n; ++i) {
+		elf_symbol_t *const symbol = symbols[i];
+		if (get_symbol_binding(symbol) == STB_LOCAL)
+			put_entity_symbol(&symtab, &strtab, symbol, STB_LOCAL);
+	}
+	unsigned const first_global = ARR_LEN(symtab) / SYM_SIZE;
+	for (size_t i = 0, n = ARR_LEN(symbols); i < n; ++i) {
+		elf_symbol_t *const symbol  = symbols[i];
+		uint8_t       const binding = get_symbol_binding(symbol);
+		if (binding != STB_LOCAL)
+			put_entity_symbol(&symtab, &strtab, symbol, binding);
+	}
+
+	elf_header_t  *headers  = NEW_ARR_F(elf_header_t, 0);
+	unsigned char *shstrtab = NEW_ARR_F(unsigned char, 0);
+	add_string(&shstrtab, "", "");
+	ARR_APP1(elf_header_t, headers, (elf_header_t) { .type = SHT_NULL });
+	for (elf_section_id_t i = ELF_SECTION_TEXT; i <= ELF_SECTION_LAST; ++i) {
+		elf_section_t const *const section = &sections[i];
+		if (section->index == 0)
+			continue;
+		elf_header_t const header = {
+			.name      = add_string(&shstrtab, "", section->name),
+			.type      = section->type,
+			.flags     = section->flags,
+			.size      = section->size,
+			.alignment = section->alignment,
+			.data      = section->data,
+		};
+		ARR_APP1(elf_header_t, headers, header);
+	}
+
+	/* The relocation sections follow the sections they apply to, the symbol
+	 * table follows all of them. */
+	unsigned n_relas = 0;
+	for (elf_section_id_t i = ELF_SECTION_TEXT; i <= ELF_SECTION_LAST; ++i) {
+		if (sections[i].index != 0 && ARR_LEN(sections[i].relocations) > 0)
+			++n_relas;
+	}
+	unsigned const symtab_index = n_headers + n_relas;
+	unsigned char **relas = NEW_ARR_F(unsigned char*, 0);
+	for (elf_section_id_t i = ELF_SECTION_TEXT; i <= ELF_SECTION_LAST; ++i) {
+		elf_section_t const *const section = &sections[i];
+		size_t               const n       = ARR_LEN(section->relocations);
+		if (section->index == 0 || n == 0)
+			continue;
+		unsigned char *rela = NEW_ARR_F(unsigned char, 0);
+		for (size_t r = 0; r < n; ++r) {
+			elf_relocation_t const *const relocation
+				= &section->relocations[r];
+			elf_symbol_t const *const symbol = relocation->symbol;
+			uint64_t const index = symbol != NULL ? symbol->index
+			                                      : section->symbol;
+			put(&rela, 8, relocation->offset);
+			put(&rela, 8, index << 32 | relocation->type);
+			put(&rela, 8, (uint64_t)relocation->addend);
+		}
+		ARR_APP1(unsigned char*, relas, rela);
+
+		elf_header_t const header = {
+			.name       = add_string(&shstrtab, ".rela", section->name),
+			.type       = SHT_RELA,
+			.flags      = SHF_INFO_LINK,
+			.size       = ARR_LEN(rela),
+			.link       = symtab_index,
+			.info       = section->index,
+			.alignment  = 8,
+			.entry_size = RELA_SIZE,
+			.data       = rela,
+		};
+		ARR_APP1(elf_header_t, headers, header);
+	}
+
+	elf_header_t const symtab_header = {
+		.name       = add_string(&shstrtab, "", ".symtab"),
+		.type       = SHT_SYMTAB,
+		.size       = ARR_LEN(symtab),
+		.link       = symtab_index + 1,
+		.info       = first_global,
+		.alignment  = 8,
+		.entry_size = SYM_SIZE,
+		.data       = symtab,
+	};
+	ARR_APP1(elf_header_t, headers, symtab_header);
+	elf_header_t const strtab_header = {
+		.name      = add_string(&shstrtab, "", ".strtab"),
+		.type      = SHT_STRTAB,
+		.size      = ARR_LEN(strtab),
+		.alignment = 1,
+		.data      = strtab,
+	};
+	ARR_APP1(elf_header_t, headers, strtab_header);
+	uint32_t     const shstrtab_name = add_string(&shstrtab, "", ".shstrtab");
+	elf_header_t const shstrtab_header = {
+		.name      = shstrtab_name,
+		.type      = SHT_STRTAB,
+		.size      = ARR_LEN(shstrtab),
+		.alignment = 1,
+		.data      = shstrtab,
+	};
+	ARR_APP1(elf_header_t, headers, shstrtab_header);
+
+	/* lay out the contents behind the ELF header */
+	size_t   const n_all  = ARR_LEN(headers);
+	uint64_t       offset = EHDR_SIZE;
+	for (size_t i = 1; i < n_all; ++i) {
+		elf_header_t *const header = &headers[i];
+		offset = round_up2(offset, header->alignment);
+		header->offset = offset;
+		if (header->type != SHT_NOBITS)
+			offset += header->size;
+	}
+	uint64_t const header_offset = round_up2(offset, 8);
+
+	unsigned char *buffer = NEW_ARR_F(unsigned char, 0);
+	static unsigned char const magic[] = { 0x7F, 'E', 'L', 'F' };
+	for (size_t i = 0; i < ARRAY_SIZE(magic); ++i)
+		ARR_APP1(unsigned char, buffer, magic[i]);
+	put(&buffer, 1, ELFCLASS64);
+	put(&buffer, 1, big_endian ? ELFDATA2MSB : ELFDATA2LSB);
+	put(&buffer, 1, EV_CURRENT);
+	while (ARR_LEN(buffer) < 16)
+		put(&buffer, 1, 0);
+	put(&buffer, 2, ET_REL);
+	put(&buffer, 2, target->machine);
+	put(&buffer, 4, EV_CURRENT);
+	put(&buffer, 8, 0); /* entry */
+	put(&buffer, 8, 0); /* program header offset */
+	put(&buffer, 8, header_offset);
+	put(&buffer, 4, 0); /* flags */
+	put(&buffer, 2, EHDR_SIZE);
+	put(&buffer, 2, 0); /* program header entry size */
+	put(&buffer, 2, 0); /* program header count */
+	put(&buffer, 2, SHDR_SIZE);
+	put(&buffer, 2, n_all);
+	put(&buffer, 2, n_all - 1);
+	assert(ARR_LEN(buffer) == EHDR_SIZE);
+	fwrite(buffer, 1, ARR_LEN(buffer), output);
+
+	uint64_t position = EHDR_SIZE;
+	for (size_t i = 1; i < n_all; ++i) {
+		elf_header_t const *const header = &headers[i];
+		if (header->type == SHT_NOBITS || header->size == 0)
+			continue;
+		write_padding(header->offset - position);
+		fwrite(header->data, 1, header->size, output);
+		position = header->offset + header->size;
+	}
+	write_padding(header_offset - position);
+
+	ARR_SHRINKLEN(buffer, 0);
+	for (size_t i = 0; i < n_all; ++i)
+		put_header(&buffer, &headers[i]);
+	fwrite(buffer, 1, ARR_LEN(buffer), output);
+
+	DEL_ARR_F(buffer);
+	for (size_t i = 0, n = ARR_LEN(relas); i < n; ++i)
+		DEL_ARR_F(relas[i]);
+	DEL_ARR_F(relas);
+	DEL_ARR_F(headers);
+	DEL_ARR_F(shstrtab);
+	DEL_ARR_F(strtab);
+	DEL_ARR_F(symtab);
+}
+
+void be_elf_finish(void)
+{
+	emit_globals(get_glob_type());
+	emit_globals(get_tls_type());
+	emit_globals(get_segment_type(IR_SEGMENT_CONSTRUCTORS));
+	emit_globals(get_segment_type(IR_SEGMENT_DESTRUCTORS));
+	emit_globals(get_segment_type(IR_SEGMENT_JCR));
+
+	for (size_t i = 0, n = ARR_LEN(symbols); i < n; ++i) {
+		elf_symbol_t *const symbol = symbols[i];
+		if (symbol->alias != NULL)
+			resolve_alias(symbol);
+	}
+
+	write_object();
+
+	for (elf_section_id_t i = ELF_SECTION_TEXT; i <= ELF_SECTION_LAST; ++i) {
+		if (sections[i].data != NULL)
+			DEL_ARR_F(sections[i].data);
+		DEL_ARR_F(sections[i].relocations);
+	}
+	pmap_destroy(symbol_map);
+	DEL_ARR_F(symbols);
+	obstack_free(&obst, NULL);
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Writes relocatable ELF object files.
+ *
+ * Functions are encoded by the binary emitter of the target (see bejit.h) and
+ * copied into the text section, global entities are laid out like the
+ * assembler output of begnuas.c would place them.
+ */
+#ifndef FIRM_BE_BEELF_H
+#define FIRM_BE_BEELF_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "be_types.h"
+#include "bejit.h"
+#include "firm_types.h"
+
+/** Target specific properties of the object file. */
+struct be_elf_target_t {
+	uint16_t machine;     /**< value of the e_machine field */
+	uint32_t reloc_abs32; /**< relocation type for 32bit data addresses */
+	uint32_t reloc_abs64; /**< relocation type for 64bit data addresses */
+};
+
+/**
+ * Start collecting an object file, which is written to @p output by
+ * be_elf_finish().
+ */
+void be_elf_begin(FILE *output, be_elf_target_t const *target);
+
+/**
+ * Write all global entities of the program and the object file itself.
+ */
+void be_elf_finish(void);
+
+/**
+ * Append the machine code of @p function to the text section and define
+ * @p entity at its start.
+ *
+ * While the code is copied, the relocation callback of @p emitter has to
+ * record relocations with be_elf_add_relocation() and
+ * be_elf_add_local_relocation().
+ */
+void be_elf_emit_function(ir_entity *entity, unsigned p2align,
+                          ir_jit_function_t *function,
+                          be_jit_emit_interface_t const *emitter);
+
+/**
+ * Record a relocation of type @p type at @p field to the address of
+ * @p entity plus @p addend.
+ */
+void be_elf_add_relocation(char const *field, uint32_t type,
+                           ir_entity *entity, int64_t addend);
+
+/**
+ * Record a relocation of type @p type at @p field to the address which is
+ * @p offset bytes behind @p field in the same section.
+ */
+void be_elf_add_local_relocation(char const *field, uint32_t type,
+                                 int64_t offset);
+
+#endif
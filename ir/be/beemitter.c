@@ -9,28 +9,78 @@
  * @author      Matthias Braun
  * @date        12.03.2007
  */
+#include <assert.h>
+
 #include "beemitter.h"
 
+#include "obst.h"
 #include "panic.h"
 #include "irprintf.h"
+#include "xmalloc.h"
+
+/** Text for the emitter file is written out once it reaches this size. */
+#define EMIT_FLUSH_SIZE (64 * 1024)
 
-static FILE    *emit_file;
-struct obstack  emit_obst;
+static FILE             *emit_file;
+static be_emit_buffer_t  file_buffer;
+/** The buffer whose contents are currently held in emit_buf. */
+static be_emit_buffer_t *emit_target = &file_buffer;
+/** Storage of a flushed buffer, which is handed to the next empty buffer. */
+static be_emit_buffer_t  spare_buffer;
+/** Scratch space for formatting with ir_printf. */
+static struct obstack    format_obst;
+be_emit_buffer_t         emit_buf;
 
 void be_emit_init(FILE *file)
 {
+	assert(emit_target == &file_buffer);
 	emit_file = file;
-	obstack_init(&emit_obst);
+	obstack_init(&format_obst);
+}
+
+static void write_buffer(be_emit_buffer_t *const buffer)
+{
+	assert(buffer->line == buffer->cur);
+	size_t const len = buffer->cur - buffer->begin;
+	if (len > 0)
+		fwrite(buffer->begin, 1, len, emit_file);
+	buffer->cur  = buffer->begin;
+	buffer->line = buffer->begin;
 }
 
 void be_emit_exit(void)
 {
-	obstack_free(&emit_obst, NULL);
+	assert(emit_target == &file_buffer);
+	write_buffer(&emit_buf);
+	free(emit_buf.begin);
+	free(spare_buffer.begin);
+	emit_buf     = (be_emit_buffer_t){ NULL, NULL, NULL, NULL };
+	spare_buffer = (be_emit_buffer_t){ NULL, NULL, NULL, NULL };
+	obstack_free(&format_obst, NULL);
+}
+
+void be_emit_grow(size_t const size)
+{
+	size_t const used     = emit_buf.cur  - emit_buf.begin;
+	size_t const line     = emit_buf.line - emit_buf.begin;
+	size_t       capacity = emit_buf.end  - emit_buf.begin;
+	if (capacity == 0)
+		capacity = 2 * EMIT_FLUSH_SIZE;
+	while (capacity - used < size)
+		capacity *= 2;
+	char *const begin = XREALLOC(emit_buf.begin, char, capacity);
+	emit_buf.begin = begin;
+	emit_buf.cur   = begin + used;
+	emit_buf.end   = begin + capacity;
+	emit_buf.line  = begin + line;
 }
 
 void be_emit_irvprintf(const char *fmt, va_list args)
 {
-	ir_obst_vprintf(&emit_obst, fmt, args);
+	ir_obst_vprintf(&format_obst, fmt, args);
+	size_t const len = obstack_object_size(&format_obst);
+	be_emit_string_len((char const*)obstack_base(&format_obst), len);
+	obstack_blank_fast(&format_obst, -(ptrdiff_t)len);
 }
 
 void be_emit_irprintf(const char *fmt, ...)
@@ -41,10 +91,79 @@ void be_emit_irprintf(const char *fmt, ...)
 	va_end(ap);
 }
 
+void be_emit_uint(uint64_t value)
+{
+	char  digits[20];
+	char *p = digits + sizeof(digits);
+	do {
+		*--p   = '0' + value % 10;
+		value /= 10;
+	} while (value != 0);
+	be_emit_string_len(p, digits + sizeof(digits) - p);
+}
+
+void be_emit_int(int64_t const value)
+{
+	if (value < 0) {
+		be_emit_char('-');
+		be_emit_uint(-(uint64_t)value);
+	} else {
+		be_emit_uint(value);
+	}
+}
+
+void be_emit_offset(int64_t const value)
+{
+	if (value >= 0)
+		be_emit_char('+');
+	be_emit_int(value);
+}
+
+void be_emit_hex(uint64_t value)
+{
+	char  digits[16];
+	char *p = digits + sizeof(digits);
+	do {
+		*--p    = "0123456789ABCDEF"[value & 0xF];
+		value >>= 4;
+	} while (value != 0);
+	be_emit_string_len(p, digits + sizeof(digits) - p);
+}
+
 void be_emit_write_line(void)
 {
-	size_t const len  = obstack_object_size(&emit_obst);
-	char  *const line = (char*)obstack_finish(&emit_obst);
-	fwrite(line, 1, len, emit_file);
-	obstack_free(&emit_obst, line);
+	emit_buf.line = emit_buf.cur;
+	if (emit_target == &file_buffer
+	 && (size_t)(emit_buf.cur - emit_buf.begin) >= EMIT_FLUSH_SIZE)
+		write_buffer(&emit_buf);
+}
+
+void be_emit_set_buffer(be_emit_buffer_t *buffer)
+{
+	assert(be_emit_get_column() == 0);
+	/* text collected for the file precedes everything written later */
+	if (emit_target == &file_buffer)
+		write_buffer(&emit_buf);
+	*emit_target = emit_buf;
+
+	emit_target = buffer != NULL ? buffer : &file_buffer;
+	if (emit_target->begin == NULL) {
+		*emit_target = spare_buffer;
+		spare_buffer = (be_emit_buffer_t){ NULL, NULL, NULL, NULL };
+	}
+	emit_buf = *emit_target;
+}
+
+void be_emit_flush_buffer(be_emit_buffer_t *buffer)
+{
+	assert(buffer != emit_target);
+	write_buffer(buffer);
+	/* keep the larger storage for the next buffer */
+	if (spare_buffer.end - spare_buffer.begin < buffer->end - buffer->begin) {
+		free(spare_buffer.begin);
+		spare_buffer = *buffer;
+	} else {
+		free(buffer->begin);
+	}
+	*buffer = (be_emit_buffer_t){ NULL, NULL, NULL, NULL };
 }
@@ -15,18 +15,46 @@
 #ifndef FIRM_BE_BEEMITTER_H
 #define FIRM_BE_BEEMITTER_H
 
+#include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
-#include "obst.h"
+#include <string.h>
+
+/**
+ * A growing flat buffer of emitted text.  Zero initialization yields an empty
+ * buffer.
+ */
+typedef struct be_emit_buffer_t {
+	char *begin; /**< start of the text */
+	char *cur;   /**< end of the text, where the next character goes */
+	char *end;   /**< end of the allocated storage */
+	char *line;  /**< start of the current line */
+} be_emit_buffer_t;
 
 /* don't use the following vars directly, they're only here for the inlines */
-extern struct obstack  emit_obst;
+extern be_emit_buffer_t emit_buf;
+
+/** Grow the current buffer to hold at least @p size more characters. */
+void be_emit_grow(size_t size);
+
+/**
+ * Return space for @p size characters in the (assembler) output, which have
+ * to be committed by advancing emit_buf.cur.
+ */
+static inline char *be_emit_reserve(size_t size)
+{
+	if ((size_t)(emit_buf.end - emit_buf.cur) < size)
+		be_emit_grow(size);
+	return emit_buf.cur;
+}
 
 /**
  * Emit a character to the (assembler) output.
  */
 static inline void be_emit_char(char c)
 {
-	obstack_1grow(&emit_obst, c);
+	*be_emit_reserve(1) = c;
+	++emit_buf.cur;
 }
 
 /**
@@ -37,7 +65,8 @@ static inline void be_emit_char(char c)
  */
 static inline void be_emit_string_len(const char *str, size_t l)
 {
-	obstack_grow(&emit_obst, str, l);
+	memcpy(be_emit_reserve(l), str, l);
+	emit_buf.cur += l;
 }
 
 /**
@@ -59,6 +88,27 @@ static inline void be_emit_string(const char *str)
 #define be_emit_cstring(str) \
 	be_emit_string_len(str, sizeof(str) - 1)
 
+/**
+ * Emit an unsigned number in decimal.
+ */
+void be_emit_uint(uint64_t value);
+
+/**
+ * Emit a signed number in decimal.
+ */
+void be_emit_int(int64_t value);
+
+/**
+ * Emit a signed number in decimal with an explicit sign, which is the form of
+ * an offset added to a symbol.
+ */
+void be_emit_offset(int64_t value);
+
+/**
+ * Emit a number in hexadecimal with upper case digits and without prefix.
+ */
+void be_emit_hex(uint64_t value);
+
 /**
  * Initializes an emitter environment.
  *
@@ -86,14 +136,31 @@ void be_emit_irprintf(const char *fmt, ...);
 void be_emit_irvprintf(const char *fmt, va_list args);
 
 /**
- * Flush the line in the current line buffer to the emitter file.
+ * Finish the current line.  Lines are collected in a buffer, which is written
+ * to the emitter file once it grows large, when switching to another buffer
+ * with be_emit_set_buffer() and by be_emit_exit().
  */
 void be_emit_write_line(void);
 
+/**
+ * Collect all lines written by be_emit_write_line() in @p buffer instead of
+ * writing them to the emitter file. Passing NULL writes directly again.
+ *
+ * This allows to produce the code for a graph independently of the order in
+ * which the graphs end up in the output file.
+ */
+void be_emit_set_buffer(be_emit_buffer_t *buffer);
+
+/**
+ * Write the lines collected in @p buffer to the emitter file with a single
+ * fwrite and empty it.  Its storage is handed on to the next buffer.
+ */
+void be_emit_flush_buffer(be_emit_buffer_t *buffer);
+
 /** Return column in current line. Counting starts at 0. */
 static inline size_t be_emit_get_column(void)
 {
-	return obstack_object_size(&emit_obst);
+	return emit_buf.cur - emit_buf.line;
 }
 
 #endif
@@ -1167,7 +1167,9 @@ static void emit_initializer(ir_entity const *const entity,
 			elem_size = emit_string_initializer(vals[k].v.string);
 			break;
 		case BITFIELD:
-			be_emit_irprintf("\t.byte\t%d\n", vals[k].v.bf_val);
+			be_emit_cstring("\t.byte\t");
+			be_emit_int(vals[k].v.bf_val);
+			be_emit_char('\n');
 			be_emit_write_line();
 			elem_size = 1;
 			break;
@@ -1184,13 +1186,192 @@ static void emit_initializer(ir_entity const *const entity,
 
 		/* a gap */
 		if (space > 0) {
-			be_emit_irprintf("\t.space\t%d, 0\n", space);
+			be_emit_cstring("\t.space\t");
+			be_emit_int(space);
+			be_emit_cstring(", 0\n");
 			be_emit_write_line();
 		}
 	}
 	free(vals);
 }
 
+/**
+ * Write the lowest @p size bytes of @p value in target byte order.
+ */
+static void encode_value(unsigned char *const buffer, unsigned const size,
+                         uint64_t const value)
+{
+	bool const big_endian = be_get_backend_param()->byte_order_big_endian;
+	for (unsigned i = 0; i < size; ++i) {
+		unsigned char const byte = (unsigned char)(value >> (8 * i));
+		buffer[big_endian ? size - 1 - i : i] = byte;
+	}
+}
+
+static void encode_tarval(unsigned char *const buffer, unsigned const size,
+                          ir_tarval *const tv)
+{
+	bool const big_endian = be_get_backend_param()->byte_order_big_endian;
+	for (unsigned i = 0; i < size; ++i) {
+		unsigned char const byte = get_tarval_sub_bits(tv, i);
+		buffer[big_endian ? size - 1 - i : i] = byte;
+	}
+}
+
+/**
+ * Evaluate an atomic initializer value to the address of an entity plus a
+ * constant.
+ *
+ * @param value  receives the constant part
+ * @return       the entity or NULL for plain numbers
+ */
+static ir_entity *encode_init_expression(ir_node *const init,
+                                         int64_t *const value)
+{
+	switch (get_irn_opcode(init)) {
+	case iro_Conv:
+		return encode_init_expression(get_Conv_op(init), value);
+
+	case iro_Const:
+		*value = get_tarval_long(get_Const_tarval(init));
+		return NULL;
+
+	case iro_Address:
+		*value = 0;
+		return get_Address_entity(init);
+
+	case iro_Offset:
+		*value = get_entity_offset(get_Offset_entity(init));
+		return NULL;
+
+	case iro_Align:
+		*value = get_type_alignment(get_Align_type(init));
+		return NULL;
+
+	case iro_Size:
+		*value = get_type_size(get_Size_type(init));
+		return NULL;
+
+	case iro_Add: {
+		int64_t          left;
+		int64_t          right;
+		ir_entity *const l = encode_init_expression(get_Add_left(init), &left);
+		ir_entity *const r = encode_init_expression(get_Add_right(init), &right);
+		if (l != NULL && r != NULL)
+			panic("cannot encode sum of addresses in %+F", init);
+		*value = left + right;
+		return l != NULL ? l : r;
+	}
+
+	case iro_Sub: {
+		int64_t          left;
+		int64_t          right;
+		ir_entity *const l = encode_init_expression(get_Sub_left(init), &left);
+		ir_entity *const r = encode_init_expression(get_Sub_right(init), &right);
+		*value = left - right;
+		if (r == NULL)
+			return l;
+		if (l == r)
+			return NULL;
+		panic("cannot encode difference of addresses in %+F", init);
+	}
+
+	case iro_Mul: {
+		int64_t left;
+		int64_t right;
+		if (encode_init_expression(get_Mul_left(init), &left) != NULL
+		 || encode_init_expression(get_Mul_right(init), &right) != NULL)
+			panic("cannot encode product of addresses in %+F", init);
+		*value = left * right;
+		return NULL;
+	}
+
+	case iro_Unknown:
+		*value = 0;
+		return NULL;
+
+	default:
+		panic("unsupported IR-node %+F", init);
+	}
+}
+
+static void encode_node_data(unsigned char *const buffer,
+                             unsigned long const offset, ir_node *const init,
+                             ir_type *const type,
+                             be_encode_reloc_func const reloc)
+{
+	unsigned const size = get_type_size(type);
+	if (is_Const(init)) {
+		encode_tarval(&buffer[offset], size, get_Const_tarval(init));
+		return;
+	}
+
+	int64_t          value;
+	ir_entity *const entity = encode_init_expression(init, &value);
+	if (entity != NULL) {
+		reloc(offset, size, entity, value);
+	} else {
+		encode_value(&buffer[offset], size, value);
+	}
+}
+
+static void encode_string_initializer(unsigned char *const buffer,
+                                      ir_initializer_t const *const initializer)
+{
+	for (size_t i = 0, n = get_initializer_compound_n_entries(initializer);
+	     i < n; ++i) {
+		ir_initializer_t const *const sub_initializer
+			= get_initializer_compound_value(initializer, i);
+		buffer[i] = get_tarval_long(get_initializer_tarval(sub_initializer));
+	}
+}
+
+void be_encode_initializer(ir_entity const *const entity,
+                           unsigned long const size,
+                           unsigned char *const buffer,
+                           be_encode_reloc_func const reloc)
+{
+	ir_initializer_t const *const initializer = get_entity_initializer(entity);
+	if (initializer_is_string_const(initializer, false)) {
+		encode_string_initializer(buffer, initializer);
+		return;
+	}
+
+	assert(size > 0);
+
+	normal_or_bitfield *const vals = XMALLOCNZ(normal_or_bitfield, size);
+
+#ifndef NDEBUG
+	glob_vals = vals;
+	max_vals  = size;
+#endif
+
+	ir_type *const type = get_entity_type(entity);
+	emit_ir_initializer(vals, initializer, type);
+
+	/* Bytes covered by a value are NORMAL entries without a value. */
+	for (unsigned long k = 0; k < size; ++k) {
+		switch (vals[k].kind) {
+		case NORMAL:
+			if (vals[k].v.value != NULL)
+				encode_node_data(buffer, k, vals[k].v.value, vals[k].type,
+				                 reloc);
+			break;
+		case TARVAL:
+			encode_tarval(&buffer[k], get_type_size(vals[k].type),
+			              vals[k].v.tarval);
+			break;
+		case STRING:
+			encode_string_initializer(&buffer[k], vals[k].v.string);
+			break;
+		case BITFIELD:
+			buffer[k] = vals[k].v.bf_val;
+			break;
+		}
+	}
+	free(vals);
+}
+
 static void emit_align(unsigned p2alignment)
 {
 	be_emit_irprintf("\t.p2align\t%u\n", log2_floor(p2alignment));
@@ -1284,6 +1465,21 @@ static void emit_alias(const ir_entity *entity)
 	be_emit_write_line();
 }
 
+be_gas_section_t be_gas_get_entity_section(ir_entity const *const entity)
+{
+	return determine_section(NULL, entity);
+}
+
+unsigned long be_gas_get_entity_size(ir_entity const *const entity)
+{
+	return compute_entity_size(entity);
+}
+
+unsigned be_gas_get_entity_alignment(ir_entity const *const entity)
+{
+	return get_effective_entity_alignment(entity);
+}
+
 char const *be_gas_get_private_prefix(void)
 {
 	return is_macho() ? "L" : ".L";
@@ -1304,7 +1500,9 @@ void be_gas_emit_entity(const ir_entity *entity)
 {
 	if (entity->kind == IR_ENTITY_LABEL) {
 		ir_label_t label = get_entity_label(entity);
-		be_emit_irprintf("%s_%lu", be_gas_get_private_prefix(), label);
+		be_emit_string(be_gas_get_private_prefix());
+		be_emit_char('_');
+		be_emit_uint(label);
 		return;
 	}
 
@@ -1333,7 +1531,8 @@ void be_gas_emit_block_name(const ir_node *block)
 		} else {
 			nr = PTR_TO_INT(nr_val) - 1;
 		}
-		be_emit_irprintf("%s%d", be_gas_get_private_prefix(), nr);
+		be_emit_string(be_gas_get_private_prefix());
+		be_emit_int(nr);
 	}
 }
 
@@ -1527,9 +1726,9 @@ static void emit_global_decls(be_main_env_t const *const main_env)
 	}
 }
 
-void be_emit_jump_table(const ir_node *node, const ir_switch_table *table,
-                        ir_entity const *const entity, ir_mode *entry_mode,
-                        emit_target_func emit_target)
+ir_node const **be_get_jump_table_targets(ir_node const *const node,
+                                          ir_switch_table const *const table,
+                                          unsigned long *const length_out)
 {
 	/* go over all proj's and collect their jump targets */
 	unsigned        n_outs  = arch_get_irn_n_outs(node);
@@ -1564,7 +1763,9 @@ void be_emit_jump_table(const ir_node *node, const ir_switch_table *table,
 	}
 	++length;
 
-	const ir_node **labels = XMALLOCNZ(const ir_node*, length);
+	const ir_node **labels = XMALLOCN(const ir_node*, length);
+	for (unsigned long i = 0; i < length; ++i)
+		labels[i] = targets[0];
 	for (size_t e = 0; e < n_entries; ++e) {
 		const ir_switch_table_entry *entry
 			= ir_switch_table_get_entry_const(table, e);
@@ -1586,6 +1787,18 @@ void be_emit_jump_table(const ir_node *node, const ir_switch_table *table,
 			}
 		}
 	}
+	free(targets);
+
+	*length_out = length;
+	return labels;
+}
+
+void be_emit_jump_table(const ir_node *node, const ir_switch_table *table,
+                        ir_entity const *const entity, ir_mode *entry_mode,
+                        emit_target_func emit_target)
+{
+	unsigned long         length;
+	ir_node const **const labels = be_get_jump_table_targets(node, table, &length);
 
 	/* emit table */
 	unsigned const pointer_size = get_mode_size_bytes(entry_mode);
@@ -1598,11 +1811,8 @@ void be_emit_jump_table(const ir_node *node, const ir_switch_table *table,
 	}
 
 	for (unsigned long i = 0; i < length; ++i) {
-		ir_node const *target = labels[i];
-		if (target == NULL)
-			target = targets[0];
 		emit_size_type(pointer_size);
-		emit_target(entity, target);
+		emit_target(entity, labels[i]);
 		be_emit_char('\n');
 		be_emit_write_line();
 	}
@@ -1611,7 +1821,6 @@ void be_emit_jump_table(const ir_node *node, const ir_switch_table *table,
 		be_gas_emit_switch_section(GAS_SECTION_TEXT);
 
 	free(labels);
-	free(targets);
 }
 
 static void emit_global_asms(void)
@@ -13,6 +13,7 @@
 #define FIRM_BE_BEGNUAS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "be_types.h"
 #include "bedwarf.h"
 
@@ -120,8 +121,54 @@ void be_gas_end_compilation_unit(const be_main_env_t *env);
  */
 const char *be_gas_insn_label_prefix(void);
 
+/**
+ * Return the section a global entity is placed in.
+ */
+be_gas_section_t be_gas_get_entity_section(ir_entity const *entity);
+
+/**
+ * Return the number of bytes occupied by a global entity, which may be larger
+ * than its type for variable sized types.
+ */
+unsigned long be_gas_get_entity_size(ir_entity const *entity);
+
+/**
+ * Return the alignment of a global entity, which defaults to the alignment of
+ * its type.
+ */
+unsigned be_gas_get_entity_alignment(ir_entity const *entity);
+
+/**
+ * Callback reporting the address of an entity in binary data.
+ *
+ * @param offset  offset of the field from the start of the data
+ * @param size    size of the field in bytes
+ * @param addend  constant added to the address of @p entity
+ */
+typedef void (*be_encode_reloc_func)(unsigned long offset, unsigned size,
+                                     ir_entity *entity, int64_t addend);
+
+/**
+ * Writes the initializer of @p entity as target data to @p buffer, which
+ * must hold @p size zeroed bytes.  Fields containing the address of an
+ * entity are left zero and passed to @p reloc instead.
+ */
+void be_encode_initializer(ir_entity const *entity, unsigned long size,
+                           unsigned char *buffer, be_encode_reloc_func reloc);
+
 typedef void (*emit_target_func)(ir_entity const *table, ir_node const *proj_x);
 
+/**
+ * Determines the entries of the jump table of a switch operation.
+ *
+ * @param length  receives the number of table entries
+ * @return        an xmalloc()ed array with the control flow Proj for each
+ *                entry, which must be freed by the caller
+ */
+ir_node const **be_get_jump_table_targets(ir_node const *node,
+                                          ir_switch_table const *table,
+                                          unsigned long *length);
+
 /**
  * Emits a jump table for switch operations
  */
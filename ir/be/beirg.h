@@ -15,6 +15,7 @@
 #include "be.h"
 #include "be_types.h"
 #include "be_t.h"
+#include "beemitter.h"
 #include "irgraph_t.h"
 
 void be_assure_live_sets(ir_graph *irg);
@@ -54,6 +55,11 @@ typedef struct be_irg_t {
 	struct obstack    obst;
 	/** Architecture specific per-graph data */
 	void             *isa_link;
+	/** assembly text emitted for this graph; written to the output file
+	 * by be_step_last() */
+	be_emit_buffer_t  emit_buffer;
+	/** compile for jit tier 0: prefer compile speed over code quality */
+	bool              fast_compile;
 } be_irg_t;
 
 static inline be_irg_t *be_birg_from_irg(const ir_graph *irg)
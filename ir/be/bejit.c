@@ -83,6 +83,16 @@ void be_destroy_jit_segment(ir_jit_segment_t *segment)
 	free(segment);
 }
 
+void be_reset_jit_segment(ir_jit_segment_t *segment)
+{
+	obstack_free(&segment->code_obst, NULL);
+	obstack_free(&segment->fragment_info_obst, NULL);
+	obstack_free(&segment->fragment_info_arr_obst, NULL);
+	obstack_init(&segment->code_obst);
+	obstack_init(&segment->fragment_info_obst);
+	obstack_init(&segment->fragment_info_arr_obst);
+}
+
 void be_jit_set_entity_addr(ir_entity *entity, void const *address)
 {
 	assert(is_global_entity(entity));
@@ -273,7 +283,12 @@ static void emit_bytes_as_asm(char const *const begin, char const *const end)
 {
 	assert(begin <= end);
 	for (char const *b = begin; b < end; ++b) {
-		be_emit_irprintf("\t.byte 0x%02X\n", (uint8_t)*b);
+		uint8_t const byte = *b;
+		be_emit_cstring("\t.byte 0x");
+		if (byte < 0x10)
+			be_emit_char('0');
+		be_emit_hex(byte);
+		be_emit_char('\n');
 		be_emit_write_line();
 	}
 }
@@ -358,7 +373,7 @@ void be_jit_emit_memory(char *const buffer, ir_jit_function_t *const function,
 	for (size_t i = 0, n = function->n_fragments; i < n; ++i) {
 		fragment_info_t const *const fragment  = function->fragment_infos[i];
 		unsigned               const address   = fragment->address;
-		unsigned               const nop_bytes = last_address - address;
+		unsigned               const nop_bytes = address - last_address;
 		assert(address >= last_address);
 		if (nop_bytes > 0)
 			emitter->nops(buffer + last_address, nop_bytes);
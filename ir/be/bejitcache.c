@@ -0,0 +1,356 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Executable memory for jit compiled functions.
+ *
+ * Blocks consist of whole pages, so changing the protection of one block never
+ * affects another function.  Their sizes are powers of two from one page up to
+ * 1 << MAX_CLASS_LOG pages and they are carved from chunks of CHUNK_PAGES
+ * pages.  Released blocks are put on a free list of their size class and
+ * blocks of larger classes are split when a chunk is used up.  Larger
+ * functions get a mapping of their own, which is unmapped when they are
+ * released.  The free lists and block descriptors live outside of the code
+ * memory, so the code pages are only written while a function is emitted.
+ * Free memory is inaccessible, so stale pointers into released functions
+ * fault instead of running whatever code is left there.
+ *
+ * As blocks are page granular, a function of a few dozen bytes still takes a
+ * whole page.  Packing small functions into shared pages would make their
+ * neighbours non-executable while one of them is emitted and prevent
+ * protecting released ones, so there is no smaller size class.
+ */
+/* MAP_ANONYMOUS and clock_gettime() are not part of C99 */
+#define _DEFAULT_SOURCE
+
+#include <assert.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "array.h"
+#include "be.h"
+#include "bitfiddle.h"
+#include "hashptr.h"
+#include "jit.h"
+#include "panic.h"
+#include "pset.h"
+#include "xmalloc.h"
+
+#define MAX_CLASS_LOG 2
+#define N_CLASSES     (MAX_CLASS_LOG + 1)
+#define CHUNK_PAGES   64
+/** size class of blocks with a mapping of their own */
+#define CLASS_MAPPED  N_CLASSES
+
+typedef struct code_block_t {
+	char    *address;
+	size_t   size;       /**< bytes reserved for the block */
+	unsigned code_size;  /**< bytes used by the function */
+	unsigned size_class;
+} code_block_t;
+
+struct ir_jit_code_cache_t {
+	char  **free_blocks[N_CLASSES]; /**< released blocks of each size class */
+	char  **chunks;                 /**< all mapped chunks */
+	char   *chunk_free;             /**< unused rest of the last chunk */
+	size_t  chunk_left;
+	pset   *blocks;                 /**< code_block_t of the live functions */
+	size_t  page_size;
+	size_t  chunk_size;
+	ir_jit_code_cache_stats_t stats;
+};
+
+static int block_cmp(void const *const elt, void const *const key)
+{
+	code_block_t const *const b0 = (code_block_t const*)elt;
+	code_block_t const *const b1 = (code_block_t const*)key;
+	return b0->address != b1->address;
+}
+
+static code_block_t *find_block(ir_jit_code_cache_t const *const cache,
+                                void *const code)
+{
+	code_block_t const key = { .address = (char*)code };
+	return (code_block_t*)pset_find(cache->blocks, &key, hash_ptr(code));
+}
+
+ir_jit_code_cache_t *be_new_jit_code_cache(void)
+{
+	ir_jit_code_cache_t *const cache = XMALLOCZ(ir_jit_code_cache_t);
+	for (unsigned i = 0; i < N_CLASSES; ++i)
+		cache->free_blocks[i] = NEW_ARR_F(char*, 0);
+	cache->chunks     = NEW_ARR_F(char*, 0);
+	cache->blocks     = new_pset(block_cmp, 64);
+	cache->page_size  = sysconf(_SC_PAGESIZE);
+	cache->chunk_size = CHUNK_PAGES * cache->page_size;
+	return cache;
+}
+
+/** Unmap the blocks with a mapping of their own and free all descriptors. */
+static void free_blocks(ir_jit_code_cache_t *const cache)
+{
+	foreach_pset(cache->blocks, code_block_t, block) {
+		if (block->size_class == CLASS_MAPPED)
+			munmap(block->address, block->size);
+		free(block);
+	}
+}
+
+void be_destroy_jit_code_cache(ir_jit_code_cache_t *cache)
+{
+	free_blocks(cache);
+	del_pset(cache->blocks);
+	for (size_t i = 0, n = ARR_LEN(cache->chunks); i < n; ++i)
+		munmap(cache->chunks[i], cache->chunk_size);
+	DEL_ARR_F(cache->chunks);
+	for (unsigned i = 0; i < N_CLASSES; ++i)
+		DEL_ARR_F(cache->free_blocks[i]);
+	free(cache);
+}
+
+static char *map_memory(size_t const size)
+{
+	void *const memory = mmap(NULL, size, PROT_NONE,
+	                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return memory != MAP_FAILED ? (char*)memory : NULL;
+}
+
+static unsigned get_size_class(ir_jit_code_cache_t const *const cache,
+                               unsigned const size)
+{
+	size_t const n_pages = (size + cache->page_size - 1) / cache->page_size;
+	if (n_pages <= 1)
+		return 0;
+	unsigned const pages_log = log2_ceil(n_pages);
+	return pages_log <= MAX_CLASS_LOG ? pages_log : CLASS_MAPPED;
+}
+
+static size_t get_class_size(ir_jit_code_cache_t const *const cache,
+                             unsigned const size_class)
+{
+	return cache->page_size << size_class;
+}
+
+/**
+ * Put the unused rest of the current chunk on the free lists before a new
+ * chunk is mapped.  All block sizes are multiples of the smallest class, so
+ * nothing is lost.
+ */
+static void retire_chunk_rest(ir_jit_code_cache_t *const cache)
+{
+	for (unsigned c = N_CLASSES; c-- > 0;) {
+		size_t const class_size = get_class_size(cache, c);
+		while (cache->chunk_left >= class_size) {
+			ARR_APP1(char*, cache->free_blocks[c], cache->chunk_free);
+			cache->chunk_free += class_size;
+			cache->chunk_left -= class_size;
+		}
+	}
+	assert(cache->chunk_left == 0);
+}
+
+/**
+ * Continue carving from a released block of a larger size class than
+ * @p size_class instead of mapping a new chunk.
+ */
+static bool split_free_block(ir_jit_code_cache_t *const cache,
+                             unsigned const size_class)
+{
+	for (unsigned c = size_class + 1; c < N_CLASSES; ++c) {
+		size_t const n_free = ARR_LEN(cache->free_blocks[c]);
+		if (n_free == 0)
+			continue;
+		char *const block = cache->free_blocks[c][n_free - 1];
+		ARR_SHRINKLEN(cache->free_blocks[c], n_free - 1);
+		retire_chunk_rest(cache);
+		cache->chunk_free = block;
+		cache->chunk_left = get_class_size(cache, c);
+		return true;
+	}
+	return false;
+}
+
+static char *alloc_block(ir_jit_code_cache_t *const cache,
+                         unsigned const size_class, size_t const size)
+{
+	if (size_class == CLASS_MAPPED) {
+		char *const address = map_memory(size);
+		if (address != NULL)
+			cache->stats.mapped_bytes += size;
+		return address;
+	}
+
+	char **const free_blocks = cache->free_blocks[size_class];
+	size_t const n_free      = ARR_LEN(free_blocks);
+	if (n_free > 0) {
+		char *const address = free_blocks[n_free - 1];
+		ARR_SHRINKLEN(cache->free_blocks[size_class], n_free - 1);
+		return address;
+	}
+
+	if (cache->chunk_left < size && !split_free_block(cache, size_class)) {
+		char *const chunk = map_memory(cache->chunk_size);
+		if (chunk == NULL)
+			return NULL;
+		retire_chunk_rest(cache);
+		ARR_APP1(char*, cache->chunks, chunk);
+		cache->chunk_free          = chunk;
+		cache->chunk_left          = cache->chunk_size;
+		cache->stats.mapped_bytes += cache->chunk_size;
+		cache->stats.free_bytes   += cache->chunk_size;
+	}
+	char *const address = cache->chunk_free;
+	cache->chunk_free += size;
+	cache->chunk_left -= size;
+	return address;
+}
+
+/** Return the block at @p address of @p size bytes to the free memory. */
+static void release_block(ir_jit_code_cache_t *const cache,
+                          char *const address, unsigned const size_class,
+                          size_t const size)
+{
+	if (size_class == CLASS_MAPPED) {
+		munmap(address, size);
+		cache->stats.mapped_bytes -= size;
+	} else {
+		if (mprotect(address, size, PROT_NONE) != 0)
+			panic("could not protect released jit code");
+		ARR_APP1(char*, cache->free_blocks[size_class], address);
+	}
+}
+
+static double get_usec(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1e6 + now.tv_nsec * 1e-3;
+}
+
+void *be_jit_code_cache_add(ir_jit_code_cache_t *cache,
+                            ir_jit_function_t *function)
+{
+	double   const start      = get_usec();
+	unsigned const code_size  = be_get_function_size(function);
+	unsigned const size_class = get_size_class(cache, code_size);
+	size_t   const size       = size_class == CLASS_MAPPED
+		? round_up2(code_size, cache->page_size)
+		: get_class_size(cache, size_class);
+	char *const address = alloc_block(cache, size_class, size);
+	if (address == NULL)
+		return NULL;
+
+	if (mprotect(address, size, PROT_READ | PROT_WRITE) != 0) {
+		release_block(cache, address, size_class, size);
+		return NULL;
+	}
+	be_emit_function(address, function);
+	if (mprotect(address, size, PROT_READ | PROT_EXEC) != 0) {
+		release_block(cache, address, size_class, size);
+		return NULL;
+	}
+#ifdef __GNUC__
+	__builtin___clear_cache(address, address + code_size);
+#endif
+
+	code_block_t *const block = XMALLOC(code_block_t);
+	block->address    = address;
+	block->size       = size;
+	block->code_size  = code_size;
+	block->size_class = size_class;
+	pset_insert(cache->blocks, block, hash_ptr(address));
+
+	ir_jit_code_cache_stats_t *const stats = &cache->stats;
+	if (size_class != CLASS_MAPPED)
+		stats->free_bytes -= size;
+	++stats->n_functions;
+	++stats->n_added;
+	stats->code_bytes  += code_size;
+	stats->block_bytes += size;
+	stats->add_usec    += get_usec() - start;
+	return address;
+}
+
+void be_jit_code_cache_free(ir_jit_code_cache_t *cache, void *code)
+{
+	code_block_t *const block = find_block(cache, code);
+	if (block == NULL)
+		panic("code was not added to the jit code cache");
+	pset_remove(cache->blocks, block, hash_ptr(code));
+
+	ir_jit_code_cache_stats_t *const stats = &cache->stats;
+	--stats->n_functions;
+	stats->code_bytes  -= block->code_size;
+	stats->block_bytes -= block->size;
+	if (block->size_class != CLASS_MAPPED)
+		stats->free_bytes += block->size;
+	release_block(cache, block->address, block->size_class, block->size);
+	free(block);
+}
+
+void be_jit_code_cache_reset(ir_jit_code_cache_t *cache)
+{
+	free_blocks(cache);
+	del_pset(cache->blocks);
+	cache->blocks = new_pset(block_cmp, 64);
+
+	/* all chunks are free again, the last one is carved from first and the
+	 * others are split when it is used up */
+	for (unsigned i = 0; i < N_CLASSES; ++i)
+		ARR_SHRINKLEN(cache->free_blocks[i], 0);
+	cache->chunk_left = 0;
+	size_t const n_chunks = ARR_LEN(cache->chunks);
+	for (size_t i = 0; i < n_chunks; ++i) {
+		if (mprotect(cache->chunks[i], cache->chunk_size, PROT_NONE) != 0)
+			panic("could not protect released jit code");
+		retire_chunk_rest(cache);
+		cache->chunk_free = cache->chunks[i];
+		cache->chunk_left = cache->chunk_size;
+	}
+
+	ir_jit_code_cache_stats_t *const stats = &cache->stats;
+	stats->n_functions  = 0;
+	stats->code_bytes   = 0;
+	stats->block_bytes  = 0;
+	stats->mapped_bytes = n_chunks * cache->chunk_size;
+	stats->free_bytes   = stats->mapped_bytes;
+}
+
+void be_jit_code_cache_get_stats(ir_jit_code_cache_t const *cache,
+                                 ir_jit_code_cache_stats_t *stats)
+{
+	*stats = cache->stats;
+}
+
+void be_jit_code_cache_print_stats(FILE *out, ir_jit_code_cache_t const *cache)
+{
+	ir_jit_code_cache_stats_t const *const stats = &cache->stats;
+	size_t const n_functions = stats->n_functions;
+	fprintf(out, "jit code cache: %zu live functions, %zu added\n",
+	        n_functions, stats->n_added);
+	fprintf(out, "  mapped %zu bytes, code %zu bytes, blocks %zu bytes, free %zu bytes\n",
+	        stats->mapped_bytes, stats->code_bytes, stats->block_bytes,
+	        stats->free_bytes);
+	if (n_functions > 0) {
+		fprintf(out, "  %.1f mapped bytes per live function\n",
+		        (double)stats->mapped_bytes / n_functions);
+	}
+	if (stats->block_bytes > 0) {
+		fprintf(out, "  internal fragmentation %.1f%%\n",
+		        100.0 * (stats->block_bytes - stats->code_bytes)
+		        / stats->block_bytes);
+	}
+	if (stats->mapped_bytes > 0) {
+		fprintf(out, "  free memory %.1f%% of the mapped memory\n",
+		        100.0 * stats->free_bytes / stats->mapped_bytes);
+	}
+	if (stats->n_added > 0) {
+		fprintf(out, "  %.2f usec until executable per added function\n",
+		        stats->add_usec / stats->n_added);
+	}
+}
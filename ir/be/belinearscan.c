@@ -0,0 +1,522 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Linear scan register allocation on SSA form.
+ *
+ * The blocks are laid out in reverse postorder, so the definition of a value
+ * comes before all of its uses and every lifetime interval starts at its
+ * definition.  An interval consists of the ranges of positions at which the
+ * value is live, they are built from the liveness sets.  The intervals are
+ * visited in the order of their start and get a register which is not held
+ * by an active interval, i.e. an interval covering the current position.
+ *
+ * After spilling the register pressure does not exceed the number of
+ * registers.  In SSA form two values interfere iff one is live at the
+ * definition of the other, so a value never collides with an interval which
+ * is in a lifetime hole at its definition and the scan itself never has to
+ * spill or split.  Intervals are split in advance instead: the values live at
+ * an instruction with register constraints are permuted right in front of it
+ * (see handle_constraints()) and Phi operands which did not get the register
+ * of their Phi are moved at the end of the predecessor block by the SSA
+ * destruction.  Phis, their operands, Copies and should_be_same results
+ * prefer the register of their partner to keep the number of these moves low.
+ */
+#include "be_t.h"
+#include "bechordal_common.h"
+#include "bechordal_t.h"
+#include "beirg.h"
+#include "belive.h"
+#include "belower.h"
+#include "bemodule.h"
+#include "benode.h"
+#include "bera.h"
+#include "besched.h"
+#include "bespill.h"
+#include "bespillutil.h"
+#include "bessadestr.h"
+#include "beutil.h"
+#include "beverify.h"
+#include "debug.h"
+#include "irdom.h"
+#include "iredges_t.h"
+#include "irflag.h"
+#include "panic.h"
+#include "raw_bitset.h"
+#include "statev_t.h"
+#include "util.h"
+#include "xmalloc.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+typedef struct live_range_t live_range_t;
+struct live_range_t {
+	unsigned      from; /**< first position covered by the range */
+	unsigned      to;   /**< first position behind the range */
+	live_range_t *next; /**< the next range at higher positions */
+};
+
+/** The lifetime interval of a value. */
+typedef struct interval_t {
+	ir_node      *value;
+	live_range_t *ranges; /**< ranges not yet passed by the scan */
+	unsigned      reg;    /**< index of the (first) assigned register */
+	unsigned      width;  /**< number of assigned registers */
+} interval_t;
+
+static ir_graph                    *irg;
+static arch_register_class_t const *cls;
+static unsigned                     n_regs;
+static be_chordal_env_t             constr_env; /**< for handle_constraints() */
+static ir_node                    **blocks;     /**< blocks in reverse postorder */
+static unsigned                    *block_pos;  /**< start position of each block */
+static interval_t                 **intervals;  /**< interval of each node index */
+static interval_t                 **active;     /**< intervals live at the current position */
+static interval_t                 **inactive;   /**< intervals in a lifetime hole */
+static unsigned                    *occupied;   /**< registers of the active intervals */
+
+static void determine_block_order(void)
+{
+	blocks = be_get_cfgpostorder(irg);
+	for (size_t i = 0, n = ARR_LEN(blocks); i < n / 2; ++i) {
+		ir_node *const block = blocks[i];
+		blocks[i]         = blocks[n - i - 1];
+		blocks[n - i - 1] = block;
+	}
+}
+
+/**
+ * Number the instructions.  Every block starts with a position for its Phis
+ * and live-in values, then each instruction gets two positions: its operands
+ * are used at the first one and its results start at the second one.
+ */
+static void number_instructions(void)
+{
+	size_t const n_blocks = ARR_LEN(blocks);
+	block_pos = XMALLOCN(unsigned, n_blocks + 1);
+	unsigned pos = 0;
+	for (size_t i = 0; i < n_blocks; ++i) {
+		block_pos[i] = pos;
+		pos += 2;
+		sched_foreach_non_phi(blocks[i], node) {
+			pos += 2;
+		}
+	}
+	block_pos[n_blocks] = pos;
+}
+
+static interval_t *get_interval(ir_node *const value)
+{
+	unsigned const idx = get_irn_idx(value);
+	interval_t    *it  = intervals[idx];
+	if (it == NULL) {
+		it = OALLOCZ(&constr_env.obst, interval_t);
+		it->value      = value;
+		intervals[idx] = it;
+	}
+	return it;
+}
+
+/**
+ * Add the range [from, to) to the interval of @p value.  Ranges are added
+ * from back to front, so a new range either overlaps with the first range of
+ * the interval or lies in front of it.
+ */
+static void add_range(ir_node *const value, unsigned const from,
+                      unsigned const to)
+{
+	interval_t   *const it   = get_interval(value);
+	live_range_t *const head = it->ranges;
+	if (head != NULL && to >= head->from) {
+		head->from = MIN(head->from, from);
+		head->to   = MAX(head->to, to);
+		return;
+	}
+	live_range_t *const range = OALLOC(&constr_env.obst, live_range_t);
+	range->from = from;
+	range->to   = to;
+	range->next = head;
+	it->ranges  = range;
+}
+
+/**
+ * Let the interval of @p value start at @p pos.  The first range reaches to
+ * the start of the block at this point.
+ */
+static void add_def(ir_node *const value, unsigned const pos)
+{
+	interval_t   *const it   = get_interval(value);
+	live_range_t *const head = it->ranges;
+	if (head != NULL) {
+		head->from = pos;
+	} else {
+		/* the value is never used */
+		add_range(value, pos, pos + 1);
+	}
+}
+
+static void build_intervals(void)
+{
+	be_lv_t *const lv = be_get_irg_liveness(irg);
+	for (size_t i = ARR_LEN(blocks); i-- > 0;) {
+		ir_node *const block = blocks[i];
+		unsigned const from  = block_pos[i];
+		unsigned       pos   = block_pos[i + 1];
+
+		be_lv_foreach_cls(lv, block, be_lv_state_end, cls, value) {
+			add_range(value, from, pos);
+		}
+
+		sched_foreach_non_phi_reverse(block, node) {
+			pos -= 2;
+			be_foreach_definition(node, cls, value, req,
+				add_def(value, pos + 1);
+			);
+			be_foreach_use(node, cls, in_req, value, value_req,
+				add_range(value, from, pos + 1);
+			);
+		}
+		assert(pos == from + 2);
+
+		sched_foreach_phi(block, phi) {
+			if (arch_irn_consider_in_reg_alloc(cls, phi))
+				add_def(phi, from);
+		}
+	}
+}
+
+static void set_occupied(interval_t const *const it, bool const occupy)
+{
+	for (unsigned r = it->reg; r < it->reg + it->width; ++r) {
+		assert(rbitset_is_set(occupied, r) != occupy);
+		if (occupy)
+			rbitset_set(occupied, r);
+		else
+			rbitset_clear(occupied, r);
+	}
+}
+
+/** Drop the ranges of @p it which end before @p pos. */
+static live_range_t *skip_ranges(interval_t *const it, unsigned const pos)
+{
+	live_range_t *range = it->ranges;
+	while (range != NULL && range->to <= pos)
+		range = range->next;
+	it->ranges = range;
+	return range;
+}
+
+static void remove_interval(interval_t **const list, size_t const i)
+{
+	size_t const n = ARR_LEN(list);
+	list[i] = list[n - 1];
+	ARR_SHRINKLEN(list, n - 1);
+}
+
+/**
+ * Update the active and inactive intervals for position @p pos.
+ */
+static void advance(unsigned const pos)
+{
+	for (size_t i = 0; i < ARR_LEN(active);) {
+		interval_t   *const it    = active[i];
+		live_range_t *const range = skip_ranges(it, pos);
+		if (range != NULL && range->from <= pos) {
+			++i;
+			continue;
+		}
+		set_occupied(it, false);
+		remove_interval(active, i);
+		if (range != NULL)
+			ARR_APP1(interval_t*, inactive, it);
+	}
+
+	for (size_t i = 0; i < ARR_LEN(inactive);) {
+		interval_t   *const it    = inactive[i];
+		live_range_t *const range = skip_ranges(it, pos);
+		if (range != NULL && range->from > pos) {
+			++i;
+			continue;
+		}
+		remove_interval(inactive, i);
+		if (range != NULL) {
+			/* values in a lifetime hole do not interfere with the values
+			 * defined meanwhile, so the register is still free */
+			set_occupied(it, true);
+			ARR_APP1(interval_t*, active, it);
+		}
+	}
+}
+
+static bool is_free(unsigned const *const allowed, unsigned const reg,
+                    unsigned const width)
+{
+	if (reg % width != 0 || reg + width > n_regs)
+		return false;
+	for (unsigned r = reg; r < reg + width; ++r) {
+		if (!rbitset_is_set(allowed, r) || rbitset_is_set(occupied, r))
+			return false;
+	}
+	return true;
+}
+
+static bool is_free_reg(unsigned const *const allowed,
+                        arch_register_t const *const reg, unsigned const width)
+{
+	return reg != NULL && reg->cls == cls && is_free(allowed, reg->index, width);
+}
+
+/**
+ * Returns a free register which avoids a copy after the SSA destruction or
+ * for a should_be_same constraint, or NULL if there is none.
+ */
+static arch_register_t const *get_hint(ir_node *const value,
+                                       arch_register_req_t const *const req,
+                                       unsigned const *const allowed)
+{
+	unsigned const width = req->width;
+	if (is_Phi(value)) {
+		foreach_irn_in(value, i, op) {
+			arch_register_t const *const reg = arch_get_irn_register(op);
+			if (is_free_reg(allowed, reg, width))
+				return reg;
+		}
+	} else if (be_is_Copy(value)) {
+		arch_register_t const *const reg
+			= arch_get_irn_register(be_get_Copy_op(value));
+		if (is_free_reg(allowed, reg, width))
+			return reg;
+	} else if (req->should_be_same != 0) {
+		ir_node *const node = skip_Proj(value);
+		foreach_irn_in(node, i, op) {
+			if (!rbitset_is_set(&req->should_be_same, i))
+				continue;
+			arch_register_t const *const reg = arch_get_irn_register(op);
+			if (is_free_reg(allowed, reg, width))
+				return reg;
+		}
+	}
+
+	/* Phis on loop back edges are assigned before their operands */
+	foreach_out_edge(value, edge) {
+		ir_node *const user = get_edge_src_irn(edge);
+		if (!is_Phi(user))
+			continue;
+		arch_register_t const *const reg = arch_get_irn_register(user);
+		if (is_free_reg(allowed, reg, width))
+			return reg;
+	}
+	return NULL;
+}
+
+static arch_register_t const *get_free_reg(ir_node *const value,
+                                           arch_register_req_t const *const req,
+                                           unsigned const *const allowed)
+{
+	/* if the result does not get the register of its should_be_same input,
+	 * a copy of that input is placed in the result register before the node,
+	 * so it should not be the register of another operand */
+	unsigned const  width        = req->width;
+	unsigned *const operand_regs = rbitset_alloca(n_regs);
+	if (req->should_be_same != 0) {
+		ir_node *const node = skip_Proj(value);
+		foreach_irn_in(node, i, op) {
+			arch_register_t const *const reg = arch_get_irn_register(op);
+			if (reg != NULL && reg->cls == cls
+			 && !rbitset_is_set(&req->should_be_same, i))
+				rbitset_set(operand_regs, reg->index);
+		}
+	}
+
+	for (unsigned r = 0; r < n_regs; r += width) {
+		if (is_free(allowed, r, width) && !rbitset_is_set(operand_regs, r))
+			return arch_register_for_index(cls, r);
+	}
+	/* the backend can still swap the operands of commutative nodes */
+	for (unsigned r = 0; r < n_regs; r += width) {
+		if (is_free(allowed, r, width))
+			return arch_register_for_index(cls, r);
+	}
+	/* the common reason to hit this panic is when 1 of your nodes is not
+	 * register pressure faithful */
+	panic("no register left for %+F", value);
+}
+
+static void assign(ir_node *const value)
+{
+	interval_t                *const it  = intervals[get_irn_idx(value)];
+	arch_register_req_t const *const req = arch_get_irn_register_req(value);
+	arch_register_t const     *reg       = arch_get_irn_register(value);
+	if (reg != NULL) {
+		/* set_occupied() checks that the register is free */
+		DB((dbg, LEVEL_2, "Preassignment %+F -> %s\n", value, reg->name));
+	} else {
+		assert(!req->ignore);
+		unsigned const *const allowed = req->limited != NULL
+			? req->limited : constr_env.allocatable_regs->data;
+		reg = get_hint(value, req, allowed);
+		if (reg == NULL)
+			reg = get_free_reg(value, req, allowed);
+		arch_set_irn_register(value, reg);
+		DB((dbg, LEVEL_2, "Assign %+F -> %s\n", value, reg->name));
+	}
+
+	it->reg   = reg->index;
+	it->width = req->width;
+	set_occupied(it, true);
+	ARR_APP1(interval_t*, active, it);
+}
+
+/**
+ * Assign the results of @p node, which start at @p pos.  Preassigned results
+ * go first, so their registers are not taken by the others.
+ */
+static void assign_results(ir_node *const node, unsigned const pos)
+{
+	bool advanced = false;
+	for (int preassigned = 1; preassigned >= 0; --preassigned) {
+		be_foreach_definition(node, cls, value, req,
+			if ((arch_get_irn_register(value) != NULL) != preassigned)
+				continue;
+			if (!advanced) {
+				advance(pos);
+				advanced = true;
+			}
+			assign(value);
+		);
+	}
+}
+
+static void scan(void)
+{
+	active   = NEW_ARR_F(interval_t*, 0);
+	inactive = NEW_ARR_F(interval_t*, 0);
+	occupied = rbitset_malloc(n_regs);
+
+	for (size_t i = 0, n = ARR_LEN(blocks); i < n; ++i) {
+		ir_node *const block = blocks[i];
+		unsigned       pos   = block_pos[i];
+
+		advance(pos);
+		sched_foreach_phi(block, phi) {
+			if (arch_irn_consider_in_reg_alloc(cls, phi))
+				assign(phi);
+		}
+
+		sched_foreach_non_phi(block, node) {
+			pos += 2;
+			assign_results(node, pos + 1);
+		}
+	}
+
+	free(occupied);
+	DEL_ARR_F(inactive);
+	DEL_ARR_F(active);
+}
+
+static void linear_scan_cls(void)
+{
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+	be_assure_live_sets(irg);
+
+	be_timer_push(T_RA_CONSTR);
+	dom_tree_walk_irg(irg, handle_constraints, NULL, &constr_env);
+	be_timer_pop(T_RA_CONSTR);
+
+	be_timer_push(T_RA_COLOR);
+	number_instructions();
+	intervals = XMALLOCNZ(interval_t*, get_irg_last_idx(irg));
+	build_intervals();
+	scan();
+	free(intervals);
+	free(block_pos);
+	be_timer_pop(T_RA_COLOR);
+
+	be_dump(DUMP_RA, irg, "linearscan");
+
+	be_timer_push(T_RA_SSA);
+	be_ssa_destruction(irg, cls);
+	be_timer_pop(T_RA_SSA);
+}
+
+/**
+ * The linear scan register allocator for a whole procedure.
+ */
+static void be_linear_scan(ir_graph *new_irg, const regalloc_if_t *regif)
+{
+	/* disable optimization callbacks as we cannot deal with same-input phis
+	 * getting optimized away. */
+	int last_opt_state = get_optimize();
+	set_optimize(0);
+
+	irg = new_irg;
+	obstack_init(&constr_env.obst);
+	constr_env.irg          = irg;
+	constr_env.border_heads = NULL;
+	constr_env.ifg          = NULL;
+
+	be_spill_prepare_for_constraints(irg);
+	determine_block_order();
+
+	arch_register_class_t const *const reg_classes = isa_if->register_classes;
+	for (int c = 0, n_cls = isa_if->n_register_classes; c < n_cls; ++c) {
+		cls = &reg_classes[c];
+		if (cls->manual_ra)
+			continue;
+
+		stat_ev_ctx_push_str("regcls", cls->name);
+
+		n_regs                      = cls->n_regs;
+		constr_env.cls              = cls;
+		constr_env.allocatable_regs = bitset_malloc(n_regs);
+		be_get_allocatable_regs(irg, cls, constr_env.allocatable_regs->data);
+
+		be_timer_push(T_RA_SPILL);
+		be_do_spill(irg, cls, regif);
+		be_timer_pop(T_RA_SPILL);
+
+		be_timer_push(T_RA_SPILL_APPLY);
+		check_for_memory_operands(irg, regif);
+		be_timer_pop(T_RA_SPILL_APPLY);
+
+		be_dump(DUMP_RA, irg, "spill");
+
+		/* verify schedule and register pressure */
+		if (be_options.do_verify) {
+			be_timer_push(T_VERIFY);
+			bool check_schedule = be_verify_schedule(irg);
+			be_check_verify_result(check_schedule, irg);
+			bool check_pressure = be_verify_register_pressure(irg, cls);
+			be_check_verify_result(check_pressure, irg);
+			be_timer_pop(T_VERIFY);
+		}
+
+		linear_scan_cls();
+
+		free(constr_env.allocatable_regs);
+		obstack_free(&constr_env.obst, NULL);
+		obstack_init(&constr_env.obst);
+
+		stat_ev_ctx_pop("regcls");
+	}
+
+	be_timer_push(T_RA_EPILOG);
+	lower_nodes_after_ra(irg, false);
+	be_invalidate_live_sets(irg);
+	be_timer_pop(T_RA_EPILOG);
+
+	DEL_ARR_F(blocks);
+	obstack_free(&constr_env.obst, NULL);
+
+	set_optimize(last_opt_state);
+}
+
+BE_REGISTER_MODULE_CONSTRUCTOR(be_init_linear_scan)
+void be_init_linear_scan(void)
+{
+	be_register_allocator("linear", be_linear_scan);
+	FIRM_DBG_REGISTER(dbg, "firm.be.linearscan");
+}
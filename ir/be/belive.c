@@ -18,6 +18,11 @@
 #include "irprintf.h"
 #include "irdump_t.h"
 #include "irnodeset.h"
+#include "irtools.h"
+#include "util.h"
+#include "xmalloc.h"
+#include "lc_opts.h"
+#include "lc_opts_enum.h"
 
 #include "statev_t.h"
 #include "be_t.h"
@@ -30,6 +35,28 @@ DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
 
 #define LV_STD_SIZE             63
 
+typedef enum lv_sets_repr_t {
+	LV_SETS_SORTED, /**< sorted arrays only, queries use binary search */
+	LV_SETS_DENSE,  /**< additional bitsets indexed by node index */
+} lv_sets_repr_t;
+
+static int lv_sets_repr = LV_SETS_SORTED;
+
+static const lc_opt_enum_int_items_t lv_sets_items[] = {
+	{ "sorted", LV_SETS_SORTED },
+	{ "dense",  LV_SETS_DENSE  },
+	{ NULL, 0 }
+};
+
+static lc_opt_enum_int_var_t lv_sets_var = {
+	&lv_sets_repr, lv_sets_items
+};
+
+static const lc_opt_table_entry_t be_live_options[] = {
+	LC_OPT_ENT_ENUM_INT("livesets", "representation of the live sets", &lv_sets_var),
+	LC_OPT_LAST
+};
+
 static unsigned _be_liveness_bsearch(be_lv_info_t const *const arr, ir_node const *const node)
 {
 	unsigned const n = arr->n_members;
@@ -80,8 +107,49 @@ be_lv_info_node_t *be_lv_get(const be_lv_t *li, const ir_node *bl,
 	return res;
 }
 
+/**
+ * Makes the dense bitsets of a block cover node index @p idx.  The bitsets
+ * grow geometrically, as passes often add nodes one at a time.
+ */
+static void lv_grow_dense(be_lv_t const *const li, be_lv_info_t *const info,
+                          unsigned const idx)
+{
+	unsigned const old_n = info->n_states;
+	if (idx < old_n)
+		return;
+
+	/* Initially make room for all nodes of the graph. */
+	unsigned const n         = old_n == 0
+	                         ? MAX(idx + 1, get_irg_last_idx(li->irg))
+	                         : MAX(idx + 1, 2 * old_n);
+	size_t   const old_words = BITSET_SIZE_ELEMS(old_n) * 3;
+	size_t   const words     = BITSET_SIZE_ELEMS(n) * 3;
+	unsigned      *states    = XREALLOC(info->states, unsigned, words);
+	memset(&states[old_words], 0, (words - old_words) * sizeof(*states));
+	info->states   = states;
+	info->n_states = BITSET_SIZE_ELEMS(n) * BITS_PER_ELEM;
+}
+
+/**
+ * Adds liveness states of a node in a block.
+ */
+static void lv_add_state(be_lv_info_t *const info, be_lv_info_node_t *const n,
+                         be_lv_state_t const state)
+{
+	n->flags |= state;
+	if (info->states != NULL) {
+		unsigned  const idx   = get_irn_idx(n->node);
+		unsigned *const words = &info->states[idx / BITS_PER_ELEM * 3];
+		for (unsigned i = 0; i < 3; ++i) {
+			if (state & (1u << i))
+				rbitset_set(&words[i], idx % BITS_PER_ELEM);
+		}
+	}
+}
+
 static be_lv_info_node_t *be_lv_get_or_set(be_lv_t *li, ir_node *bl,
-                                           ir_node *irn)
+                                           ir_node *irn,
+                                           be_lv_info_t **const info)
 {
 	assert(get_irn_mode(irn) != mode_T);
 
@@ -91,6 +159,8 @@ static be_lv_info_node_t *be_lv_get_or_set(be_lv_t *li, ir_node *bl,
 		irn_live->n_size = LV_STD_SIZE;
 		ir_nodehashmap_insert(&li->map, bl, irn_live);
 	}
+	if (li->dense)
+		lv_grow_dense(li, irn_live, get_irn_idx(irn));
 
 	/* Get the position of the index in the array. */
 	unsigned pos = _be_liveness_bsearch(irn_live, irn);
@@ -123,30 +193,26 @@ static be_lv_info_node_t *be_lv_get_or_set(be_lv_t *li, ir_node *bl,
 		res->flags = 0;
 	}
 
+	*info = irn_live;
 	return res;
 }
 
-typedef struct lv_remove_walker_t {
-	be_lv_t       *lv;
-	ir_node const *irn;
-} lv_remove_walker_t;
-
 /**
  * Removes a node from the list of live variables of a block.
+ * @return true if the node was live in the block
  */
-static void lv_remove_irn_walker(ir_node *const bl, void *const data)
+static bool lv_remove_irn(be_lv_t *const lv, ir_node const *const bl,
+                          ir_node const *const irn)
 {
-	lv_remove_walker_t *const w        = (lv_remove_walker_t*)data;
-	be_lv_info_t       *const irn_live = ir_nodehashmap_get(be_lv_info_t, &w->lv->map, bl);
+	be_lv_info_t *const irn_live = ir_nodehashmap_get(be_lv_info_t, &lv->map, bl);
 	if (irn_live == NULL)
-		return;
+		return false;
 
 	unsigned           const n   = irn_live->n_members;
-	ir_node     const *const irn = w->irn;
 	unsigned           const pos = _be_liveness_bsearch(irn_live, irn);
 	be_lv_info_node_t *const res = &irn_live->nodes[pos];
 	if (res->node != irn)
-		return;
+		return false;
 
 	/* The node is indeed in the block's array. Let's remove it. */
 	for (unsigned i = pos + 1; i < n; ++i)
@@ -156,7 +222,14 @@ static void lv_remove_irn_walker(ir_node *const bl, void *const data)
 	irn_live->nodes[n - 1].flags = 0;
 
 	--irn_live->n_members;
+	if (irn_live->states != NULL) {
+		unsigned  const idx   = get_irn_idx(irn);
+		unsigned *const words = &irn_live->states[idx / BITS_PER_ELEM * 3];
+		for (unsigned i = 0; i < 3; ++i)
+			rbitset_clear(&words[i], idx % BITS_PER_ELEM);
+	}
 	DBG((dbg, LEVEL_3, "\tdeleting %+F from %+F at pos %d\n", irn, bl, pos));
+	return true;
 }
 
 static struct {
@@ -174,13 +247,14 @@ static struct {
  */
 static void live_end_at_block(ir_node *const block, be_lv_state_t const state)
 {
-	be_lv_info_node_t *const n      = be_lv_get_or_set(re.lv, block, re.def);
+	be_lv_info_t            *info;
+	be_lv_info_node_t *const n      = be_lv_get_or_set(re.lv, block, re.def, &info);
 	be_lv_state_t      const before = n->flags;
 
 	assert(state == be_lv_state_end || state == (be_lv_state_end | be_lv_state_out));
 	DBG((dbg, LEVEL_2, "marking %+F live %s at %+F\n", re.def,
 	     state & be_lv_state_out ? "end+out" : "end", block));
-	n->flags |= state;
+	lv_add_state(info, n, state);
 
 	/* There is no need to recurse further, if we where here before (i.e., any
 	 * live state bits were set before). */
@@ -192,7 +266,7 @@ static void live_end_at_block(ir_node *const block, be_lv_state_t const state)
 		return;
 
 	DBG((dbg, LEVEL_2, "marking %+F live in at %+F\n", re.def, block));
-	n->flags |= be_lv_state_in;
+	lv_add_state(info, n, be_lv_state_in);
 
 	for (unsigned i = get_Block_n_cfgpreds(block); i-- > 0;) {
 		ir_node *const pred_block = get_Block_cfgpred_block(block, i);
@@ -235,9 +309,10 @@ static void liveness_for_node(ir_node *irn)
 		} else if (def_block != use_block) {
 			/* Else, the value is live in at this block. Mark it and call live
 			 * out on the predecessors. */
-			be_lv_info_node_t *const n = be_lv_get_or_set(re.lv, use_block, irn);
+			be_lv_info_t            *info;
+			be_lv_info_node_t *const n = be_lv_get_or_set(re.lv, use_block, irn, &info);
 			DBG((dbg, LEVEL_2, "marking %+F live in at %+F\n", irn, use_block));
-			n->flags |= be_lv_state_in;
+			lv_add_state(info, n, be_lv_state_in);
 
 			for (unsigned i = get_Block_n_cfgpreds(use_block); i-- > 0; ) {
 				ir_node *pred_block = get_Block_cfgpred_block(use_block, i);
@@ -299,6 +374,14 @@ void be_liveness_invalidate_sets(be_lv_t *lv)
 {
 	if (!lv->sets_valid)
 		return;
+	if (lv->dense) {
+		ir_nodehashmap_entry_t    entry;
+		ir_nodehashmap_iterator_t iter;
+		foreach_ir_nodehashmap(&lv->map, entry, iter) {
+			be_lv_info_t *const info = (be_lv_info_t*)entry.data;
+			free(info->states);
+		}
+	}
 	obstack_free(&lv->obst, NULL);
 	ir_nodehashmap_destroy(&lv->map);
 	lv->sets_valid = false;
@@ -317,7 +400,9 @@ void be_liveness_invalidate_chk(be_lv_t *lv)
 be_lv_t *be_liveness_new(ir_graph *irg)
 {
 	be_lv_t *lv = XMALLOCZ(be_lv_t);
-	lv->irg = irg;
+	lv->irg      = irg;
+	lv->worklist = NEW_ARR_F(ir_node*, 0);
+	lv->dense    = lv_sets_repr == LV_SETS_DENSE;
 	return lv;
 }
 
@@ -325,6 +410,7 @@ void be_liveness_free(be_lv_t *lv)
 {
 	be_liveness_invalidate_sets(lv);
 	be_liveness_invalidate_chk(lv);
+	DEL_ARR_F(lv->worklist);
 	free(lv);
 }
 
@@ -333,10 +419,26 @@ void be_liveness_remove(be_lv_t *lv, const ir_node *irn)
 	assert(lv->sets_valid);
 
 	/* Removes a single irn from the liveness information.
-	 * Since an irn can only be live at blocks dominated by the block of its
-	 * definition, we only have to process that dominance subtree. */
-	lv_remove_walker_t w = { lv, irn };
-	dom_tree_walk(get_nodes_block(irn), lv_remove_irn_walker, NULL, &w);
+	 * The blocks an irn is live in form a connected region around the block
+	 * of its definition: Every other block of the region has the irn live
+	 * in, so it is live at the end of all predecessors. Thus it suffices to
+	 * follow the control flow from the definition as long as the irn is
+	 * found, instead of visiting everything the definition dominates. */
+	ir_node *const def_bl = get_nodes_block(irn);
+	if (!lv_remove_irn(lv, def_bl, irn))
+		return;
+
+	ARR_APP1(ir_node*, lv->worklist, def_bl);
+	while (ARR_LEN(lv->worklist) > 0) {
+		size_t   const n  = ARR_LEN(lv->worklist) - 1;
+		ir_node *const bl = lv->worklist[n];
+		ARR_SHRINKLEN(lv->worklist, n);
+		foreach_block_succ(bl, edge) {
+			ir_node *const succ = get_edge_src_irn(edge);
+			if (lv_remove_irn(lv, succ, irn))
+				ARR_APP1(ir_node*, lv->worklist, succ);
+		}
+	}
 }
 
 void be_liveness_introduce(be_lv_t *lv, ir_node *irn)
@@ -565,5 +667,8 @@ BE_REGISTER_MODULE_CONSTRUCTOR(be_init_live)
 void be_init_live(void)
 {
 	(void)be_live_chk_compare;
+	lc_opt_entry_t *be_grp = lc_opt_get_grp(firm_opt_get_root(), "be");
+	lc_opt_add_table(be_grp, be_live_options);
+
 	FIRM_DBG_REGISTER(dbg, "firm.be.liveness");
 }
@@ -17,6 +17,7 @@
 #include "irnodehashmap.h"
 #include "irlivechk.h"
 #include "bearch.h"
+#include "raw_bitset.h"
 
 typedef enum be_lv_state_t {
 	be_lv_state_none = 0,
@@ -135,6 +136,8 @@ struct be_lv_t {
 	bool             sets_valid;
 	ir_graph        *irg;
 	lv_chk_t        *lvc;
+	ir_node        **worklist; /**< scratch space of be_liveness_remove() */
+	bool             dense;    /**< answer queries from dense bitsets */
 };
 
 typedef struct be_lv_info_node_t be_lv_info_node_t;
@@ -146,15 +149,42 @@ struct be_lv_info_node_t {
 struct be_lv_info_t {
 	unsigned          n_members;
 	unsigned          n_size;
+	/** Number of node indices covered by @c states. */
+	unsigned          n_states;
+	/** The liveness states indexed by node index, NULL if the sets are not
+	 * dense. Each word of the in, end and out bitsets is followed by the
+	 * corresponding words of the other two. Allocated with xmalloc, as it
+	 * grows while nodes are added. */
+	unsigned         *states;
 	be_lv_info_node_t nodes[];
 };
 
 be_lv_info_node_t *be_lv_get(const be_lv_t *li, const ir_node *block,
                              const ir_node *irn);
 
+/**
+ * Returns the liveness state of the node with index @p idx from the dense
+ * bitsets of a block.
+ */
+static inline be_lv_state_t be_lv_get_dense(be_lv_info_t const *const info,
+                                            unsigned const idx)
+{
+	if (idx >= info->n_states)
+		return be_lv_state_none;
+	unsigned const *const words = &info->states[idx / BITS_PER_ELEM * 3];
+	unsigned const        bit   = idx % BITS_PER_ELEM;
+	return (be_lv_state_t)(((words[0] >> bit) & 1)
+	                     | ((words[1] >> bit) & 1) << 1
+	                     | ((words[2] >> bit) & 1) << 2);
+}
+
 static inline be_lv_state_t be_get_live_state(be_lv_t const *const li, ir_node const *const block, ir_node const *const irn)
 {
 	if (li->sets_valid) {
+		if (li->dense) {
+			be_lv_info_t const *const info = ir_nodehashmap_get(be_lv_info_t, &li->map, block);
+			return info ? be_lv_get_dense(info, get_irn_idx(irn)) : be_lv_state_none;
+		}
 		be_lv_info_node_t *info = be_lv_get(li, block, irn);
 		return info ? info->flags : be_lv_state_none;
 	} else {
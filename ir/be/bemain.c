@@ -34,6 +34,7 @@
 
 #include "be_t.h"
 #include "bediagnostic.h"
+#include "beelf.h"
 #include "begnuas.h"
 #include "bemodule.h"
 #include "beutil.h"
@@ -55,6 +56,8 @@
 
 static struct obstack obst;
 static be_main_env_t  env;
+/** be_finish() writes an ELF object instead of assembler */
+static bool           emit_elf;
 
 /* options visible for anyone */
 be_options_t be_options = {
@@ -66,6 +69,7 @@ be_options_t be_options = {
 	.do_verify            = true,
 	.ilp_solver           = "",
 	.verbose_asm          = true,
+	.graph_buffers        = false,
 	.pic_style            = BE_PIC_NONE,
 };
 
@@ -109,6 +113,7 @@ static const lc_opt_table_entry_t be_main_options[] = {
 	LC_OPT_ENT_BOOL     ("profilegenerate", "instrument the code for execution count profiling", &be_options.opt_profile_generate),
 	LC_OPT_ENT_BOOL     ("profileuse",      "use existing profile data",                         &be_options.opt_profile_use),
 	LC_OPT_ENT_BOOL     ("verboseasm", "enable verbose assembler output",                        &be_options.verbose_asm),
+	LC_OPT_ENT_BOOL     ("graphbuffers", "emit each graph into its own buffer",                  &be_options.graph_buffers),
 
 	LC_OPT_ENT_STR("ilp.solver", "the ilp solver name", &be_options.ilp_solver),
 	LC_OPT_LAST
@@ -353,7 +358,7 @@ static ir_graph *be_prepare_profile(const char *const cup_name)
 	return prof_init_irg;
 }
 
-void be_begin(FILE *file_handle, const char *cup_name)
+static void begin(FILE *file_handle, const char *cup_name)
 {
 	memset(be_asm_constraint_flags, 0, sizeof(be_asm_constraint_flags));
 
@@ -421,10 +426,23 @@ void be_begin(FILE *file_handle, const char *cup_name)
 	ir_graph *prof_init_irg = be_prepare_profile(cup_name);
 	if (prof_init_irg != NULL)
 		initialize_birg(&birgs[num_birgs++], prof_init_irg, &env);
+}
 
+void be_begin(FILE *file_handle, const char *cup_name)
+{
+	begin(file_handle, cup_name);
+	emit_elf = false;
 	be_gas_begin_compilation_unit(&env);
 }
 
+void be_begin_elf(FILE *file_handle, const char *cup_name,
+                  be_elf_target_t const *target)
+{
+	begin(file_handle, cup_name);
+	emit_elf = true;
+	be_elf_begin(file_handle, target);
+}
+
 void firm_be_finish(void)
 {
 	finish_isa();
@@ -475,7 +493,7 @@ float_int_conversion_overflow_style_t be_get_float_int_overflow(void)
 
 int be_timing;
 
-static const char *get_timer_name(be_timer_id_t id)
+char const *be_get_timer_name(be_timer_id_t id)
 {
 	switch (id) {
 	case T_ABI:            return "abi";
@@ -504,6 +522,26 @@ static const char *get_timer_name(be_timer_id_t id)
 	return "unknown";
 }
 ir_timer_t *be_timers[T_LAST+1];
+bool        be_timer_scoped[T_LAST+1];
+
+/** the graph compiled by the backend, whose scopes of the compile time
+ * profile record its node indices and memory */
+static ir_graph *timed_irg;
+
+bool be_timing_scope_begin(char const *const name)
+{
+	if (timed_irg != NULL)
+		return irg_timing_scope_begin(timed_irg, name);
+	return ir_timing_scope_begin(name, NULL, 0, 0);
+}
+
+void be_timing_scope_end(bool const begun)
+{
+	if (timed_irg != NULL)
+		irg_timing_scope_end(timed_irg, begun);
+	else if (begun)
+		ir_timing_scope_end(0, 0);
+}
 
 static void dummy_after_transform(ir_graph *irg, const char *name)
 {
@@ -532,7 +570,9 @@ void be_lower_for_target(void)
 {
 	initialize_isa();
 
+	bool const timed = be_timing_scope_begin("lower_for_target");
 	isa_if->lower_for_target();
+	be_timing_scope_end(timed);
 	/* set the phase to low */
 	foreach_irp_irg_r(i, irg) {
 		assert(!irg_is_constrained(irg, IR_GRAPH_CONSTRAINT_TARGET_LOWERED));
@@ -540,7 +580,8 @@ void be_lower_for_target(void)
 	}
 }
 
-static int cse_setting;
+static int  cse_setting;
+static bool backend_scoped;
 
 bool be_step_first(ir_graph *irg)
 {
@@ -548,13 +589,18 @@ bool be_step_first(ir_graph *irg)
 	if (get_entity_linkage(entity) & IR_LINKAGE_NO_CODEGEN)
 		return false;
 
+	timed_irg      = irg;
+	backend_scoped = be_timing_scope_begin("backend");
 	be_timer_push(T_OTHER);
 	if (stat_ev_enabled) {
 		stat_ev_ctx_push_fmt("bemain_irg", "%+F", irg);
 		stat_ev_ull("bemain_insns_start", be_count_insns(irg));
 		stat_ev_ull("bemain_blocks_start", be_count_blocks(irg));
 	}
+	be_irg_t *const birg = be_birg_from_irg(irg);
 	cse_setting = get_opt_cse();
+	if (be_options.graph_buffers)
+		be_emit_set_buffer(&birg->emit_buffer);
 	return true;
 }
 
@@ -596,6 +642,14 @@ void be_step_regalloc(ir_graph *irg, const regalloc_if_t *regif)
 
 void be_step_last(ir_graph *irg)
 {
+	/* graphs finish in program order, so the buffered text can be written
+	 * right away */
+	be_irg_t *const birg = be_birg_from_irg(irg);
+	if (be_options.graph_buffers) {
+		be_emit_set_buffer(NULL);
+		be_emit_flush_buffer(&birg->emit_buffer);
+	}
+
 	if (stat_ev_enabled) {
 		stat_ev_ull("bemain_insns_finish", be_count_insns(irg));
 		stat_ev_ull("bemain_blocks_finish", be_count_blocks(irg));
@@ -605,20 +659,22 @@ void be_step_last(ir_graph *irg)
 	be_regalloc_verify(irg);
 
 	be_timer_pop(T_OTHER);
+	be_timing_scope_end(backend_scoped);
+	timed_irg = NULL;
 
 	if (be_timing) {
 		if (stat_ev_enabled) {
 			for (be_timer_id_t t = T_FIRST; t < T_LAST+1; ++t) {
 				char buf[128];
 				snprintf(buf, sizeof(buf), "bemain_time_%s",
-				         get_timer_name(t));
+				         be_get_timer_name(t));
 				stat_ev_dbl(buf, ir_timer_elapsed_usec(be_timers[t]));
 			}
 		} else {
 			printf("==>> IRG %s <<==\n", get_entity_name(get_irg_entity(irg)));
 			for (be_timer_id_t t = T_FIRST; t < T_LAST+1; ++t) {
 				double val = ir_timer_elapsed_usec(be_timers[t]) / 1000.0;
-				printf("%-20s: %10.3f msec\n", get_timer_name(t), val);
+				printf("%-20s: %10.3f msec\n", be_get_timer_name(t), val);
 			}
 		}
 		for (be_timer_id_t t = T_FIRST; t < T_LAST+1; ++t) {
@@ -634,7 +690,11 @@ void be_step_last(ir_graph *irg)
 
 void be_finish(void)
 {
-	be_gas_end_compilation_unit(&env);
+	if (emit_elf) {
+		be_elf_finish();
+	} else {
+		be_gas_end_compilation_unit(&env);
+	}
 
 	if (be_options.timing) {
 		ir_timer_stop(bemain_timer);
@@ -668,23 +728,41 @@ void be_main(FILE *file_handle, const char *cup_name)
 
 ir_jit_function_t *be_jit_compile(ir_jit_segment_t *const segment,
                                   ir_graph *const irg)
+{
+	return be_jit_compile_tier(segment, irg, ir_jit_tier_optimize);
+}
+
+ir_jit_function_t *be_jit_compile_tier(ir_jit_segment_t *const segment,
+                                       ir_graph *const irg,
+                                       ir_jit_tier_t const tier)
 {
 	initialize_isa();
 	if (isa_if->jit_compile == NULL)
 		return NULL;
 
-	obstack_init(&obst);
-
 	ir_entity *entity = get_irg_entity(irg);
 	if (get_entity_linkage(entity) & IR_LINKAGE_NO_CODEGEN)
 		return NULL;
+	timed_irg = irg;
+	bool const timed = irg_timing_scope_begin(irg, "jit_compile");
 	be_irg_t *const birg = OALLOCZ(&obst, be_irg_t);
 	initialize_birg(birg, irg, &env);
+	birg->fast_compile = tier == ir_jit_tier_fast;
 	if (isa_if->handle_intrinsics)
 		isa_if->handle_intrinsics(irg);
 	be_dump(DUMP_INITIAL, irg, "prepared");
 
-	return isa_if->jit_compile(segment, irg);
+	/* cheap compared to the backend and without it block placement and
+	 * spilling degrade badly, so both tiers estimate the frequencies */
+	be_timer_push(T_EXECFREQ);
+	ir_estimate_execfreq(irg);
+	be_timer_pop(T_EXECFREQ);
+
+	ir_jit_function_t *const function = isa_if->jit_compile(segment, irg);
+	/* the backend steps reset timed_irg, so end the scope of irg directly */
+	irg_timing_scope_end(irg, timed);
+	timed_irg = NULL;
+	return function;
 }
 
 void be_emit_function(char *const buffer, ir_jit_function_t *const function)
@@ -44,6 +44,7 @@ void be_init_copyopt(void);
 void be_init_daemelspill(void);
 void be_init_dwarf(void);
 void be_init_gas(void);
+void be_init_linear_scan(void);
 void be_init_listsched(void);
 void be_init_live(void);
 void be_init_loopana(void);
@@ -108,6 +109,7 @@ void be_init_modules(void)
 
 	be_init_chordal_main();
 	be_init_pref_alloc();
+	be_init_linear_scan();
 
 	be_init_chordal();
 	be_init_pbqp_coloring();
@@ -149,17 +151,12 @@ static bool set_opt_module(void *const data, size_t const length, char const *co
 	(void)length;
 
 	const module_opt_data_t *moddata = (module_opt_data_t*)data;
-	bool                     res     = false;
-	for (const be_module_list_entry_t *module = *(moddata->list_head);
-	     module != NULL; module = module->next) {
-		if (streq(module->name, opt)) {
-			*(moddata->var) = module->data;
-			res = true;
-			break;
-		}
-	}
+	void                    *module  = be_find_module(*moddata->list_head, opt);
+	if (module == NULL)
+		return false;
 
-	return res;
+	*(moddata->var) = module;
+	return true;
 }
 
 /**
@@ -219,6 +216,16 @@ void be_add_module_to_list(be_module_list_entry_t **list_head, const char *name,
 	*list_head  = entry;
 }
 
+void *be_find_module(be_module_list_entry_t const *list_head, char const *name)
+{
+	for (const be_module_list_entry_t *module = list_head; module != NULL;
+	     module = module->next) {
+		if (streq(module->name, name))
+			return module->data;
+	}
+	return NULL;
+}
+
 /**
  * Add an option for a module.
  */
@@ -9,6 +9,7 @@
  * @author      Sebastian Hack
  * @date        22.11.2004
  */
+#include "beirg.h"
 #include "bemodule.h"
 #include "bera.h"
 #include "irtools.h"
@@ -26,7 +27,10 @@ void be_register_allocator(const char *name, allocate_func allocator)
 
 void be_allocate_registers(ir_graph *irg, const regalloc_if_t *regif)
 {
-	selected_allocator(irg, regif);
+	allocate_func allocator = selected_allocator;
+	if (be_birg_from_irg(irg)->fast_compile)
+		allocator = (allocate_func)be_find_module(register_allocators, "linear");
+	allocator(irg, regif);
 }
 
 BE_REGISTER_MODULE_CONSTRUCTOR(be_init_ra)
@@ -50,7 +50,8 @@ struct regalloc_if_t {
 };
 
 /**
- * Do register allocation with currently selected register allocator
+ * Do register allocation with currently selected register allocator.
+ * Graphs compiled for jit tier 0 use the "linear" allocator.
  */
 void be_allocate_registers(ir_graph *irg, const regalloc_if_t *regif);
 
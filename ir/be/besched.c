@@ -15,6 +15,7 @@
 #include "ircons.h"
 #include "irgmod.h"
 
+#include "beirg.h"
 #include "bemodule.h"
 #include "besched.h"
 #include "belistsched.h"
@@ -155,7 +156,10 @@ void be_register_scheduler(const char *name, schedule_func func)
 
 void be_schedule_graph(ir_graph *irg)
 {
-	scheduler(irg);
+	schedule_func func = scheduler;
+	if (be_birg_from_irg(irg)->fast_compile)
+		func = (schedule_func)be_find_module(schedulers, "trivial");
+	func(irg);
 }
 
 BE_REGISTER_MODULE_CONSTRUCTOR(be_init_sched)
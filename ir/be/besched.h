@@ -243,6 +243,7 @@ void be_register_scheduler(const char *name, schedule_func func);
 
 /**
  * schedule a graph with the currently selected scheduler.
+ * Graphs compiled for jit tier 0 use the trivial scheduler.
  */
 void be_schedule_graph(ir_graph *irg);
 
@@ -8,7 +8,12 @@
  * @brief       Beladys spillalgorithm.
  * @author      Daniel Grund, Matthias Braun
  * @date        20.09.2005
+ *
+ * The "remat" variant chooses the values to evict with a cost model: it
+ * weighs the next use distance of a value against the execution frequency
+ * weighted costs of spilling and reloading or rematerializing it.
  */
+#include <math.h>
 #include <stdbool.h>
 
 #include "debug.h"
@@ -55,6 +60,7 @@ typedef struct loc_t {
 	ir_node          *node;
 	unsigned          time;     /**< A use time (see beuses.h). */
 	bool              spilled;  /**< value was already spilled on this path */
+	double            score;    /**< eviction priority of the cost model */
 } loc_t;
 
 typedef struct workset_t {
@@ -73,6 +79,8 @@ static be_uses_t                   *uses;   /**< env for the next-use magic */
 static spill_env_t                 *senv;   /**< see bespill.h */
 static ir_node                    **blocklist;
 static workset_t                   *temp_workset;
+static unsigned                     reload_cost;
+static bool                         cost_model; /**< evict by costs */
 
 static bool                         move_spills      = true;
 static bool                         respectloopdepth = true;
@@ -201,9 +209,28 @@ static int loc_compare(const void *a, const void *b)
 	return get_irn_node_nr(p->node) - get_irn_node_nr(q->node);
 }
 
+static int loc_compare_score(const void *a, const void *b)
+{
+	const loc_t *p = (const loc_t*)a;
+	const loc_t *q = (const loc_t*)b;
+
+	/* dead values go before everything else, even values without costs */
+	bool const p_dead = USES_IS_INFINITE(p->time);
+	bool const q_dead = USES_IS_INFINITE(q->time);
+	if (p_dead != q_dead)
+		return p_dead ? 1 : -1;
+	if (p->score < q->score)
+		return -1;
+	if (p->score > q->score)
+		return 1;
+
+	return get_irn_node_nr(p->node) - get_irn_node_nr(q->node);
+}
+
 static void workset_sort(workset_t *workset)
 {
-	QSORT(workset->vals, workset->len, loc_compare);
+	QSORT(workset->vals, workset->len, cost_model ? loc_compare_score
+	                                              : loc_compare);
 }
 
 static inline unsigned workset_get_time(const workset_t *workset, unsigned idx)
@@ -285,6 +312,51 @@ static unsigned get_distance(ir_node *from, const ir_node *def,
 	return time;
 }
 
+/**
+ * Computes the next use distance and the eviction priority of a value for the
+ * cost model.  The priority is the next use distance divided by the costs of
+ * evicting the value: reloading or rematerializing it before the next use and
+ * spilling it unless it is rematerialized or already spilled, all weighted by
+ * the execution frequencies.  Values with higher priority are evicted first,
+ * dead values before all others (see loc_compare_score()).
+ */
+static void compute_score(loc_t *const loc, ir_node *const from,
+                          bool const skip_from_uses)
+{
+	ir_node      *const def = loc->node;
+	be_next_use_t const use = be_get_next_use(uses, from, def, skip_from_uses);
+	if (USES_IS_INFINITE(use.time)) {
+		loc->time  = USES_INFINITY;
+		loc->score = HUGE_VAL;
+		return;
+	}
+
+	/* We have to keep nonspillable nodes in the workingset */
+	if (arch_get_irn_flags(skip_Proj_const(def)) & arch_irn_flag_dont_spill) {
+		loc->time  = 0;
+		loc->score = 0;
+		return;
+	}
+
+	/* a Phi argument is reloaded at the end of the predecessor block */
+	ir_node *before = (ir_node*)use.before;
+	if (before == NULL)
+		before = from;
+	else if (is_Block(before))
+		before = sched_last(before);
+
+	double costs = be_get_reload_costs(senv, def, before);
+	if (!loc->spilled
+	    && be_get_reload_costs_no_weight(senv, def, before) >= reload_cost) {
+		ir_node *const spill_pos = move_spills ? from : skip_Proj(def);
+		costs += be_get_spill_costs(senv, def, spill_pos);
+	}
+	/* free rematerialization or a block frequency of 0 give costs of 0 */
+	loc->time  = use.time;
+	loc->score = costs > 0 ? use.time / costs
+	                       : (use.time == 0 ? 0 : HUGE_VAL);
+}
+
 /**
  * Performs the actions necessary to grant the request that:
  * - new_vals can be held in registers
@@ -337,12 +409,16 @@ static void displace(workset_t *const new_vals, bool const is_usage,
 
 		/* calculate current next-use distance for live values */
 		for (unsigned i = 0; i < len; ++i) {
+			if (cost_model) {
+				compute_score(&ws->vals[i], instr, !is_usage);
+				continue;
+			}
 			ir_node  *val  = workset_get_val(ws, i);
 			unsigned  dist = get_distance(instr, val, !is_usage);
 			workset_set_time(ws, i, dist);
 		}
 
-		/* sort entries by increasing nextuse-distance*/
+		/* sort entries by increasing nextuse-distance or eviction priority */
 		workset_sort(ws);
 
 		for (int i = len - spills_needed; i < (int)len; ++i) {
@@ -831,8 +907,8 @@ static void fix_block_borders(ir_node *block, void *data)
 	}
 }
 
-static void be_spill_belady(ir_graph *irg, const arch_register_class_t *rcls,
-							const regalloc_if_t *regif)
+static void spill_belady(ir_graph *irg, const arch_register_class_t *rcls,
+                         const regalloc_if_t *regif, bool use_cost_model)
 {
 	be_assure_live_sets(irg);
 
@@ -857,6 +933,8 @@ static void be_spill_belady(ir_graph *irg, const arch_register_class_t *rcls,
 	senv         = be_new_spill_env(irg, regif);
 	blocklist    = be_get_cfgpostorder(irg);
 	temp_workset = new_workset();
+	reload_cost  = regif->reload_cost;
+	cost_model   = use_cost_model;
 	stat_ev_tim_pop("belady_time_init");
 
 	stat_ev_tim_push();
@@ -885,6 +963,18 @@ static void be_spill_belady(ir_graph *irg, const arch_register_class_t *rcls,
 	obstack_free(&obst, NULL);
 }
 
+static void be_spill_belady(ir_graph *irg, const arch_register_class_t *rcls,
+                            const regalloc_if_t *regif)
+{
+	spill_belady(irg, rcls, regif, false);
+}
+
+static void be_spill_remat(ir_graph *irg, const arch_register_class_t *rcls,
+                           const regalloc_if_t *regif)
+{
+	spill_belady(irg, rcls, regif, true);
+}
+
 BE_REGISTER_MODULE_CONSTRUCTOR(be_init_spillbelady)
 void be_init_spillbelady(void)
 {
@@ -893,5 +983,6 @@ void be_init_spillbelady(void)
 	lc_opt_add_table(belady_group, options);
 
 	be_register_spiller("belady", be_spill_belady);
+	be_register_spiller("remat", be_spill_remat);
 	FIRM_DBG_REGISTER(dbg, "firm.be.spill.belady");
 }
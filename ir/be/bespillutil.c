@@ -34,6 +34,7 @@
 #include "irgmod.h"
 #include "irgwalk.h"
 #include "irnodehashmap.h"
+#include "irnodeset.h"
 #include "irnode_t.h"
 #include "statev_t.h"
 #include "type_t.h"
@@ -77,6 +78,7 @@ struct spill_info_t {
 struct spill_env_t {
 	ir_graph         *irg;
 	ir_nodehashmap_t  spillmap;
+	ir_nodeset_t      changed; /**< nodes whose liveness has to be updated */
 	spill_info_t     *spills;
 	spill_info_t     *mem_phis;
 	struct obstack    obst;
@@ -113,6 +115,7 @@ spill_env_t *be_new_spill_env(ir_graph *irg, const regalloc_if_t *regif)
 	env->irg         = irg;
 	env->regif       = *regif;
 	ir_nodehashmap_init(&env->spillmap);
+	ir_nodeset_init(&env->changed);
 	obstack_init(&env->obst);
 	return env;
 }
@@ -120,6 +123,7 @@ spill_env_t *be_new_spill_env(ir_graph *irg, const regalloc_if_t *regif)
 void be_delete_spill_env(spill_env_t *env)
 {
 	ir_nodehashmap_destroy(&env->spillmap);
+	ir_nodeset_destroy(&env->changed);
 	obstack_free(&env->obst, NULL);
 	free(env);
 }
@@ -237,6 +241,29 @@ void be_spill_phi(spill_env_t *const env, ir_node *const phi)
 
 static void determine_spill_costs(spill_env_t *env, spill_info_t *spillinfo);
 
+/**
+ * Remembers a newly created node for the liveness update: Its own liveness is
+ * unknown and its operands gained a new user.
+ */
+static void mark_changed(spill_env_t *env, ir_node *node)
+{
+	ir_nodeset_insert(&env->changed, node);
+	foreach_irn_in(skip_Proj(node), i, op) {
+		ir_nodeset_insert(&env->changed, op);
+	}
+}
+
+/**
+ * Remembers the Phis created by an SSA reconstruction for the liveness
+ * update.
+ */
+static void mark_changed_phis(spill_env_t *env, be_ssa_construction_env_t *senv)
+{
+	ir_node **const phis = be_ssa_construction_get_new_phis(senv);
+	for (size_t i = 0, n = ARR_LEN(phis); i < n; ++i)
+		mark_changed(env, phis[i]);
+}
+
 /**
  * Creates a spill.
  *
@@ -256,6 +283,7 @@ static void spill_irn(spill_env_t *env, spill_info_t *spillinfo)
 	     spill = spill->next) {
 		ir_node *const after = be_move_after_schedule_first(spill->after);
 		spill->spill = env->regif.new_spill(to_spill, after);
+		mark_changed(env, spill->spill);
 		DB((dbg, LEVEL_1, "\t%+F after %+F\n", spill->spill, after));
 		env->spill_count++;
 	}
@@ -304,6 +332,7 @@ static void spill_phi(spill_env_t *env, spill_info_t *spillinfo)
 		ins[i] = arg_info->spills->spill;
 	}
 	be_complete_Phi(phim, arity, ins);
+	mark_changed(env, phim);
 	DBG((dbg, LEVEL_1, "... done spilling Phi %+F, created PhiM %+F\n", phi, phim));
 }
 
@@ -425,6 +454,7 @@ static ir_node *do_remat(spill_env_t *env, ir_node *spilled, ir_node *reloader)
 	ir_node *const res = new_similar_node(spilled, bl, ins);
 	if (env->regif.mark_remat)
 		env->regif.mark_remat(res);
+	mark_changed(env, res);
 
 	DBG((dbg, LEVEL_1, "Insert remat %+F of %+F before reloader %+F\n", res,
 	     spilled, reloader));
@@ -554,6 +584,7 @@ void be_insert_spills_reloads(spill_env_t *env)
 		bool      force_remat     = false;
 
 		DBG((dbg, LEVEL_1, "\nhandling all reloaders of %+F:\n", to_spill));
+		ir_nodeset_insert(&env->changed, to_spill);
 
 		determine_spill_costs(env, si);
 
@@ -620,6 +651,7 @@ void be_insert_spills_reloads(spill_env_t *env)
 				assert(si->spills != NULL);
 				copy = env->regif.new_reload(si->to_spill, si->spills->spill,
 				                             rld->reloader);
+				mark_changed(env, copy);
 				env->reload_count++;
 			}
 
@@ -636,6 +668,7 @@ void be_insert_spills_reloads(spill_env_t *env)
 			be_ssa_construction_add_copy(&senv, to_spill);
 			be_ssa_construction_add_copies(&senv, copies, ARR_LEN(copies));
 			be_ssa_construction_fix_users(&senv, to_spill);
+			mark_changed_phis(env, &senv);
 			be_ssa_construction_destroy(&senv);
 		}
 		/* need to reconstruct SSA form if we had multiple spills */
@@ -654,6 +687,7 @@ void be_insert_spills_reloads(spill_env_t *env)
 			if (spill_count > 1) {
 				/* all reloads are attached to the first spill, fix them now */
 				be_ssa_construction_fix_users(&senv, si->spills->spill);
+				mark_changed_phis(env, &senv);
 			}
 
 			be_ssa_construction_destroy(&senv);
@@ -668,12 +702,18 @@ void be_insert_spills_reloads(spill_env_t *env)
 	stat_ev_dbl("spill_remats", env->remat_count);
 	stat_ev_dbl("spill_spilled_phis", env->spilled_phi_count);
 
-	/* Matze: In theory be_ssa_construction should take care of the liveness...
-	 * try to disable this again in the future */
-	be_invalidate_live_sets(env->irg);
-
 	be_remove_dead_nodes_from_schedule(env->irg);
 
+	/* Only the live ranges of the spilled values and of the nodes created
+	 * for them changed, so update these instead of recomputing everything. */
+	be_lv_t *const lv = be_get_irg_liveness(env->irg);
+	if (lv->sets_valid) {
+		foreach_ir_nodeset(&env->changed, node, iter) {
+			if (!is_Deleted(node))
+				be_liveness_update(lv, node);
+		}
+	}
+
 	be_timer_pop(T_RA_SPILL_APPLY);
 }
 
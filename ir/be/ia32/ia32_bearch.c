@@ -1119,7 +1119,8 @@ static void ia32_before_emit(ir_graph *irg)
 	be_dump(DUMP_RA, irg, "x87");
 
 	/* do peephole optimizations */
-	ia32_peephole_optimization(irg);
+	if (!be_birg_from_irg(irg)->fast_compile)
+		ia32_peephole_optimization(irg);
 
 	be_remove_dead_nodes_from_schedule(irg);
 }
@@ -26,7 +26,6 @@
  *   pnc_Uge => P || AE
  *   pnc_Ne  => P || NE
  */
-#include <inttypes.h>
 #include <dlfcn.h>
 
 #include "be_t.h"
@@ -608,20 +607,20 @@ emit_S:
 			case 'u':
 				if (mod & EMIT_LONG) {
 					unsigned long num = va_arg(ap, unsigned long);
-					be_emit_irprintf("%lu", num);
+					be_emit_uint(num);
 				} else {
 					unsigned num = va_arg(ap, unsigned);
-					be_emit_irprintf("%u", num);
+					be_emit_uint(num);
 				}
 				break;
 
 			case 'd':
 				if (mod & EMIT_LONG) {
 					long num = va_arg(ap, long);
-					be_emit_irprintf("%ld", num);
+					be_emit_int(num);
 				} else {
 					int num = va_arg(ap, int);
-					be_emit_irprintf("%d", num);
+					be_emit_int(num);
 				}
 				break;
 
@@ -1578,7 +1577,9 @@ static unsigned emit_jit_entity_relocation_asm(char *const buffer,
 	(void)buffer;
 	assert(buffer == NULL);
 	if (be_kind == IA32_RELOCATION_RELJUMP) {
-		be_emit_irprintf("\t.long %"PRId32"\n", offset);
+		be_emit_cstring("\t.long ");
+		be_emit_int(offset);
+		be_emit_char('\n');
 		be_emit_write_line();
 		return 4;
 	}
@@ -1593,7 +1594,7 @@ static unsigned emit_jit_entity_relocation_asm(char *const buffer,
 	}
 	x86_emit_relocation_no_offset(be_kind, entity);
 	if (offset != 0)
-		be_emit_irprintf("%+"PRId32, offset);
+		be_emit_offset(offset);
 	be_emit_char('\n');
 	be_emit_write_line();
 	return res;
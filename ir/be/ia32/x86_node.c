@@ -156,10 +156,10 @@ void x86_emit_imm32(x86_imm32_t const *const imm)
 	int32_t              const offset = imm->offset;
 	if (kind == X86_IMM_VALUE) {
 		assert(imm->entity == NULL);
-		be_emit_irprintf("%"PRId32, (uint32_t)offset);
+		be_emit_int(offset);
 	} else {
 		x86_emit_relocation_no_offset(kind, imm->entity);
 		if (offset != 0)
-			be_emit_irprintf("%+"PRId32, offset);
+			be_emit_offset(offset);
 	}
 }
@@ -8,8 +8,6 @@
  * @brief   emit assembler for a backend graph
  * @author  Hannes Rapp, Matthias Braun
  */
-#include <inttypes.h>
-
 #include "beasm.h"
 #include "beblocksched.h"
 #include "bediagnostic.h"
@@ -58,7 +56,7 @@ static void sparc_emit_indent(void)
 static void sparc_emit_immediate(int32_t value, ir_entity *entity)
 {
 	if (entity == NULL) {
-		be_emit_irprintf("%"PRId32, value);
+		be_emit_int(value);
 	} else {
 		if (is_tls_entity(entity)) {
 			be_emit_cstring("%tle_lox10(");
@@ -67,7 +65,7 @@ static void sparc_emit_immediate(int32_t value, ir_entity *entity)
 		}
 		be_gas_emit_entity(entity);
 		if (value != 0) {
-			be_emit_irprintf("%+"PRId32, value);
+			be_emit_offset(value);
 		}
 		be_emit_char(')');
 	}
@@ -89,7 +87,7 @@ static void sparc_emit_high_immediate(ir_node const *node)
 		}
 		be_gas_emit_entity(entity);
 		if (attr->immediate_value != 0) {
-			be_emit_irprintf("%+"PRId32, attr->immediate_value);
+			be_emit_offset(attr->immediate_value);
 		}
 		be_emit_char(')');
 	}
@@ -130,7 +128,7 @@ static void sparc_emit_offset(const ir_node *node, int offset_node_pos)
 		int32_t offset = attr->base.immediate_value;
 		if (offset != 0) {
 			assert(sparc_is_value_imm_encodeable(offset));
-			be_emit_irprintf("%+"PRId32, offset);
+			be_emit_offset(offset);
 		}
 	} else if (attr->base.immediate_value != 0
 	           || attr->base.immediate_value_entity != NULL) {
@@ -578,7 +576,10 @@ void sparc_emitf(ir_node const *const node, char const *fmt, ...)
 			sparc_attr_t const *const attr = get_sparc_attr_const(node);
 			be_gas_emit_entity(attr->immediate_value_entity);
 			if (attr->immediate_value != 0) {
-				be_emit_irprintf(plus ? "%+"PRId32 : "%"PRId32, attr->immediate_value);
+				if (plus)
+					be_emit_offset(attr->immediate_value);
+				else
+					be_emit_int(attr->immediate_value);
 			}
 			break;
 		}
@@ -652,7 +653,10 @@ void sparc_emitf(ir_node const *const node, char const *fmt, ...)
 
 		case 'd': {
 			int const num = va_arg(ap, int);
-			be_emit_irprintf(plus ? "%+d" : "%d", num);
+			if (plus)
+				be_emit_offset(num);
+			else
+				be_emit_int(num);
 			break;
 		}
 
@@ -664,13 +668,15 @@ void sparc_emitf(ir_node const *const node, char const *fmt, ...)
 
 		case 'u': {
 			unsigned const num = va_arg(ap, unsigned);
-			be_emit_irprintf(plus ? "%+u" : "%u", num);
+			if (plus)
+				be_emit_char('+');
+			be_emit_uint(num);
 			break;
 		}
 
 		case 'X': {
 			unsigned const num = va_arg(ap, unsigned);
-			be_emit_irprintf("%X", num);
+			be_emit_hex(num);
 			break;
 		}
 
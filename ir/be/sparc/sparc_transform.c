@@ -2064,6 +2064,10 @@ static ir_node *gen_Builtin(ir_node *node)
 		return gen_va_start(node);
 	case ir_bk_may_alias:
 	case ir_bk_va_arg:
+	case ir_bk_min:
+	case ir_bk_max:
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub:
 		break;
 	}
 	panic("Builtin %s not implemented", get_builtin_kind_name(kind));
@@ -2114,6 +2118,10 @@ static ir_node *gen_Proj_Builtin(ir_node *proj)
 		}
 	case ir_bk_may_alias:
 	case ir_bk_va_arg:
+	case ir_bk_min:
+	case ir_bk_max:
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub:
 		break;
 	}
 	panic("Builtin %s not implemented", get_builtin_kind_name(kind));
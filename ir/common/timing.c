@@ -7,10 +7,16 @@
  * @file
  * @brief   platform neutral timing utilities
  */
+/* clock_gettime() is not part of C99 */
+#define _DEFAULT_SOURCE
+
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "timing.h"
+#include "array.h"
 #include "xmalloc.h"
 #include "panic.h"
 
@@ -28,16 +34,12 @@ typedef union {
 #else
 
 #include <unistd.h>
-#define HAVE_GETTIMEOFDAY
+#define HAVE_CLOCK_GETTIME
 
-/*
- * Just, if we have gettimeofday()
- * Someday, we will have a check here.
- */
-#include <sys/time.h>
+#include <time.h>
 
-/* Linux timer value. */
-typedef struct timeval ir_timer_val_t;
+/* POSIX timer value, read from the monotonic clock. */
+typedef struct timespec ir_timer_val_t;
 
 #endif /* _Win32 */
 
@@ -70,44 +72,49 @@ void ir_timer_free(ir_timer_t *timer)
 	free(timer);
 }
 
-#ifdef HAVE_GETTIMEOFDAY
+#ifdef HAVE_CLOCK_GETTIME
 
 static inline void _time_get(ir_timer_val_t *val)
 {
-	gettimeofday(val, NULL);
+	clock_gettime(CLOCK_MONOTONIC, val);
 }
 
 static inline void _time_reset(ir_timer_val_t *val)
 {
 	val->tv_sec  = 0;
-	val->tv_usec = 0;
+	val->tv_nsec = 0;
+}
+
+static inline uint64_t _time_to_nsec(const ir_timer_val_t *elapsed)
+{
+	return (uint64_t)elapsed->tv_sec * 1000000000U + (uint64_t)elapsed->tv_nsec;
 }
 
 static inline unsigned long _time_to_msec(const ir_timer_val_t *elapsed)
 {
 	return (unsigned long) elapsed->tv_sec * 1000UL
-		+ (unsigned long) elapsed->tv_usec / 1000UL;
+		+ (unsigned long) elapsed->tv_nsec / 1000000UL;
 }
 
 static inline unsigned long _time_to_usec(const ir_timer_val_t *elapsed)
 {
 	return (unsigned long) elapsed->tv_sec * 1000000UL
-		+ (unsigned long) elapsed->tv_usec;
+		+ (unsigned long) elapsed->tv_nsec / 1000UL;
 }
 
 static inline double _time_to_sec(const ir_timer_val_t *elapsed)
 {
-	return (double)elapsed->tv_sec + (double)elapsed->tv_usec / 1000000.0;
+	return (double)elapsed->tv_sec + (double)elapsed->tv_nsec / 1000000000.0;
 }
 
 static inline ir_timer_val_t *_time_add(ir_timer_val_t *res,
 		const ir_timer_val_t *lhs, const ir_timer_val_t *rhs)
 {
 	res->tv_sec  = lhs->tv_sec + rhs->tv_sec;
-	res->tv_usec = lhs->tv_usec + rhs->tv_usec;
-	if (res->tv_usec >= 1000000) {
+	res->tv_nsec = lhs->tv_nsec + rhs->tv_nsec;
+	if (res->tv_nsec >= 1000000000) {
 		res->tv_sec++;
-		res->tv_usec -= 1000000;
+		res->tv_nsec -= 1000000000;
 	}
 	return res;
 }
@@ -116,10 +123,10 @@ static inline ir_timer_val_t *_time_sub(ir_timer_val_t *res,
 		const ir_timer_val_t *lhs, const ir_timer_val_t *rhs)
 {
 	res->tv_sec  = lhs->tv_sec - rhs->tv_sec;
-	res->tv_usec = lhs->tv_usec - rhs->tv_usec;
-	if (res->tv_usec < 0) {
+	res->tv_nsec = lhs->tv_nsec - rhs->tv_nsec;
+	if (res->tv_nsec < 0) {
 		res->tv_sec--;
-		res->tv_usec += 1000000;
+		res->tv_nsec += 1000000000;
 	}
 	return res;
 }
@@ -157,6 +164,16 @@ static inline unsigned long _time_to_usec(const ir_timer_val_t *elapsed)
 	return (unsigned long) ((elapsed->hi_prec.QuadPart * 1000000) / freq.QuadPart);
 }
 
+static inline uint64_t _time_to_nsec(const ir_timer_val_t *elapsed)
+{
+	LARGE_INTEGER freq;
+
+	if (!QueryPerformanceFrequency(&freq))
+		return (uint64_t) elapsed->lo_prec * 1000000;
+
+	return (uint64_t) ((double)elapsed->hi_prec.QuadPart * 1e9 / freq.QuadPart);
+}
+
 static inline double _time_to_sec(const ir_timer_val_t *elapsed)
 {
 	LARGE_INTEGER freq;
@@ -415,3 +432,193 @@ double ir_timer_elapsed_sec(const ir_timer_t *timer)
 	}
 	return _time_to_sec(elapsed);
 }
+
+/** A scope of the compile time profile. */
+typedef struct timing_scope_t {
+	char const *name;
+	char const *graph;           /**< name of the graph, NULL outside of graphs */
+	uint64_t    start;           /**< begin in nanoseconds since the profile started */
+	uint64_t    end;             /**< end in nanoseconds since the profile started */
+	uint64_t    nested;          /**< nanoseconds spent in nested scopes */
+	unsigned    depth;           /**< number of enclosing scopes */
+	bool        closed;
+	unsigned    indices_before;  /**< node indices in use at the begin */
+	unsigned    indices_after;   /**< node indices in use at the end */
+	size_t      memory_before;   /**< bytes used by the graph at the begin */
+	size_t      memory_after;    /**< bytes used by the graph at the end */
+} timing_scope_t;
+
+static bool            scopes_enabled;
+static timing_scope_t *scopes;      /**< recorded scopes in order of their begin */
+static size_t         *open_scopes; /**< indices of the scopes not ended yet */
+static uint64_t        epoch;       /**< clock value at the start of the profile */
+static uint64_t        overhead;    /**< nanoseconds spent recording the profile */
+
+static uint64_t get_nanoseconds(void)
+{
+	ir_timer_val_t now;
+	_time_get(&now);
+	return _time_to_nsec(&now);
+}
+
+/**
+ * Returns the time since the start of the profile without the time spent in
+ * the profiler, so the accounting does not inflate the enclosing scopes.
+ */
+static uint64_t get_profile_time(uint64_t const now)
+{
+	return now - epoch - overhead;
+}
+
+void ir_timing_enable_scopes(int enable)
+{
+	if (enable && scopes == NULL) {
+		scopes      = NEW_ARR_F(timing_scope_t, 0);
+		open_scopes = NEW_ARR_F(size_t, 0);
+		epoch       = get_nanoseconds();
+		overhead    = 0;
+	}
+	scopes_enabled = enable;
+}
+
+int ir_timing_scopes_enabled(void)
+{
+	return scopes_enabled;
+}
+
+void ir_timing_clear_scopes(void)
+{
+	if (scopes != NULL) {
+		DEL_ARR_F(scopes);
+		DEL_ARR_F(open_scopes);
+		scopes      = NULL;
+		open_scopes = NULL;
+	}
+	if (scopes_enabled)
+		ir_timing_enable_scopes(true);
+}
+
+int ir_timing_scope_begin(char const *name, char const *graph,
+                          unsigned n_indices, size_t memory)
+{
+	if (!scopes_enabled)
+		return false;
+	uint64_t const enter = get_nanoseconds();
+
+	size_t const depth = ARR_LEN(open_scopes);
+	if (graph == NULL && depth > 0)
+		graph = scopes[open_scopes[depth - 1]].graph;
+
+	timing_scope_t scope;
+	memset(&scope, 0, sizeof(scope));
+	scope.name           = name;
+	scope.graph          = graph;
+	scope.depth          = depth;
+	scope.indices_before = n_indices;
+	scope.memory_before  = memory;
+	ARR_APP1(timing_scope_t, scopes, scope);
+	size_t const index = ARR_LEN(scopes) - 1;
+	ARR_APP1(size_t, open_scopes, index);
+
+	uint64_t const leave = get_nanoseconds();
+	overhead += leave - enter;
+	scopes[index].start = get_profile_time(leave);
+	return true;
+}
+
+void ir_timing_scope_end(unsigned n_indices, size_t memory)
+{
+	/* the profile may have been disabled or cleared since the begin */
+	if (open_scopes == NULL || ARR_LEN(open_scopes) == 0)
+		return;
+	uint64_t const enter = get_nanoseconds();
+
+	size_t const depth = ARR_LEN(open_scopes);
+	timing_scope_t *const scope = &scopes[open_scopes[depth - 1]];
+	ARR_SHRINKLEN(open_scopes, depth - 1);
+	scope->end           = get_profile_time(enter);
+	scope->closed        = true;
+	scope->indices_after = n_indices;
+	scope->memory_after  = memory;
+	if (depth > 1)
+		scopes[open_scopes[depth - 2]].nested += scope->end - scope->start;
+
+	overhead += get_nanoseconds() - enter;
+}
+
+static void write_escaped(FILE *const out, char const *const str,
+                          bool const json)
+{
+	for (char const *c = str; *c != '\0'; ++c) {
+		if (json && (*c == '"' || *c == '\\')) {
+			fprintf(out, "\\%c", *c);
+		} else if (json && (unsigned char)*c < 0x20) {
+			fprintf(out, "\\u%04x", (unsigned)*c);
+		} else if (!json && *c == '"') {
+			fputs("\"\"", out);
+		} else {
+			fputc(*c, out);
+		}
+	}
+}
+
+static void write_trace(FILE *const out)
+{
+	fputs("{\"traceEvents\":[", out);
+	char const *sep = "\n";
+	for (size_t i = 0, n = ARR_LEN(scopes); i < n; ++i) {
+		timing_scope_t const *const scope = &scopes[i];
+		if (!scope->closed)
+			continue;
+		fprintf(out, "%s{\"name\":\"", sep);
+		write_escaped(out, scope->name, true);
+		fprintf(out, "\",\"cat\":\"firm\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+		        "\"ts\":%.3f,\"dur\":%.3f,\"args\":{",
+		        scope->start / 1000.0, (scope->end - scope->start) / 1000.0);
+		if (scope->graph != NULL) {
+			fputs("\"graph\":\"", out);
+			write_escaped(out, scope->graph, true);
+			fputs("\",", out);
+		}
+		fprintf(out, "\"indices_before\":%u,\"indices_after\":%u,"
+		        "\"memory_before\":%zu,\"memory_after\":%zu}}",
+		        scope->indices_before, scope->indices_after,
+		        scope->memory_before, scope->memory_after);
+		sep = ",\n";
+	}
+	fputs("\n],\"displayTimeUnit\":\"ns\"}\n", out);
+}
+
+static void write_csv(FILE *const out)
+{
+	fputs("name,graph,depth,start_ns,duration_ns,self_ns,indices_before,"
+	      "indices_after,memory_before,memory_after\n", out);
+	for (size_t i = 0, n = ARR_LEN(scopes); i < n; ++i) {
+		timing_scope_t const *const scope = &scopes[i];
+		if (!scope->closed)
+			continue;
+		uint64_t const duration = scope->end - scope->start;
+		fputc('"', out);
+		write_escaped(out, scope->name, false);
+		fputs("\",\"", out);
+		if (scope->graph != NULL)
+			write_escaped(out, scope->graph, false);
+		fprintf(out, "\",%u,%llu,%llu,%llu,%u,%u,%zu,%zu\n", scope->depth,
+		        (unsigned long long)scope->start,
+		        (unsigned long long)duration,
+		        (unsigned long long)(duration - scope->nested),
+		        scope->indices_before, scope->indices_after,
+		        scope->memory_before, scope->memory_after);
+	}
+}
+
+void ir_timing_write_scopes(FILE *out, ir_timing_format_t format)
+{
+	if (scopes == NULL)
+		return;
+	switch (format) {
+	case ir_timing_format_trace: write_trace(out); return;
+	case ir_timing_format_csv:   write_csv(out);   return;
+	}
+	panic("invalid timing output format");
+}
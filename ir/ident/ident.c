@@ -8,31 +8,96 @@
  * @brief     Hash table to store names.
  * @author    Goetz Lindenmaier
  */
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "hashptr.h"
 #include "ident_t.h"
 #include "obst.h"
-#include "set.h"
 
-static set *id_set;
+/** A string to look up, not necessarily 0-terminated. */
+typedef struct ident_key_t {
+	const char *str;
+	size_t      len;
+} ident_key_t;
+
+/**
+ * Obstack holding the (0-terminated) strings of all idents, each preceded by
+ * its length.
+ */
+static struct obstack id_strings;
+
+static const char *intern_string(ident_key_t const key)
+{
+	size_t *const len = (size_t*)obstack_alloc(&id_strings,
+	                                           sizeof(size_t) + key.len + 1);
+	char   *const str = (char*)(len + 1);
+	*len = key.len;
+	memcpy(str, key.str, key.len);
+	str[key.len] = '\0';
+	return str;
+}
+
+static size_t get_interned_len(const char *const id)
+{
+	return ((const size_t*)id)[-1];
+}
+
+static bool ident_equals(const char *const id, ident_key_t const key)
+{
+	return get_interned_len(id) == key.len
+	    && memcmp(id, key.str, key.len) == 0;
+}
+
+#define HashSet                   ident_set_t
+#define ValueType                 const char*
+#define NullValue                 NULL
+#define DeletedValue              ((const char*)-1)
+#define KeyType                   ident_key_t
+#define GetKey(value)             (value)
+#define InitData(self,value,key)  (value) = intern_string(key)
+#define Hash(self,key)            hash_data((const unsigned char*)(key).str, (key).len)
+#define KeysEqual(self,key1,key2) ident_equals((key1), (key2))
+#define SCALAR_RETURN
+#define SetRangeEmpty(ptr,size)   memset(ptr, 0, (size) * sizeof((ptr)[0]))
+
+#include "hashset.h"
+
+typedef struct ident_set_t ident_set_t;
+
+static void ident_set_init_size(ident_set_t *self, size_t expected_elements);
+static const char *ident_set_insert(ident_set_t *self, ident_key_t key);
+static void ident_set_destroy(ident_set_t *self);
+
+#define hashset_init_size ident_set_init_size
+#define hashset_insert    ident_set_insert
+#define hashset_destroy   ident_set_destroy
+
+#include "hashset.c.h"
+
+/**
+ * Open addressing table of all idents. The entries store the hash next to
+ * the string pointer, so most mismatches are rejected without touching the
+ * string itself. The table is not synchronized, so idents must not be created
+ * by several threads at once.
+ */
+static ident_set_t id_set;
 
 /** An obstack used for temporary space */
 static struct obstack id_obst;
 
 void init_ident(void)
 {
-	/* it's ok to use memcmp here, we check only strings */
-	id_set = new_set(memcmp, 128);
+	ident_set_init_size(&id_set, 1024);
+	obstack_init(&id_strings);
 	obstack_init(&id_obst);
 }
 
 ident *new_id_from_chars(const char *str, size_t len)
 {
-	unsigned   hash   = hash_data((const unsigned char*)str, len);
-	set_entry *result = set_hinsert0(id_set, str, len, hash);
-	return (ident*)result->dptr;
+	ident_key_t const key = { str, len };
+	return ident_set_insert(&id_set, key);
 }
 
 ident *new_id_from_str(const char *str)
@@ -66,8 +131,8 @@ const char *(get_id_str)(ident *id)
 void finish_ident(void)
 {
 	obstack_free(&id_obst, NULL);
-	del_set(id_set);
-	id_set = NULL;
+	ident_set_destroy(&id_set);
+	obstack_free(&id_strings, NULL);
 }
 
 ident *id_unique(const char *tag)
@@ -263,11 +263,12 @@ void mature_immBlock(ir_node *block)
 		size_t                n_preds = ARR_LEN(block->in) - 1;
 		if (n_preds == 0) {
 			n_preds   = 1;
-			new_in    = NEW_ARR_D(ir_node*, obst, 2);
+			new_in    = new_irn_in(irg, 2);
 			new_in[0] = NULL;
 			new_in[1] = new_r_Bad(irg, mode_X);
 		} else {
-			new_in = DUP_ARR_D(ir_node*, obst, block->in);
+			new_in = new_irn_in(irg, n_preds + 1);
+			MEMCPY(new_in, block->in, n_preds + 1);
 		}
 		DEL_ARR_F(block->in);
 		block->in                     = new_in;
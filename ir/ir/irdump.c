@@ -792,6 +792,15 @@ static void dump_node_nodeattr(FILE *F, const ir_node *n)
 	case iro_CopyB:
 		ir_fprintf(F, "(%+F)", get_CopyB_type(n));
 		break;
+	case iro_Extract:
+		fprintf(F, "%u ", get_Extract_lane(n));
+		break;
+	case iro_Insert:
+		fprintf(F, "%u ", get_Insert_lane(n));
+		break;
+	case iro_Shuffle:
+		ir_fprintf(F, "%T ", get_Shuffle_mask(n));
+		break;
 
 	default:
 		break;
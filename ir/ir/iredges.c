@@ -496,6 +496,8 @@ void edges_deactivate_kind(ir_graph *irg, ir_edge_kind_t kind)
 	irg_edge_info_t *info = get_irg_edge_info(irg, kind);
 
 	info->activated = 0;
+	/* without out edges it is unknown whether killed nodes are still used */
+	ARR_SHRINKLEN(irg->dead_nodes, 0);
 	if (info->allocated) {
 		obstack_free(&info->edges_obst, NULL);
 		ir_edgeset_destroy(&info->edges);
@@ -34,6 +34,19 @@ void turn_into_tuple(ir_node *const node, int const arity,
 	clear_irg_properties(get_irn_irg(node), IR_GRAPH_PROPERTY_NO_TUPLES);
 }
 
+/**
+ * Turns a node into an Id or Deleted node, which remembers the memory
+ * allocated for the node.
+ */
+static void turn_into_corpse(ir_node *const node, ir_op *const op)
+{
+	size_t const size        = get_irn_alloc_size(node);
+	bool   const flexible_in = irn_has_flexible_in(node);
+	set_irn_op(node, op);
+	node->attr.corpse.size        = size;
+	node->attr.corpse.flexible_in = flexible_in;
+}
+
 void exchange(ir_node *old, ir_node *nw)
 {
 	assert(old != NULL && nw != NULL);
@@ -61,8 +74,9 @@ void exchange(ir_node *old, ir_node *nw)
 	if (edges_activated(irg)) {
 		edges_reroute(old, nw);
 		edges_node_deleted(old);
+		irg_bury_node(irg, old);
 		/* noone is allowed to reference this node anymore */
-		set_irn_op(old, op_Deleted);
+		turn_into_corpse(old, op_Deleted);
 	} else {
 		/* Else, do it the old-fashioned way. */
 		ir_node *block = old->in[0];
@@ -73,11 +87,14 @@ void exchange(ir_node *old, ir_node *nw)
 			}
 		}
 
-		if (is_irn_dynamic(old))
+		turn_into_corpse(old, op_Id);
+		if (irn_has_flexible_in(old))
 			DEL_ARR_F(old->in);
+		else
+			free_irn_in(irg, old->in);
 
-		old->op    = op_Id;
-		old->in    = NEW_ARR_D(ir_node*, get_irg_obstack(irg), 2);
+		old->attr.corpse.flexible_in = false;
+		old->in    = new_irn_in(irg, 2);
 		old->in[0] = block;
 		old->in[1] = nw;
 	}
@@ -307,9 +324,10 @@ void kill_node(ir_node *node)
 	ir_graph *irg = get_irn_irg(node);
 	if (edges_activated(irg)) {
 		edges_node_deleted(node);
+		irg_bury_node(irg, node);
 	}
 	/* noone is allowed to reference this node anymore */
-	set_irn_op(node, op_Deleted);
+	turn_into_corpse(node, op_Deleted);
 }
 
 ir_node *duplicate_subgraph(dbg_info *dbg, ir_node *n, ir_node *block)
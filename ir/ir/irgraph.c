@@ -62,6 +62,8 @@ static ir_graph *alloc_graph(void)
 	res->idx_irn_map = NEW_ARR_FZ(ir_node*, INITIAL_IDX_IRN_MAP_SIZE);
 
 	obstack_init(&res->obst);
+	arena_init(&res->node_arena);
+	res->dead_nodes = NEW_ARR_F(ir_node*, 0);
 
 	/* value table for global value numbering for optimizing use in iropt.c */
 	new_identities(res);
@@ -76,6 +78,8 @@ static void free_graph(ir_graph *irg)
 {
 	for (ir_edge_kind_t i = EDGE_KIND_FIRST; i <= EDGE_KIND_LAST; ++i)
 		edges_deactivate_kind(irg, i);
+	DEL_ARR_F(irg->dead_nodes);
+	arena_destroy(&irg->node_arena);
 	DEL_ARR_F(irg->idx_irn_map);
 	free(irg);
 }
@@ -400,14 +404,9 @@ int get_irg_n_locs(ir_graph *irg)
 
 int node_is_in_irgs_storage(const ir_graph *irg, const ir_node *n)
 {
-	/* Check whether the ir_node pointer is on the obstack.
+	/* Check whether the ir_node pointer is in the node arena.
 	 * A more sophisticated check would test the "whole" ir_node. */
-	for (struct _obstack_chunk const *p = irg->obst.chunk; p; p = p->prev) {
-		if (((char *)p->contents <= (char *)n) && ((char *)n < (char *)p->limit))
-			return 1;
-	}
-
-	return 0;
+	return arena_contains(&irg->node_arena, n);
 }
 
 op_pin_state (get_irg_pinned)(const ir_graph *irg)
@@ -582,16 +581,71 @@ void assure_irg_properties(ir_graph *irg, ir_graph_properties_t props)
 		{ IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE,  assure_irg_entity_usage_computed },
 		{ IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE_FRONTIERS, ir_compute_dominance_frontiers },
 	};
+	/* the functions confirm properties themselves, but the calling pass is
+	 * not finished, so they must not release its deleted nodes */
+	++irg->pass_nesting;
 	for (size_t i = 0; i < ARRAY_SIZE(property_functions); ++i) {
 		ir_graph_properties_t missing = props & ~irg->properties;
 		if (missing & property_functions[i].property)
 			property_functions[i].func(irg);
 	}
+	--irg->pass_nesting;
 	assert((props & ~irg->properties) == IR_GRAPH_PROPERTIES_NONE);
 }
 
+void irg_bury_node(ir_graph *const irg, ir_node *const node)
+{
+	/* a node is buried before it turns into a corpse, so never twice */
+	assert(!irn_is_corpse(node));
+	/* Nodes of the construction and the backend are still referenced by
+	 * variables and schedules after they were killed. */
+	if (irg_is_constrained(irg, IR_GRAPH_CONSTRAINT_CONSTRUCTION)
+	    || irg_is_constrained(irg, IR_GRAPH_CONSTRAINT_BACKEND))
+		return;
+	ARR_APP1(ir_node*, irg->dead_nodes, node);
+}
+
+void irg_release_dead_nodes(ir_graph *const irg)
+{
+	assert(irg->pass_nesting == 0);
+	size_t const n_dead = ARR_LEN(irg->dead_nodes);
+	if (n_dead == 0)
+		return;
+
+	/* the value table must not refer to released nodes */
+	cpset_iterator_t iter;
+	cpset_iterator_init(&iter, irg->value_table);
+	for (ir_node *n; (n = (ir_node*)cpset_iterator_next(&iter)) != NULL;) {
+		if (is_Deleted(n))
+			cpset_remove_iterator(irg->value_table, &iter);
+	}
+
+	for (size_t i = 0; i < n_dead; ++i) {
+		ir_node *const node = irg->dead_nodes[i];
+		/* nodes still used by other (dead) nodes are left alone */
+		if (!list_empty(&node->edge_info[EDGE_KIND_NORMAL].outs_head)
+		    || !list_empty(&node->edge_info[EDGE_KIND_BLOCK].outs_head))
+			continue;
+		irg->idx_irn_map[get_irn_idx(node)] = NULL;
+		free_irn(irg, node);
+	}
+	ARR_SHRINKLEN(irg->dead_nodes, 0);
+}
+
+size_t get_irg_node_memory(const ir_graph *irg)
+{
+	return irg->node_arena.used;
+}
+
+size_t get_irg_node_memory_peak(const ir_graph *irg)
+{
+	return irg->node_arena.peak;
+}
+
 void confirm_irg_properties(ir_graph *irg, ir_graph_properties_t props)
 {
+	if (irg->pass_nesting == 0)
+		irg_release_dead_nodes(irg);
 	clear_irg_properties(irg, ~props);
 	if (!(props & IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES))
 		edges_deactivate(irg);
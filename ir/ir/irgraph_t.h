@@ -13,7 +13,9 @@
 
 #include "irgraph.h"
 
+#include "arena.h"
 #include "entity_t.h"
+#include "cpset.h"
 #include "firm_types.h"
 #include "iredgekinds.h"
 #include "iredgeset.h"
@@ -23,6 +25,7 @@
 #include "list.h"
 #include "obst.h"
 #include "pset.h"
+#include "timing.h"
 #include "type_t.h"
 
 #define get_irg_start_block(irg)              get_irg_start_block_(irg)
@@ -111,7 +114,10 @@ struct ir_graph {
 	/** A type representing the stack frame. */
 	ir_type               *frame_type;
 	ir_node               *anchor;        /**< Pointer to the anchor node. */
-	struct obstack         obst;          /**< obstack allocator for nodes. */
+	struct obstack         obst;          /**< obstack allocator for node data. */
+	arena_t                node_arena;    /**< memory of nodes and in arrays. */
+	ir_node              **dead_nodes;    /**< killed nodes to release. */
+	unsigned               pass_nesting;   /**< active assure_irg_properties() and nested passes. */
 
 	ir_graph_properties_t  properties;
 	ir_graph_constraints_t constraints;
@@ -138,7 +144,7 @@ struct ir_graph {
 	ir_node *current_block;    /**< Block for new_*()ly created nodes. */
 
 	/** Hash table for global value numbering (CSE) */
-	pset               *value_table;
+	cpset_t            *value_table;
 	struct obstack      out_obst;    /**< Space for the Def-Use arrays. */
 	bool                out_obst_allocated;
 	ir_bitinfo          bitinfo;     /**< bit info */
@@ -457,8 +463,8 @@ static inline unsigned irg_register_node_idx(ir_graph *irg, ir_node *irn)
 }
 
 /**
- * Kill a node from the irg. BEWARE: this kills
- * all later created nodes.
+ * Kill the node created last in the irg and release its memory immediately.
+ * The node must not be referenced anywhere.
  */
 static inline void irg_kill_node(ir_graph *irg, ir_node *n)
 {
@@ -468,7 +474,44 @@ static inline void irg_kill_node(ir_graph *irg, ir_node *n)
 	if (idx + 1 == irg->last_node_idx)
 		--irg->last_node_idx;
 	irg->idx_irn_map[idx] = NULL;
-	obstack_free(&irg->obst, n);
+	free_irn(irg, n);
+}
+
+/**
+ * Remembers a node, which is about to be deleted, so its memory can be
+ * released by irg_release_dead_nodes().  Nodes are only remembered while out
+ * edges are activated, as the edges tell whether the node is still used.
+ */
+void irg_bury_node(ir_graph *irg, ir_node *node);
+
+/**
+ * Releases the memory of the nodes remembered by irg_bury_node(), which are
+ * not used anymore.  Called by confirm_irg_properties() at the end of a pass,
+ * when no pointers to deleted nodes are left.  Passes run by
+ * assure_irg_properties() in the middle of another pass do not release
+ * anything, as the outer pass may still hold deleted nodes.  The same holds
+ * for a pass called directly by another pass between irg_begin_nested_pass()
+ * and irg_end_nested_pass().
+ */
+void irg_release_dead_nodes(ir_graph *irg);
+
+/**
+ * Begins a pass called directly by another pass on @p irg.  Until the
+ * matching irg_end_nested_pass() nothing is released, so the nodes deleted
+ * by the calling pass stay valid.
+ */
+static inline void irg_begin_nested_pass(ir_graph *const irg)
+{
+	++irg->pass_nesting;
+}
+
+/**
+ * Ends a pass begun by irg_begin_nested_pass().
+ */
+static inline void irg_end_nested_pass(ir_graph *const irg)
+{
+	assert(irg->pass_nesting > 0);
+	--irg->pass_nesting;
 }
 
 /**
@@ -484,6 +527,40 @@ static inline ir_node *get_idx_irn_(const ir_graph *irg, unsigned idx)
 	return irg->idx_irn_map[idx];
 }
 
+/**
+ * Returns the bytes used by the graph: its obstack and its nodes.
+ */
+static inline size_t get_irg_memory_used(ir_graph *const irg)
+{
+	return obstack_memory_used(&irg->obst) + irg->node_arena.used;
+}
+
+/**
+ * Begins a scope named @p name of the compile time profile for a pass on
+ * @p irg.  Returns true if a scope was begun, which has to be ended with
+ * irg_timing_scope_end().
+ */
+static inline bool irg_timing_scope_begin(ir_graph *const irg,
+                                          char const *const name)
+{
+	if (!ir_timing_scopes_enabled())
+		return false;
+	ir_entity *const entity = get_irg_entity(irg);
+	char const *const graph = entity != NULL ? get_entity_ld_name(entity) : NULL;
+	return ir_timing_scope_begin(name, graph, irg->last_node_idx,
+	                             get_irg_memory_used(irg));
+}
+
+/**
+ * Ends the scope of the compile time profile begun by
+ * irg_timing_scope_begin() if @p begun is set.
+ */
+static inline void irg_timing_scope_end(ir_graph *const irg, bool const begun)
+{
+	if (begun)
+		ir_timing_scope_end(irg->last_node_idx, get_irg_memory_used(irg));
+}
+
 /**
  * Get the anchor.
  */
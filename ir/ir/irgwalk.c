@@ -17,7 +17,7 @@
 #include "irnode_t.h"
 #include "irgraph_t.h"
 #include "irprog_t.h"
-#include "irgwalk.h"
+#include "irgwalk_t.h"
 #include "irhooks.h"
 #include "entity_t.h"
 #include "ircons.h"
@@ -27,49 +27,76 @@
 #include "array.h"
 
 /**
- * specialized version of irg_walk_2, called if only pre callback exists
+ * Marks @p node visited, calls the pre callback and pushes it onto the walk
+ * stack.  Non-block nodes start with their block (pos -1), blocks directly
+ * with their last input.
  */
-static void irg_walk_2_pre(ir_node *node, irg_walk_func *pre, void *env)
+static inline void irg_walk_enter(walk_stack *stack, ir_node *node,
+                                  ir_visited_t visited, irg_walk_func *pre,
+                                  void *env)
 {
-	ir_graph    *irg     = get_irn_irg(node);
-	ir_visited_t visited = irg->visited;
-
 	set_irn_visited(node, visited);
 
-	pre(node, env);
+	if (pre != NULL)
+		pre(node, env);
 
-	if (!is_Block(node)) {
-		ir_node *pred = get_nodes_block(node);
-		if (pred->visited < visited)
-			irg_walk_2_pre(pred, pre, env);
-	}
-	foreach_irn_in_r(node, i, pred) {
-		if (pred->visited < visited)
-			irg_walk_2_pre(pred, pre, env);
-	}
+	walk_frame *const frame = walk_stack_push(stack, node);
+	frame->pos = is_Block(node) ? get_irn_arity(node) : -1;
 }
 
 /**
- * specialized version of irg_walk_2, called if only post callback exists
+ * Walks the predecessors of @p node depth first.  The visit order is the
+ * same as for a recursive walk which handles the block of a node first and
+ * then its inputs from the last to the first one.
  */
-static void irg_walk_2_post(ir_node *node, irg_walk_func *post, void *env)
+static inline void irg_walk_2_impl(ir_node *node, irg_walk_func *pre,
+                                   irg_walk_func *post, void *env)
 {
 	ir_graph    *irg     = get_irn_irg(node);
 	ir_visited_t visited = irg->visited;
 
-	set_irn_visited(node, visited);
+	walk_stack stack;
+	walk_stack_init(&stack);
+	irg_walk_enter(&stack, node, visited, pre, env);
+
+	while (stack.len > 0) {
+		walk_frame *const frame = walk_stack_top(&stack);
+		ir_node    *const cur   = frame->node;
+		ir_node          *pred;
+		if (frame->pos > 0) {
+			pred = get_irn_n(cur, --frame->pos);
+		} else if (frame->pos < 0) {
+			/* the inputs are counted after the block has been walked */
+			frame->pos = get_irn_arity(cur);
+			pred       = get_nodes_block(cur);
+		} else {
+			walk_stack_pop(&stack);
+			if (post != NULL)
+				post(cur, env);
+			continue;
+		}
 
-	if (!is_Block(node)) {
-		ir_node *pred = get_nodes_block(node);
 		if (pred->visited < visited)
-			irg_walk_2_post(pred, post, env);
-	}
-	foreach_irn_in_r(node, i, pred) {
-		if (pred->visited < visited)
-			irg_walk_2_post(pred, post, env);
+			irg_walk_enter(&stack, pred, visited, pre, env);
 	}
 
-	post(node, env);
+	walk_stack_free(&stack);
+}
+
+/**
+ * specialized version of irg_walk_2, called if only pre callback exists
+ */
+static void irg_walk_2_pre(ir_node *node, irg_walk_func *pre, void *env)
+{
+	irg_walk_2_impl(node, pre, NULL, env);
+}
+
+/**
+ * specialized version of irg_walk_2, called if only post callback exists
+ */
+static void irg_walk_2_post(ir_node *node, irg_walk_func *post, void *env)
+{
+	irg_walk_2_impl(node, NULL, post, env);
 }
 
 /**
@@ -78,24 +105,7 @@ static void irg_walk_2_post(ir_node *node, irg_walk_func *post, void *env)
 static void irg_walk_2_both(ir_node *node, irg_walk_func *pre,
                                 irg_walk_func *post, void *env)
 {
-	ir_graph    *irg     = get_irn_irg(node);
-	ir_visited_t visited = irg->visited;
-
-	set_irn_visited(node, visited);
-
-	pre(node, env);
-
-	if (!is_Block(node)) {
-		ir_node *pred = get_nodes_block(node);
-		if (pred->visited < visited)
-			irg_walk_2_both(pred, pre, post, env);
-	}
-	foreach_irn_in_r(node, i, pred) {
-		if (pred->visited < visited)
-			irg_walk_2_both(pred, pre, post, env);
-	}
-
-	post(node, env);
+	irg_walk_2_impl(node, pre, post, env);
 }
 
 void irg_walk_2(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
@@ -145,22 +155,7 @@ void all_irg_walk(irg_walk_func *pre, irg_walk_func *post, void *env)
 static void irg_walk_in_or_dep_2_pre(ir_node *node, irg_walk_func *pre,
                                      void *env)
 {
-	ir_graph    *irg     = get_irn_irg(node);
-	ir_visited_t visited = irg->visited;
-
-	set_irn_visited(node, visited);
-
-	pre(node, env);
-
-	if (!is_Block(node)) {
-		ir_node *pred = get_nodes_block(node);
-		if (pred->visited < visited)
-			irg_walk_in_or_dep_2_pre(pred, pre, env);
-	}
-	foreach_irn_in_r(node, i, pred) {
-		if (pred->visited < visited)
-			irg_walk_in_or_dep_2_pre(pred, pre, env);
-	}
+	irg_walk_2_impl(node, pre, NULL, env);
 }
 
 /**
@@ -169,22 +164,7 @@ static void irg_walk_in_or_dep_2_pre(ir_node *node, irg_walk_func *pre,
 static void irg_walk_in_or_dep_2_post(ir_node *node, irg_walk_func *post,
                                       void *env)
 {
-	ir_graph    *irg     = get_irn_irg(node);
-	ir_visited_t visited = irg->visited;
-
-	set_irn_visited(node, visited);
-
-	if (!is_Block(node)) {
-		ir_node *pred = get_nodes_block(node);
-		if (pred->visited < visited)
-			irg_walk_in_or_dep_2_post(pred, post, env);
-	}
-	foreach_irn_in_r(node, i, pred) {
-		if (pred->visited < visited)
-			irg_walk_in_or_dep_2_post(pred, post, env);
-	}
-
-	post(node, env);
+	irg_walk_2_impl(node, NULL, post, env);
 }
 
 /**
@@ -193,24 +173,7 @@ static void irg_walk_in_or_dep_2_post(ir_node *node, irg_walk_func *post,
 static void irg_walk_in_or_dep_2_both(ir_node *node, irg_walk_func *pre,
                                       irg_walk_func *post, void *env)
 {
-	ir_graph    *irg     = get_irn_irg(node);
-	ir_visited_t visited = irg->visited;
-
-	set_irn_visited(node, visited);
-
-	pre(node, env);
-
-	if (!is_Block(node)) {
-		ir_node *pred = get_nodes_block(node);
-		if (pred->visited < visited)
-			irg_walk_in_or_dep_2_both(pred, pre, post, env);
-	}
-	foreach_irn_in_r(node, i, pred) {
-		if (pred->visited < visited)
-			irg_walk_in_or_dep_2_both(pred, pre, post, env);
-	}
-
-	post(node, env);
+	irg_walk_2_impl(node, pre, post, env);
 }
 
 /**
@@ -255,28 +218,52 @@ static ir_node *get_cf_op(ir_node *n)
 	return n;
 }
 
+/**
+ * Marks @p block visited, calls the pre callback and pushes it onto the walk
+ * stack, starting with its last control flow predecessor.
+ */
+static inline void irg_block_walk_enter(walk_stack *stack, ir_node *block,
+                                        irg_walk_func *pre, void *env)
+{
+	mark_Block_block_visited(block);
+
+	if (pre != NULL)
+		pre(block, env);
+
+	walk_frame *const frame = walk_stack_push(stack, block);
+	frame->pos = get_Block_n_cfgpreds(block);
+}
+
 static void irg_block_walk_2(ir_node *node, irg_walk_func *pre,
                              irg_walk_func *post, void *env)
 {
 	if (Block_block_visited(node))
 		return;
-	mark_Block_block_visited(node);
 
-	if (pre != NULL)
-		pre(node, env);
+	walk_stack stack;
+	walk_stack_init(&stack);
+	irg_block_walk_enter(&stack, node, pre, env);
+
+	while (stack.len > 0) {
+		walk_frame *const frame = walk_stack_top(&stack);
+		ir_node    *const block = frame->node;
+		if (frame->pos == 0) {
+			walk_stack_pop(&stack);
+			if (post != NULL)
+				post(block, env);
+			continue;
+		}
 
-	for (int i = get_Block_n_cfgpreds(node); i-- > 0; ) {
 		/* find the corresponding predecessor block. */
-		ir_node *pred_cfop  = get_cf_op(get_Block_cfgpred(node, i));
+		ir_node *pred_cfop = get_cf_op(get_Block_cfgpred(block, --frame->pos));
 		if (is_Bad(pred_cfop))
 			continue;
 		ir_node *pred_block = get_nodes_block(pred_cfop);
-		/* recursion */
-		irg_block_walk_2(pred_block, pre, post, env);
+		if (!Block_block_visited(pred_block))
+			irg_block_walk_enter(&stack, pred_block, pre, env);
 	}
 
-	if (post != NULL)
-		post(node, env);
+	walk_stack_free(&stack);
 }
 
 void irg_block_walk(ir_node *node, irg_walk_func *pre, irg_walk_func *post,
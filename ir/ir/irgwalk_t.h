@@ -0,0 +1,81 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Explicit stack used by the graph walkers.
+ *
+ * The walkers keep their traversal state in an explicit stack instead of
+ * recursing, so deep graphs (long chains of Phis or memory nodes) cannot
+ * overflow the C stack. Small walks stay in a fixed buffer that lives in
+ * the caller's stack frame; the heap is only touched for deeper walks.
+ */
+#ifndef FIRM_IR_IRGWALK_T_H
+#define FIRM_IR_IRGWALK_T_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "irgwalk.h"
+#include "xmalloc.h"
+
+/** Number of frames a walk_stack holds before moving to the heap. */
+#define WALK_STACK_LOCAL 64
+
+/** A node currently being walked and the position of its next edge. */
+typedef struct walk_frame {
+	ir_node *node;
+	int      pos; /**< next edge to look at, meaning depends on the walker */
+	int      n;   /**< number of edges, captured when the walk starts */
+} walk_frame;
+
+typedef struct walk_stack {
+	walk_frame *frames;
+	size_t      len;
+	size_t      cap;
+	walk_frame  local[WALK_STACK_LOCAL];
+} walk_stack;
+
+static inline void walk_stack_init(walk_stack *stack)
+{
+	stack->frames = stack->local;
+	stack->len    = 0;
+	stack->cap    = WALK_STACK_LOCAL;
+}
+
+static inline void walk_stack_free(walk_stack *stack)
+{
+	if (stack->frames != stack->local)
+		free(stack->frames);
+}
+
+static inline walk_frame *walk_stack_push(walk_stack *stack, ir_node *node)
+{
+	if (stack->len == stack->cap) {
+		size_t const new_cap = stack->cap * 2;
+		if (stack->frames == stack->local) {
+			stack->frames = XMALLOCN(walk_frame, new_cap);
+			memcpy(stack->frames, stack->local, sizeof(stack->local));
+		} else {
+			stack->frames = XREALLOC(stack->frames, walk_frame, new_cap);
+		}
+		stack->cap = new_cap;
+	}
+	walk_frame *const frame = &stack->frames[stack->len++];
+	frame->node = node;
+	return frame;
+}
+
+static inline walk_frame *walk_stack_top(walk_stack const *stack)
+{
+	return &stack->frames[stack->len - 1];
+}
+
+static inline void walk_stack_pop(walk_stack *stack)
+{
+	--stack->len;
+}
+
+#endif
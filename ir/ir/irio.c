@@ -14,6 +14,12 @@
 #include <ctype.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "array.h"
 #include "ircons_t.h"
@@ -32,6 +38,21 @@
 
 #define SYMERROR ((unsigned) ~0)
 
+/* The binary format contains the same tokens as the textual one, prefixed by
+ * a tag instead of separated by whitespace. Numbers are zigzag encoded LEB128
+ * numbers, node numbers are stored as difference to the previous node number
+ * to keep them short. Words and strings refer to a string table which is built while
+ * writing: The reference 0 is followed by the length and the zero terminated
+ * characters of a new string, others name the n-th string defined so far.
+ * Brackets and braces are written as themselves. */
+#define BIN_NUMBER '0'
+#define BIN_NODE   'n'
+#define BIN_WORD   'w'
+#define BIN_STRING '"'
+
+static const char     binary_magic[8] = "\x7F" "FIRMIR";
+static const unsigned binary_version  = 1;
+
 typedef enum typetag_t {
 	tt_align,
 	tt_builtin_kind,
@@ -70,6 +91,7 @@ typedef enum keyword_t {
 	kw_type,
 	kw_typegraph,
 	kw_unknown,
+	kw_vector_mode,
 } keyword_t;
 
 typedef struct symbol_t {
@@ -83,6 +105,12 @@ typedef struct id_entry {
 	void *elem;
 } id_entry;
 
+/** An entry of the string table of binary output. */
+typedef struct string_ref_t {
+	const char *str;
+	unsigned    ref;  /**< The number of this string in the table. */
+} string_ref_t;
+
 /** The symbol table, a set of symbol_t elements. */
 static set *symtbl;
 
@@ -108,17 +136,29 @@ static int id_cmp(const void *elt, const void *key, size_t size)
 	return entry->id - keyentry->id;
 }
 
+static int string_ref_cmp(const void *elt, const void *key, size_t size)
+{
+	(void)size;
+	const string_ref_t *entry = (const string_ref_t *) elt;
+	const string_ref_t *keyentry = (const string_ref_t *) key;
+	return strcmp(entry->str, keyentry->str);
+}
+
 static void FIRM_PRINTF(2, 3)
 parse_error(read_env_t *env, const char *fmt, ...)
 {
 	/* workaround read_c "feature" that a '\n' triggers the line++
 	 * instead of the character after the '\n' */
-	unsigned line = env->line;
-	if (env->c == '\n') {
-		line--;
+	if (env->binary) {
+		size_t const offset = env->pos - env->begin;
+		fprintf(stderr, "%s:@%zu: error ", env->inputname, offset);
+	} else {
+		unsigned line = env->line;
+		if (env->c == '\n') {
+			line--;
+		}
+		fprintf(stderr, "%s:%u: error ", env->inputname, line);
 	}
-
-	fprintf(stderr, "%s:%u: error ", env->inputname, line);
 	env->read_errors = true;
 
 	va_list ap;
@@ -199,6 +239,7 @@ static void symtbl_init(void)
 	INSERTKEYWORD(type);
 	INSERTKEYWORD(typegraph);
 	INSERTKEYWORD(unknown);
+	INSERTKEYWORD(vector_mode);
 
 	INSERTENUM(tt_align, align_non_aligned);
 	INSERTENUM(tt_align, align_is_aligned);
@@ -218,6 +259,10 @@ static void symtbl_init(void)
 	INSERTENUM(tt_builtin_kind, ir_bk_outport);
 	INSERTENUM(tt_builtin_kind, ir_bk_saturating_increment);
 	INSERTENUM(tt_builtin_kind, ir_bk_compare_swap);
+	INSERTENUM(tt_builtin_kind, ir_bk_min);
+	INSERTENUM(tt_builtin_kind, ir_bk_max);
+	INSERTENUM(tt_builtin_kind, ir_bk_saturating_add);
+	INSERTENUM(tt_builtin_kind, ir_bk_saturating_sub);
 
 	INSERTENUM(tt_cond_jmp_predicate, COND_JMP_PRED_NONE);
 	INSERTENUM(tt_cond_jmp_predicate, COND_JMP_PRED_TRUE);
@@ -295,28 +340,97 @@ static unsigned symbol(const char *str, typetag_t typetag)
 	return entry ? entry->code : SYMERROR;
 }
 
+/** Writes an unsigned LEB128 number. */
+static void write_varint(write_env_t *env, unsigned long value)
+{
+	while (value >= 0x80) {
+		putc((int)(value & 0x7F) | 0x80, env->file);
+		value >>= 7;
+	}
+	putc((int)value, env->file);
+}
+
+/**
+ * Writes a reference to a string of the binary string table. The first
+ * reference to a string defines it.
+ */
+static void write_string_ref(write_env_t *env, char tag, const char *str)
+{
+	putc(tag, env->file);
+
+	string_ref_t   key   = { str, 0 };
+	unsigned const hash  = hash_str(str);
+	string_ref_t  *entry = set_find(string_ref_t, env->strings, &key,
+	                                sizeof(key), hash);
+	if (entry != NULL) {
+		write_varint(env, entry->ref);
+		return;
+	}
+
+	size_t const len = strlen(str);
+	key.str = (const char*)obstack_copy0(&env->strings_obst, str, len);
+	key.ref = ++env->n_strings;
+	(void)set_insert(string_ref_t, env->strings, &key, sizeof(key), hash);
+	write_varint(env, 0);
+	write_varint(env, len);
+	fwrite(str, 1, len + 1, env->file);
+}
+
+/** Writes characters which only make the textual format readable. */
+static void write_layout(write_env_t *env, char c)
+{
+	if (!env->binary)
+		fputc(c, env->file);
+}
+
+static void write_zigzag(write_env_t *env, char tag, long value)
+{
+	putc(tag, env->file);
+	write_varint(env, ((unsigned long)value << 1) ^ (unsigned long)-(value < 0));
+}
+
 void write_long(write_env_t *env, long value)
 {
+	if (env->binary) {
+		write_zigzag(env, BIN_NUMBER, value);
+		return;
+	}
 	fprintf(env->file, "%ld ", value);
 }
 
 void write_int(write_env_t *env, int value)
 {
+	if (env->binary) {
+		write_long(env, value);
+		return;
+	}
 	fprintf(env->file, "%d ", value);
 }
 
 void write_unsigned(write_env_t *env, unsigned value)
 {
+	if (env->binary) {
+		write_long(env, (long)value);
+		return;
+	}
 	fprintf(env->file, "%u ", value);
 }
 
 void write_size_t(write_env_t *env, size_t value)
 {
+	if (env->binary) {
+		write_long(env, (long)value);
+		return;
+	}
 	ir_fprintf(env->file, "%zu ", value);
 }
 
 void write_symbol(write_env_t *env, const char *symbol)
 {
+	if (env->binary) {
+		write_string_ref(env, BIN_WORD, symbol);
+		return;
+	}
 	fputs(symbol, env->file);
 	fputc(' ', env->file);
 }
@@ -343,6 +457,10 @@ void write_type_ref(write_env_t *env, ir_type *type)
 
 void write_string(write_env_t *env, const char *string)
 {
+	if (env->binary) {
+		write_string_ref(env, BIN_STRING, string);
+		return;
+	}
 	fputc('"', env->file);
 	for (const char *c = string; *c != '\0'; ++c) {
 		switch (*c) {
@@ -371,7 +489,7 @@ void write_ident(write_env_t *env, ident *id)
 void write_ident_null(write_env_t *env, ident *id)
 {
 	if (id == NULL) {
-		fputs("NULL ", env->file);
+		write_symbol(env, "NULL");
 	} else {
 		write_ident(env, id);
 	}
@@ -386,28 +504,25 @@ void write_tarval_ref(write_env_t *env, ir_tarval *tv)
 {
 	ir_mode *mode = get_tarval_mode(tv);
 	write_mode_ref(env, mode);
-	char buf[128];
-	const char *ascii = ir_tarval_to_ascii(buf, sizeof(buf), tv);
-	fputs(ascii, env->file);
-	fputc(' ', env->file);
+	/* vectors need 2 hex digits per byte plus a separator per lane */
+	size_t len = 128 + get_mode_size_bits(mode) / 2;
+	char  *buf = ALLOCAN(char, len);
+	write_symbol(env, ir_tarval_to_ascii(buf, len, tv));
 }
 
 void write_align(write_env_t *env, ir_align align)
 {
-	fputs(get_align_name(align), env->file);
-	fputc(' ', env->file);
+	write_symbol(env, get_align_name(align));
 }
 
 void write_builtin_kind(write_env_t *env, ir_builtin_kind kind)
 {
-	fputs(get_builtin_kind_name(kind), env->file);
-	fputc(' ', env->file);
+	write_symbol(env, get_builtin_kind_name(kind));
 }
 
 void write_cond_jmp_predicate(write_env_t *env, cond_jmp_predicate pred)
 {
-	fputs(get_cond_jmp_predicate_name(pred), env->file);
-	fputc(' ', env->file);
+	write_symbol(env, get_cond_jmp_predicate_name(pred));
 }
 
 void write_relation(write_env_t *env, ir_relation relation)
@@ -427,37 +542,48 @@ void write_loop(write_env_t *env, bool loop)
 
 static void write_list_begin(write_env_t *env)
 {
-	fputs("[", env->file);
+	fputc('[', env->file);
 }
 
 static void write_list_end(write_env_t *env)
 {
-	fputs("] ", env->file);
+	fputc(']', env->file);
+	write_layout(env, ' ');
 }
 
 static void write_scope_begin(write_env_t *env)
 {
-	fputs("{\n", env->file);
+	fputc('{', env->file);
+	write_layout(env, '\n');
 }
 
 static void write_scope_end(write_env_t *env)
 {
-	fputs("}\n\n", env->file);
+	fputc('}', env->file);
+	write_layout(env, '\n');
+	write_layout(env, '\n');
+}
+
+static void write_node_number(write_env_t *env, long nr)
+{
+	if (env->binary) {
+		write_zigzag(env, BIN_NODE, nr - env->last_node_nr);
+		env->last_node_nr = nr;
+		return;
+	}
+	write_long(env, nr);
 }
 
 void write_node_ref(write_env_t *env, const ir_node *node)
 {
-	write_long(env, get_irn_node_nr(node));
+	write_node_number(env, get_irn_node_nr(node));
 }
 
 void write_initializer(write_env_t *const env,
                        ir_initializer_t const *const ini)
 {
-	FILE *f = env->file;
 	ir_initializer_kind_t ini_kind = get_initializer_kind(ini);
-
-	fputs(get_initializer_kind_name(ini_kind), f);
-	fputc(' ', f);
+	write_symbol(env, get_initializer_kind_name(ini_kind));
 
 	switch (ini_kind) {
 	case IR_INITIALIZER_CONST:
@@ -484,37 +610,32 @@ void write_initializer(write_env_t *const env,
 
 void write_pin_state(write_env_t *env, op_pin_state state)
 {
-	fputs(get_op_pin_state_name(state), env->file);
-	fputc(' ', env->file);
+	write_symbol(env, get_op_pin_state_name(state));
 }
 
 void write_volatility(write_env_t *env, ir_volatility vol)
 {
-	fputs(get_volatility_name(vol), env->file);
-	fputc(' ', env->file);
+	write_symbol(env, get_volatility_name(vol));
 }
 
 static void write_type_state(write_env_t *env, ir_type_state state)
 {
-	fputs(get_type_state_name(state), env->file);
-	fputc(' ', env->file);
+	write_symbol(env, get_type_state_name(state));
 }
 
 void write_visibility(write_env_t *env, ir_visibility visibility)
 {
-	fputs(get_visibility_name(visibility), env->file);
-	fputc(' ', env->file);
+	write_symbol(env, get_visibility_name(visibility));
 }
 
 static void write_mode_arithmetic(write_env_t *env, ir_mode_arithmetic arithmetic)
 {
-	fputs(get_mode_arithmetic_name(arithmetic), env->file);
-	fputc(' ', env->file);
+	write_symbol(env, get_mode_arithmetic_name(arithmetic));
 }
 
 static void write_type_common(write_env_t *env, ir_type *tp)
 {
-	fputc('\t', env->file);
+	write_layout(env, '\t');
 	write_symbol(env, "type");
 	write_long(env, get_type_nr(tp));
 	write_symbol(env, get_type_opcode_name(get_type_opcode(tp)));
@@ -529,7 +650,7 @@ static void write_type(write_env_t *env, ir_type *tp);
 static bool is_internal_mode(ir_mode *mode)
 {
 	return !mode_is_int(mode) && !mode_is_reference(mode)
-	    && !mode_is_float(mode);
+	    && !mode_is_float(mode) && !mode_is_vector(mode);
 }
 
 static bool is_default_mode(ir_mode *mode)
@@ -548,7 +669,7 @@ static void write_type_primitive(write_env_t *env, ir_type *tp)
 
 	write_type_common(env, tp);
 	write_mode_ref(env, mode);
-	fputc('\n', env->file);
+	write_layout(env, '\n');
 }
 
 static void write_type_compound(write_env_t *env, ir_type *tp)
@@ -562,7 +683,7 @@ static void write_type_compound(write_env_t *env, ir_type *tp)
 	}
 	write_type_common(env, tp);
 	write_ident_null(env, get_compound_ident(tp));
-	fputc('\n', env->file);
+	write_layout(env, '\n');
 
 	for (size_t i = 0, n = get_compound_n_members(tp); i < n; ++i) {
 		ir_entity *member = get_compound_member(tp, i);
@@ -578,7 +699,7 @@ static void write_type_array(write_env_t *env, ir_type *tp)
 	write_type_common(env, tp);
 	write_type_ref(env, element_type);
 	write_unsigned(env, get_array_size(tp));
-	fputc('\n', env->file);
+	write_layout(env, '\n');
 }
 
 static void write_type_method(write_env_t *env, ir_type *tp)
@@ -600,7 +721,7 @@ static void write_type_method(write_env_t *env, ir_type *tp)
 		write_type_ref(env, get_method_param_type(tp, i));
 	for (size_t i = 0; i < nresults; i++)
 		write_type_ref(env, get_method_res_type(tp, i));
-	fputc('\n', env->file);
+	write_layout(env, '\n');
 }
 
 static void write_type_pointer(write_env_t *env, ir_type *tp)
@@ -611,7 +732,7 @@ static void write_type_pointer(write_env_t *env, ir_type *tp)
 
 	write_type_common(env, tp);
 	write_type_ref(env, points_to);
-	fputc('\n', env->file);
+	write_layout(env, '\n');
 }
 
 static void write_type(write_env_t *env, ir_type *tp)
@@ -660,7 +781,7 @@ static void write_entity(write_env_t *env, ir_entity *ent)
 		write_entity(env, aliased);
 	}
 
-	fputc('\t', env->file);
+	write_layout(env, '\t');
 	switch ((ir_entity_kind)ent->kind) {
 	case IR_ENTITY_ALIAS:           write_symbol(env, "alias");           break;
 	case IR_ENTITY_NORMAL:          write_symbol(env, "entity");          break;
@@ -747,7 +868,7 @@ static void write_entity(write_env_t *env, ir_entity *ent)
 		break;
 	}
 
-	fputc('\n', env->file);
+	write_layout(env, '\n');
 }
 
 void write_switch_table_ref(write_env_t *env, const ir_switch_table *table)
@@ -778,7 +899,7 @@ void write_pred_refs(write_env_t *env, const ir_node *node, int from)
 
 void write_node_nr(write_env_t *env, const ir_node *node)
 {
-	write_long(env, get_irn_node_nr(node));
+	write_node_number(env, get_irn_node_nr(node));
 }
 
 static void write_ASM(write_env_t *env, const ir_node *node)
@@ -876,11 +997,11 @@ static void write_node(const ir_node *node, write_env_t *env)
 	ir_op           *const op   = get_irn_op(node);
 	write_node_func *const func = get_generic_function_ptr(write_node_func, op);
 
-	fputc('\t', env->file);
+	write_layout(env, '\t');
 	if (func == NULL)
 		panic("no write_node_func for %+F", node);
 	func(env, node);
-	fputc('\n', env->file);
+	write_layout(env, '\n');
 }
 
 static void write_node_recursive(ir_node *node, write_env_t *env);
@@ -943,6 +1064,11 @@ static void write_mode(write_env_t *env, ir_mode *mode)
 		write_unsigned(env, get_mode_exponent_size(mode));
 		write_unsigned(env, get_mode_mantissa_size(mode));
 		write_unsigned(env, get_mode_float_int_overflow(mode));
+	} else if (mode_is_vector(mode)) {
+		write_symbol(env, "vector_mode");
+		write_string(env, get_mode_name(mode));
+		write_mode_ref(env, get_mode_element_mode(mode));
+		write_unsigned(env, get_mode_n_lanes(mode));
 	} else {
 		panic("cannot write internal modes");
 	}
@@ -951,18 +1077,18 @@ static void write_mode(write_env_t *env, ir_mode *mode)
 static void write_modes(write_env_t *env)
 {
 	write_symbol(env, "modes");
-	fputs("{\n", env->file);
+	write_scope_begin(env);
 
 	for (size_t i = 0, n_modes = ir_get_n_modes(); i < n_modes; i++) {
 		ir_mode *mode = ir_get_mode(i);
 		if (is_internal_mode(mode))
 			continue;
-		fputc('\t', env->file);
+		write_layout(env, '\t');
 		write_mode(env, mode);
-		fputc('\n', env->file);
+		write_layout(env, '\n');
 	}
 
-	fputs("}\n\n", env->file);
+	write_scope_end(env);
 }
 
 static void write_program(write_env_t *env)
@@ -970,15 +1096,15 @@ static void write_program(write_env_t *env)
 	write_symbol(env, "program");
 	write_scope_begin(env);
 	if (irp_prog_name_is_set()) {
-		fputc('\t', env->file);
+		write_layout(env, '\t');
 		write_symbol(env, "name");
 		write_string(env, get_irp_name());
-		fputc('\n', env->file);
+		write_layout(env, '\n');
 	}
 
 	for (ir_segment_t s = IR_SEGMENT_FIRST; s <= IR_SEGMENT_LAST; ++s) {
 		ir_type *segment_type = get_segment_type(s);
-		fputc('\t', env->file);
+		write_layout(env, '\t');
 		write_symbol(env, "segment_type");
 		write_symbol(env, get_segment_name(s));
 		if (segment_type == NULL) {
@@ -986,15 +1112,15 @@ static void write_program(write_env_t *env)
 		} else {
 			write_type_ref(env, segment_type);
 		}
-		fputc('\n', env->file);
+		write_layout(env, '\n');
 	}
 
 	for (size_t i = 0, n_asms = get_irp_n_asms(); i < n_asms; ++i) {
 		ident *asm_text = get_irp_asm(i);
-		fputc('\t', env->file);
+		write_layout(env, '\t');
 		write_symbol(env, "asm");
 		write_ident(env, asm_text);
-		fputc('\n', env->file);
+		write_layout(env, '\n');
 	}
 	write_scope_end(env);
 }
@@ -1059,13 +1185,8 @@ static void write_irg(write_env_t *env, ir_graph *irg)
 }
 
 /* Exports the whole irp to the given file in a textual form. */
-void ir_export_file(FILE *file)
+static void write_firm(write_env_t *env)
 {
-	write_env_t my_env;
-	write_env_t *env = &my_env;
-
-	memset(env, 0, sizeof(*env));
-	env->file         = file;
 	env->write_queue  = new_pdeq();
 	env->entity_queue = new_pdeq();
 
@@ -1090,10 +1211,54 @@ void ir_export_file(FILE *file)
 	del_pdeq(env->write_queue);
 }
 
+void ir_export_file(FILE *file)
+{
+	write_env_t env;
+	memset(&env, 0, sizeof(env));
+	env.file = file;
+	write_firm(&env);
+}
+
+void ir_export_binary_file(FILE *file)
+{
+	write_env_t env;
+	memset(&env, 0, sizeof(env));
+	env.file    = file;
+	env.binary  = true;
+	env.strings = new_set(string_ref_cmp, 256);
+	obstack_init(&env.strings_obst);
+
+	fwrite(binary_magic, 1, sizeof(binary_magic), file);
+	write_varint(&env, binary_version);
+	write_firm(&env);
+
+	obstack_free(&env.strings_obst, NULL);
+	del_set(env.strings);
+}
+
+int ir_export_binary(const char *filename)
+{
+	FILE *file = fopen(filename, "wb");
+	if (file == NULL) {
+		perror(filename);
+		return 1;
+	}
+
+	ir_export_binary_file(file);
+	int res = ferror(file);
+	fclose(file);
+	return res;
+}
+
 
 
 static void read_c(read_env_t *env)
 {
+	if (env->binary) {
+		env->c = env->pos != env->end ? *env->pos++ : EOF;
+		return;
+	}
+
 	int c = fgetc(env->file);
 	env->c = c;
 	if (c == '\n')
@@ -1120,6 +1285,11 @@ static void skip_ws(read_env_t *env)
 
 static void skip_to(read_env_t *env, char to_ch)
 {
+	if (env->binary) {
+		/* there are no lines to resynchronize at */
+		parse_error(env, "cannot continue after errors in binary input\n");
+		exit(1);
+	}
 	while (env->c != to_ch && env->c != EOF) {
 		read_c(env);
 	}
@@ -1139,9 +1309,71 @@ static bool expect_char(read_env_t *env, char ch)
 
 #define EXPECT(c) if (expect_char(env, (c))) {} else return
 
+/** Reads an unsigned LEB128 number of binary input. */
+static unsigned long read_varint(read_env_t *env)
+{
+	unsigned long res = 0;
+	for (unsigned shift = 0;; shift += 7) {
+		if (env->pos == env->end || shift >= sizeof(res) * 8) {
+			parse_error(env, "Malformed number\n");
+			exit(1);
+		}
+		unsigned char const b = *env->pos++;
+		res |= (unsigned long)(b & 0x7F) << shift;
+		if ((b & 0x80) == 0)
+			return res;
+	}
+}
+
+/**
+ * Reads a word or string token of binary input and returns its entry in the
+ * string table.
+ */
+static binary_string_t *read_string_ref(read_env_t *env, int tag)
+{
+	if (env->c != tag) {
+		parse_error(env, "Expected %s, got tag '%c'\n",
+		            tag == BIN_WORD ? "word" : "string", env->c);
+		exit(1);
+	}
+
+	unsigned long const ref = read_varint(env);
+	size_t              idx;
+	if (ref == 0) {
+		unsigned long const len = read_varint(env);
+		if ((size_t)(env->end - env->pos) <= len || env->pos[len] != '\0') {
+			parse_error(env, "Malformed string\n");
+			exit(1);
+		}
+		binary_string_t const str = { (char const*)env->pos, NULL };
+		ARR_APP1(binary_string_t, env->strings, str);
+		env->pos += len + 1;
+		idx = ARR_LEN(env->strings) - 1;
+	} else if (ref <= ARR_LEN(env->strings)) {
+		idx = ref - 1;
+	} else {
+		parse_error(env, "Undefined string %lu\n", ref);
+		exit(1);
+	}
+	read_c(env);
+	return &env->strings[idx];
+}
+
+static ident *read_string_ref_ident(read_env_t *env, int tag)
+{
+	binary_string_t *const str = read_string_ref(env, tag);
+	if (str->id == NULL)
+		str->id = new_id_from_str(str->str);
+	return str->id;
+}
+
 static char *read_word(read_env_t *env)
 {
 	skip_ws(env);
+	if (env->binary) {
+		char const *const str = read_string_ref(env, BIN_WORD)->str;
+		return (char*)obstack_copy0(&env->obst, str, strlen(str));
+	}
 
 	assert(obstack_object_size(&env->obst) == 0);
 	while (true) {
@@ -1169,6 +1401,10 @@ endofword:
 static char *read_string(read_env_t *env)
 {
 	skip_ws(env);
+	if (env->binary) {
+		char const *const str = read_string_ref(env, BIN_STRING)->str;
+		return (char*)obstack_copy0(&env->obst, str, strlen(str));
+	}
 	if (env->c != '"') {
 		parse_error(env, "Expected string, got '%c'\n", env->c);
 		exit(1);
@@ -1209,6 +1445,9 @@ static char *read_string(read_env_t *env)
 
 static ident *read_ident(read_env_t *env)
 {
+	if (env->binary)
+		return read_string_ref_ident(env, BIN_STRING);
+
 	char  *str = read_string(env);
 	ident *res = new_id_from_str(str);
 	obstack_free(&env->obst, str);
@@ -1217,6 +1456,9 @@ static ident *read_ident(read_env_t *env)
 
 static ident *read_symbol(read_env_t *env)
 {
+	if (env->binary)
+		return read_string_ref_ident(env, BIN_WORD);
+
 	char  *str = read_word(env);
 	ident *res = new_id_from_str(str);
 	obstack_free(&env->obst, str);
@@ -1229,14 +1471,13 @@ static ident *read_symbol(read_env_t *env)
 static char *read_string_null(read_env_t *env)
 {
 	skip_ws(env);
-	if (env->c == 'N') {
-		char *str = read_word(env);
-		if (streq(str, "NULL")) {
-			obstack_free(&env->obst, str);
-			return NULL;
-		}
-	} else if (env->c == '"') {
+	if (env->c == '"')
 		return read_string(env);
+
+	char *str = read_word(env);
+	if (streq(str, "NULL")) {
+		obstack_free(&env->obst, str);
+		return NULL;
 	}
 
 	parse_error(env, "Expected \"string\" or NULL\n");
@@ -1254,8 +1495,33 @@ static ident *read_ident_null(read_env_t *env)
 	return res;
 }
 
+/** Tests whether the next token is a number. */
+static bool is_number_next(read_env_t *env)
+{
+	skip_ws(env);
+	if (env->binary)
+		return env->c == BIN_NUMBER || env->c == BIN_NODE;
+	return isdigit(env->c) || env->c == '-';
+}
+
 static long read_long(read_env_t *env)
 {
+	if (env->binary) {
+		int const tag = env->c;
+		if (tag != BIN_NUMBER && tag != BIN_NODE) {
+			parse_error(env, "Expected number, got tag '%c'\n", tag);
+			exit(1);
+		}
+		unsigned long const zigzag = read_varint(env);
+		long                value  = (long)(zigzag >> 1) ^ -(long)(zigzag & 1);
+		if (tag == BIN_NODE) {
+			value += env->last_node_nr;
+			env->last_node_nr = value;
+		}
+		read_c(env);
+		return value;
+	}
+
 	skip_ws(env);
 	if (!isdigit(env->c) && env->c != '-') {
 		parse_error(env, "Expected number, got '%c'\n", env->c);
@@ -1304,11 +1570,11 @@ static void expect_list_begin(read_env_t *env)
 
 static bool list_has_next(read_env_t *env)
 {
-	if (feof(env->file)) {
+	skip_ws(env);
+	if (env->c == EOF) {
 		parse_error(env, "Unexpected EOF while reading list");
 		exit(1);
 	}
-	skip_ws(env);
 	if (env->c == ']') {
 		read_c(env);
 		return false;
@@ -1362,6 +1628,9 @@ static ir_type *get_type(read_env_t *env, long typenr)
 
 ir_type *read_type_ref(read_env_t *env)
 {
+	if (is_number_next(env))
+		return get_type(env, read_long(env));
+
 	char *str = read_word(env);
 	if (streq(str, "unknown")) {
 		obstack_free(&env->obst, str);
@@ -1775,14 +2044,16 @@ static void read_entity(read_env_t *env, ir_entity_kind kind)
 			entity, (mtp_additional_properties) read_long(env));
 		break;
 	case IR_ENTITY_PARAMETER: {
-		char  *str = read_word(env);
 		size_t parameter_number;
-		if (streq(str, "va_start")) {
-			parameter_number = IR_VA_START_PARAMETER_NUMBER;
+		if (is_number_next(env)) {
+			parameter_number = read_size_t(env);
 		} else {
-			parameter_number = atol(str);
+			char *str = read_word(env);
+			if (!streq(str, "va_start"))
+				parse_error(env, "expected parameter number, got '%s'\n", str);
+			parameter_number = IR_VA_START_PARAMETER_NUMBER;
+			obstack_free(&env->obst, str);
 		}
-		obstack_free(&env->obst, str);
 		entity = new_parameter_entity(owner, parameter_number, type);
 		set_entity_offset(entity, read_int(env));
 		set_entity_bitfield_offset(entity, read_unsigned(env));
@@ -2126,6 +2397,13 @@ static void read_modes(read_env_t *env)
 			               overflow);
 			break;
 		}
+		case kw_vector_mode: {
+			const char *name    = read_string(env);
+			ir_mode    *element = read_mode_ref(env);
+			unsigned    n_lanes = read_unsigned(env);
+			new_vector_mode(name, element, n_lanes);
+			break;
+		}
 
 		default:
 			skip_to(env, '\n');
@@ -2178,22 +2456,22 @@ int ir_import(const char *filename)
 	return res;
 }
 
-int ir_import_file(FILE *input, const char *inputname)
+/**
+ * Reads a whole program. The input of @p env must already be set up, the
+ * first character or tag has not been read yet.
+ */
+static int read_firm(read_env_t *env, const char *inputname)
 {
-	read_env_t          myenv;
-	int                 oldoptimize = get_optimize();
-	read_env_t         *env         = &myenv;
+	int oldoptimize = get_optimize();
 
 	readers_init();
 	symtbl_init();
 
-	memset(env, 0, sizeof(*env));
 	obstack_init(&env->obst);
 	obstack_init(&env->preds_obst);
 	env->idset      = new_set(id_cmp, 128);
 	env->fixedtypes = NEW_ARR_F(ir_type *, 0);
 	env->inputname  = inputname;
-	env->file       = input;
 	env->line       = 1;
 	env->delayed_initializers = NEW_ARR_F(delayed_initializer_t, 0);
 
@@ -2201,7 +2479,7 @@ int ir_import_file(FILE *input, const char *inputname)
 	read_c(env);
 
 	/* if the first line starts with '#', it contains a comment. */
-	if (env->c == '#')
+	if (!env->binary && env->c == '#')
 		skip_to(env, '\n');
 
 	set_optimize(0);
@@ -2278,3 +2556,108 @@ int ir_import_file(FILE *input, const char *inputname)
 
 	return env->read_errors;
 }
+
+int ir_import_file(FILE *input, const char *inputname)
+{
+	read_env_t env;
+	memset(&env, 0, sizeof(env));
+	env.file = input;
+	return read_firm(&env, inputname);
+}
+
+/** Reads a program in binary format from memory. */
+static int read_binary(const void *data, size_t size, const char *inputname)
+{
+	const unsigned char *const begin = (const unsigned char*)data;
+	if (size < sizeof(binary_magic)
+	    || memcmp(begin, binary_magic, sizeof(binary_magic)) != 0) {
+		fprintf(stderr, "%s: error not a binary firm file\n", inputname);
+		return 1;
+	}
+
+	read_env_t env;
+	memset(&env, 0, sizeof(env));
+	env.binary  = true;
+	env.begin   = begin;
+	env.pos     = begin + sizeof(binary_magic);
+	env.end     = begin + size;
+	env.strings = NEW_ARR_F(binary_string_t, 0);
+	env.inputname = inputname;
+
+	int res;
+	unsigned long const version = read_varint(&env);
+	if (version != binary_version) {
+		fprintf(stderr, "%s: error unsupported binary firm version %lu\n",
+		        inputname, version);
+		res = 1;
+	} else {
+		res = read_firm(&env, inputname);
+	}
+	DEL_ARR_F(env.strings);
+	return res;
+}
+
+int ir_import_binary_file(FILE *input, const char *inputname)
+{
+	struct obstack obst;
+	obstack_init(&obst);
+	char   buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), input)) > 0)
+		obstack_grow(&obst, buf, n);
+
+	int res;
+	if (ferror(input)) {
+		perror(inputname);
+		res = 1;
+	} else {
+		size_t const size = obstack_object_size(&obst);
+		res = read_binary(obstack_finish(&obst), size, inputname);
+	}
+	obstack_free(&obst, NULL);
+	return res;
+}
+
+int ir_import_binary(const char *filename)
+{
+#ifdef _WIN32
+	FILE *file = fopen(filename, "rb");
+	if (file == NULL) {
+		perror(filename);
+		return 1;
+	}
+
+	int res = ir_import_binary_file(file, filename);
+	fclose(file);
+	return res;
+#else
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		perror(filename);
+		return 1;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		perror(filename);
+		close(fd);
+		return 1;
+	}
+	if (st.st_size == 0) {
+		close(fd);
+		return read_binary(NULL, 0, filename);
+	}
+
+	/* map the file, so reading needs no copy and no buffering */
+	void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		perror(filename);
+		return 1;
+	}
+
+	int res = read_binary(data, st.st_size, filename);
+	munmap(data, st.st_size);
+	return res;
+#endif
+}
@@ -6,6 +6,7 @@
 #include "irnode_t.h"
 #include "obst.h"
 #include "pdeq.h"
+#include "pmap.h"
 #include "set.h"
 #include "type_t.h"
 #include "typerep.h"
@@ -21,12 +22,26 @@ typedef struct delayed_pred_t {
 	long     preds[];
 } delayed_pred_t;
 
+/** A string of the binary string table while reading. */
+typedef struct binary_string_t {
+	const char *str;
+	ident      *id;  /**< the string as ident, NULL if not needed yet */
+} binary_string_t;
+
 typedef struct read_env_t {
-	int            c;           /**< currently read char */
+	int            c;           /**< currently read char, or the tag of the
+	                                 current token of binary input */
 	FILE          *file;
 	const char    *inputname;
 	unsigned       line;
 
+	bool                 binary;  /**< reading the binary format */
+	const unsigned char *begin;   /**< binary input */
+	const unsigned char *pos;     /**< position after the current tag */
+	const unsigned char *end;
+	binary_string_t     *strings; /**< binary string table */
+	long                 last_node_nr;
+
 	ir_graph      *irg;
 	set           *idset;       /**< id_entry set, which maps from file ids to
 	                                 new Firm elements */
@@ -39,9 +54,14 @@ typedef struct read_env_t {
 } read_env_t;
 
 typedef struct write_env_t {
-	FILE *file;
-	pdeq *write_queue;
-	pdeq *entity_queue;
+	FILE  *file;
+	pdeq  *write_queue;
+	pdeq  *entity_queue;
+	bool   binary;    /**< write the binary format */
+	set   *strings;   /**< binary string table, string_ref_t elements */
+	size_t n_strings;
+	struct obstack strings_obst; /**< copies of the written strings */
+	long   last_node_nr;
 } write_env_t;
 
 void write_align(write_env_t *env, ir_align align);
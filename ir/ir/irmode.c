@@ -8,8 +8,10 @@
  * @brief    Data modes of operations.
  * @author   Martin Trapp, Christian Schaefer, Goetz Lindenmaier, Mathias Heil
  */
+#include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "irprog_t.h"
 #include "irmode_t.h"
@@ -34,6 +36,8 @@ static bool modes_are_equal(const ir_mode *m, const ir_mode *n)
 		return false;
 	if (m->sort == irms_auxiliary || m->sort == irms_data)
 		return streq(m->name, n->name);
+	if (m->sort == irms_vector)
+		return m->element_mode == n->element_mode && m->n_lanes == n->n_lanes;
 	return m->arithmetic        == n->arithmetic
 	    && m->size              == n->size
 	    && m->sign              == n->sign
@@ -207,6 +211,24 @@ ir_mode *new_non_arithmetic_mode(const char *name, unsigned bit_size)
 	return register_mode(result);
 }
 
+ir_mode *new_vector_mode(const char *name, ir_mode *element_mode,
+                         unsigned n_lanes)
+{
+	if (!mode_is_int(element_mode) && !mode_is_float(element_mode))
+		panic("cannot create vector mode of %+F", element_mode);
+	if (get_mode_size_bits(element_mode) % 8 != 0)
+		panic("cannot create vector mode: lanes must be a multiple of 8 bits");
+	if (n_lanes < 2)
+		panic("cannot create vector mode with less than 2 lanes");
+
+	unsigned const bit_size = n_lanes * get_mode_size_bits(element_mode);
+	ir_mode *result = alloc_mode(name, irms_vector, irma_none, bit_size,
+	                             mode_is_signed(element_mode), 0);
+	result->element_mode = element_mode;
+	result->n_lanes      = n_lanes;
+	return register_mode(result);
+}
+
 static ir_mode *new_non_data_mode(const char *name)
 {
 	ir_mode *result = alloc_mode(name, irms_auxiliary, irma_none, 0, 0, 0);
@@ -301,6 +323,11 @@ int (mode_is_reference)(const ir_mode *mode)
 	return mode_is_reference_(mode);
 }
 
+int (mode_is_vector)(const ir_mode *mode)
+{
+	return mode_is_vector_(mode);
+}
+
 int (mode_is_num)(const ir_mode *mode)
 {
 	return mode_is_num_(mode);
@@ -321,6 +348,38 @@ unsigned (get_mode_exponent_size)(const ir_mode *mode)
 	return get_mode_exponent_size_(mode);
 }
 
+ir_mode *(get_mode_element_mode)(const ir_mode *mode)
+{
+	return get_mode_element_mode_(mode);
+}
+
+unsigned (get_mode_n_lanes)(const ir_mode *mode)
+{
+	return get_mode_n_lanes_(mode);
+}
+
+ir_mode *find_vector_mode(const ir_mode *element_mode, unsigned n_lanes)
+{
+	ir_mode n;
+	memset(&n, 0, sizeof(n));
+	n.sort         = irms_vector;
+	n.element_mode = (ir_mode*)element_mode;
+	n.n_lanes      = n_lanes;
+	return find_mode(&n);
+}
+
+ir_mode *get_vector_mode(ir_mode *element_mode, unsigned n_lanes)
+{
+	ir_mode *mode = find_vector_mode(element_mode, n_lanes);
+	if (mode == NULL) {
+		char name[32];
+		snprintf(name, sizeof(name), "V%u%s", n_lanes,
+		         get_mode_name(element_mode));
+		mode = new_vector_mode(name, element_mode, n_lanes);
+	}
+	return mode;
+}
+
 float_int_conversion_overflow_style_t get_mode_float_int_overflow(
 		const ir_mode *mode)
 {
@@ -362,6 +421,7 @@ int smaller_mode(const ir_mode *sm, const ir_mode *lm)
 		case irms_internal_boolean:
 		case irms_reference:
 		case irms_float_number:
+		case irms_vector:
 			/* int to float works if the float is large enough */
 			return false;
 		}
@@ -376,6 +436,7 @@ int smaller_mode(const ir_mode *sm, const ir_mode *lm)
 	case irms_data:
 	case irms_internal_boolean:
 	case irms_reference:
+	case irms_vector:
 		/* do exist machines out there with different pointer lengths ?*/
 		return false;
 	}
@@ -494,6 +555,7 @@ ir_mode *find_double_bits_int_mode(const ir_mode *mode)
 
 int mode_has_signed_zero(const ir_mode *mode)
 {
+	mode = get_mode_element_mode(mode);
 	switch (mode->arithmetic) {
 	case irma_ieee754:
 	case irma_x86_extended_float:
@@ -507,6 +569,7 @@ int mode_has_signed_zero(const ir_mode *mode)
 
 int mode_overflow_on_unary_Minus(const ir_mode *mode)
 {
+	mode = get_mode_element_mode(mode);
 	switch (mode->arithmetic) {
 	case irma_twos_complement:
 		return true;
@@ -520,6 +583,7 @@ int mode_overflow_on_unary_Minus(const ir_mode *mode)
 
 int mode_wrap_around(const ir_mode *mode)
 {
+	mode = get_mode_element_mode(mode);
 	switch (mode->arithmetic) {
 	case irma_twos_complement:
 	case irma_none:
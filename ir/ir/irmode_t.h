@@ -28,11 +28,14 @@
 #define mode_is_float(mode)            mode_is_float_(mode)
 #define mode_is_int(mode)              mode_is_int_(mode)
 #define mode_is_reference(mode)        mode_is_reference_(mode)
+#define mode_is_vector(mode)           mode_is_vector_(mode)
 #define mode_is_num(mode)              mode_is_num_(mode)
 #define mode_is_data(mode)             mode_is_data_(mode)
 #define get_type_for_mode(mode)        get_type_for_mode_(mode)
 #define get_mode_mantissa_size(mode)   get_mode_mantissa_size_(mode)
 #define get_mode_exponent_size(mode)   get_mode_exponent_size_(mode)
+#define get_mode_element_mode(mode)    get_mode_element_mode_(mode)
+#define get_mode_n_lanes(mode)         get_mode_n_lanes_(mode)
 
 /** Helper values for ir_mode_sort. */
 enum ir_mode_sort_helper {
@@ -50,6 +53,7 @@ typedef enum ir_mode_sort {
 	irms_reference        = 3 | irmsh_is_data,
 	irms_int_number       = 4 | irmsh_is_data | irmsh_is_num,
 	irms_float_number     = 5 | irmsh_is_data | irmsh_is_num,
+	irms_vector           = 6 | irmsh_is_data,
 } ir_mode_sort;
 
 /**
@@ -92,6 +96,9 @@ struct ir_mode {
 	/** For reference modes, a signed integer mode used to add/subtract
 	 * offsets. */
 	ir_mode            *offset_mode;
+	/** For vector modes, the mode of the lanes. */
+	ir_mode            *element_mode;
+	unsigned            n_lanes;   /**< Number of lanes of a vector mode. */
 };
 
 static inline ident *get_mode_ident_(const ir_mode *mode)
@@ -146,6 +153,11 @@ static inline int mode_is_reference_(const ir_mode *mode)
 	return get_mode_sort(mode) == irms_reference;
 }
 
+static inline int mode_is_vector_(const ir_mode *mode)
+{
+	return get_mode_sort(mode) == irms_vector;
+}
+
 static inline int mode_is_num_(const ir_mode *mode)
 {
 	return (get_mode_sort(mode) & irmsh_is_num) != 0;
@@ -171,6 +183,22 @@ static inline unsigned get_mode_exponent_size_(const ir_mode *mode)
 	return mode->float_desc.exponent_size;
 }
 
+static inline ir_mode *get_mode_element_mode_(const ir_mode *mode)
+{
+	return mode_is_vector_(mode) ? mode->element_mode : (ir_mode*)mode;
+}
+
+static inline unsigned get_mode_n_lanes_(const ir_mode *mode)
+{
+	return mode_is_vector_(mode) ? mode->n_lanes : 1;
+}
+
+/**
+ * Returns the vector mode with @p n_lanes lanes of @p element_mode, creating
+ * it if it does not exist yet.
+ */
+ir_mode *get_vector_mode(ir_mode *element_mode, unsigned n_lanes);
+
 /** mode module initialization, call once before use of any other function **/
 void init_mode(void);
 
@@ -10,6 +10,7 @@
  */
 #include <string.h>
 
+#include "array_t.h"
 #include "pset_new.h"
 #include "ident.h"
 #include "irnode_t.h"
@@ -75,13 +76,37 @@ ir_relation get_inversed_relation(ir_relation relation)
 	return code;
 }
 
+ir_node **new_irn_in(ir_graph *const irg, size_t const n_in)
+{
+	assert(n_in > 0);
+	size_t const size = ARR_ELTS_OFFS + n_in * sizeof(ir_node*);
+	return (ir_node**)ir_init_arr_d(arena_alloc(&irg->node_arena, size), n_in);
+}
+
+void free_irn_in(ir_graph *const irg, ir_node **const in)
+{
+	ir_arr_descr *const dp = ARR_DESCR(in);
+	arena_free(&irg->node_arena, dp,
+	           ARR_ELTS_OFFS + dp->allocated * sizeof(ir_node*));
+}
+
+void free_irn(ir_graph *const irg, ir_node *const node)
+{
+	if (irn_has_flexible_in(node))
+		DEL_ARR_F(node->in);
+	else
+		free_irn_in(irg, node->in);
+	arena_free(&irg->node_arena, node, get_irn_alloc_size(node));
+}
+
 ir_node *new_ir_node(dbg_info *db, ir_graph *irg, ir_node *block, ir_op *op,
                      ir_mode *mode, int arity, ir_node *const *in)
 {
 	assert(mode != NULL);
 
-	size_t   const node_size = offsetof(ir_node, attr) + op->attr_size;
-	ir_node *const res       = (ir_node*)OALLOCNZ(get_irg_obstack(irg), char, node_size);
+	size_t   const node_size = get_irn_size(op);
+	ir_node *const res       = (ir_node*)arena_alloc(&irg->node_arena, node_size);
+	memset(res, 0, node_size);
 
 	res->kind     = k_ir_node;
 	res->op       = op;
@@ -96,7 +121,7 @@ ir_node *new_ir_node(dbg_info *db, ir_graph *irg, ir_node *block, ir_op *op,
 		if (op->opar == oparity_dynamic)
 			res->in = NEW_ARR_F(ir_node *, (arity+1));
 		else
-			res->in = NEW_ARR_D(ir_node*, get_irg_obstack(irg), arity + 1);
+			res->in = new_irn_in(irg, arity + 1);
 		MEMCPY(&res->in[1], in, arity);
 	}
 
@@ -164,14 +189,23 @@ void set_irn_in(ir_node *const node, int const arity, ir_node *const *const in)
 		edges_notify_edge(node, i, NULL, (*pOld_in)[i+1], irg);
 	}
 
-	if (arity != (int)ARR_LEN(*pOld_in) - 1) {
-		ir_node * block = (*pOld_in)[0];
-		*pOld_in = NEW_ARR_D(ir_node*, get_irg_obstack(irg), arity + 1);
-		(*pOld_in)[0] = block;
+	ir_node **const old_in   = *pOld_in;
+	bool      const flexible = irn_has_flexible_in(node);
+	if (arity != (int)ARR_LEN(old_in) - 1) {
+		*pOld_in = flexible ? NEW_ARR_F(ir_node*, arity + 1)
+		                    : new_irn_in(irg, arity + 1);
+		(*pOld_in)[0] = old_in[0];
 	}
 	fix_backedges(get_irg_obstack(irg), node);
 
 	MEMCPY(*pOld_in + 1, in, arity);
+	/* in may point into the old array, so release it afterwards */
+	if (*pOld_in != old_in) {
+		if (flexible)
+			DEL_ARR_F(old_in);
+		else
+			free_irn_in(irg, old_in);
+	}
 
 	/* update irg flags */
 	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUTS | IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO);
@@ -563,6 +597,10 @@ const char *get_builtin_kind_name(ir_builtin_kind kind)
 		X(ir_bk_may_alias);
 		X(ir_bk_va_start);
 		X(ir_bk_va_arg);
+		X(ir_bk_min);
+		X(ir_bk_max);
+		X(ir_bk_saturating_add);
+		X(ir_bk_saturating_sub);
 	}
 	return "<unknown>";
 #undef X
@@ -835,6 +873,10 @@ int is_irn_const_memory(const ir_node *node)
 		case ir_bk_outport:
 		case ir_bk_saturating_increment:
 		case ir_bk_may_alias:
+		case ir_bk_min:
+		case ir_bk_max:
+		case ir_bk_saturating_add:
+		case ir_bk_saturating_sub:
 			return true;
 		}
 		panic("invalid Builtin %+F", node);
@@ -98,6 +98,7 @@ typedef struct block_attr {
 	ir_entity  *entity;         /**< entity representing this block */
 	ir_node    *phis;           /**< The list of Phi nodes in this block. */
 	double      execfreq;       /**< block execution frequency */
+	ir_loop    *loop;           /**< innermost loop containing this block */
 } block_attr;
 
 /** Attributes for Cond nodes. */
@@ -231,12 +232,31 @@ typedef struct proj_attr {
 	unsigned num; /**< number of tuple sub-value which is projected */
 } proj_attr;
 
+/** Attributes for Extract and Insert nodes. */
+typedef struct lane_attr {
+	unsigned lane; /**< number of the accessed lane */
+} lane_attr;
+
+/** Attributes for Shuffle nodes. */
+typedef struct shuffle_attr {
+	ir_tarval *mask; /**< vector of lane numbers */
+} shuffle_attr;
+
 /** Attributes for Switch nodes. */
 typedef struct switch_attr {
 	unsigned         n_outs;
 	ir_switch_table *table;
 } switch_attr;
 
+/**
+ * Attributes of Id and Deleted nodes.  They describe the memory of the node,
+ * which was allocated for its previous opcode.
+ */
+typedef struct corpse_attr {
+	unsigned size;        /**< bytes allocated for the node */
+	bool     flexible_in; /**< the in array is a flexible array */
+} corpse_attr;
+
 /** Union with all possible node attributes. */
 typedef union ir_attr {
 	block_attr     block;
@@ -261,6 +281,9 @@ typedef union ir_attr {
 	mod_attr       mod;
 	asm_attr       assem;
 	switch_attr    switcha;
+	lane_attr      lane;
+	shuffle_attr   shuffle;
+	corpse_attr    corpse;
 } ir_attr;
 
 /**
@@ -289,6 +312,12 @@ typedef struct ir_def_use_edges {
 
 /**
  * Data of a function graph node.
+ *
+ * Fields used by walkers and local optimizations come first so they share a
+ * cache line; rarely used fields follow. On 64 bit hosts the first cache
+ * line ends after the out edges (o); the everlasting out edges (edge_info,
+ * 48 bytes) do not fit into it and start at offset 72. Loop information is
+ * only kept for blocks (see block_attr).
  */
 struct ir_node {
 	firm_kind        kind;     /**< Distinguishes this node from others. */
@@ -301,17 +330,15 @@ struct ir_node {
 	void            *link;     /**< To attach additional information to the
 	                                node, e.g. used during optimization to link
 	                                to nodes that shall replace a node. */
-	dbg_info        *dbi;      /**< Information for debug support. */
-	long             node_nr;  /**< Globally unique node number. */
-
 	union {
 		ir_def_use_edges *out;    /**< array of def-use edges. */
 		unsigned          n_outs; /**< number of def-use edges (temporarily used
 		                               during construction of data structure) */
 	} o;
-	ir_loop         *loop;         /**< Loop information. */
 	void            *backend_info;
 	irn_edges_info_t edge_info;    /**< Everlasting out edges. */
+	dbg_info        *dbi;      /**< Information for debug support. */
+	long             node_nr;  /**< Globally unique node number. */
 
 	/** Attributes of this node. Depends on opcode. Must be last field. */
 	ir_attr attr;
@@ -543,6 +570,42 @@ static inline bool is_irn_dynamic(ir_node const *const n)
 	return get_irn_op(n)->opar == oparity_dynamic;
 }
 
+/**
+ * Returns the number of bytes allocated for a node with opcode @p op.  There
+ * is always room for the attributes of a corpse.
+ */
+static inline size_t get_irn_size(ir_op const *const op)
+{
+	size_t const attr_size = op->attr_size > sizeof(corpse_attr)
+	                       ? op->attr_size : sizeof(corpse_attr);
+	return offsetof(ir_node, attr) + attr_size;
+}
+
+/**
+ * Checks whether a node is the remainder of an exchanged or killed node.
+ */
+static inline bool irn_is_corpse(ir_node const *const n)
+{
+	return is_Id(n) || is_Deleted(n);
+}
+
+/** Returns the number of bytes allocated for a node. */
+static inline size_t get_irn_alloc_size(ir_node const *const n)
+{
+	return irn_is_corpse(n) ? n->attr.corpse.size : get_irn_size(n->op);
+}
+
+/**
+ * Checks whether the in array of a node is a flexible array instead of being
+ * allocated from the node arena of its graph.
+ */
+static inline bool irn_has_flexible_in(ir_node const *const n)
+{
+	if (irn_is_corpse(n))
+		return n->attr.corpse.flexible_in;
+	return is_irn_dynamic(n) || (is_Block(n) && n->attr.block.dynamic_ins);
+}
+
 /**
  * Get the predecessor block.
  *
@@ -732,6 +795,15 @@ static inline const ir_switch_table_entry *ir_switch_table_get_entry_const(
 
 void ir_register_getter_ops(void);
 
+/** Allocates an in array with @p n_in entries from the node arena. */
+ir_node **new_irn_in(ir_graph *irg, size_t n_in);
+
+/** Releases an in array allocated by new_irn_in(). */
+void free_irn_in(ir_graph *irg, ir_node **in);
+
+/** Releases the memory of a node and its in array. */
+void free_irn(ir_graph *irg, ir_node *node);
+
 /** remove keep alive edge to node by rerouting the edge to a Bad node.
  * (rerouting is preferable to removing when we are in a walker which also
  *  accesses the End node) */
@@ -439,6 +439,20 @@ static int attrs_equal_ASM(const ir_node *a, const ir_node *b)
 	return except_attrs_equal(&attr_a->exc, &attr_b->exc);
 }
 
+/** Compares the attributes of two Extract/Insert nodes. */
+static int attrs_equal_lane(const ir_node *a, const ir_node *b)
+{
+	const lane_attr *attr_a = &a->attr.lane;
+	const lane_attr *attr_b = &b->attr.lane;
+	return attr_a->lane == attr_b->lane;
+}
+
+/** Compares the attributes of two Shuffle nodes. */
+static int attrs_equal_Shuffle(const ir_node *a, const ir_node *b)
+{
+	return get_Shuffle_mask(a) == get_Shuffle_mask(b);
+}
+
 static void default_copy_attr(ir_graph *irg, const ir_node *old_node,
                               ir_node *new_node)
 {
@@ -465,9 +479,12 @@ static void block_copy_attr(ir_graph *irg, const ir_node *old_node,
                             ir_node *new_node)
 {
 	default_copy_attr(irg, old_node, new_node);
+	/* the in array of the copy is never a flexible array */
+	new_node->attr.block.dynamic_ins   = false;
 	new_node->attr.block.phis          = NULL;
 	new_node->attr.block.backedge      = new_backedge_arr(get_irg_obstack(irg), get_irn_arity(new_node));
 	new_node->attr.block.block_visited = 0;
+	new_node->attr.block.loop          = NULL;
 	memset(&new_node->attr.block.dom, 0, sizeof(new_node->attr.block.dom));
 	memset(&new_node->attr.block.pdom, 0, sizeof(new_node->attr.block.pdom));
 	/* It should be safe to copy the entity here, as it has no back-link to the
@@ -603,6 +620,8 @@ void firm_init_op(void)
 	set_op_attrs_equal(op_CopyB,   attrs_equal_CopyB);
 	set_op_attrs_equal(op_Div,     attrs_equal_Div);
 	set_op_attrs_equal(op_Dummy,   attrs_equal_false);
+	set_op_attrs_equal(op_Extract, attrs_equal_lane);
+	set_op_attrs_equal(op_Insert,  attrs_equal_lane);
 	set_op_attrs_equal(op_Load,    attrs_equal_Load);
 	set_op_attrs_equal(op_Member,  attrs_equal_Member);
 	set_op_attrs_equal(op_Mod,     attrs_equal_Mod);
@@ -610,6 +629,7 @@ void firm_init_op(void)
 	set_op_attrs_equal(op_Phi,     attrs_equal_Phi);
 	set_op_attrs_equal(op_Proj,    attrs_equal_Proj);
 	set_op_attrs_equal(op_Sel,     attrs_equal_Sel);
+	set_op_attrs_equal(op_Shuffle, attrs_equal_Shuffle);
 	set_op_attrs_equal(op_Size,    attrs_equal_typeconst);
 	set_op_attrs_equal(op_Store,   attrs_equal_Store);
 	set_op_attrs_equal(op_Unknown, attrs_equal_false);
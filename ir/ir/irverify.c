@@ -636,11 +636,17 @@ static int verify_node_Call(const ir_node *n)
 	return fine;
 }
 
+/** Returns true if @p mode is numeric or a vector with numeric lanes. */
+static int mode_is_num_lanes(const ir_mode *mode)
+{
+	return mode_is_num(get_mode_element_mode(mode));
+}
+
 static int verify_node_Add(const ir_node *n)
 {
 	bool     fine = true;
 	ir_mode *mode = get_irn_mode(n);
-	if (mode_is_num(mode)) {
+	if (mode_is_num_lanes(mode)) {
 		fine &= check_mode_same_input(n, n_Add_left, "left");
 		fine &= check_mode_same_input(n, n_Add_right, "right");
 	} else if (mode_is_reference(mode)) {
@@ -668,7 +674,7 @@ static int verify_node_Sub(const ir_node *n)
 {
 	bool     fine = true;
 	ir_mode *mode = get_irn_mode(n);
-	if (mode_is_num(mode)) {
+	if (mode_is_num_lanes(mode)) {
 		ir_mode *mode_left = get_irn_mode(get_Sub_left(n));
 		if (mode_is_reference(mode_left)) {
 			fine &= check_input_mode(n, n_Sub_right, "right", mode_left);
@@ -688,14 +694,14 @@ static int verify_node_Sub(const ir_node *n)
 
 static int verify_node_Minus(const ir_node *n)
 {
-	bool fine = check_mode_func(n, mode_is_num, "numeric");
+	bool fine = check_mode_func(n, mode_is_num_lanes, "numeric");
 	fine &= check_mode_same_input(n, n_Minus_op, "op");
 	return fine;
 }
 
 static int verify_node_Mul(const ir_node *n)
 {
-	bool fine = check_mode_func(n, mode_is_num, "numeric");
+	bool fine = check_mode_func(n, mode_is_num_lanes, "numeric");
 	fine &= check_mode_same_input(n, n_Mul_left, "left");
 	fine &= check_mode_same_input(n, n_Mul_right, "right");
 	return fine;
@@ -739,7 +745,7 @@ static int verify_node_Mod(const ir_node *n)
 
 static int mode_is_intb(const ir_mode *mode)
 {
-	return mode_is_int(mode) || mode == mode_b;
+	return mode_is_int(get_mode_element_mode(mode)) || mode == mode_b;
 }
 
 static int verify_node_And(const ir_node *n)
@@ -787,6 +793,10 @@ static int verify_node_Cmp(const ir_node *n)
 		     moder);
 		fine = false;
 	}
+	if (mode_is_vector(model)) {
+		warn(n, "cannot compare vector values of mode %+F", model);
+		fine = false;
+	}
 	return fine;
 }
 
@@ -824,6 +834,14 @@ static int verify_node_Conv(const ir_node *n)
 	bool fine = check_mode_func(n, mode_is_data_not_b, "data_not_b");
 	fine &= check_input_func(n, n_Conv_op, "op", mode_is_data_not_b,
 	                         "data_not_b");
+	/* vectors are converted lane-wise */
+	ir_mode *op_mode = get_irn_mode(get_Conv_op(n));
+	ir_mode *mode    = get_irn_mode(n);
+	if (get_mode_n_lanes(op_mode) != get_mode_n_lanes(mode)) {
+		warn(n, "cannot convert %+F to %+F with a different number of lanes",
+		     op_mode, mode);
+		fine = false;
+	}
 	return fine;
 }
 
@@ -837,15 +855,96 @@ static int verify_node_Bitcast(const ir_node *n)
 	ir_mode *dst_mode = get_irn_mode(n);
 	/* Note: This constraint is currently strict as you can use Conv
 	 * for the other cases and we want to avoid having 2 nodes representing the
-	 * same operation. We might loosen this constraint in the future. */
+	 * same operation. We might loosen this constraint in the future. Vectors
+	 * have no arithmetic of their own, Conv works lane-wise for them. */
+	bool const vector = mode_is_vector(src_mode) || mode_is_vector(dst_mode);
 	if (get_mode_size_bits(src_mode) != get_mode_size_bits(dst_mode)
-	    || get_mode_arithmetic(src_mode) == get_mode_arithmetic(dst_mode)) {
+	    || src_mode == dst_mode
+	    || (!vector && get_mode_arithmetic(src_mode)
+	                   == get_mode_arithmetic(dst_mode))) {
 	    warn(n, "bitcast only allowed for modes with same size and different arithmetic");
 	    fine = false;
 	}
 	return fine;
 }
 
+static int verify_node_Broadcast(const ir_node *n)
+{
+	bool fine = check_mode_func(n, mode_is_vector, "vector");
+	if (fine) {
+		ir_mode *element = get_mode_element_mode(get_irn_mode(n));
+		fine &= check_input_mode(n, n_Broadcast_op, "op", element);
+	}
+	return fine;
+}
+
+/**
+ * Checks that @p lane is a lane of vector mode @p mode. Displays a message
+ * and returns false otherwise.
+ */
+static bool check_lane(const ir_node *n, unsigned lane, const ir_mode *mode)
+{
+	if (lane >= get_mode_n_lanes(mode)) {
+		warn(n, "lane %u out of range for mode %+F", lane, mode);
+		return false;
+	}
+	return true;
+}
+
+static int verify_node_Extract(const ir_node *n)
+{
+	bool fine = check_input_func(n, n_Extract_vector, "vector", mode_is_vector,
+	                             "vector");
+	if (fine) {
+		ir_mode *vector_mode = get_irn_mode(get_Extract_vector(n));
+		fine &= check_mode(n, get_mode_element_mode(vector_mode));
+		fine &= check_lane(n, get_Extract_lane(n), vector_mode);
+	}
+	return fine;
+}
+
+static int verify_node_Insert(const ir_node *n)
+{
+	bool fine = check_mode_func(n, mode_is_vector, "vector");
+	fine &= check_mode_same_input(n, n_Insert_vector, "vector");
+	if (fine) {
+		ir_mode *mode = get_irn_mode(n);
+		fine &= check_input_mode(n, n_Insert_value, "value",
+		                         get_mode_element_mode(mode));
+		fine &= check_lane(n, get_Insert_lane(n), mode);
+	}
+	return fine;
+}
+
+static int verify_node_Shuffle(const ir_node *n)
+{
+	bool fine = check_mode_func(n, mode_is_vector, "vector");
+	fine &= check_mode_same_input(n, n_Shuffle_left, "left");
+	fine &= check_mode_same_input(n, n_Shuffle_right, "right");
+	if (!fine)
+		return false;
+
+	ir_mode   *mode      = get_irn_mode(n);
+	ir_tarval *mask      = get_Shuffle_mask(n);
+	ir_mode   *mask_mode = get_tarval_mode(mask);
+	unsigned   n_lanes   = get_mode_n_lanes(mode);
+	if (!mode_is_vector(mask_mode)
+	    || !mode_is_int(get_mode_element_mode(mask_mode))
+	    || get_mode_n_lanes(mask_mode) != n_lanes) {
+		warn(n, "mask mode %+F does not fit mode %+F", mask_mode, mode);
+		return false;
+	}
+	for (unsigned i = 0; i < n_lanes; ++i) {
+		ir_tarval *lane = get_tarval_lane(mask, i);
+		if (!tarval_is_long(lane) || get_tarval_long(lane) < 0
+		    || get_tarval_long(lane) >= 2 * (long)n_lanes) {
+			warn(n, "mask lane %u selects no lane of the operands", i);
+			fine = false;
+		}
+	}
+	return fine;
+}
+
 static int mode_is_dataMb(const ir_mode *mode)
 {
 	return mode_is_data(mode) || mode == mode_M;
@@ -999,12 +1098,12 @@ static bool check_dominance_for_node(const ir_node *use)
 
 #ifdef DEBUG_libfirm
 /**
- * Check if node is stored on the obstack belonging to the ir graph
+ * Check if node is stored in the node arena belonging to the ir graph
  */
 static bool check_irn_storage(ir_graph *irg, const ir_node *node)
 {
 	if (!node_is_in_irgs_storage(irg, node)) {
-		warn(node, "node is not stored on graph obstack");
+		warn(node, "node is not stored in graph node arena");
 		return false;
 	}
 	return true;
@@ -1310,6 +1409,7 @@ void ir_register_verify_node_ops(void)
 	set_op_verify(op_And,      verify_node_And);
 	set_op_verify(op_Bitcast,  verify_node_Bitcast);
 	set_op_verify(op_Block,    verify_node_Block);
+	set_op_verify(op_Broadcast, verify_node_Broadcast);
 	set_op_verify(op_Call,     verify_node_Call);
 	set_op_verify(op_Cmp,      verify_node_Cmp);
 	set_op_verify(op_Cond,     verify_node_Cond);
@@ -1321,8 +1421,10 @@ void ir_register_verify_node_ops(void)
 	set_op_verify(op_Div,      verify_node_Div);
 	set_op_verify(op_End,      verify_node_End);
 	set_op_verify(op_Eor,      verify_node_Eor);
+	set_op_verify(op_Extract,  verify_node_Extract);
 	set_op_verify(op_Free,     verify_node_Free);
 	set_op_verify(op_IJmp,     verify_node_IJmp);
+	set_op_verify(op_Insert,   verify_node_Insert);
 	set_op_verify(op_Jmp,      verify_node_Jmp);
 	set_op_verify(op_Load,     verify_node_Load);
 	set_op_verify(op_Member,   verify_node_Member);
@@ -1342,6 +1444,7 @@ void ir_register_verify_node_ops(void)
 	set_op_verify(op_Shl,      verify_node_Shl);
 	set_op_verify(op_Shr,      verify_node_Shr);
 	set_op_verify(op_Shrs,     verify_node_Shrs);
+	set_op_verify(op_Shuffle,  verify_node_Shuffle);
 	set_op_verify(op_Size,     verify_node_int);
 	set_op_verify(op_Start,    verify_node_Start);
 	set_op_verify(op_Store,    verify_node_Store);
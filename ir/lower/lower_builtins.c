@@ -18,6 +18,7 @@
 #include "irgmod.h"
 #include "irgwalk.h"
 #include "iroptimize.h"
+#include "lowering.h"
 #include "panic.h"
 #include "irprog_t.h"
 #include "util.h"
@@ -45,6 +46,10 @@ static const char *get_builtin_name(ir_builtin_kind kind)
 	case ir_bk_may_alias:
 	case ir_bk_va_start:
 	case ir_bk_va_arg:
+	case ir_bk_min:
+	case ir_bk_max:
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub:
 		break;
 	}
 	abort();
@@ -155,9 +160,143 @@ static void replace_may_alias(ir_node *node)
 	turn_into_tuple(node, ARRAY_SIZE(in), in);
 }
 
-static void lower_builtin(ir_node *node, void *env)
+/** Returns a mask with all bits set if the sign bit of @p value is set. */
+static ir_node *create_sign_mask(ir_node *block, ir_node *value)
 {
-	bool *changed = (bool*)env;
+	ir_graph *const irg   = get_irn_irg(block);
+	unsigned  const bits  = get_mode_size_bits(get_irn_mode(value));
+	ir_node  *const shift = new_r_Const_long(irg, mode_Iu, bits - 1);
+	return new_r_Shrs(block, value, shift);
+}
+
+/**
+ * Returns a mask with all bits set if @p a is less than @p b. The sign of
+ * the difference decides, unless the operands differ in their sign bit and
+ * the subtraction may have overflowed (Hacker's Delight 2-12).
+ */
+static ir_node *create_less_mask(ir_node *block, ir_node *a, ir_node *b)
+{
+	ir_node *const diff = new_r_Sub(block, a, b);
+	ir_node *const same = new_r_Not(block, new_r_Eor(block, a, b));
+	ir_node *const sign = mode_is_signed(get_irn_mode(a))
+		? new_r_And(block, a, new_r_Not(block, b))
+		: new_r_And(block, new_r_Not(block, a), b);
+	ir_node *const less = new_r_Or(block, sign, new_r_And(block, same, diff));
+	return create_sign_mask(block, less);
+}
+
+/** Returns @p value where the bits in @p mask are taken from @p other. */
+static ir_node *create_select(ir_node *block, ir_node *mask, ir_node *other,
+                              ir_node *value)
+{
+	ir_node *const diff = new_r_Eor(block, other, value);
+	return new_r_Eor(block, value, new_r_And(block, diff, mask));
+}
+
+/**
+ * Computes a lane-wise builtin for the scalar lanes @p a and @p b. Mux nodes
+ * created for float lanes are added to @p muxes.
+ */
+static ir_node *lower_lane(ir_builtin_kind kind, ir_node *block, ir_node *a,
+                           ir_node *b, pset_new_t *muxes)
+{
+	ir_mode *const mode = get_irn_mode(a);
+	if (mode_is_float(mode)) {
+		assert(kind == ir_bk_min || kind == ir_bk_max);
+		ir_relation const relation = kind == ir_bk_min ? ir_relation_less
+		                                               : ir_relation_greater;
+		ir_node *const cmp = new_r_Cmp(block, a, b, relation);
+		ir_node *const mux = new_r_Mux(block, cmp, b, a);
+		pset_new_insert(muxes, mux);
+		return mux;
+	}
+
+	/* integer lanes are computed without branches */
+	switch (kind) {
+	case ir_bk_min:
+		return create_select(block, create_less_mask(block, a, b), a, b);
+	case ir_bk_max:
+		return create_select(block, create_less_mask(block, b, a), a, b);
+
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub: {
+		bool     const add = kind == ir_bk_saturating_add;
+		ir_node *const res = add ? new_r_Add(block, a, b)
+		                         : new_r_Sub(block, a, b);
+		if (!mode_is_signed(mode)) {
+			if (add) {
+				/* the result wrapped around iff it is less than a */
+				return new_r_Or(block, res, create_less_mask(block, res, a));
+			}
+			ir_node *const borrow = create_less_mask(block, a, b);
+			return new_r_And(block, res, new_r_Not(block, borrow));
+		}
+		/* the result overflowed iff its sign differs from the sign of a and
+		 * the sign of b (addition) or a and b differ in sign (subtraction),
+		 * it is then clamped towards the sign of a */
+		ir_node   *const other    = add ? new_r_Eor(block, b, res)
+		                                : new_r_Eor(block, a, b);
+		ir_node   *const ovf_bits = new_r_And(block, new_r_Eor(block, a, res),
+		                                      other);
+		ir_node   *const overflow = create_sign_mask(block, ovf_bits);
+		ir_graph  *const irg      = get_irn_irg(block);
+		ir_node   *const max      = new_r_Const(irg, get_mode_max(mode));
+		ir_node   *const clamped  = new_r_Eor(block, create_sign_mask(block, a),
+		                                      max);
+		return create_select(block, overflow, clamped, res);
+	}
+
+	default:
+		panic("unexpected lane-wise builtin %s", get_builtin_kind_name(kind));
+	}
+}
+
+void lower_lanewise_builtin(ir_node *node, pset_new_t *muxes)
+{
+	ir_builtin_kind const kind  = get_Builtin_kind(node);
+	ir_node        *const block = get_nodes_block(node);
+	ir_node        *const a     = get_Builtin_param(node, 0);
+	ir_node        *const b     = get_Builtin_param(node, 1);
+	ir_mode        *const mode  = get_irn_mode(a);
+
+	ir_node *res;
+	if (mode_is_vector(mode)) {
+		res = a;
+		for (unsigned i = 0, n = get_mode_n_lanes(mode); i < n; ++i) {
+			ir_node *const lane_a = new_r_Extract(block, a, i);
+			ir_node *const lane_b = new_r_Extract(block, b, i);
+			ir_node *const lane   = lower_lane(kind, block, lane_a, lane_b,
+			                                   muxes);
+			res = new_r_Insert(block, res, lane, i);
+		}
+	} else {
+		res = lower_lane(kind, block, a, b, muxes);
+	}
+
+	ir_node *const in[] = {
+		[pn_Builtin_M]       = get_Builtin_mem(node),
+		[pn_Builtin_max + 1] = res,
+	};
+	turn_into_tuple(node, ARRAY_SIZE(in), in);
+}
+
+static int is_mux_unsupported(ir_node *mux)
+{
+	arch_allow_ifconv_func const allow_ifconv
+		= be_get_backend_param()->allow_ifconv;
+	return allow_ifconv == NULL
+	    || !allow_ifconv(get_Mux_sel(mux), get_Mux_false(mux),
+	                     get_Mux_true(mux));
+}
+
+typedef struct lower_builtin_env_t {
+	bool       changed;
+	pset_new_t muxes;   /**< Mux nodes created for float lanes */
+} lower_builtin_env_t;
+
+static void lower_builtin(ir_node *node, void *data)
+{
+	lower_builtin_env_t *const env = (lower_builtin_env_t*)data;
 	if (!is_Builtin(node))
 		return;
 
@@ -186,8 +325,15 @@ static void lower_builtin(ir_node *node, void *env)
 
 	case ir_bk_may_alias:
 		replace_may_alias(node);
+		goto changed;
+
+	case ir_bk_min:
+	case ir_bk_max:
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub:
+		lower_lanewise_builtin(node, &env->muxes);
 changed:
-		*changed = true;
+		env->changed = true;
 		return;
 
 	case ir_bk_va_arg:
@@ -218,10 +364,19 @@ void lower_builtins(size_t n_exceptions, ir_builtin_kind *exceptions)
 	}
 
 	foreach_irp_irg(i, irg) {
-		bool changed = false;
+		lower_builtin_env_t env = { .changed = false };
+		pset_new_init(&env.muxes);
 		assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
-		irg_walk_graph(irg, NULL, lower_builtin, &changed);
-		confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
-		                                    : IR_GRAPH_PROPERTIES_ALL);
+		irg_walk_graph(irg, NULL, lower_builtin, &env);
+		ir_graph_properties_t properties
+			= env.changed ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
+			              : IR_GRAPH_PROPERTIES_ALL;
+		/* floating point lanes are selected by Mux nodes */
+		if (pset_new_size(&env.muxes) > 0) {
+			lower_mux(irg, is_mux_unsupported);
+			properties = IR_GRAPH_PROPERTIES_NONE;
+		}
+		pset_new_destroy(&env.muxes);
+		confirm_irg_properties(irg, properties);
 	}
 }
@@ -12,8 +12,17 @@
 #define FIRM_LOWER_BUILTINS_H
 
 #include "firm_types.h"
+#include "pset_new.h"
 #include <stddef.h>
 
 void lower_builtins(size_t n_exceptions, ir_builtin_kind *exceptions);
 
+/**
+ * Replaces a lane-wise builtin (ir_bk_min, ir_bk_max, ir_bk_saturating_add,
+ * ir_bk_saturating_sub) by arithmetic on its single lanes. Backends use this
+ * for the instances they cannot select directly. Float lanes are selected by
+ * Mux nodes, which are added to @p muxes.
+ */
+void lower_lanewise_builtin(ir_node *node, pset_new_t *muxes);
+
 #endif
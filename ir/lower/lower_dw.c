@@ -2411,6 +2411,10 @@ static void lower_Builtin(ir_node *builtin, ir_mode *mode)
 	case ir_bk_trap:
 	case ir_bk_va_start:
 	case ir_bk_va_arg:
+	case ir_bk_min:
+	case ir_bk_max:
+	case ir_bk_saturating_add:
+	case ir_bk_saturating_sub:
 		/* Nothing to do/impossible to lower in a generic way */
 		return;
 	case ir_bk_bswap:
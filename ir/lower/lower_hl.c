@@ -151,10 +151,12 @@ static void lower_irnode(ir_node *irn, void *env)
 
 void lower_highlevel_graph(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "lower_highlevel_graph");
 	/* Finally: lower Offset/TypeConst-size and Sel nodes, unaligned Load/Stores. */
 	irg_walk_graph(irg, NULL, lower_irnode, NULL);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+	irg_timing_scope_end(irg, timed);
 }
 
 /*
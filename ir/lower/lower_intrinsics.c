@@ -101,6 +101,7 @@ static void call_mapper(ir_node *node, void *data)
 
 void ir_lower_intrinsics(ir_graph *irg, ir_intrinsics_map *map)
 {
+	bool const timed = irg_timing_scope_begin(irg, "ir_lower_intrinsics");
 	if (map->part_block_used) {
 		ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_PHI_LIST);
 		collect_phiprojs_and_start_block_nodes(irg);
@@ -112,6 +113,7 @@ void ir_lower_intrinsics(ir_graph *irg, ir_intrinsics_map *map)
 	if (map->n_intrinsics > 0) {
 		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
 	}
+	irg_timing_scope_end(irg, timed);
 }
 
 /**
@@ -83,6 +83,7 @@ static void lower_mux_node(ir_node* mux)
 
 void lower_mux(ir_graph *irg, lower_mux_callback *cb_func)
 {
+	bool const timed = irg_timing_scope_begin(irg, "lower_mux");
 	/* Scan the graph for mux nodes to lower. */
 	walk_env_t env;
 	env.cb_func = cb_func;
@@ -107,4 +108,5 @@ void lower_mux(ir_graph *irg, lower_mux_callback *cb_func)
 		clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 	}
 	DEL_ARR_F(env.muxes);
+	irg_timing_scope_end(irg, timed);
 }
@@ -0,0 +1,125 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Replaces vector operations by operations on their lanes
+ */
+#include "lowering.h"
+#include "array.h"
+#include "irnode_t.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irgmod.h"
+#include "ircons.h"
+#include "panic.h"
+#include "tv.h"
+
+typedef struct walk_env {
+	lower_vector_callback *cb_func;
+	ir_node              **nodes;
+} walk_env_t;
+
+static void find_vector_nodes(ir_node *node, void *ctx)
+{
+	if (!mode_is_vector(get_irn_mode(node)))
+		return;
+
+	switch (get_irn_opcode(node)) {
+	case iro_Add:
+	case iro_And:
+	case iro_Conv:
+	case iro_Eor:
+	case iro_Minus:
+	case iro_Mul:
+	case iro_Not:
+	case iro_Or:
+	case iro_Shuffle:
+	case iro_Sub:
+		break;
+	default:
+		return;
+	}
+
+	walk_env_t *env = (walk_env_t*)ctx;
+	if (env->cb_func != NULL && !env->cb_func(node))
+		return;
+
+	ARR_APP1(ir_node*, env->nodes, node);
+}
+
+/** Creates the scalar operation of @p node for lane @p lane. */
+static ir_node *lower_lane(ir_node *node, unsigned lane)
+{
+	dbg_info *const dbgi  = get_irn_dbg_info(node);
+	ir_node  *const block = get_nodes_block(node);
+
+	if (is_Shuffle(node)) {
+		ir_mode   *const mode    = get_irn_mode(node);
+		unsigned   const n_lanes = get_mode_n_lanes(mode);
+		ir_tarval *const mask    = get_Shuffle_mask(node);
+		unsigned   const from    = get_tarval_long(get_tarval_lane(mask, lane));
+		ir_node   *const vector  = from < n_lanes ? get_Shuffle_left(node)
+		                                          : get_Shuffle_right(node);
+		return new_rd_Extract(dbgi, block, vector, from % n_lanes);
+	}
+
+	ir_node *const op = new_rd_Extract(dbgi, block, get_irn_n(node, 0), lane);
+	switch (get_irn_opcode(node)) {
+	case iro_Conv: {
+		ir_mode *const lane_mode = get_mode_element_mode(get_irn_mode(node));
+		return new_rd_Conv(dbgi, block, op, lane_mode);
+	}
+	case iro_Minus: return new_rd_Minus(dbgi, block, op);
+	case iro_Not:   return new_rd_Not(dbgi, block, op);
+	default:        break;
+	}
+
+	ir_node *const r = new_rd_Extract(dbgi, block, get_irn_n(node, 1), lane);
+	switch (get_irn_opcode(node)) {
+	case iro_Add: return new_rd_Add(dbgi, block, op, r);
+	case iro_And: return new_rd_And(dbgi, block, op, r);
+	case iro_Eor: return new_rd_Eor(dbgi, block, op, r);
+	case iro_Mul: return new_rd_Mul(dbgi, block, op, r);
+	case iro_Or:  return new_rd_Or(dbgi, block, op, r);
+	case iro_Sub: return new_rd_Sub(dbgi, block, op, r);
+	default:      break;
+	}
+	panic("unexpected vector operation %+F", node);
+}
+
+static void lower_vector_node(ir_node *node)
+{
+	dbg_info *const dbgi  = get_irn_dbg_info(node);
+	ir_node  *const block = get_nodes_block(node);
+	ir_mode  *const mode  = get_irn_mode(node);
+	ir_graph *const irg   = get_irn_irg(node);
+
+	ir_node *res = new_r_Unknown(irg, mode);
+	for (unsigned i = 0, n = get_mode_n_lanes(mode); i < n; ++i) {
+		ir_node *const lane = lower_lane(node, i);
+		res = new_rd_Insert(dbgi, block, res, lane, i);
+	}
+	exchange(node, res);
+}
+
+void lower_vector(ir_graph *irg, lower_vector_callback *cb_func)
+{
+	bool const timed = irg_timing_scope_begin(irg, "lower_vector");
+	walk_env_t env;
+	env.cb_func = cb_func;
+	env.nodes   = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, find_vector_nodes, NULL, &env);
+
+	size_t const n_nodes = ARR_LEN(env.nodes);
+	for (size_t i = 0; i < n_nodes; ++i) {
+		lower_vector_node(env.nodes[i]);
+	}
+	DEL_ARR_F(env.nodes);
+
+	confirm_irg_properties(irg, n_nodes > 0 ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
+	                                        : IR_GRAPH_PROPERTIES_ALL);
+	irg_timing_scope_end(irg, timed);
+}
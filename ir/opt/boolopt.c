@@ -700,6 +700,7 @@ restart:
 
 void opt_bool(ir_graph *const irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "opt_bool");
 	bool_opt_env_t env;
 
 	/* register a debug mask */
@@ -718,4 +719,5 @@ void opt_bool(ir_graph *const irg)
 
 	confirm_irg_properties(irg,
 		env.changed ? IR_GRAPH_PROPERTIES_NONE : IR_GRAPH_PROPERTIES_ALL);
+	irg_timing_scope_end(irg, timed);
 }
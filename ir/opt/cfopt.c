@@ -544,6 +544,7 @@ again:;
 
 void optimize_cf(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "optimize_cf");
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
 	                         | IR_GRAPH_PROPERTY_ONE_RETURN);
 	/* we have some hacky is_Id() checks here so exchange must not use Deleted
@@ -585,4 +586,5 @@ void optimize_cf(ir_graph *irg)
 	                     | IR_RESOURCE_IRN_LINK);
 	confirm_irg_properties(irg, global_changed ? IR_GRAPH_PROPERTIES_NONE
 	                                           : IR_GRAPH_PROPERTIES_ALL);
+	irg_timing_scope_end(irg, timed);
 }
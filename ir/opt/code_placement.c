@@ -329,6 +329,7 @@ static void place_late(ir_graph *irg, pdeq *worklist)
 /* Code Placement. */
 void place_code(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "place_code");
 	/* Handle graph state */
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES |
@@ -354,4 +355,5 @@ void place_code(ir_graph *irg)
 
 	del_pdeq(worklist);
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+	irg_timing_scope_end(irg, timed);
 }
@@ -3185,6 +3185,7 @@ static void add_memory_keeps(ir_graph *irg, ir_node **kept_memory, size_t len)
 
 void combo(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "combo");
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_NO_BADS
 		| IR_GRAPH_PROPERTY_NO_TUPLES
@@ -3280,4 +3281,5 @@ void combo(ir_graph *irg)
 	set_value_of_func(NULL);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
+	irg_timing_scope_end(irg, timed);
 }
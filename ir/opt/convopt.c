@@ -277,6 +277,7 @@ static void conv_opt_walker(ir_node *node, void *data)
 
 void conv_opt(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "conv_opt");
 	FIRM_DBG_REGISTER(dbg, "firm.opt.conv");
 
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
@@ -288,11 +289,15 @@ void conv_opt(ir_graph *irg)
 	do {
 		changed = false;
 		irg_walk_graph(irg, NULL, conv_opt_walker, &changed);
-		if (changed)
+		if (changed) {
+			irg_begin_nested_pass(irg);
 			local_optimize_graph(irg);
+			irg_end_nested_pass(irg);
+		}
 		global_changed |= changed;
 	} while (changed);
 
 	confirm_irg_properties(irg,
 		global_changed ? IR_GRAPH_PROPERTIES_NONE : IR_GRAPH_PROPERTIES_ALL);
+	irg_timing_scope_end(irg, timed);
 }
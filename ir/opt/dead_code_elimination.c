@@ -11,8 +11,9 @@
  * Strictly speaking dead node elimination is unnecessary in firm - everthying
  * which is not used can't be found by any walker.
  * The only drawback is that the nodes still take up memory. This phase fixes
- * this by copying all (reachable) nodes to a new obstack and throwing away
- * the old one.
+ * this by copying all (reachable) nodes to a new obstack and node arena and
+ * throwing away the old ones.  Alternatively the dead nodes are released in
+ * place, which does not need memory for a copy of the graph.
  */
 #include "iroptimize.h"
 #include "irnode_t.h"
@@ -25,6 +26,7 @@
 #include "irouts.h"
 #include "iropt_t.h"
 #include "pmap.h"
+#include "util.h"
 #include "vrp.h"
 
 /**
@@ -74,6 +76,7 @@ static void copy_graph_env(ir_graph *irg)
  */
 void dead_node_elimination(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "dead_node_elimination");
 	edges_deactivate(irg);
 
 	/* Handle graph state */
@@ -85,10 +88,12 @@ void dead_node_elimination(ir_graph *irg)
 
 	/* A quiet place, where the old obstack can rest in peace,
 	   until it will be cremated. */
-	struct obstack graveyard_obst = irg->obst;
+	struct obstack graveyard_obst  = irg->obst;
+	arena_t        graveyard_arena = irg->node_arena;
 
 	/* A new obstack, where the reachable nodes will be copied to. */
 	obstack_init(&irg->obst);
+	arena_init(&irg->node_arena);
 	irg->last_node_idx = 0;
 
 	/* We also need a new value table for CSE */
@@ -101,4 +106,56 @@ void dead_node_elimination(ir_graph *irg)
 
 	/* Free memory from old unoptimized obstack */
 	obstack_free(&graveyard_obst, 0);  /* First empty the obstack ... */
+
+	/* both arenas were alive while copying */
+	size_t const peak = graveyard_arena.used + irg->node_arena.used;
+	irg->node_arena.peak = MAX(graveyard_arena.peak, peak);
+	arena_destroy(&graveyard_arena);
+	irg_timing_scope_end(irg, timed);
+}
+
+void dead_node_elimination_in_place(ir_graph *irg)
+{
+	bool const timed = irg_timing_scope_begin(irg, "dead_node_elimination_in_place");
+	edges_deactivate(irg);
+
+	/* Handle graph state */
+	free_callee_info(irg);
+	free_irg_outs(irg);
+	free_loop_information(irg);
+	free_vrp_data(irg);
+	/* Unlike the copying variant, nothing rewires the nodes here, so the
+	 * outs have to be invalidated explicitly. */
+	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE
+	                        | IR_GRAPH_PROPERTY_CONSISTENT_OUTS);
+
+	/* Unreachable nodes are released below and the indices of the buried
+	 * ones are reused, so they must not be released again. */
+	ARR_SHRINKLEN(irg->dead_nodes, 0);
+
+	/* The value table hashes node indices, which change. */
+	new_identities(irg);
+
+	/* Mark the nodes reachable from the anchor. */
+	irg_walk_in_or_dep(irg->anchor, NULL, NULL, NULL);
+
+	/* Release unmarked nodes and number the marked ones densely, keeping
+	 * their order. */
+	ir_node **const map    = irg->idx_irn_map;
+	unsigned  const n_idx  = irg->last_node_idx;
+	unsigned        n_live = 0;
+	for (unsigned idx = 0; idx < n_idx; ++idx) {
+		ir_node *const node = map[idx];
+		if (node == NULL)
+			continue;
+		if (!irn_visited(node)) {
+			free_irn(irg, node);
+			continue;
+		}
+		node->node_idx = n_live;
+		map[n_live++]  = node;
+	}
+	irg->last_node_idx = n_live;
+	ARR_SETLEN(ir_node*, irg->idx_irn_map, n_live);
+	irg_timing_scope_end(irg, timed);
 }
@@ -352,6 +352,10 @@ next_no_change:
 			case ir_bk_bswap:
 			case ir_bk_saturating_increment:
 			case ir_bk_may_alias:
+			case ir_bk_min:
+			case ir_bk_max:
+			case ir_bk_saturating_add:
+			case ir_bk_saturating_sub:
 				/* just arithmetic/no semantic change => no problem */
 				goto next_no_change;
 			case ir_bk_compare_swap:
@@ -101,8 +101,8 @@ typedef struct pre_env {
 	char            first_iter;   /* non-zero for first fixed point iteration */
 	int             iteration;    /* iteration counter */
 #if OPTIMIZE_NODES
-	pset           *value_table;   /* standard value table*/
-	pset           *gvnpre_values; /* GVN-PRE value table */
+	cpset_t        *value_table;   /* standard value table*/
+	cpset_t        *gvnpre_values; /* GVN-PRE value table */
 #endif
 } pre_env;
 
@@ -225,7 +225,7 @@ static void dump_all_expgen_sets(block_info *list)
 
 /**
  * Compares node collisions in value table.
- * Modified identities_cmp().
+ * Modified identities_equal().
  */
 static int compare_gvn_identities(const void *elt, const void *key)
 {
@@ -237,7 +237,7 @@ static int compare_gvn_identities(const void *elt, const void *key)
 
 	/* phi nodes kill predecessor values and are always different */
 	if (is_Phi(a) || is_Phi(b))
-		return 1;
+		return 0;
 
 	/* memops are not the same, even if we want to optimize them
 	   we have to take the order in account */
@@ -247,20 +247,20 @@ static int compare_gvn_identities(const void *elt, const void *key)
 		/* Loads with the same predecessors are the same value;
 		   this should only happen after phi translation. */
 		if ((! is_Load(a) || ! is_Load(b)) && (! is_Store(a) || ! is_Store(b)))
-			return 1;
+			return 0;
 	}
 
 	if ((get_irn_op(a) != get_irn_op(b)) ||
-	    (get_irn_mode(a) != get_irn_mode(b))) return 1;
+	    (get_irn_mode(a) != get_irn_mode(b))) return 0;
 
 	/* compare if a's in and b's in are of equal length */
 	irn_arity_a = get_irn_arity(a);
 	if (irn_arity_a != get_irn_arity(b))
-		return 1;
+		return 0;
 
 	/* blocks are never the same */
 	if (is_Block(a) || is_Block(b))
-		return 1;
+		return 0;
 
 	/* should only be used with GCSE enabled */
 	assert(get_opt_global_cse());
@@ -270,12 +270,12 @@ static int compare_gvn_identities(const void *elt, const void *key)
 		ir_node *pred_a = get_irn_n(a, i);
 		ir_node *pred_b = get_irn_n(b, i);
 		if (pred_a != pred_b)
-			return 1;
+			return 0;
 	}
 
 	/* here, we already now that the nodes are identical except their
 	 * attributes */
-	return !a->op->ops.attrs_equal(a, b);
+	return a->op->ops.attrs_equal(a, b);
 }
 
 /**
@@ -1850,6 +1850,7 @@ static void gvn_pre(ir_graph *irg, pre_env *env)
  */
 void do_gvn_pre(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "do_gvn_pre");
 	pre_env               env;
 	ir_nodeset_t          keeps;
 	optimization_state_t  state;
@@ -1902,11 +1903,7 @@ void do_gvn_pre(ir_graph *irg)
 	   the value of a node, which is independent from
 	   its block. */
 	set_opt_global_cse(1);
-	/* new_identities() */
-	if (irg->value_table != NULL)
-		del_pset(irg->value_table);
-	/* initially assumed nodes in pset are 512 */
-	irg->value_table = new_pset(compare_gvn_identities, 512);
+	new_identities_cmp(irg, compare_gvn_identities);
 #if OPTIMIZE_NODES
 	env.gvnpre_values = irg->value_table;
 #endif
@@ -1933,7 +1930,7 @@ void do_gvn_pre(ir_graph *irg)
 
 #if OPTIMIZE_NODES
 	irg->value_table = env.value_table;
-	del_pset(irg->value_table);
+	del_identities(irg);
 	irg->value_table = env.gvnpre_values;
 #endif
 
@@ -1944,4 +1941,5 @@ void do_gvn_pre(ir_graph *irg)
 	/* TODO assure nothing else breaks. */
 	set_opt_global_cse(0);
 	edges_activate(irg);
+	irg_timing_scope_end(irg, timed);
 }
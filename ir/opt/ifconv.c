@@ -433,6 +433,7 @@ static void fill_waitq(ir_node *node, void *env) {
 
 void opt_if_conv_cb(ir_graph *irg, arch_allow_ifconv_func callback)
 {
+	bool const timed = irg_timing_scope_begin(irg, "opt_if_conv");
 	walker_env  env   = { .allow_ifconv = callback, .changed = false };
 	pdeq       *waitq = new_pdeq();
 
@@ -469,7 +470,9 @@ void opt_if_conv_cb(ir_graph *irg, arch_allow_ifconv_func callback)
 	ir_free_resources(irg, IR_RESOURCE_BLOCK_MARK | IR_RESOURCE_PHI_LIST);
 
 	if (env.changed) {
+		irg_begin_nested_pass(irg);
 		local_optimize_graph(irg);
+		irg_end_nested_pass(irg);
 	}
 
 	free_cdep(irg);
@@ -477,6 +480,7 @@ void opt_if_conv_cb(ir_graph *irg, arch_allow_ifconv_func callback)
 	confirm_irg_properties(irg,
 		IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
 		| IR_GRAPH_PROPERTY_ONE_RETURN);
+	irg_timing_scope_end(irg, timed);
 }
 
 void opt_if_conv(ir_graph *irg)
@@ -120,7 +120,9 @@ static void find_unreachable_blocks(ir_node *block, void *env)
 
 void local_optimize_graph(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "local_optimize_graph");
 	local_optimize_node(get_irg_end(irg));
+	irg_timing_scope_end(irg, timed);
 }
 
 /**
@@ -153,6 +155,7 @@ static void opt_walker(ir_node *n, void *env)
 
 void optimize_graph_df(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "optimize_graph_df");
 	pdeq *waitq = new_pdeq();
 
 	if (get_opt_global_cse())
@@ -210,6 +213,7 @@ void optimize_graph_df(ir_graph *irg)
 	 * Doing this AFTER edges where deactivated saves cycles */
 	ir_node *end = get_irg_end(irg);
 	remove_End_Bads_and_doublets(end);
+	irg_timing_scope_end(irg, timed);
 }
 
 void local_opts_const_code(void)
@@ -993,6 +993,99 @@ static ir_tarval *computed_value_Proj(const ir_node *proj)
 	return tarval_unknown;
 }
 
+/**
+ * Return the value of a Broadcast.
+ */
+static ir_tarval *computed_value_Broadcast(const ir_node *n)
+{
+	ir_tarval *ta = value_of(get_Broadcast_op(n));
+	if (!tarval_is_constant(ta))
+		return tarval_unknown;
+	return tarval_broadcast(ta, get_irn_mode(n));
+}
+
+/**
+ * Return the value of an Extract.
+ */
+static ir_tarval *computed_value_Extract(const ir_node *n)
+{
+	ir_tarval *ta = value_of(get_Extract_vector(n));
+	if (!tarval_is_constant(ta))
+		return tarval_unknown;
+	return get_tarval_lane(ta, get_Extract_lane(n));
+}
+
+/**
+ * Return the value of an Insert.
+ */
+static ir_tarval *computed_value_Insert(const ir_node *n)
+{
+	ir_tarval *ta = value_of(get_Insert_vector(n));
+	ir_tarval *tb = value_of(get_Insert_value(n));
+	if (!tarval_is_constant(ta) || !tarval_is_constant(tb))
+		return tarval_unknown;
+
+	ir_mode    *const mode    = get_irn_mode(n);
+	unsigned    const n_lanes = get_mode_n_lanes(mode);
+	ir_tarval **const lanes   = ALLOCAN(ir_tarval*, n_lanes);
+	for (unsigned i = 0; i < n_lanes; ++i)
+		lanes[i] = get_tarval_lane(ta, i);
+	lanes[get_Insert_lane(n)] = tb;
+	return new_tarval_vector(mode, lanes);
+}
+
+/**
+ * Return the value of a Shuffle.
+ */
+static ir_tarval *computed_value_Shuffle(const ir_node *n)
+{
+	ir_tarval *ta = value_of(get_Shuffle_left(n));
+	ir_tarval *tb = value_of(get_Shuffle_right(n));
+	if (!tarval_is_constant(ta) || !tarval_is_constant(tb))
+		return tarval_unknown;
+
+	ir_mode    *const mode    = get_irn_mode(n);
+	ir_tarval  *const mask    = get_Shuffle_mask(n);
+	unsigned    const n_lanes = get_mode_n_lanes(mode);
+	ir_tarval **const lanes   = ALLOCAN(ir_tarval*, n_lanes);
+	for (unsigned i = 0; i < n_lanes; ++i) {
+		unsigned const sel = get_tarval_long(get_tarval_lane(mask, i));
+		lanes[i] = sel < n_lanes ? get_tarval_lane(ta, sel)
+		                         : get_tarval_lane(tb, sel - n_lanes);
+	}
+	return new_tarval_vector(mode, lanes);
+}
+
+/**
+ * Returns true if @p n computes lane-wise arithmetic on vector values.  The
+ * algebraic rules of the local optimizer are written for scalars (e.g. they
+ * assume a single sign or a single shift amount), so these nodes are only
+ * folded if all their operands are constant.
+ */
+static bool is_vector_arithmetic(const ir_node *n)
+{
+	if (!is_binop(n) && !is_Minus(n) && !is_Not(n) && !is_Conv(n)
+	    && !is_Bitcast(n) && !is_Mux(n))
+		return false;
+	if (mode_is_vector(get_irn_mode(n)))
+		return true;
+	foreach_irn_in(n, i, pred) {
+		if (mode_is_vector(get_irn_mode(pred)))
+			return true;
+	}
+	return false;
+}
+
+/** Returns true if all operands of @p n have a known value. */
+static bool has_constant_operands(const ir_node *n)
+{
+	foreach_irn_in(n, i, pred) {
+		if (!tarval_is_constant(value_of(pred)))
+			return false;
+	}
+	return true;
+}
+
 /**
  * If the parameter n can be computed, return its value, else tarval_unknown.
  * Performs constant folding.
@@ -1001,6 +1094,9 @@ static ir_tarval *computed_value_Proj(const ir_node *proj)
  */
 ir_tarval *computed_value(const ir_node *n)
 {
+	if (is_vector_arithmetic(n) && !has_constant_operands(n))
+		return tarval_unknown;
+
 	const vrp_attr *vrp = vrp_get_info(n);
 	if (vrp != NULL && vrp->bits_set == vrp->bits_not_set)
 		return vrp->bits_set;
@@ -1470,6 +1566,67 @@ static ir_node *equivalent_node_Sync(ir_node *n)
 	return op;
 }
 
+/**
+ * Extract(Broadcast(x), l) = x
+ * Extract(Insert(v, x, l), l) = x, looking through Inserts into other lanes.
+ */
+static ir_node *equivalent_node_Extract(ir_node *n)
+{
+	unsigned const lane   = get_Extract_lane(n);
+	ir_node       *vector = get_Extract_vector(n);
+	while (is_Insert(vector)) {
+		if (get_Insert_lane(vector) == lane) {
+			ir_node *const value = get_Insert_value(vector);
+			DBG_OPT_ALGSIM0(n, value);
+			return value;
+		}
+		vector = get_Insert_vector(vector);
+	}
+	if (is_Broadcast(vector)) {
+		ir_node *const op = get_Broadcast_op(vector);
+		DBG_OPT_ALGSIM0(n, op);
+		return op;
+	}
+	return n;
+}
+
+/**
+ * Insert(v, Extract(v, l), l) = v
+ */
+static ir_node *equivalent_node_Insert(ir_node *n)
+{
+	ir_node *const vector = get_Insert_vector(n);
+	ir_node *const value  = get_Insert_value(n);
+	if (is_Extract(value) && get_Extract_vector(value) == vector
+	    && get_Extract_lane(value) == get_Insert_lane(n)) {
+		DBG_OPT_ALGSIM0(n, vector);
+		return vector;
+	}
+	return n;
+}
+
+/**
+ * Shuffles selecting all lanes of one operand in order are the operand.
+ */
+static ir_node *equivalent_node_Shuffle(ir_node *n)
+{
+	ir_tarval *const mask    = get_Shuffle_mask(n);
+	unsigned   const n_lanes = get_mode_n_lanes(get_irn_mode(n));
+	bool             left    = true;
+	bool             right   = true;
+	for (unsigned i = 0; i < n_lanes; ++i) {
+		unsigned const sel = get_tarval_long(get_tarval_lane(mask, i));
+		left  &= sel == i;
+		right &= sel == i + n_lanes;
+	}
+
+	ir_node *const res = left ? get_Shuffle_left(n)
+	                   : right ? get_Shuffle_right(n) : n;
+	if (res != n)
+		DBG_OPT_ALGSIM0(n, res);
+	return res;
+}
+
 static ir_node *equivalent_node_Pin(ir_node *n)
 {
 	ir_node *const op = get_Pin_op(n);
@@ -1738,6 +1895,8 @@ static ir_node *equivalent_node_Confirm(ir_node *n)
  */
 ir_node *equivalent_node(ir_node *n)
 {
+	if (is_vector_arithmetic(n))
+		return n;
 	if (n->op->ops.equivalent_node)
 		return n->op->ops.equivalent_node(n);
 	return n;
@@ -7568,7 +7727,7 @@ restart:;
 	if (get_opt_algebraic_simplification() ||
 		(iro == iro_Cond) ||
 		(iro == iro_Proj)) {    /* Flags tested local. */
-		if (n->op->ops.transform_node != NULL) {
+		if (n->op->ops.transform_node != NULL && !is_vector_arithmetic(n)) {
 			n = n->op->ops.transform_node(n);
 			if (n != old_n)
 				goto restart;
@@ -7584,12 +7743,15 @@ void ir_register_opt_node_ops(void)
 	set_op_computed_value(op_Align,    computed_value_Align);
 	set_op_computed_value(op_And,      computed_value_And);
 	set_op_computed_value(op_Bitcast,  computed_value_Bitcast);
+	set_op_computed_value(op_Broadcast, computed_value_Broadcast);
 	set_op_computed_value(op_Cmp,      computed_value_Cmp);
 	set_op_computed_value(op_Confirm,  computed_value_Confirm);
 	set_op_computed_value(op_Const,    computed_value_Const);
 	set_op_computed_value(op_Conv,     computed_value_Conv);
 	set_op_computed_value(op_Offset,   computed_value_Offset);
 	set_op_computed_value(op_Eor,      computed_value_Eor);
+	set_op_computed_value(op_Extract,  computed_value_Extract);
+	set_op_computed_value(op_Insert,   computed_value_Insert);
 	set_op_computed_value(op_Minus,    computed_value_Minus);
 	set_op_computed_value(op_Mul,      computed_value_Mul);
 	set_op_computed_value(op_Mux,      computed_value_Mux);
@@ -7599,6 +7761,7 @@ void ir_register_opt_node_ops(void)
 	set_op_computed_value(op_Shl,      computed_value_Shl);
 	set_op_computed_value(op_Shr,      computed_value_Shr);
 	set_op_computed_value(op_Shrs,     computed_value_Shrs);
+	set_op_computed_value(op_Shuffle,  computed_value_Shuffle);
 	set_op_computed_value(op_Size,     computed_value_Size);
 	set_op_computed_value(op_Sub,      computed_value_Sub);
 	set_op_computed_value_proj(op_Builtin, computed_value_Proj_Builtin);
@@ -7612,7 +7775,9 @@ void ir_register_opt_node_ops(void)
 	set_op_equivalent_node(op_Conv,    equivalent_node_Conv);
 	set_op_equivalent_node(op_CopyB,   equivalent_node_CopyB);
 	set_op_equivalent_node(op_Eor,     equivalent_node_Eor);
+	set_op_equivalent_node(op_Extract, equivalent_node_Extract);
 	set_op_equivalent_node(op_Id,      equivalent_node_Id);
+	set_op_equivalent_node(op_Insert,  equivalent_node_Insert);
 	set_op_equivalent_node(op_Minus,   equivalent_node_Minus);
 	set_op_equivalent_node(op_Mul,     equivalent_node_Mul);
 	set_op_equivalent_node(op_Mux,     equivalent_node_Mux);
@@ -7624,6 +7789,7 @@ void ir_register_opt_node_ops(void)
 	set_op_equivalent_node(op_Shl,     equivalent_node_right_zero);
 	set_op_equivalent_node(op_Shr,     equivalent_node_right_zero);
 	set_op_equivalent_node(op_Shrs,    equivalent_node_right_zero);
+	set_op_equivalent_node(op_Shuffle, equivalent_node_Shuffle);
 	set_op_equivalent_node(op_Sub,     equivalent_node_Sub);
 	set_op_equivalent_node(op_Sync,    equivalent_node_Sync);
 	set_op_equivalent_node_proj(op_Div,   equivalent_node_Proj_Div);
@@ -7668,38 +7834,38 @@ void ir_register_opt_node_ops(void)
  * in a graph. */
 #define N_IR_NODES 512
 
-static int identities_cmp(const void *elt, const void *key)
+static int identities_equal(const void *elt, const void *key)
 {
 	ir_node *a = (ir_node *)elt;
 	ir_node *b = (ir_node *)key;
 
 	if (a == b)
-		return 0;
+		return 1;
 
 	if ((get_irn_op(a) != get_irn_op(b)) ||
 	    (get_irn_mode(a) != get_irn_mode(b)))
-	    return 1;
+	    return 0;
 
 	/* compare if a's in and b's in are of equal length */
 	int irn_arity_a = get_irn_arity(a);
 	if (irn_arity_a != get_irn_arity(b))
-		return 1;
+		return 0;
 
 	/* blocks are never the same */
 	if (is_Block(a))
-		return 1;
+		return 0;
 
 	if (get_irn_pinned(a)) {
 		/* for pinned nodes, the block inputs must be equal */
 		if (get_nodes_block(a) != get_nodes_block(b))
-			return 1;
+			return 0;
 	} else {
 		ir_node *block_a = get_nodes_block(a);
 		ir_node *block_b = get_nodes_block(b);
 		if (!get_opt_global_cse()) {
 			/* for block-local CSE both nodes must be in the same Block */
 			if (block_a != block_b)
-				return 1;
+				return 0;
 		} else {
 			/* The optimistic approach would be to do nothing here.
 			 * However doing GCSE optimistically produces a lot of partially dead code which appears
@@ -7708,7 +7874,7 @@ static int identities_cmp(const void *elt, const void *key)
 			 * other. */
 			if (!block_dominates(block_a, block_b)
 			 && !block_dominates(block_b, block_a))
-			    return 1;
+			    return 0;
 		}
 	}
 
@@ -7717,12 +7883,12 @@ static int identities_cmp(const void *elt, const void *key)
 		ir_node *pred_a = get_irn_n(a, i);
 		ir_node *pred_b = get_irn_n(b, i);
 		if (pred_a != pred_b)
-			return 1;
+			return 0;
 	}
 
 	/* here, we already know that the nodes are identical except their
 	 * attributes */
-	return !a->op->ops.attrs_equal(a, b);
+	return a->op->ops.attrs_equal(a, b);
 }
 
 unsigned ir_node_hash(const ir_node *node)
@@ -7730,16 +7896,30 @@ unsigned ir_node_hash(const ir_node *node)
 	return node->op->ops.hash(node);
 }
 
-void new_identities(ir_graph *irg)
+static unsigned identities_hash(const void *node)
+{
+	return ir_node_hash((const ir_node*)node);
+}
+
+void new_identities_cmp(ir_graph *irg, cpset_cmp_function cmp)
 {
 	del_identities(irg);
-	irg->value_table = new_pset(identities_cmp, N_IR_NODES);
+	irg->value_table = XMALLOC(cpset_t);
+	cpset_init_size(irg->value_table, identities_hash, cmp, N_IR_NODES);
+}
+
+void new_identities(ir_graph *irg)
+{
+	new_identities_cmp(irg, identities_equal);
 }
 
 void del_identities(ir_graph *irg)
 {
-	if (irg->value_table != NULL)
-		del_pset(irg->value_table);
+	if (irg->value_table != NULL) {
+		cpset_destroy(irg->value_table);
+		free(irg->value_table);
+		irg->value_table = NULL;
+	}
 }
 
 static int cmp_node_nr(const void *a, const void *b)
@@ -7794,14 +7974,14 @@ void ir_normalize_node(ir_node *n)
 ir_node *identify_remember(ir_node *n)
 {
 	ir_graph *irg         = get_irn_irg(n);
-	pset     *value_table = irg->value_table;
+	cpset_t  *value_table = irg->value_table;
 
 	if (value_table == NULL)
 		return n;
 
 	ir_normalize_node(n);
 	/* lookup or insert in hash table with given hash key. */
-	ir_node *nn = (ir_node *)pset_insert(value_table, n, ir_node_hash(n));
+	ir_node *nn = (ir_node *)cpset_insert(value_table, n);
 
 	/* nn is reachable again */
 	if (nn != n)
@@ -7841,7 +8021,9 @@ void add_identities(ir_node *node)
 
 void visit_all_identities(ir_graph *irg, irg_walk_func visit, void *env)
 {
-	foreach_pset(irg->value_table, ir_node, node) {
+	cpset_iterator_t iter;
+	cpset_iterator_init(&iter, irg->value_table);
+	for (ir_node *node; (node = (ir_node*)cpset_iterator_next(&iter)) != NULL;) {
 		visit(node, env);
 	}
 }
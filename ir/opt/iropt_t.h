@@ -12,6 +12,7 @@
 #define FIRM_IR_IROPT_T_H
 
 #include <stdbool.h>
+#include "cpset.h"
 #include "irop_t.h"
 #include "iropt.h"
 #include "irnode_t.h"
@@ -40,9 +41,13 @@ ir_node *equivalent_node(ir_node *n);
 void new_identities(ir_graph *irg);
 
 /**
- * Deletes a identities value table.
- *
- * @param value_table  the identity set
+ * Creates a new value table like new_identities() but uses @p cmp to decide
+ * whether two nodes compute the same value.
+ */
+void new_identities_cmp(ir_graph *irg, cpset_cmp_function cmp);
+
+/**
+ * Deletes the identities value table of a graph.
  */
 void del_identities(ir_graph *irg);
 
@@ -2252,11 +2252,14 @@ void combine_memops(ir_graph *irg)
 	if (!be_get_backend_param()->unaligned_memaccess_supported)
 		return;
 
+	bool const timed = irg_timing_scope_begin(irg, "combine_memops");
 	irg_walk_graph(irg, combine_memop, NULL, NULL);
+	irg_timing_scope_end(irg, timed);
 }
 
 void optimize_load_store(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "optimize_load_store");
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
 	                         | IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
 	                         | IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
@@ -2304,4 +2307,5 @@ void optimize_load_store(ir_graph *irg)
 		| IR_GRAPH_PROPERTY_NO_BADS | IR_GRAPH_PROPERTY_NO_TUPLES
 		| IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE
 		| IR_GRAPH_PROPERTY_MANY_RETURNS);
+	irg_timing_scope_end(irg, timed);
 }
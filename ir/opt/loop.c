@@ -10,11 +10,14 @@
  *
  */
 
+#include <limits.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stdlib.h>
 
 #include "util.h"
 #include "array.h"
+#include "be.h"
 #include "debug.h"
 #include "panic.h"
 #include "irbackedge_t.h"
@@ -25,8 +28,11 @@
 #include "irgopt.h"
 #include "irgwalk.h"
 #include "irloop_t.h"
+#include "irmemory.h"
+#include "irmode_t.h"
 #include "irnode_t.h"
 #include "irnodemap.h"
+#include "irnodeset.h"
 #include "iroptimize.h"
 #include "irouts.h"
 #include "irtools.h"
@@ -91,6 +97,8 @@ typedef struct loop_stats_t {
 	unsigned constant_unroll;
 	unsigned invariant_unroll;
 
+	unsigned vectorized;
+
 	unsigned unhandled;
 } loop_stats_t;
 
@@ -115,6 +123,7 @@ static void print_stats(void)
 	DB((dbg, LEVEL_2, "u_simple_counting :   %d\n", stats.u_simple_counting_loop));
 	DB((dbg, LEVEL_2, "constant_unroll   :   %d\n", stats.constant_unroll));
 	DB((dbg, LEVEL_2, "invariant_unroll  :   %d\n", stats.invariant_unroll));
+	DB((dbg, LEVEL_2, "vectorized        :   %d\n", stats.vectorized));
 	DB((dbg, LEVEL_2, "=======================================\n"));
 }
 
@@ -189,7 +198,8 @@ static struct obstack obst;
 typedef enum loop_op_t {
 	loop_op_inversion,
 	loop_op_unrolling,
-	loop_op_peeling
+	loop_op_peeling,
+	loop_op_vectorization
 } loop_op_t;
 
 /* Returns the maximum nodes for the given nest depth */
@@ -2224,6 +2234,722 @@ static void unroll_loop(ir_graph *const irg)
 	}
 }
 
+/*
+ * Loop vectorization
+ *
+ * A simple counting loop consisting of a single block is preceded by a vector
+ * loop processing n_lanes iterations at once.  The original loop stays in
+ * place and runs the remaining iterations, so it serves as the scalar epilogue.
+ * As the original loop is tail-controlled, it runs at least once and all values
+ * leaving the loop are still computed by it.
+ */
+
+/* An address of the form base + sym + scale * iv + offset. */
+typedef struct affine_t {
+	ir_node *base;   /* loop invariant pointer or NULL */
+	ir_node *sym;    /* loop invariant integer or NULL */
+	long     scale;
+	long     offset;
+} affine_t;
+
+/* Information about the loop to vectorize. */
+typedef struct vec_info_t {
+	ir_node   *mem_phi;     /* memory phi of the loop head or NULL */
+	ir_node  **memops;      /* Loads and Stores of the loop */
+	affine_t  *addresses;   /* addresses of memops */
+	ir_node  **reductions;  /* phis of reductions */
+	unsigned   lane_bits;
+	unsigned   n_lanes;
+
+	/* vector loop construction */
+	ir_node   *pre_block;   /* block before the vector loop */
+	ir_node   *block;       /* body of the vector loop */
+	ir_node   *iv;          /* counter of the vector loop */
+	ir_node   *mem;         /* memory phi of the vector loop */
+	ir_nodemap scalars;     /* scalar copies in the vector loop */
+	ir_nodemap vectors;     /* vectorized values */
+} vec_info_t;
+
+static vec_info_t vec_info;
+
+static ir_node *get_memop_ptr(ir_node const *const node)
+{
+	return is_Load(node) ? get_Load_ptr(node) : get_Store_ptr(node);
+}
+
+static ir_type *get_memop_type(ir_node const *const node)
+{
+	return is_Load(node) ? get_Load_type(node) : get_Store_type(node);
+}
+
+static ir_mode *get_memop_mode(ir_node const *const node)
+{
+	return is_Load(node) ? get_Load_mode(node)
+	                     : get_irn_mode(get_Store_value(node));
+}
+
+/* Describes address node as affine function of the iteration phi.
+ * Returns false if this is not possible. */
+static bool get_affine(ir_node *const node, affine_t *const res)
+{
+	if (is_Const(node)) {
+		ir_tarval *const tv = get_Const_tarval(node);
+		if (!tarval_is_long(tv))
+			return false;
+		*res = (affine_t){ .offset = get_tarval_long(tv) };
+		return true;
+	}
+	if (!is_in_loop(node)) {
+		if (mode_is_reference(get_irn_mode(node)))
+			*res = (affine_t){ .base = node };
+		else
+			*res = (affine_t){ .sym = node };
+		return true;
+	}
+	if (node == loop_info.iteration_phi) {
+		*res = (affine_t){ .scale = 1 };
+		return true;
+	}
+
+	/* Integer arithmetic narrower than a pointer might wrap around. Only the
+	 * iv and its successor are known not to, as they are below end_val. */
+	ir_mode *const mode = get_irn_mode(node);
+	if (mode_is_int(mode) && node != loop_info.add
+	    && get_mode_size_bits(mode) < get_mode_size_bits(mode_P))
+		return false;
+
+	affine_t l;
+	affine_t r;
+	switch (get_irn_opcode(node)) {
+	case iro_Add:
+		if (!get_affine(get_Add_left(node), &l)
+		    || !get_affine(get_Add_right(node), &r)
+		    || (l.base && r.base) || (l.sym && r.sym))
+			return false;
+		*res = (affine_t){
+			.base   = l.base ? l.base : r.base,
+			.sym    = l.sym ? l.sym : r.sym,
+			.scale  = l.scale + r.scale,
+			.offset = l.offset + r.offset,
+		};
+		return true;
+
+	case iro_Sub:
+		if (!get_affine(get_Sub_left(node), &l)
+		    || !get_affine(get_Sub_right(node), &r) || r.base || r.sym)
+			return false;
+		*res = (affine_t){
+			.base   = l.base,
+			.sym    = l.sym,
+			.scale  = l.scale - r.scale,
+			.offset = l.offset - r.offset,
+		};
+		return true;
+
+	case iro_Mul:
+	case iro_Shl: {
+		ir_node *const right = get_binop_right(node);
+		if (!is_Const(right) || !tarval_is_long(get_Const_tarval(right)))
+			return false;
+		long factor = get_tarval_long(get_Const_tarval(right));
+		if (is_Shl(node)) {
+			if (factor < 0 || factor >= 32)
+				return false;
+			factor = 1L << factor;
+		}
+		if (!get_affine(get_binop_left(node), &l) || l.base || l.sym)
+			return false;
+		*res = (affine_t){ .scale = l.scale * factor, .offset = l.offset * factor };
+		return true;
+	}
+
+	case iro_Conv: {
+		ir_node *const op = get_Conv_op(node);
+		if (op != loop_info.iteration_phi && op != loop_info.add)
+			return false;
+		if (!mode_is_int(mode)
+		    || get_mode_size_bits(mode) < get_mode_size_bits(get_irn_mode(op)))
+			return false;
+		return get_affine(op, res);
+	}
+
+	default:
+		return false;
+	}
+}
+
+/* Returns true if the loop carries a dependence between memops a and b
+ * that is shorter than a vector. */
+static bool has_short_dependence(unsigned const a, unsigned const b)
+{
+	affine_t const *const aa = &vec_info.addresses[a];
+	affine_t const *const ab = &vec_info.addresses[b];
+	if (aa->base == ab->base) {
+		if (aa->sym != ab->sym || aa->scale != ab->scale)
+			return true;
+		long const distance = labs(ab->offset - aa->offset);
+		long const width    = vec_info.n_lanes * vec_info.lane_bits / 8;
+		return distance != 0 && distance < width;
+	}
+	if (aa->base == NULL || ab->base == NULL)
+		return true;
+
+	/* The accesses may cover any part of the objects behind the bases. */
+	ir_node *const na = vec_info.memops[a];
+	ir_node *const nb = vec_info.memops[b];
+	return get_alias_relation(aa->base, get_memop_type(na), UINT_MAX,
+	                          ab->base, get_memop_type(nb), UINT_MAX)
+	       != ir_no_alias;
+}
+
+/* Returns true if memop is a non-volatile Load or Store whose memory is
+ * produced by the loop head memory phi or Loads and Stores of the loop. */
+static bool is_vectorizable_memop(ir_node *const node)
+{
+	if (is_Load(node)) {
+		if (get_Load_volatility(node) == volatility_is_volatile)
+			return false;
+	} else if (is_Store(node)) {
+		if (get_Store_volatility(node) == volatility_is_volatile)
+			return false;
+	} else {
+		return false;
+	}
+	if (ir_throws_exception(node))
+		return false;
+
+	ir_node *const mem = get_memop_mem(node);
+	if (!is_in_loop(mem) || mem == vec_info.mem_phi)
+		return true;
+	if (!is_Proj(mem))
+		return false;
+	ir_node *const pred = get_Proj_pred(mem);
+	return is_Load(pred) || is_Store(pred);
+}
+
+/* Returns true if phi accumulates a value with an associative integer
+ * operation that is not used otherwise inside the loop. */
+static bool is_reduction(ir_node *const phi)
+{
+	ir_mode *const mode = get_irn_mode(phi);
+	if (!mode_is_int(mode) || get_irn_n_edges(phi) != 1)
+		return false;
+
+	ir_node *const next = get_Phi_pred(phi, loop_info.be_src_pos);
+	switch (get_irn_opcode(next)) {
+	case iro_Add:
+	case iro_And:
+	case iro_Eor:
+	case iro_Mul:
+	case iro_Or:
+		break;
+	default:
+		return false;
+	}
+	if (get_binop_left(next) != phi && get_binop_right(next) != phi)
+		return false;
+
+	foreach_out_edge(next, edge) {
+		ir_node *const user = get_edge_src_irn(edge);
+		if (user != phi && is_in_loop(user))
+			return false;
+	}
+	return true;
+}
+
+/* Returns the operand of reduction which is not the phi. */
+static ir_node *get_reduction_operand(ir_node *const phi)
+{
+	ir_node *const next = get_Phi_pred(phi, loop_info.be_src_pos);
+	ir_node *const left = get_binop_left(next);
+	return left == phi ? get_binop_right(next) : left;
+}
+
+static int get_memop_index(ir_node const *const node)
+{
+	for (size_t i = 0, n = ARR_LEN(vec_info.memops); i < n; ++i) {
+		if (vec_info.memops[i] == node)
+			return i;
+	}
+	return -1;
+}
+
+/* Returns true if the memop at index i accesses the same address in every
+ * iteration, so its value is broadcasted instead of loading a vector. */
+static bool is_uniform_load(unsigned const i)
+{
+	return vec_info.addresses[i].scale == 0;
+}
+
+/* Checks if the value node can be computed lane-wise in the vector loop. */
+static bool check_vector(ir_node *const node, ir_nodeset_t *const checked)
+{
+	ir_mode *const mode = get_irn_mode(node);
+	if ((!mode_is_int(mode) && !mode_is_float(mode))
+	    || get_mode_size_bits(mode) != vec_info.lane_bits)
+		return false;
+	if (!is_in_loop(node) || node == loop_info.iteration_phi)
+		return true;
+	if (!ir_nodeset_insert(checked, node))
+		return true;
+
+	switch (get_irn_opcode(node)) {
+	case iro_Proj: {
+		ir_node *const load = get_Proj_pred(node);
+		return is_Load(load) && get_memop_index(load) >= 0;
+	}
+
+	case iro_Add:
+	case iro_And:
+	case iro_Eor:
+	case iro_Mul:
+	case iro_Or:
+	case iro_Sub:
+		return check_vector(get_binop_left(node), checked)
+		    && check_vector(get_binop_right(node), checked);
+
+	case iro_Conv:
+	case iro_Minus:
+	case iro_Not:
+		return check_vector(get_irn_n(node, 0), checked);
+
+	default:
+		return false;
+	}
+}
+
+/* Returns false if the loop condition does not fit the vector loop, which
+ * runs while iv < end_val and more than n_lanes iterations are left. */
+static bool check_vector_condition(ir_node *const cmp)
+{
+	ir_relation relation = get_Cmp_relation(cmp);
+	if (get_Cmp_left(cmp) == loop_info.end_val)
+		relation = get_inversed_relation(relation);
+	if (loop_info.exit_cond)
+		relation = get_negated_relation(relation);
+	relation &= ~ir_relation_unordered;
+
+	if (relation != ir_relation_less && relation != ir_relation_less_greater)
+		return false;
+
+	/* Check if the loop runs long enough for the vector loop. */
+	if (is_Const(loop_info.start_val) && is_Const(loop_info.end_val)) {
+		ir_tarval *const count = tarval_sub(get_Const_tarval(loop_info.end_val),
+		                                    get_Const_tarval(loop_info.start_val));
+		if (!tarval_is_long(count)
+		    || get_tarval_long(count) < 2 * (long)vec_info.n_lanes)
+			return false;
+	}
+	return true;
+}
+
+/* Collects the memops of the loop and checks the loop for vectorization. */
+static bool analyze_vector_loop(void)
+{
+	ir_node *const cmp = is_simple_loop();
+	if (!cmp)
+		return false;
+
+	/* Only single block loops, the vector loop gets its own blocks. */
+	if (get_Block_n_cfgpreds(loop_head) != 2)
+		return false;
+	if (get_nodes_block(get_Block_cfgpred(loop_head, loop_info.be_src_pos)) != loop_head)
+		return false;
+
+	/* The iv is counted up by one and compared by its latest value. */
+	ir_node *iteration_path;
+	if (!get_invariant_pred(cmp, &loop_info.end_val, &iteration_path))
+		return false;
+	if (!is_Add(iteration_path))
+		return false;
+	loop_info.add = iteration_path;
+	if (!get_const_pred(loop_info.add, &loop_info.step, &loop_info.iteration_phi))
+		return false;
+	if (!is_Phi(loop_info.iteration_phi) || !get_start_and_add(invariant))
+		return false;
+	if (!are_mode_I(loop_info.start_val, loop_info.step, loop_info.end_val)
+	    || !is_Const(loop_info.step) || !tarval_is_one(get_Const_tarval(loop_info.step)))
+		return false;
+
+	/* Apart from the iv, phis are the memory or reductions. */
+	for_each_phi(loop_head, phi) {
+		if (phi == loop_info.iteration_phi)
+			continue;
+		if (get_irn_mode(phi) == mode_M) {
+			vec_info.mem_phi = phi;
+		} else if (is_reduction(phi)) {
+			ARR_APP1(ir_node*, vec_info.reductions, phi);
+		} else {
+			DB((dbg, LEVEL_3, "no reduction %N\n", phi));
+			return false;
+		}
+	}
+
+	/* Only Loads and Stores may use memory, and every Store has to be on the
+	 * memory chain leaving through the backedge. */
+	unsigned n_stores = 0;
+	foreach_out_edge(loop_head, edge) {
+		ir_node *const node = get_edge_src_irn(edge);
+		if (is_Phi(node) || is_Proj(node))
+			continue;
+		bool has_mem = false;
+		foreach_irn_in(node, i, pred) {
+			has_mem |= get_irn_mode(pred) == mode_M;
+		}
+		if (!has_mem)
+			continue;
+		if (!is_vectorizable_memop(node))
+			return false;
+		if (is_Store(node))
+			++n_stores;
+		ARR_APP1(ir_node*, vec_info.memops, node);
+	}
+	if (n_stores > 0) {
+		if (vec_info.mem_phi == NULL)
+			return false;
+		ir_node *mem = get_Phi_pred(vec_info.mem_phi, loop_info.be_src_pos);
+		while (mem != vec_info.mem_phi) {
+			if (!is_Proj(mem))
+				return false;
+			ir_node *const pred = get_Proj_pred(mem);
+			if (is_Store(pred))
+				--n_stores;
+			mem = get_memop_mem(pred);
+		}
+		if (n_stores != 0)
+			return false;
+	}
+
+	/* Determine the lane width from the memory accesses. */
+	size_t const n_memops = ARR_LEN(vec_info.memops);
+	vec_info.addresses = NEW_ARR_F(affine_t, n_memops);
+	for (size_t i = 0; i < n_memops; ++i) {
+		ir_node  *const memop = vec_info.memops[i];
+		affine_t *const addr  = &vec_info.addresses[i];
+		if (!get_affine(get_memop_ptr(memop), addr))
+			return false;
+
+		ir_mode *const mode = get_memop_mode(memop);
+		unsigned const bits = get_mode_size_bits(mode);
+		if ((!mode_is_int(mode) && !mode_is_float(mode)) || bits % 8 != 0)
+			return false;
+		if (addr->scale == 0 && is_Load(memop))
+			continue;
+		if (vec_info.lane_bits == 0)
+			vec_info.lane_bits = bits;
+		if (bits != vec_info.lane_bits || addr->scale != (long)bits / 8)
+			return false;
+	}
+	if (vec_info.lane_bits == 0) {
+		if (ARR_LEN(vec_info.reductions) == 0)
+			return false;
+		vec_info.lane_bits = get_mode_size_bits(get_irn_mode(vec_info.reductions[0]));
+	}
+	unsigned const vector_size = be_get_backend_param()->vector_size;
+	if (vector_size % vec_info.lane_bits != 0)
+		return false;
+	vec_info.n_lanes = vector_size / vec_info.lane_bits;
+	if (vec_info.n_lanes < 2)
+		return false;
+
+	if (!check_vector_condition(cmp))
+		return false;
+
+	/* Check memory dependences between the iterations of a vector. */
+	for (size_t i = 0; i < n_memops; ++i) {
+		for (size_t j = i + 1; j < n_memops; ++j) {
+			if (is_Load(vec_info.memops[i]) && is_Load(vec_info.memops[j]))
+				continue;
+			if (has_short_dependence(i, j)) {
+				DB((dbg, LEVEL_3, "dependence between %N and %N\n",
+				    vec_info.memops[i], vec_info.memops[j]));
+				return false;
+			}
+		}
+	}
+
+	/* Check the values flowing into Stores and reductions. */
+	ir_nodeset_t checked;
+	ir_nodeset_init(&checked);
+	bool ok = true;
+	for (size_t i = 0; ok && i < n_memops; ++i) {
+		ir_node *const memop = vec_info.memops[i];
+		if (is_Store(memop))
+			ok = check_vector(get_Store_value(memop), &checked);
+	}
+	for (size_t i = 0, n = ARR_LEN(vec_info.reductions); ok && i < n; ++i) {
+		ir_node *const phi = vec_info.reductions[i];
+		ok = get_mode_size_bits(get_irn_mode(phi)) == vec_info.lane_bits
+		  && check_vector(get_reduction_operand(phi), &checked);
+	}
+	ir_nodeset_destroy(&checked);
+	return ok;
+}
+
+/* Returns the copy of the scalar node for the current vector iteration. */
+static ir_node *get_vector_scalar(ir_node *const node)
+{
+	if (!is_in_loop(node))
+		return node;
+	if (node == loop_info.iteration_phi)
+		return vec_info.iv;
+
+	ir_node *copy = ir_nodemap_get(ir_node, &vec_info.scalars, node);
+	if (copy == NULL) {
+		copy = exact_copy(node);
+		set_nodes_block(copy, vec_info.block);
+		foreach_irn_in(node, i, pred) {
+			set_irn_n(copy, i, get_vector_scalar(pred));
+		}
+		ir_nodemap_insert(&vec_info.scalars, node, copy);
+	}
+	return copy;
+}
+
+static ir_cons_flags get_vector_flags(ir_node const *const memop)
+{
+	return get_irn_pinned(memop) == op_pin_state_floats
+	       ? cons_unaligned | cons_floats : cons_unaligned;
+}
+
+static ir_node *get_vector_mem(ir_node *mem);
+static ir_node *get_vector_value(ir_node *node);
+
+/* Creates the vector or uniform version of memop. */
+static ir_node *vectorize_memop(ir_node *const memop)
+{
+	ir_node *res = ir_nodemap_get(ir_node, &vec_info.vectors, memop);
+	if (res != NULL)
+		return res;
+
+	dbg_info *const dbgi  = get_irn_dbg_info(memop);
+	ir_node  *const mem   = get_vector_mem(get_memop_mem(memop));
+	ir_node  *const ptr   = get_vector_scalar(get_memop_ptr(memop));
+	ir_mode  *const mode  = get_memop_mode(memop);
+	ir_type  *const type  = get_memop_type(memop);
+	ir_mode  *const vmode = get_vector_mode(mode, vec_info.n_lanes);
+	ir_type  *const vtype = new_type_array(type, vec_info.n_lanes);
+	if (is_Load(memop)) {
+		if (is_uniform_load(get_memop_index(memop))) {
+			res = new_rd_Load(dbgi, vec_info.block, mem, ptr, mode, type,
+			                  get_irn_pinned(memop) == op_pin_state_floats
+			                  ? cons_floats : cons_none);
+		} else {
+			res = new_rd_Load(dbgi, vec_info.block, mem, ptr, vmode, vtype,
+			                  get_vector_flags(memop));
+		}
+	} else {
+		ir_node *const value = get_vector_value(get_Store_value(memop));
+		res = new_rd_Store(dbgi, vec_info.block, mem, ptr, value, vtype,
+		                   get_vector_flags(memop));
+	}
+	ir_nodemap_insert(&vec_info.vectors, memop, res);
+	return res;
+}
+
+/* Returns the memory of the vector loop corresponding to mem. */
+static ir_node *get_vector_mem(ir_node *const mem)
+{
+	if (!is_in_loop(mem))
+		return mem;
+	if (mem == vec_info.mem_phi)
+		return vec_info.mem;
+	ir_node *const memop = vectorize_memop(get_Proj_pred(mem));
+	return new_r_Proj(memop, mode_M, is_Load(memop) ? pn_Load_M : pn_Store_M);
+}
+
+static ir_node *new_vector_binop(ir_node *const node, ir_node *const block,
+                                 ir_node *const left, ir_node *const right)
+{
+	dbg_info *const dbgi = get_irn_dbg_info(node);
+	switch (get_irn_opcode(node)) {
+	case iro_Add: return new_rd_Add(dbgi, block, left, right);
+	case iro_And: return new_rd_And(dbgi, block, left, right);
+	case iro_Eor: return new_rd_Eor(dbgi, block, left, right);
+	case iro_Mul: return new_rd_Mul(dbgi, block, left, right);
+	case iro_Or:  return new_rd_Or(dbgi, block, left, right);
+	case iro_Sub: return new_rd_Sub(dbgi, block, left, right);
+	default:      panic("unexpected binop %+F", node);
+	}
+}
+
+/* Returns the vector with the lanes of node in n_lanes iterations. */
+static ir_node *get_vector_value(ir_node *const node)
+{
+	ir_node *res = ir_nodemap_get(ir_node, &vec_info.vectors, node);
+	if (res != NULL)
+		return res;
+
+	ir_graph *const irg   = get_irn_irg(node);
+	dbg_info *const dbgi  = get_irn_dbg_info(node);
+	ir_node  *const block = vec_info.block;
+	ir_mode  *const mode  = get_irn_mode(node);
+	ir_mode  *const vmode = get_vector_mode(mode, vec_info.n_lanes);
+	if (is_Const(node)) {
+		res = new_r_Const(irg, tarval_broadcast(get_Const_tarval(node), vmode));
+	} else if (!is_in_loop(node)) {
+		res = new_rd_Broadcast(dbgi, vec_info.pre_block, node, vmode);
+	} else if (node == loop_info.iteration_phi) {
+		ir_tarval **const lanes = ALLOCAN(ir_tarval*, vec_info.n_lanes);
+		for (unsigned i = 0; i < vec_info.n_lanes; ++i)
+			lanes[i] = new_tarval_from_long(i, mode);
+		ir_node *const iv  = new_rd_Broadcast(dbgi, block, vec_info.iv, vmode);
+		ir_node *const inc = new_r_Const(irg, new_tarval_vector(vmode, lanes));
+		res = new_rd_Add(dbgi, block, iv, inc);
+	} else if (is_Proj(node)) {
+		ir_node *const load = get_Proj_pred(node);
+		ir_node *const vec  = vectorize_memop(load);
+		res = new_r_Proj(vec, get_Load_mode(vec), pn_Load_res);
+		if (!mode_is_vector(get_irn_mode(res)))
+			res = new_rd_Broadcast(dbgi, block, res, vmode);
+	} else if (is_Conv(node)) {
+		res = new_rd_Conv(dbgi, block, get_vector_value(get_Conv_op(node)), vmode);
+	} else if (is_Minus(node)) {
+		res = new_rd_Minus(dbgi, block, get_vector_value(get_Minus_op(node)));
+	} else if (is_Not(node)) {
+		res = new_rd_Not(dbgi, block, get_vector_value(get_Not_op(node)));
+	} else {
+		ir_node *const left  = get_vector_value(get_binop_left(node));
+		ir_node *const right = get_vector_value(get_binop_right(node));
+		res = new_vector_binop(node, block, left, right);
+	}
+	ir_nodemap_insert(&vec_info.vectors, node, res);
+	return res;
+}
+
+/* Returns the neutral element of the reduction operation op. */
+static ir_tarval *get_reduction_neutral(ir_node const *const op, ir_mode *const mode)
+{
+	switch (get_irn_opcode(op)) {
+	case iro_And: return get_mode_all_one(mode);
+	case iro_Mul: return get_mode_one(mode);
+	default:      return get_mode_null(mode);
+	}
+}
+
+/* Puts the vector loop in front of the loop head. */
+static void create_vector_loop(ir_graph *const irg)
+{
+	int       const be_pos    = loop_info.be_src_pos;
+	int       const entry_pos = 1 - be_pos;
+	ir_node  *const entry     = get_Block_cfgpred(loop_head, entry_pos);
+	ir_node  *const end_val   = loop_info.end_val;
+	ir_mode  *const iv_mode   = get_irn_mode(loop_info.iteration_phi);
+	unsigned  const n_lanes   = vec_info.n_lanes;
+	dbg_info *const dbgi      = get_irn_dbg_info(loop_head);
+
+	/* The backedge of the vector loop is set once the body exists. */
+	ir_node *const head_in[] = { entry, new_r_Dummy(irg, mode_X) };
+	ir_node *const head      = new_rd_Block(dbgi, irg, ARRAY_SIZE(head_in), head_in);
+	vec_info.pre_block = get_nodes_block(entry);
+
+	ir_node *const iv_in[] = { loop_info.start_val, new_r_Dummy(irg, iv_mode) };
+	vec_info.iv = new_r_Phi(head, ARRAY_SIZE(iv_in), iv_in, iv_mode);
+	if (vec_info.mem_phi != NULL) {
+		ir_node *const mem_in[] = {
+			get_Phi_pred(vec_info.mem_phi, entry_pos), new_r_Dummy(irg, mode_M)
+		};
+		vec_info.mem = new_r_Phi(head, ARRAY_SIZE(mem_in), mem_in, mode_M);
+	}
+
+	/* Reductions accumulate in the lanes of a vector starting with the
+	 * neutral element, the start value is added when leaving. */
+	size_t    const n_reductions = ARR_LEN(vec_info.reductions);
+	ir_node **const accs         = ALLOCAN(ir_node*, n_reductions);
+	for (size_t i = 0; i < n_reductions; ++i) {
+		ir_node   *const phi     = vec_info.reductions[i];
+		ir_mode   *const mode    = get_irn_mode(phi);
+		ir_mode   *const vmode   = get_vector_mode(mode, n_lanes);
+		ir_tarval *const neutral = get_reduction_neutral(get_Phi_pred(phi, be_pos), mode);
+		ir_node   *const acc_in[] = {
+			new_r_Const(irg, tarval_broadcast(neutral, vmode)),
+			new_r_Dummy(irg, vmode)
+		};
+		accs[i] = new_r_Phi(head, ARRAY_SIZE(acc_in), acc_in, vmode);
+		ir_nodemap_insert(&vec_info.vectors, phi, accs[i]);
+	}
+
+	/* Stay in the vector loop while iv < end_val and more than n_lanes
+	 * iterations are left, so the scalar loop runs at least once. */
+	ir_mode *const umode    = find_unsigned_mode(iv_mode);
+	ir_node *const in_range = new_rd_Cmp(dbgi, head, vec_info.iv, end_val, ir_relation_less);
+	ir_node *const u_end    = new_rd_Conv(dbgi, head, end_val, umode);
+	ir_node *const u_iv     = new_rd_Conv(dbgi, head, vec_info.iv, umode);
+	ir_node *const left     = new_rd_Sub(dbgi, head, u_end, u_iv);
+	ir_node *const width    = new_r_Const_long(irg, umode, n_lanes);
+	ir_node *const enough   = new_rd_Cmp(dbgi, head, left, width, ir_relation_greater);
+	ir_node *const stay     = new_rd_And(dbgi, head, in_range, enough);
+	ir_node *const cond     = new_rd_Cond(dbgi, head, stay);
+	ir_node *const proj_t   = new_r_Proj(cond, mode_X, pn_Cond_true);
+	ir_node *const proj_f   = new_r_Proj(cond, mode_X, pn_Cond_false);
+
+	/* Stores are all on the memory chain, Loads are created as needed. */
+	ir_node *const body = new_rd_Block(dbgi, irg, 1, &proj_t);
+	vec_info.block = body;
+	if (vec_info.mem_phi != NULL) {
+		ir_node *const mem = get_Phi_pred(vec_info.mem_phi, be_pos);
+		set_Phi_pred(vec_info.mem, 1, get_vector_mem(mem));
+	}
+	for (size_t i = 0; i < n_reductions; ++i) {
+		ir_node *const next = get_Phi_pred(vec_info.reductions[i], be_pos);
+		set_Phi_pred(accs[i], 1, get_vector_value(next));
+	}
+	ir_node *const step    = new_r_Const_long(irg, iv_mode, n_lanes);
+	ir_node *const iv_next = new_rd_Add(dbgi, body, vec_info.iv, step);
+	set_Phi_pred(vec_info.iv, 1, iv_next);
+	set_Block_cfgpred(head, 1, new_rd_Jmp(dbgi, body));
+
+	/* Continue with the scalar loop. */
+	ir_node *const exit = new_rd_Block(dbgi, irg, 1, &proj_f);
+	for (size_t i = 0; i < n_reductions; ++i) {
+		ir_node *const phi  = vec_info.reductions[i];
+		ir_node *const next = get_Phi_pred(phi, be_pos);
+		ir_node       *res  = get_Phi_pred(phi, entry_pos);
+		for (unsigned l = 0; l < n_lanes; ++l) {
+			ir_node *const lane = new_rd_Extract(dbgi, exit, accs[i], l);
+			res = new_vector_binop(next, exit, res, lane);
+		}
+		set_Phi_pred(phi, entry_pos, res);
+	}
+	set_Phi_pred(loop_info.iteration_phi, entry_pos, vec_info.iv);
+	if (vec_info.mem_phi != NULL)
+		set_Phi_pred(vec_info.mem_phi, entry_pos, vec_info.mem);
+	set_Block_cfgpred(loop_head, entry_pos, new_rd_Jmp(dbgi, exit));
+}
+
+/**
+ * Loop vectorization
+ */
+static void vectorize_loop(ir_graph *const irg)
+{
+	if (loop_info.calls > 0) {
+		++stats.calls_limit;
+		return;
+	}
+
+	memset(&vec_info, 0, sizeof(vec_info));
+	vec_info.memops     = NEW_ARR_F(ir_node*, 0);
+	vec_info.reductions = NEW_ARR_F(ir_node*, 0);
+
+	if (analyze_vector_loop()) {
+		DB((dbg, LEVEL_2, " *** Vectorizing with %u lanes ***\n", vec_info.n_lanes));
+
+		ir_nodemap_init(&vec_info.scalars, irg);
+		ir_nodemap_init(&vec_info.vectors, irg);
+		create_vector_loop(irg);
+		ir_nodemap_destroy(&vec_info.vectors);
+		ir_nodemap_destroy(&vec_info.scalars);
+
+		++stats.vectorized;
+		clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+	}
+
+	DEL_ARR_F(vec_info.memops);
+	DEL_ARR_F(vec_info.reductions);
+	if (vec_info.addresses != NULL)
+		DEL_ARR_F(vec_info.addresses);
+}
+
 /* Analyzes the loop, and checks if size is within allowed range.
  * Decides if loop will be processed. */
 static void init_analyze(ir_graph *const irg, ir_loop *const loop, loop_op_t const loop_op)
@@ -2257,6 +2983,7 @@ static void init_analyze(ir_graph *const irg, ir_loop *const loop, loop_op_t con
 	switch (loop_op) {
 		case loop_op_inversion: loop_inversion(irg); break;
 		case loop_op_unrolling: unroll_loop(irg);    break;
+		case loop_op_vectorization: vectorize_loop(irg); break;
 		default: panic("loop optimization not implemented");
 	}
 	DB((dbg, LEVEL_1, "       <<<< end of loop with node %ld >>>>\n", get_loop_loop_nr(loop)));
@@ -2359,17 +3086,33 @@ static void loop_optimization(ir_graph *const irg, loop_op_t const loop_op)
 
 void do_loop_unrolling(ir_graph *const irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "do_loop_unrolling");
 	loop_optimization(irg, loop_op_unrolling);
+	irg_timing_scope_end(irg, timed);
 }
 
 void do_loop_inversion(ir_graph *const irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "do_loop_inversion");
 	loop_optimization(irg, loop_op_inversion);
+	irg_timing_scope_end(irg, timed);
 }
 
 void do_loop_peeling(ir_graph *const irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "do_loop_peeling");
 	loop_optimization(irg, loop_op_peeling);
+	irg_timing_scope_end(irg, timed);
+}
+
+void do_loop_vectorization(ir_graph *const irg)
+{
+	backend_params const *const params = be_get_backend_param();
+	if (params->vector_size == 0 || !params->unaligned_memaccess_supported)
+		return;
+	bool const timed = irg_timing_scope_begin(irg, "do_loop_vectorization");
+	loop_optimization(irg, loop_op_vectorization);
+	irg_timing_scope_end(irg, timed);
 }
 
 void firm_init_loop_opt(void)
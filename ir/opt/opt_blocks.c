@@ -1163,6 +1163,7 @@ static void add_roots(ir_graph *irg, environment_t *env)
 /* Combines congruent end blocks into one. */
 void shape_blocks(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "shape_blocks");
 	environment_t env;
 	block_t       *bl;
 	int           res, n;
@@ -1237,4 +1238,5 @@ void shape_blocks(ir_graph *irg)
 	DEL_ARR_F(env.live_outs);
 	del_set(env.opcode2id_map);
 	obstack_free(&env.obst, NULL);
+	irg_timing_scope_end(irg, timed);
 }
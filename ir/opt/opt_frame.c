@@ -28,6 +28,7 @@ void opt_frame_irg(ir_graph *irg)
 	if (n <= 0)
 		return;
 
+	bool const timed = irg_timing_scope_begin(irg, "opt_frame_irg");
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUTS);
 	irp_reserve_resources(irp, IRP_RESOURCE_ENTITY_LINK);
 
@@ -80,4 +81,5 @@ void opt_frame_irg(ir_graph *irg)
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
 		| IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE
 		| IR_GRAPH_PROPERTY_MANY_RETURNS);
+	irg_timing_scope_end(irg, timed);
 }
@@ -1751,6 +1751,7 @@ static void insert_Loads_upwards(void)
 
 void opt_ldst(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "opt_ldst");
 	block_t *bl;
 
 	FIRM_DBG_REGISTER(dbg, "firm.opt.ldst");
@@ -1883,4 +1884,5 @@ no_changes:
 #ifdef DEBUG_libfirm
 	DEL_ARR_F(env.id_2_address);
 #endif
+	irg_timing_scope_end(irg, timed);
 }
@@ -1184,6 +1184,7 @@ static void lftr(ir_graph *irg, iv_env *env)
 /* Remove any Phi cycles with only one real input. */
 void remove_phi_cycles(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "remove_phi_cycles");
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
@@ -1230,6 +1231,7 @@ void remove_phi_cycles(ir_graph *irg)
 	obstack_free(&env.obst, NULL);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+	irg_timing_scope_end(irg, timed);
 }
 
 /**
@@ -1301,6 +1303,7 @@ static void fix_adds_and_subs(ir_node *irn, void *ctx)
 /* Performs Operator Strength Reduction for the passed graph. */
 void opt_osr(ir_graph *irg, unsigned flags)
 {
+	bool const timed = irg_timing_scope_begin(irg, "opt_osr");
 	FIRM_DBG_REGISTER(dbg, "firm.opt.osr");
 
 	assure_irg_properties(irg,
@@ -1355,4 +1358,5 @@ void opt_osr(ir_graph *irg, unsigned flags)
 	obstack_free(&env.obst, NULL);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
+	irg_timing_scope_end(irg, timed);
 }
@@ -495,6 +495,7 @@ static void eliminate_sync_edges(ir_graph *irg)
 
 void opt_parallelize_mem(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "opt_parallelize_mem");
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
 	                           | IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 	irg_walk_blkwise_dom_top_down(irg, NULL, walker, NULL);
@@ -502,4 +503,5 @@ void opt_parallelize_mem(ir_graph *irg)
 	eliminate_sync_edges(irg);
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+	irg_timing_scope_end(irg, timed);
 }
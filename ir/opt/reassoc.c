@@ -2071,6 +2071,7 @@ static void do_chaining(ir_graph *irg)
  */
 void optimize_reassociation(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "optimize_reassociation");
 	assert(get_irg_pinned(irg) != op_pin_state_floats &&
 	       "Reassociation needs pinned graph to work properly");
 
@@ -2112,6 +2113,7 @@ void optimize_reassociation(ir_graph *irg)
 	del_pdeq(wq);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+	irg_timing_scope_end(irg, timed);
 }
 
 void ir_register_reassoc_node_ops(void)
@@ -562,6 +562,7 @@ static void do_scalar_replacements(ir_graph *irg, pset *members, unsigned nvals,
  */
 void scalar_replacement_opt(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "scalar_replacement_opt");
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
 	                         | IR_GRAPH_PROPERTY_CONSISTENT_OUTS
 	                         | IR_GRAPH_PROPERTY_NO_TUPLES);
@@ -640,6 +641,7 @@ void scalar_replacement_opt(ir_graph *irg)
 
 	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_NONE
 	                                    : IR_GRAPH_PROPERTIES_ALL);
+	irg_timing_scope_end(irg, timed);
 }
 
 void firm_init_scalar_replace(void)
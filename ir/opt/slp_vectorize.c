@@ -0,0 +1,922 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2016 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Superword level parallelism (SLP) vectorization
+ *
+ * Stores to adjacent addresses in a block are the seeds: the trees computing
+ * their values are packed lane by lane.  Isomorphic operations become a
+ * single operation on the packed value, Loads from adjacent addresses a
+ * single wide Load and the Stores a single wide Store.
+ *
+ * If the backend has vector registers for the element mode, the packed
+ * values use a vector mode.  Otherwise the lanes are packed into a word
+ * sized integer, which restricts the trees to bitwise operations but still
+ * turns copies, masking and constant stores of adjacent small integers into
+ * word sized memory operations.  Unlike combine_memops() this works on any
+ * number of lanes, on memory chains and on non-constant values.
+ */
+#include "iroptimize.h"
+
+#include "array.h"
+#include "be.h"
+#include "debug.h"
+#include "ircons.h"
+#include "iredges_t.h"
+#include "irgmod.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irmemory.h"
+#include "irmode_t.h"
+#include "irnode_t.h"
+#include "irnodeset.h"
+#include "irop_t.h"
+#include "obst.h"
+#include "tv_t.h"
+#include "type_t.h"
+#include "util.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+/** Maximum depth of the trees packed below a group of Stores. */
+#define MAX_DEPTH 8
+/** Maximum number of memory operations passed when following a chain. */
+#define MAX_CHAIN 64
+
+/** A Store that may start a group. */
+typedef struct store_entry_t {
+	ir_node *store;
+	ir_node *block;
+	ir_node *base;
+	long     offset;
+} store_entry_t;
+
+typedef enum pack_kind_t {
+	PACK_OP,     /**< isomorphic operations */
+	PACK_LOAD,   /**< Loads from adjacent addresses */
+	PACK_CONST,  /**< constants */
+	PACK_SPLAT,  /**< the same value in all lanes */
+	PACK_VALUE,  /**< the lanes of an already packed value */
+	PACK_GATHER, /**< unrelated values inserted lane by lane */
+} pack_kind_t;
+
+typedef struct pack_t pack_t;
+struct pack_t {
+	pack_kind_t kind;
+	ir_node   **lanes; /**< the scalar value of each lane */
+	pack_t    **ops;   /**< operand packs of a PACK_OP */
+	ir_node   **nodes; /**< the Loads of a PACK_LOAD */
+	ir_node    *first; /**< the Load to replace first, NULL if parallel */
+	ir_node    *value; /**< the packed value of a PACK_VALUE */
+};
+
+typedef struct slp_env_t {
+	struct obstack obst;
+	ir_node       *block;     /**< block of the current tree */
+	ir_mode       *lane_mode; /**< mode of the lanes of the current tree */
+	ir_mode       *wide_mode; /**< mode of the packed values */
+	unsigned       n_lanes;   /**< number of lanes of the current tree */
+	int            cost;      /**< cost of the current tree, < 0 is a win */
+	ir_nodeset_t   tree;      /**< values replaced by the current tree */
+	ir_nodeset_t   done;      /**< nodes replaced by earlier trees */
+	ir_node      **stack;     /**< worklist of depends_on_tree() */
+	bool           changed;
+} slp_env_t;
+
+static void get_base_and_offset(ir_node *ptr, ir_node **base, long *offset)
+{
+	long     res  = 0;
+	ir_mode *mode = get_irn_mode(ptr);
+	for (;;) {
+		if (is_Add(ptr)) {
+			ir_node *l = get_Add_left(ptr);
+			ir_node *r = get_Add_right(ptr);
+			if (get_irn_mode(l) != mode || !is_Const(r))
+				break;
+			res += get_Const_long(r);
+			ptr  = l;
+		} else if (is_Sub(ptr)) {
+			ir_node *r = get_Sub_right(ptr);
+			if (!is_Const(r))
+				break;
+			res -= get_Const_long(r);
+			ptr  = get_Sub_left(ptr);
+		} else if (is_Member(ptr)) {
+			ir_entity *entity = get_Member_entity(ptr);
+			ir_type   *owner  = get_entity_owner(entity);
+			if (get_type_state(owner) != layout_fixed)
+				break;
+			res += get_entity_offset(entity);
+			ptr  = get_Member_ptr(ptr);
+		} else {
+			break;
+		}
+	}
+	*base   = ptr;
+	*offset = res;
+}
+
+static bool is_simple_memop(const ir_node *node)
+{
+	if (is_Load(node))
+		return get_Load_volatility(node) == volatility_non_volatile
+		    && !ir_throws_exception(node);
+	if (is_Store(node))
+		return get_Store_volatility(node) == volatility_non_volatile
+		    && !ir_throws_exception(node);
+	return false;
+}
+
+static ir_type *get_memop_type(const ir_node *node)
+{
+	return is_Load(node) ? get_Load_type(node) : get_Store_type(node);
+}
+
+static ir_node *get_memop_ptr(const ir_node *node)
+{
+	return is_Load(node) ? get_Load_ptr(node) : get_Store_ptr(node);
+}
+
+static unsigned get_memop_size(const ir_node *node)
+{
+	ir_mode *const mode = is_Load(node) ? get_Load_mode(node)
+	                                    : get_irn_mode(get_Store_value(node));
+	return get_mode_size_bytes(mode);
+}
+
+static bool may_alias(const ir_node *a, const ir_node *b)
+{
+	return get_alias_relation(get_memop_ptr(a), get_memop_type(a),
+	                          get_memop_size(a), get_memop_ptr(b),
+	                          get_memop_type(b), get_memop_size(b))
+	    != ir_no_alias;
+}
+
+/** Returns the number of users of the memory results of @p node. */
+static int get_n_mem_users(const ir_node *node)
+{
+	int n = 0;
+	foreach_out_edge(node, edge) {
+		ir_node *const proj = get_edge_src_irn(edge);
+		if (get_irn_mode(proj) == mode_M)
+			n += get_irn_n_edges(proj);
+	}
+	return n;
+}
+
+/** Replaces the memory results of @p node by @p mem. */
+static void reroute_mem(ir_node *node, ir_node *mem)
+{
+	foreach_out_edge_safe(node, edge) {
+		ir_node *const proj = get_edge_src_irn(edge);
+		if (get_irn_mode(proj) == mode_M)
+			exchange(proj, mem);
+	}
+}
+
+/**
+ * Checks whether the memory operations @p ops can be merged into one.
+ *
+ * They can if they all use the same memory or if they are ordered by a
+ * single chain of Loads and Stores in their block and every operation
+ * between them provably does not alias them.  Loads are moved up to the
+ * first of them, Stores down to the last one.
+ *
+ * @param end  receives the operation at the end the group moves to, or NULL
+ *             if all operations use the same memory
+ */
+static bool check_group_memory(slp_env_t *env, ir_node *const *ops,
+                               ir_node **end)
+{
+	unsigned const n        = env->n_lanes;
+	bool     const is_store = is_Store(ops[0]);
+	ir_node *const mem      = get_memop_mem(ops[0]);
+	bool           parallel = true;
+	for (unsigned i = 1; i < n; ++i)
+		parallel &= get_memop_mem(ops[i]) == mem;
+	if (parallel) {
+		*end = NULL;
+		return true;
+	}
+
+	/* find the member above each member */
+	ir_node **const above = ALLOCANZ(ir_node*, n);
+	ir_node **const pass  = ALLOCAN(ir_node*, MAX_CHAIN);
+	for (unsigned i = 0; i < n; ++i) {
+		ir_node *cur      = get_memop_mem(ops[i]);
+		unsigned n_passed = 0;
+		for (;;) {
+			if (!is_Proj(cur) || n_passed == MAX_CHAIN)
+				break;
+			ir_node *const pred = get_Proj_pred(cur);
+			if (get_nodes_block(pred) != env->block || !is_simple_memop(pred))
+				break;
+			if (is_store && get_n_mem_users(pred) != 1)
+				break;
+			bool member = false;
+			for (unsigned j = 0; j < n; ++j)
+				member |= ops[j] == pred;
+			if (member) {
+				above[i] = pred;
+				break;
+			}
+			pass[n_passed++] = pred;
+			cur = get_memop_mem(pred);
+		}
+		if (above[i] == NULL)
+			continue;
+
+		/* the group is moved across the passed operations */
+		for (unsigned p = 0; p < n_passed; ++p) {
+			ir_node *const op = pass[p];
+			if (!is_store && is_Load(op))
+				continue;
+			for (unsigned j = 0; j < n; ++j) {
+				if (may_alias(op, ops[j]))
+					return false;
+			}
+		}
+	}
+
+	/* the members must form a single chain */
+	ir_node *first = NULL;
+	ir_node *last  = NULL;
+	for (unsigned i = 0; i < n; ++i) {
+		if (above[i] == NULL) {
+			if (first != NULL)
+				return false;
+			first = ops[i];
+		}
+		unsigned n_below = 0;
+		for (unsigned j = 0; j < n; ++j)
+			n_below += above[j] == ops[i];
+		if (n_below > 1)
+			return false;
+		if (n_below == 0)
+			last = ops[i];
+	}
+	if (first == NULL)
+		return false;
+	*end = is_store ? last : first;
+	return true;
+}
+
+static pack_t *new_pack(slp_env_t *env, pack_kind_t kind,
+                        ir_node *const *lanes)
+{
+	pack_t *const pack = OALLOCZ(&env->obst, pack_t);
+	pack->kind  = kind;
+	pack->lanes = OALLOCN(&env->obst, ir_node*, env->n_lanes);
+	MEMCPY(pack->lanes, lanes, env->n_lanes);
+	return pack;
+}
+
+static bool is_available(const slp_env_t *env, const ir_node *node)
+{
+	return get_nodes_block(node) == env->block
+	    && get_irn_mode(node) == env->lane_mode
+	    && !ir_nodeset_contains(&env->tree, node)
+	    && !ir_nodeset_contains(&env->done, node);
+}
+
+/** Adds the cost of making the lanes available to their other users. */
+static void add_extract_cost(slp_env_t *env, ir_node *const *lanes)
+{
+	int const extract_cost = mode_is_vector(env->wide_mode) ? 1 : 2;
+	for (unsigned i = 0; i < env->n_lanes; ++i) {
+		if (get_irn_n_edges(lanes[i]) > 1)
+			env->cost += extract_cost;
+	}
+}
+
+static pack_t *try_pack_loads(slp_env_t *env, ir_node *const *lanes)
+{
+	unsigned  const n     = env->n_lanes;
+	ir_node **const loads = OALLOCN(&env->obst, ir_node*, n);
+	ir_node        *base0 = NULL;
+	long            off0  = 0;
+	for (unsigned i = 0; i < n; ++i) {
+		ir_node *const lane = lanes[i];
+		if (!is_Proj(lane) || get_Proj_num(lane) != pn_Load_res
+		    || !is_available(env, lane))
+			return NULL;
+		ir_node *const load = get_Proj_pred(lane);
+		if (!is_Load(load) || !is_simple_memop(load)
+		    || ir_nodeset_contains(&env->done, load))
+			return NULL;
+
+		ir_node *base;
+		long     offset;
+		get_base_and_offset(get_Load_ptr(load), &base, &offset);
+		if (i == 0) {
+			base0 = base;
+			off0  = offset;
+		} else if (base != base0 || offset
+		           != off0 + (long)(i * get_mode_size_bytes(env->lane_mode))) {
+			return NULL;
+		}
+		loads[i] = load;
+	}
+
+	ir_node *first;
+	if (!check_group_memory(env, loads, &first))
+		return NULL;
+
+	pack_t *const pack = new_pack(env, PACK_LOAD, lanes);
+	pack->nodes = loads;
+	pack->first = first;
+	for (unsigned i = 0; i < n; ++i)
+		ir_nodeset_insert(&env->tree, lanes[i]);
+	env->cost -= (int)n - 1;
+	add_extract_cost(env, lanes);
+	return pack;
+}
+
+static bool is_packable_op(const slp_env_t *env, const ir_node *node)
+{
+	switch (get_irn_opcode(node)) {
+	case iro_And:
+	case iro_Eor:
+	case iro_Not:
+	case iro_Or:
+		return true;
+	case iro_Add:
+	case iro_Minus:
+	case iro_Mul:
+	case iro_Sub:
+		/* lanes of integer packs would carry into each other */
+		return mode_is_vector(env->wide_mode);
+	default:
+		return false;
+	}
+}
+
+static pack_t *build_pack(slp_env_t *env, ir_node *const *lanes,
+                          unsigned depth);
+
+static pack_t *try_pack_ops(slp_env_t *env, ir_node *const *lanes,
+                            unsigned depth)
+{
+	unsigned const n     = env->n_lanes;
+	ir_node *const lane0 = lanes[0];
+	if (!is_packable_op(env, lane0))
+		return NULL;
+	ir_op *const op = get_irn_op(lane0);
+	for (unsigned i = 0; i < n; ++i) {
+		if (get_irn_op(lanes[i]) != op || !is_available(env, lanes[i]))
+			return NULL;
+		for (unsigned j = 0; j < i; ++j) {
+			if (lanes[j] == lanes[i])
+				return NULL;
+		}
+	}
+
+	int       const arity = get_irn_arity(lane0);
+	ir_node **const in0   = OALLOCN(&env->obst, ir_node*, n);
+	ir_node **const in1   = OALLOCN(&env->obst, ir_node*, n);
+	for (unsigned i = 0; i < n; ++i) {
+		ir_node *l = get_irn_n(lanes[i], 0);
+		ir_node *r = arity > 1 ? get_irn_n(lanes[i], 1) : NULL;
+		/* match the operand order of the first lane */
+		if (i > 0 && is_op_commutative(op)
+		    && get_irn_op(l) != get_irn_op(in0[0])
+		    && get_irn_op(r) == get_irn_op(in0[0])) {
+			ir_node *const t = l;
+			l = r;
+			r = t;
+		}
+		in0[i] = l;
+		in1[i] = r;
+	}
+
+	pack_t *const pack = new_pack(env, PACK_OP, lanes);
+	for (unsigned i = 0; i < n; ++i)
+		ir_nodeset_insert(&env->tree, lanes[i]);
+	env->cost -= (int)n - 1;
+	add_extract_cost(env, lanes);
+
+	pack->ops    = OALLOCN(&env->obst, pack_t*, arity);
+	pack->ops[0] = build_pack(env, in0, depth + 1);
+	if (arity > 1)
+		pack->ops[1] = build_pack(env, in1, depth + 1);
+	return pack;
+}
+
+/** Checks whether the lanes are the lanes of an existing packed value. */
+static ir_node *get_packed_value(const slp_env_t *env, ir_node *const *lanes)
+{
+	if (!mode_is_vector(env->wide_mode) || !is_Extract(lanes[0]))
+		return NULL;
+	ir_node *const vector = get_Extract_vector(lanes[0]);
+	if (get_irn_mode(vector) != env->wide_mode)
+		return NULL;
+	for (unsigned i = 0; i < env->n_lanes; ++i) {
+		if (!is_Extract(lanes[i]) || get_Extract_vector(lanes[i]) != vector
+		    || get_Extract_lane(lanes[i]) != i)
+			return NULL;
+	}
+	return vector;
+}
+
+static pack_t *build_pack(slp_env_t *env, ir_node *const *lanes,
+                          unsigned depth)
+{
+	unsigned const n        = env->n_lanes;
+	bool           constant = true;
+	bool           same     = true;
+	for (unsigned i = 0; i < n; ++i) {
+		constant &= is_Const(lanes[i]);
+		same     &= lanes[i] == lanes[0];
+	}
+	if (constant)
+		return new_pack(env, PACK_CONST, lanes);
+
+	ir_node *const value = get_packed_value(env, lanes);
+	if (value != NULL) {
+		pack_t *const pack = new_pack(env, PACK_VALUE, lanes);
+		pack->value = value;
+		return pack;
+	}
+
+	bool const vector = mode_is_vector(env->wide_mode);
+	if (same && vector) {
+		env->cost += 1;
+		return new_pack(env, PACK_SPLAT, lanes);
+	}
+
+	if (depth < MAX_DEPTH) {
+		pack_t *pack = try_pack_loads(env, lanes);
+		if (pack == NULL)
+			pack = try_pack_ops(env, lanes, depth);
+		if (pack != NULL)
+			return pack;
+	}
+
+	/* Broadcast and Inserts for vectors, Conv, Shl and Or per lane else */
+	env->cost += vector ? (int)n : 3 * (int)n;
+	return new_pack(env, PACK_GATHER, lanes);
+}
+
+/**
+ * Checks whether @p node depends on a value replaced by the current tree.
+ * Using it for the tree would create a cycle.
+ */
+static bool depends_on_tree(slp_env_t *env, ir_node *node)
+{
+	ARR_SHRINKLEN(env->stack, 0);
+	ARR_APP1(ir_node*, env->stack, node);
+	while (ARR_LEN(env->stack) > 0) {
+		ir_node *const cur = env->stack[ARR_LEN(env->stack) - 1];
+		ARR_SHRINKLEN(env->stack, ARR_LEN(env->stack) - 1);
+		if (get_nodes_block(cur) != env->block || is_Phi(cur)
+		    || irn_visited_else_mark(cur))
+			continue;
+		if (ir_nodeset_contains(&env->tree, cur))
+			return true;
+		foreach_irn_in(cur, i, pred) {
+			ARR_APP1(ir_node*, env->stack, pred);
+		}
+	}
+	return false;
+}
+
+static bool is_schedulable(slp_env_t *env, const pack_t *pack)
+{
+	switch (pack->kind) {
+	case PACK_CONST:
+		return true;
+	case PACK_VALUE:
+		return !depends_on_tree(env, pack->value);
+	case PACK_SPLAT:
+	case PACK_GATHER:
+		for (unsigned i = 0; i < env->n_lanes; ++i) {
+			if (depends_on_tree(env, pack->lanes[i]))
+				return false;
+		}
+		return true;
+	case PACK_LOAD: {
+		ir_node *const load = pack->first != NULL ? pack->first
+		                                          : pack->nodes[0];
+		return !depends_on_tree(env, get_Load_ptr(load))
+		    && !depends_on_tree(env, get_Load_mem(load));
+	}
+	case PACK_OP:
+		for (int i = 0, n = get_irn_arity(pack->lanes[0]); i < n; ++i) {
+			if (!is_schedulable(env, pack->ops[i]))
+				return false;
+		}
+		return true;
+	}
+	panic("invalid pack");
+}
+
+/** Returns the shift moving lane @p lane of an integer pack to bit 0. */
+static unsigned get_lane_shift(const slp_env_t *env, unsigned lane)
+{
+	unsigned const bits = get_mode_size_bits(env->lane_mode);
+	return be_is_big_endian() ? (env->n_lanes - 1 - lane) * bits : lane * bits;
+}
+
+static ir_node *extract_lane(slp_env_t *env, ir_node *value, unsigned lane)
+{
+	ir_node *const block = env->block;
+	if (mode_is_vector(env->wide_mode))
+		return new_r_Extract(block, value, lane);
+
+	ir_graph *const irg   = get_irn_irg(block);
+	ir_node  *const shift = new_r_Const_long(irg, mode_Iu,
+	                                         get_lane_shift(env, lane));
+	ir_node  *const shr   = new_r_Shr(block, value, shift);
+	return new_r_Conv(block, shr, env->lane_mode);
+}
+
+/** Replaces the lanes of @p pack by extracts from @p value. */
+static void replace_lanes(slp_env_t *env, const pack_t *pack, ir_node *value)
+{
+	for (unsigned i = 0; i < env->n_lanes; ++i) {
+		ir_node *const lane    = pack->lanes[i];
+		ir_node *const extract = extract_lane(env, value, i);
+		if (extract != lane)
+			exchange(lane, extract);
+	}
+}
+
+static ir_node *build_const(slp_env_t *env, ir_node *const *lanes)
+{
+	unsigned   const n   = env->n_lanes;
+	ir_graph  *const irg = get_irn_irg(env->block);
+	if (mode_is_vector(env->wide_mode)) {
+		ir_tarval **const tvs = ALLOCAN(ir_tarval*, n);
+		for (unsigned i = 0; i < n; ++i)
+			tvs[i] = get_Const_tarval(lanes[i]);
+		return new_r_Const(irg, new_tarval_vector(env->wide_mode, tvs));
+	}
+
+	ir_mode   *const umode = find_unsigned_mode(env->lane_mode);
+	ir_tarval       *res   = get_mode_null(env->wide_mode);
+	for (unsigned i = 0; i < n; ++i) {
+		ir_tarval *tv = get_Const_tarval(lanes[i]);
+		tv  = tarval_convert_to(tarval_convert_to(tv, umode), env->wide_mode);
+		tv  = tarval_shl_unsigned(tv, get_lane_shift(env, i));
+		res = tarval_or(res, tv);
+	}
+	return new_r_Const(irg, res);
+}
+
+static ir_node *build_gather(slp_env_t *env, ir_node *const *lanes)
+{
+	ir_node *const block = env->block;
+	unsigned const n     = env->n_lanes;
+	if (mode_is_vector(env->wide_mode)) {
+		ir_node *res = new_r_Broadcast(block, lanes[0], env->wide_mode);
+		for (unsigned i = 1; i < n; ++i) {
+			if (lanes[i] != lanes[0])
+				res = new_r_Insert(block, res, lanes[i], i);
+		}
+		return res;
+	}
+
+	ir_graph *const irg   = get_irn_irg(block);
+	ir_mode  *const umode = find_unsigned_mode(env->lane_mode);
+	ir_node        *res   = NULL;
+	for (unsigned i = 0; i < n; ++i) {
+		ir_node *const convu = new_r_Conv(block, lanes[i], umode);
+		ir_node *const conv  = new_r_Conv(block, convu, env->wide_mode);
+		ir_node *const shift = new_r_Const_long(irg, mode_Iu,
+		                                        get_lane_shift(env, i));
+		ir_node *const shl   = new_r_Shl(block, conv, shift);
+		res = res != NULL ? new_r_Or(block, res, shl) : shl;
+	}
+	return res;
+}
+
+/** Returns the type of a memory access covering all @p ops. */
+static ir_type *get_wide_type(const slp_env_t *env, ir_node *const *ops)
+{
+	ir_type *const type0 = get_memop_type(ops[0]);
+	bool           same  = true;
+	for (unsigned i = 1; i < env->n_lanes; ++i)
+		same &= get_memop_type(ops[i]) == type0;
+	if (same)
+		return type0;
+
+	ir_type *const type = new_type_struct(id_unique("__packed_access"));
+	for (unsigned i = 0; i < env->n_lanes; ++i)
+		new_entity(type, id_unique("__lane"), get_memop_type(ops[i]));
+	return type;
+}
+
+static ir_cons_flags get_wide_flags(const slp_env_t *env, ir_node *const *ops)
+{
+	ir_cons_flags flags = cons_unaligned;
+	for (unsigned i = 0; i < env->n_lanes; ++i) {
+		if (get_irn_pinned(ops[i]) == op_pin_state_floats)
+			return flags | cons_floats;
+	}
+	return flags;
+}
+
+static ir_node *build_load(slp_env_t *env, const pack_t *pack)
+{
+	ir_node *const *const loads = pack->nodes;
+	ir_node        *const first = pack->first;
+	unsigned        const n     = env->n_lanes;
+	ir_node        *const mem   = get_Load_mem(first != NULL ? first : loads[0]);
+	ir_node        *const load  = new_rd_Load(get_irn_dbg_info(loads[0]),
+		env->block, mem, get_Load_ptr(loads[0]), env->wide_mode,
+		get_wide_type(env, loads), get_wide_flags(env, loads));
+	ir_node        *const new_mem = new_r_Proj(load, mode_M, pn_Load_M);
+	for (unsigned i = 0; i < n; ++i) {
+		ir_node *const old = loads[i];
+		if (first == NULL || old == first)
+			reroute_mem(old, new_mem);
+		else
+			reroute_mem(old, get_Load_mem(old));
+	}
+	return new_r_Proj(load, env->wide_mode, pn_Load_res);
+}
+
+static ir_node *build_op(slp_env_t *env, const pack_t *pack)
+{
+	ir_node  *const lane0 = pack->lanes[0];
+	dbg_info *const dbgi  = get_irn_dbg_info(lane0);
+	ir_node  *const block = env->block;
+	ir_node  *const l     = pack->ops[0]->value;
+	switch (get_irn_opcode(lane0)) {
+	case iro_Minus: return new_rd_Minus(dbgi, block, l);
+	case iro_Not:   return new_rd_Not(dbgi, block, l);
+	default:        break;
+	}
+
+	ir_node *const r = pack->ops[1]->value;
+	switch (get_irn_opcode(lane0)) {
+	case iro_Add: return new_rd_Add(dbgi, block, l, r);
+	case iro_And: return new_rd_And(dbgi, block, l, r);
+	case iro_Eor: return new_rd_Eor(dbgi, block, l, r);
+	case iro_Mul: return new_rd_Mul(dbgi, block, l, r);
+	case iro_Or:  return new_rd_Or(dbgi, block, l, r);
+	case iro_Sub: return new_rd_Sub(dbgi, block, l, r);
+	default:      break;
+	}
+	panic("unexpected %+F in pack", lane0);
+}
+
+/** Constructs the packed value of @p pack and replaces its lanes. */
+static void build_value(slp_env_t *env, pack_t *pack)
+{
+	switch (pack->kind) {
+	case PACK_CONST:
+		pack->value = build_const(env, pack->lanes);
+		return;
+	case PACK_SPLAT:
+		pack->value = new_r_Broadcast(env->block, pack->lanes[0],
+		                              env->wide_mode);
+		return;
+	case PACK_VALUE:
+		return;
+	case PACK_GATHER:
+		pack->value = build_gather(env, pack->lanes);
+		return;
+	case PACK_LOAD:
+		pack->value = build_load(env, pack);
+		replace_lanes(env, pack, pack->value);
+		return;
+	case PACK_OP:
+		for (int i = 0, n = get_irn_arity(pack->lanes[0]); i < n; ++i)
+			build_value(env, pack->ops[i]);
+		pack->value = build_op(env, pack);
+		replace_lanes(env, pack, pack->value);
+		return;
+	}
+	panic("invalid pack");
+}
+
+static void mark_done(slp_env_t *env, const pack_t *pack)
+{
+	if (pack->kind == PACK_OP) {
+		for (int i = 0, n = get_irn_arity(pack->lanes[0]); i < n; ++i)
+			mark_done(env, pack->ops[i]);
+	} else if (pack->kind != PACK_LOAD) {
+		return;
+	}
+	for (unsigned i = 0; i < env->n_lanes; ++i) {
+		ir_nodeset_insert(&env->done, pack->lanes[i]);
+		if (pack->kind == PACK_LOAD)
+			ir_nodeset_insert(&env->done, pack->nodes[i]);
+	}
+}
+
+static ir_mode *find_uint_mode(unsigned bits)
+{
+	for (size_t i = 0, n = ir_get_n_modes(); i < n; ++i) {
+		ir_mode *const mode = ir_get_mode(i);
+		if (mode_is_int(mode) && !mode_is_signed(mode)
+		    && get_mode_arithmetic(mode) == irma_twos_complement
+		    && get_mode_size_bits(mode) == bits)
+			return mode;
+	}
+	return NULL;
+}
+
+/**
+ * Chooses the packed mode for @p n_stores adjacent Stores of @p lane_mode.
+ * Vector registers are preferred, word sized integers are the fallback.
+ */
+static bool choose_wide_mode(slp_env_t *env, ir_mode *lane_mode,
+                             unsigned n_stores)
+{
+	unsigned const bits        = get_mode_size_bits(lane_mode);
+	unsigned const vector_size = be_get_backend_param()->vector_size;
+	if (vector_size != 0 && (mode_is_int(lane_mode) || mode_is_float(lane_mode))
+	    && bits % 8 == 0 && vector_size % bits == 0
+	    && vector_size / bits >= 2 && vector_size / bits <= n_stores) {
+		env->n_lanes   = vector_size / bits;
+		env->wide_mode = get_vector_mode(lane_mode, env->n_lanes);
+		return true;
+	}
+
+	if (!mode_is_int(lane_mode)
+	    || get_mode_arithmetic(lane_mode) != irma_twos_complement
+	    || find_unsigned_mode(lane_mode) == NULL)
+		return false;
+	unsigned const machine_size = be_get_machine_size();
+	for (unsigned n = machine_size / bits; n >= 2; n /= 2) {
+		if (n > n_stores || !is_po2_or_zero(n))
+			continue;
+		ir_mode *const mode = find_uint_mode(n * bits);
+		if (mode != NULL) {
+			env->n_lanes   = n;
+			env->wide_mode = mode;
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Tries to pack the trees below the adjacent Stores @p stores. */
+static bool try_pack_stores(slp_env_t *env, ir_node *const *stores)
+{
+	unsigned  const n     = env->n_lanes;
+	ir_node **const lanes = OALLOCN(&env->obst, ir_node*, n);
+	for (unsigned i = 0; i < n; ++i)
+		lanes[i] = get_Store_value(stores[i]);
+
+	ir_node *last;
+	if (!check_group_memory(env, stores, &last))
+		return false;
+
+	ir_nodeset_init(&env->tree);
+	for (unsigned i = 0; i < n; ++i)
+		ir_nodeset_insert(&env->tree, stores[i]);
+	env->cost = 1 - (int)n;
+	pack_t *const root = build_pack(env, lanes, 0);
+
+	ir_graph *const irg = get_irn_irg(env->block);
+	inc_irg_visited(irg);
+	bool const profitable = env->cost < 0 && is_schedulable(env, root);
+	ir_nodeset_destroy(&env->tree);
+	DB((dbg, LEVEL_2, "%+F..: %u lanes of %+F, cost %d%s\n", stores[0], n,
+	    env->wide_mode, env->cost, profitable ? "" : ", rejected"));
+	if (!profitable)
+		return false;
+
+	build_value(env, root);
+	mark_done(env, root);
+
+	ir_node *mem;
+	if (last == NULL) {
+		mem = get_Store_mem(stores[0]);
+	} else {
+		for (unsigned i = 0; i < n; ++i) {
+			if (stores[i] != last)
+				reroute_mem(stores[i], get_Store_mem(stores[i]));
+		}
+		mem = get_Store_mem(last);
+	}
+	ir_node *const store = new_rd_Store(get_irn_dbg_info(stores[0]),
+		env->block, mem, get_Store_ptr(stores[0]), root->value,
+		get_wide_type(env, stores), get_wide_flags(env, stores));
+	for (unsigned i = 0; i < n; ++i) {
+		ir_node *const old = stores[i];
+		ir_nodeset_insert(&env->done, old);
+		if (last == NULL || old == last)
+			exchange(old, store);
+	}
+	env->changed = true;
+	return true;
+}
+
+static void collect_stores(ir_node *node, void *data)
+{
+	store_entry_t **const stores = (store_entry_t**)data;
+	if (!is_Store(node) || !is_simple_memop(node))
+		return;
+	ir_mode *const mode = get_irn_mode(get_Store_value(node));
+	if (mode_is_vector(mode) || !mode_is_num(mode))
+		return;
+
+	store_entry_t entry;
+	entry.store = node;
+	entry.block = get_nodes_block(node);
+	get_base_and_offset(get_Store_ptr(node), &entry.base, &entry.offset);
+	ARR_APP1(store_entry_t, *stores, entry);
+}
+
+static int cmp_store_entry(const void *p0, const void *p1)
+{
+	store_entry_t const *const e0 = (store_entry_t const*)p0;
+	store_entry_t const *const e1 = (store_entry_t const*)p1;
+	if (e0->block != e1->block)
+		return QSORT_CMP(get_irn_idx(e0->block), get_irn_idx(e1->block));
+	if (e0->base != e1->base)
+		return QSORT_CMP(get_irn_idx(e0->base), get_irn_idx(e1->base));
+	if (e0->offset != e1->offset)
+		return QSORT_CMP(e0->offset, e1->offset);
+	return QSORT_CMP(get_irn_idx(e0->store), get_irn_idx(e1->store));
+}
+
+/** Returns the number of adjacent Stores starting at @p stores. */
+static unsigned get_run_length(const slp_env_t *env,
+                               store_entry_t const *stores, size_t n_stores)
+{
+	store_entry_t const *const start = &stores[0];
+	ir_mode        *const mode  = get_irn_mode(get_Store_value(start->store));
+	long            const size  = get_mode_size_bytes(mode);
+	unsigned              run   = 1;
+	for (size_t i = 1; i < n_stores; ++i) {
+		store_entry_t const *const entry = &stores[i];
+		if (entry->block != start->block || entry->base != start->base
+		    || entry->offset != start->offset + (long)run * size
+		    || get_irn_mode(get_Store_value(entry->store)) != mode
+		    || ir_nodeset_contains(&env->done, entry->store))
+			break;
+		++run;
+	}
+	return run;
+}
+
+void slp_vectorize(ir_graph *irg)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.slp");
+
+	/* The packed accesses are not necessarily aligned. */
+	if (!be_get_backend_param()->unaligned_memaccess_supported)
+		return;
+
+	bool const timed = irg_timing_scope_begin(irg, "slp_vectorize");
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_TUPLES
+	                         | IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
+	                         | IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE);
+	if ((get_irg_memory_disambiguator_options(irg) & aa_opt_always_alias) == 0)
+		assure_irp_globals_entity_usage_computed();
+
+	slp_env_t env;
+	memset(&env, 0, sizeof(env));
+	obstack_init(&env.obst);
+	ir_nodeset_init(&env.done);
+	env.stack = NEW_ARR_F(ir_node*, 0);
+
+	store_entry_t *stores = NEW_ARR_F(store_entry_t, 0);
+	irg_walk_graph(irg, NULL, collect_stores, &stores);
+	QSORT_ARR(stores, cmp_store_entry);
+
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_VISITED);
+	size_t const n_stores = ARR_LEN(stores);
+	for (size_t i = 0; i < n_stores;) {
+		store_entry_t const *const entry = &stores[i];
+		if (ir_nodeset_contains(&env.done, entry->store)) {
+			++i;
+			continue;
+		}
+
+		unsigned const run = get_run_length(&env, entry, n_stores - i);
+		ir_node *const value = get_Store_value(entry->store);
+		env.block     = entry->block;
+		env.lane_mode = get_irn_mode(value);
+		if (run < 2 || !choose_wide_mode(&env, env.lane_mode, run)) {
+			++i;
+			continue;
+		}
+
+		ir_node **const group = OALLOCN(&env.obst, ir_node*, env.n_lanes);
+		for (unsigned l = 0; l < env.n_lanes; ++l)
+			group[l] = stores[i + l].store;
+		if (try_pack_stores(&env, group))
+			i += env.n_lanes;
+		else
+			++i;
+	}
+	ir_free_resources(irg, IR_RESOURCE_IRN_VISITED);
+
+	DEL_ARR_F(stores);
+	DEL_ARR_F(env.stack);
+	ir_nodeset_destroy(&env.done);
+	obstack_free(&env.obst, NULL);
+
+	confirm_irg_properties(irg, env.changed ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
+	                                        : IR_GRAPH_PROPERTIES_ALL);
+	irg_timing_scope_end(irg, timed);
+}
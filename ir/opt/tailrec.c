@@ -584,6 +584,7 @@ static unsigned find_tail_rec_possibilities(tr_env *env, ir_graph *irg)
 
 void opt_tail_rec_irg(ir_graph *irg)
 {
+	bool const timed = irg_timing_scope_begin(irg, "opt_tail_rec_irg");
 	FIRM_DBG_REGISTER(dbg, "firm.opt.tailrec");
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_MANY_RETURNS
@@ -610,4 +611,5 @@ void opt_tail_rec_irg(ir_graph *irg)
 	free(env.variants);
 	free(env.parameter_projs);
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
+	irg_timing_scope_end(irg, timed);
 }
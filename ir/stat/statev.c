@@ -8,14 +8,28 @@
  * @brief       Statistic events.
  * @author      Sebastian Hack
  * @date        17.06.2007
+ *
+ * Events are written either as text lines or as a binary stream.  The
+ * binary stream starts with a header followed by chunks.  Each chunk has a
+ * 32 bit kind and a 32 bit byte length.  String chunks define strings as
+ * (id, length, bytes) triples, event chunks contain fixed size
+ * stat_ev_record_t records referring to strings by id.  All numbers are
+ * stored in native byte order, the header contains a marker to detect it.
+ * Strings are always written before the first event referring to them.
  */
 #include <assert.h>
 #include <regex.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "array.h"
+#include "cpset.h"
+#include "hashptr.h"
+#include "obst.h"
 #include "stat_timing.h"
 #include "irprintf.h"
 #include "statev_t.h"
@@ -23,9 +37,40 @@
 
 #define MAX_TIMER 256
 
+/** Number of event records buffered before they are written. */
+#define N_BUFFERED_RECORDS 4096
+
+#define BINARY_MAGIC      "FIRMSTEV"
+#define BINARY_VERSION    1
+#define BINARY_BYTE_ORDER 0x01020304
+#define CHUNK_STRINGS     'S'
+#define CHUNK_EVENTS      'E'
+
 int (stat_ev_enabled) = 0;
 
+/** An interned key or context value. */
+typedef struct stat_ev_string_t {
+	const char *str;
+	uint32_t    id;
+	bool        matches; /**< the key passes the filter */
+	bool        written; /**< the string was defined in the binary stream */
+} stat_ev_string_t;
+
+/** An event in the binary stream. */
+typedef struct stat_ev_record_t {
+	uint8_t  type;    /**< 'P', 'O', 'I', 'U' or 'D' */
+	uint8_t  pad[3];
+	uint32_t key;     /**< string id of the key */
+	union {
+		int64_t  i;
+		uint64_t u;
+		double   d;   /**< the value of 'D' events */
+		uint64_t str; /**< string id of the value of 'P' events */
+	} value;
+} stat_ev_record_t;
+
 static FILE          *stat_ev_file;
+static bool           stat_ev_binary;
 static int            stat_ev_timer_sp;
 static timing_ticks_t stat_ev_timer_elapsed[MAX_TIMER];
 static timing_ticks_t stat_ev_timer_start[MAX_TIMER];
@@ -33,12 +78,96 @@ static timing_ticks_t stat_ev_timer_start[MAX_TIMER];
 static regex_t  regex;
 static regex_t *filter;
 
+static struct obstack    string_obst;
+static struct obstack    value_obst; /**< formats context values */
+static cpset_t           strings;
+static uint32_t          n_strings;
+static char             *string_buf;
+static stat_ev_record_t  records[N_BUFFERED_RECORDS];
+static unsigned          n_records;
+
+static unsigned string_hash(const void *obj)
+{
+	const stat_ev_string_t *string = (const stat_ev_string_t*)obj;
+	return hash_str(string->str);
+}
+
+static int string_cmp(const void *p1, const void *p2)
+{
+	const stat_ev_string_t *s1 = (const stat_ev_string_t*)p1;
+	const stat_ev_string_t *s2 = (const stat_ev_string_t*)p2;
+	return streq(s1->str, s2->str);
+}
+
+/**
+ * Returns the interned string for @p str.  The filter is evaluated once when
+ * a key is seen for the first time.
+ */
+static stat_ev_string_t *intern(const char *str)
+{
+	stat_ev_string_t  key    = { .str = str };
+	stat_ev_string_t *string = (stat_ev_string_t*)cpset_find(&strings, &key);
+	if (string != NULL)
+		return string;
+
+	string          = OALLOC(&string_obst, stat_ev_string_t);
+	string->str     = (const char*)obstack_copy0(&string_obst, str, strlen(str));
+	string->id      = n_strings++;
+	string->matches = filter == NULL || regexec(filter, str, 0, NULL, 0) == 0;
+	string->written = false;
+	cpset_insert(&strings, string);
+	return string;
+}
+
 static bool key_matches(const char *key)
 {
-	if (filter == NULL)
-		return true;
+	return intern(key)->matches;
+}
+
+static void write_chunk(uint32_t kind, const void *data, size_t size)
+{
+	uint32_t header[2] = { kind, (uint32_t)size };
+	fwrite(header, sizeof(header), 1, stat_ev_file);
+	fwrite(data, 1, size, stat_ev_file);
+}
+
+static void flush_binary(void)
+{
+	size_t const string_size = ARR_LEN(string_buf);
+	if (string_size > 0) {
+		write_chunk(CHUNK_STRINGS, string_buf, string_size);
+		ARR_SHRINKLEN(string_buf, 0);
+	}
+	if (n_records > 0) {
+		write_chunk(CHUNK_EVENTS, records, n_records * sizeof(records[0]));
+		n_records = 0;
+	}
+}
 
-	return regexec(filter, key, 0, NULL, 0) == 0;
+/** Returns the id of @p string and defines it in the stream if necessary. */
+static uint32_t get_string_id(stat_ev_string_t *string)
+{
+	if (!string->written) {
+		uint32_t const len    = (uint32_t)strlen(string->str);
+		size_t   const offset = ARR_LEN(string_buf);
+		uint32_t const header[2] = { string->id, len };
+		ARR_RESIZE(char, string_buf, offset + sizeof(header) + len);
+		memcpy(&string_buf[offset], header, sizeof(header));
+		memcpy(&string_buf[offset + sizeof(header)], string->str, len);
+		string->written = true;
+	}
+	return string->id;
+}
+
+static stat_ev_record_t *new_record(char type, stat_ev_string_t *key)
+{
+	if (n_records == N_BUFFERED_RECORDS)
+		flush_binary();
+	stat_ev_record_t *record = &records[n_records++];
+	memset(record, 0, sizeof(*record));
+	record->type = (uint8_t)type;
+	record->key  = get_string_id(key);
+	return record;
 }
 
 static void stat_ev_vprintf(char ev, const char *key, const char *fmt, va_list ap)
@@ -64,7 +193,18 @@ static void stat_ev_printf(char ev, const char *key, const char *fmt, ...)
 	va_end(ap);
 }
 
-void stat_ev_tim_push(void)
+/**
+ * Returns a new binary record for @p key or NULL if the key is filtered.
+ */
+static stat_ev_record_t *binary_event(char type, const char *key)
+{
+	stat_ev_string_t *string = intern(key);
+	if (!string->matches)
+		return NULL;
+	return new_record(type, string);
+}
+
+void do_stat_ev_tim_push(void)
 {
 	int            sp   = stat_ev_timer_sp++;
 	assert((size_t)sp < ARRAY_SIZE(stat_ev_timer_start));
@@ -79,15 +219,15 @@ void stat_ev_tim_push(void)
 	}
 }
 
-void stat_ev_tim_pop(const char *name)
+void do_stat_ev_tim_pop(const char *name)
 {
 	int sp = --stat_ev_timer_sp;
 	assert(sp >= 0);
 	timing_ticks_t temp = timing_ticks();
 	temp -= stat_ev_timer_start[sp];
 	stat_ev_timer_elapsed[sp] += temp;
-	if (name != NULL && stat_ev_enabled)
-		stat_ev_ull(name, stat_ev_timer_elapsed[sp]);
+	if (name != NULL)
+		do_stat_ev_ull(name, stat_ev_timer_elapsed[sp]);
 
 	if (sp == 0) {
 		timing_leave_max_prio();
@@ -98,9 +238,20 @@ void stat_ev_tim_pop(const char *name)
 
 void do_stat_ev_ctx_push_vfmt(const char *key, const char *fmt, va_list ap)
 {
-	stat_ev_tim_push();
-	stat_ev_vprintf('P', key, fmt, ap);
-	stat_ev_tim_pop(NULL);
+	if (!stat_ev_binary) {
+		stat_ev_vprintf('P', key, fmt, ap);
+		return;
+	}
+
+	stat_ev_string_t *string = intern(key);
+	if (!string->matches)
+		return;
+	ir_obst_vprintf(&value_obst, fmt, ap);
+	obstack_1grow(&value_obst, '\0');
+	char *const    value    = (char*)obstack_finish(&value_obst);
+	uint32_t const value_id = get_string_id(intern(value));
+	obstack_free(&value_obst, value);
+	new_record('P', string)->value.str = value_id;
 }
 
 void (stat_ev_ctx_push_fmt)(const char *key, const char *fmt, ...)
@@ -121,9 +272,10 @@ void (stat_ev_ctx_push_str)(const char *key, const char *str)
 
 void do_stat_ev_ctx_pop(const char *key)
 {
-	stat_ev_tim_push();
-	stat_ev_printf('O', key, NULL);
-	stat_ev_tim_pop(NULL);
+	if (!stat_ev_binary)
+		stat_ev_printf('O', key, NULL);
+	else
+		binary_event('O', key);
 }
 
 void (stat_ev_ctx_pop)(const char *key)
@@ -133,9 +285,13 @@ void (stat_ev_ctx_pop)(const char *key)
 
 void do_stat_ev_dbl(const char *name, double value)
 {
-	stat_ev_tim_push();
-	stat_ev_printf('E', name, "%g", value);
-	stat_ev_tim_pop(NULL);
+	if (!stat_ev_binary) {
+		stat_ev_printf('E', name, "%g", value);
+		return;
+	}
+	stat_ev_record_t *record = binary_event('D', name);
+	if (record != NULL)
+		record->value.d = value;
 }
 
 void (stat_ev_dbl)(const char *name, double value)
@@ -145,9 +301,13 @@ void (stat_ev_dbl)(const char *name, double value)
 
 void do_stat_ev_int(const char *name, int value)
 {
-	stat_ev_tim_push();
-	stat_ev_printf('E', name, "%d", value);
-	stat_ev_tim_pop(NULL);
+	if (!stat_ev_binary) {
+		stat_ev_printf('E', name, "%d", value);
+		return;
+	}
+	stat_ev_record_t *record = binary_event('I', name);
+	if (record != NULL)
+		record->value.i = value;
 }
 
 void (stat_ev_int)(const char *name, int value)
@@ -157,9 +317,13 @@ void (stat_ev_int)(const char *name, int value)
 
 void do_stat_ev_ull(const char *name, unsigned long long value)
 {
-	stat_ev_tim_push();
-	stat_ev_printf('E', name, "%llu", value);
-	stat_ev_tim_pop(NULL);
+	if (!stat_ev_binary) {
+		stat_ev_printf('E', name, "%llu", value);
+		return;
+	}
+	stat_ev_record_t *record = binary_event('U', name);
+	if (record != NULL)
+		record->value.u = value;
 }
 
 void (stat_ev_ull)(const char *name, unsigned long long value)
@@ -169,9 +333,10 @@ void (stat_ev_ull)(const char *name, unsigned long long value)
 
 void do_stat_ev(const char *name)
 {
-	stat_ev_tim_push();
-	stat_ev_printf('E', name, "0.0");
-	stat_ev_tim_pop(NULL);
+	if (!stat_ev_binary)
+		stat_ev_printf('E', name, "0.0");
+	else
+		binary_event('D', name);
 }
 
 void (stat_ev)(const char *name)
@@ -179,12 +344,13 @@ void (stat_ev)(const char *name)
 	stat_ev_(name);
 }
 
-void stat_ev_begin(const char *prefix, const char *filt)
+static void begin(const char *prefix, const char *suffix, const char *mode,
+                  const char *filt)
 {
 	char buf[512];
 
-	snprintf(buf, sizeof(buf), "%s.ev", prefix);
-	stat_ev_file = fopen(buf, "wt");
+	snprintf(buf, sizeof(buf), "%s%s", prefix, suffix);
+	stat_ev_file = fopen(buf, mode);
 	if (stat_ev_file == NULL) {
 		fprintf(stderr, "Warning: Couldn't create statev output '%s'\n", buf);
 	}
@@ -200,12 +366,41 @@ void stat_ev_begin(const char *prefix, const char *filt)
 		}
 	}
 
+	obstack_init(&string_obst);
+	obstack_init(&value_obst);
+	cpset_init(&strings, string_hash, string_cmp);
+	n_strings  = 0;
+	string_buf = NEW_ARR_F(char, 0);
+	n_records  = 0;
+
 	stat_ev_enabled = stat_ev_file != NULL;
 }
 
+void stat_ev_begin(const char *prefix, const char *filt)
+{
+	stat_ev_binary = false;
+	begin(prefix, ".ev", "wt", filt);
+}
+
+void stat_ev_begin_binary(const char *prefix, const char *filt)
+{
+	stat_ev_binary = true;
+	begin(prefix, ".evb", "wb", filt);
+	if (stat_ev_file != NULL) {
+		uint32_t const header[2] = { BINARY_VERSION, BINARY_BYTE_ORDER };
+		fwrite(BINARY_MAGIC, 1, sizeof(BINARY_MAGIC) - 1, stat_ev_file);
+		fwrite(header, sizeof(header), 1, stat_ev_file);
+	}
+}
+
 void stat_ev_end(void)
 {
+	if (string_buf == NULL)
+		return;
+
 	if (stat_ev_file != NULL) {
+		if (stat_ev_binary)
+			flush_binary();
 		fclose(stat_ev_file);
 		stat_ev_file    = NULL;
 		stat_ev_enabled = 0;
@@ -214,4 +409,9 @@ void stat_ev_end(void)
 		regfree(filter);
 		filter = NULL;
 	}
+	cpset_destroy(&strings);
+	obstack_free(&string_obst, NULL);
+	obstack_free(&value_obst, NULL);
+	DEL_ARR_F(string_buf);
+	string_buf = NULL;
 }
@@ -35,8 +35,8 @@
 
 #else
 
-void stat_ev_tim_push(void);
-void stat_ev_tim_pop(const char *name);
+void do_stat_ev_tim_push(void);
+void do_stat_ev_tim_pop(const char *name);
 
 void do_stat_ev_int(const char *name, int value);
 void do_stat_ev_dbl(const char *name, double value);
@@ -88,6 +88,18 @@ static inline void stat_ev_ctx_pop_(const char *key)
 		return;
 	do_stat_ev_ctx_pop(key);
 }
+static inline void stat_ev_tim_push_(void)
+{
+	if (!stat_ev_enabled)
+		return;
+	do_stat_ev_tim_push();
+}
+static inline void stat_ev_tim_pop_(const char *name)
+{
+	if (!stat_ev_enabled)
+		return;
+	do_stat_ev_tim_pop(name);
+}
 #define stat_ev_int(name, value)        stat_ev_int_(name, value)
 #define stat_ev_dbl(name, value)        stat_ev_dbl_(name, value)
 #define stat_ev_ull(name, value)        stat_ev_ull_(name, value)
@@ -96,6 +108,8 @@ static inline void stat_ev_ctx_pop_(const char *key)
                                         stat_ev_ctx_push_fmt_(name, fmt, value)
 #define stat_ev_ctx_push_str(name, str) stat_ev_ctx_push_str_(name, str)
 #define stat_ev_ctx_pop(name)           stat_ev_ctx_pop_(name)
+#define stat_ev_tim_push()              stat_ev_tim_push_()
+#define stat_ev_tim_pop(name)           stat_ev_tim_pop_(name)
 
 #define stat_ev_cnt_decl(var)       int stat_ev_cnt_var_ ## var = 0
 #define stat_ev_cnt_inc(var)        do { ++stat_ev_cnt_var_ ## var; } while(0)
@@ -102,6 +102,64 @@ static ir_tarval *get_int_tarval(const sc_word *value, ir_mode *mode)
 	return identify_tarval(tv);
 }
 
+/**
+ * Vector tarvals store pointers to the (unique) tarvals of their lanes, so
+ * they can be hashed and compared like any other value.
+ */
+static ir_tarval *const *get_vector_lanes(ir_tarval const *tv)
+{
+	assert(mode_is_vector(tv->mode));
+	return (ir_tarval *const*)tv->value;
+}
+
+static ir_tarval *get_vector_tarval(ir_tarval *const *lanes, ir_mode *mode)
+{
+	unsigned const n_lanes = get_mode_n_lanes(mode);
+	for (unsigned i = 0; i < n_lanes; ++i) {
+		if (lanes[i] == tarval_bad)
+			return tarval_bad;
+		assert(lanes[i]->mode == get_mode_element_mode(mode));
+	}
+
+	unsigned const size = n_lanes * sizeof(*lanes);
+	ir_tarval *const tv = ALLOCAF(ir_tarval, value, size);
+	tv->kind   = k_tarval;
+	tv->mode   = mode;
+	tv->length = size;
+	memcpy(tv->value, lanes, size);
+	return identify_tarval(tv);
+}
+
+typedef ir_tarval *(*tarval_unop)(ir_tarval const *a);
+typedef ir_tarval *(*tarval_binop)(ir_tarval const *a, ir_tarval const *b);
+
+/** Applies @p op to all lanes of vector tarval @p a. */
+static ir_tarval *vector_unop(ir_tarval const *const a, tarval_unop const op)
+{
+	ir_mode           *const mode    = a->mode;
+	unsigned           const n_lanes = get_mode_n_lanes(mode);
+	ir_tarval *const  *const la      = get_vector_lanes(a);
+	ir_tarval        **const res     = ALLOCAN(ir_tarval*, n_lanes);
+	for (unsigned i = 0; i < n_lanes; ++i)
+		res[i] = op(la[i]);
+	return get_vector_tarval(res, mode);
+}
+
+/** Applies @p op to the corresponding lanes of vector tarvals @p a and @p b. */
+static ir_tarval *vector_binop(ir_tarval const *const a,
+                               ir_tarval const *const b, tarval_binop const op)
+{
+	ir_mode           *const mode    = a->mode;
+	unsigned           const n_lanes = get_mode_n_lanes(mode);
+	ir_tarval *const  *const la      = get_vector_lanes(a);
+	ir_tarval *const  *const lb      = get_vector_lanes(b);
+	ir_tarval        **const res     = ALLOCAN(ir_tarval*, n_lanes);
+	assert(b->mode == mode);
+	for (unsigned i = 0; i < n_lanes; ++i)
+		res[i] = op(la[i], lb[i]);
+	return get_vector_tarval(res, mode);
+}
+
 static bool is_overflow(const sc_word *value, ir_mode *mode)
 {
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
@@ -218,6 +276,7 @@ ir_tarval *new_tarval_from_str(const char *str, size_t len, ir_mode *mode)
 	case irms_auxiliary:
 	case irms_data:
 	case irms_internal_boolean:
+	case irms_vector:
 		break;
 	}
 	panic("unsupported tarval creation with mode %F", mode);
@@ -248,6 +307,16 @@ ir_tarval *new_tarval_nan(ir_mode *mode, int signaling,
 ir_tarval *new_tarval_from_bytes(unsigned char const *buf,
                                  ir_mode *mode)
 {
+	if (mode_is_vector(mode)) {
+		ir_mode    *const element    = get_mode_element_mode(mode);
+		unsigned    const lane_bytes = get_mode_size_bytes(element);
+		unsigned    const n_lanes    = get_mode_n_lanes(mode);
+		ir_tarval **const lanes      = ALLOCAN(ir_tarval*, n_lanes);
+		for (unsigned i = 0; i < n_lanes; ++i)
+			lanes[i] = new_tarval_from_bytes(buf + i * lane_bytes, element);
+		return get_vector_tarval(lanes, mode);
+	}
+
 	switch (get_mode_arithmetic(mode)) {
 	case irma_twos_complement: {
 		unsigned bits    = get_mode_size_bits(mode);
@@ -270,13 +339,23 @@ ir_tarval *new_tarval_from_bytes(unsigned char const *buf,
 
 void tarval_to_bytes(unsigned char *buffer, ir_tarval const *tv)
 {
-	switch (get_mode_arithmetic(get_tarval_mode(tv))) {
+	ir_mode *const mode = get_tarval_mode(tv);
+	if (mode_is_vector(mode)) {
+		unsigned          const lane_bytes
+			= get_mode_size_bytes(get_mode_element_mode(mode));
+		unsigned          const n_lanes = get_mode_n_lanes(mode);
+		ir_tarval *const *const lanes   = get_vector_lanes(tv);
+		for (unsigned i = 0; i < n_lanes; ++i)
+			tarval_to_bytes(buffer + i * lane_bytes, lanes[i]);
+		return;
+	}
+
+	switch (get_mode_arithmetic(mode)) {
 	case irma_ieee754:
 	case irma_x86_extended_float:
 		fc_val_to_bytes((const fp_value*)tv->value, buffer);
 		return;
 	case irma_twos_complement: {
-		ir_mode *mode       = get_tarval_mode(tv);
 		unsigned bits       = get_mode_size_bits(mode);
 		unsigned buffer_len = bits/CHAR_BIT + (bits%CHAR_BIT != 0);
 		sc_val_to_bytes((const sc_word*)tv->value, buffer, buffer_len);
@@ -288,6 +367,27 @@ void tarval_to_bytes(unsigned char *buffer, ir_tarval const *tv)
 	panic("unexpected arithmetic mode");
 }
 
+ir_tarval *new_tarval_vector(ir_mode *mode, ir_tarval *const *lanes)
+{
+	assert(mode_is_vector(mode));
+	return get_vector_tarval(lanes, mode);
+}
+
+ir_tarval *tarval_broadcast(ir_tarval const *tv, ir_mode *mode)
+{
+	unsigned    const n_lanes = get_mode_n_lanes(mode);
+	ir_tarval **const lanes   = ALLOCAN(ir_tarval*, n_lanes);
+	for (unsigned i = 0; i < n_lanes; ++i)
+		lanes[i] = (ir_tarval*)tv;
+	return new_tarval_vector(mode, lanes);
+}
+
+ir_tarval *get_tarval_lane(ir_tarval const *tv, unsigned lane)
+{
+	assert(lane < get_mode_n_lanes(tv->mode));
+	return get_vector_lanes(tv)[lane];
+}
+
 int tarval_is_long(ir_tarval const *tv)
 {
 	ir_mode *const mode = get_tarval_mode(tv);
@@ -473,6 +573,17 @@ void init_mode_values(ir_mode* mode)
 		break;
 	}
 
+	case irms_vector: {
+		ir_mode *const element = get_mode_element_mode(mode);
+		mode->all_one   = tarval_broadcast(element->all_one,  mode);
+		mode->infinity  = tarval_broadcast(element->infinity, mode);
+		mode->min       = tarval_broadcast(element->min,      mode);
+		mode->max       = tarval_broadcast(element->max,      mode);
+		mode->null      = tarval_broadcast(element->null,     mode);
+		mode->one       = tarval_broadcast(element->one,      mode);
+		break;
+	}
+
 	case irms_auxiliary:
 	case irms_data:
 		mode->all_one   = tarval_bad;
@@ -502,6 +613,7 @@ int tarval_is_negative(ir_tarval const *const a)
 	case irms_auxiliary:
 	case irms_internal_boolean:
 	case irms_data:
+	case irms_vector:
 		break;
 	}
 	panic("invalid mode sort");
@@ -564,6 +676,21 @@ ir_relation tarval_cmp(ir_tarval const *const a, ir_tarval const *const b)
 			return ir_relation_equal;
 		return a == tarval_b_true ? ir_relation_greater : ir_relation_less;
 
+	case irms_vector: {
+		/* Vectors are only equal if all lanes are, there is no order. */
+		ir_tarval *const *const la      = get_vector_lanes(a);
+		ir_tarval *const *const lb      = get_vector_lanes(b);
+		ir_relation             res     = ir_relation_equal;
+		for (unsigned i = 0, n = get_mode_n_lanes(a->mode); i < n; ++i) {
+			ir_relation const rel = tarval_cmp(la[i], lb[i]);
+			if (rel == ir_relation_unordered)
+				return ir_relation_unordered;
+			if (rel != ir_relation_equal)
+				res = ir_relation_less_greater;
+		}
+		return res;
+	}
+
 	case irms_auxiliary:
 	case irms_data:
 		break;
@@ -578,6 +705,19 @@ ir_tarval *tarval_convert_to(ir_tarval const *const src,
 		return (ir_tarval*)src;
 
 	switch (get_mode_sort(src->mode)) {
+	/* vectors are converted lane-wise */
+	case irms_vector: {
+		unsigned const n_lanes = get_mode_n_lanes(src->mode);
+		if (!mode_is_vector(dst_mode) || get_mode_n_lanes(dst_mode) != n_lanes)
+			return tarval_bad;
+		ir_mode          *const element = get_mode_element_mode(dst_mode);
+		ir_tarval *const *const lanes   = get_vector_lanes(src);
+		ir_tarval       **const res     = ALLOCAN(ir_tarval*, n_lanes);
+		for (unsigned i = 0; i < n_lanes; ++i)
+			res[i] = tarval_convert_to(lanes[i], element);
+		return get_vector_tarval(res, dst_mode);
+	}
+
 	/* cast float to something */
 	case irms_float_number:
 		switch (get_mode_sort(dst_mode)) {
@@ -617,6 +757,7 @@ ir_tarval *tarval_convert_to(ir_tarval const *const src,
 		case irms_internal_boolean:
 		case irms_auxiliary:
 		case irms_data:
+		case irms_vector:
 			break;
 		}
 		/* the rest can't be converted */
@@ -651,6 +792,7 @@ ir_tarval *tarval_convert_to(ir_tarval const *const src,
 		case irms_auxiliary:
 		case irms_data:
 		case irms_internal_boolean:
+		case irms_vector:
 			break;
 		}
 		break;
@@ -697,6 +839,8 @@ ir_tarval *tarval_not(ir_tarval const *const a)
 	ir_mode *const mode = a->mode;
 	if (get_mode_sort(mode) == irms_internal_boolean)
 		return a == tarval_b_true ? tarval_b_false : tarval_b_true;
+	if (mode_is_vector(mode))
+		return vector_unop(a, tarval_not);
 
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
@@ -721,6 +865,9 @@ ir_tarval *tarval_neg(ir_tarval const *const a)
 		return get_fp_tarval(buffer, mode);
 	}
 
+	case irms_vector:
+		return vector_unop(a, tarval_neg);
+
 	case irms_auxiliary:
 	case irms_data:
 	case irms_internal_boolean:
@@ -756,6 +903,9 @@ ir_tarval *tarval_add(ir_tarval const *a, ir_tarval const *b)
 		return get_fp_tarval(buffer, mode);
 	}
 
+	case irms_vector:
+		return vector_binop(a, b, tarval_add);
+
 	case irms_auxiliary:
 	case irms_data:
 	case irms_internal_boolean:
@@ -797,6 +947,9 @@ ir_tarval *tarval_sub(ir_tarval const *a, ir_tarval const *b)
 		return get_fp_tarval(buffer, dst_mode);
 	}
 
+	case irms_vector:
+		return vector_binop(a, b, tarval_sub);
+
 	case irms_auxiliary:
 	case irms_data:
 	case irms_internal_boolean:
@@ -825,6 +978,9 @@ ir_tarval *tarval_mul(ir_tarval const *const a, ir_tarval const *const b)
 		return get_fp_tarval(buffer, mode);
 	}
 
+	case irms_vector:
+		return vector_binop(a, b, tarval_mul);
+
 	case irms_auxiliary:
 	case irms_data:
 	case irms_internal_boolean:
@@ -856,6 +1012,9 @@ ir_tarval *tarval_div(ir_tarval const *const a, ir_tarval const *const b)
 		return get_fp_tarval(buffer, mode);
 	}
 
+	case irms_vector:
+		return vector_binop(a, b, tarval_div);
+
 	case irms_auxiliary:
 	case irms_data:
 	case irms_internal_boolean:
@@ -910,6 +1069,9 @@ ir_tarval *tarval_and(ir_tarval const *const a, ir_tarval const *const b)
 	if (get_mode_sort(mode) == irms_internal_boolean)
 		return a == tarval_b_false ? (ir_tarval*)a : (ir_tarval*)b;
 
+	if (mode_is_vector(mode))
+		return vector_binop(a, b, tarval_and);
+
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_and(a->value, b->value, buffer);
@@ -923,6 +1085,9 @@ ir_tarval *tarval_andnot(ir_tarval const *const a, ir_tarval const *const b)
 	if (get_mode_sort(mode) == irms_internal_boolean)
 		return a == tarval_b_true && b == tarval_b_false ? tarval_b_true
 		                                                 : tarval_b_false;
+	if (mode_is_vector(mode))
+		return vector_binop(a, b, tarval_andnot);
+
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_andnot(a->value, b->value, buffer);
@@ -936,6 +1101,9 @@ ir_tarval *tarval_or(ir_tarval const *const a, ir_tarval const *const b)
 	if (get_mode_sort(mode) == irms_internal_boolean)
 		return a == tarval_b_true ? (ir_tarval*)a : (ir_tarval*)b;
 
+	if (mode_is_vector(mode))
+		return vector_binop(a, b, tarval_or);
+
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_or(a->value, b->value, buffer);
@@ -949,6 +1117,9 @@ ir_tarval *tarval_ornot(ir_tarval const *const a, ir_tarval const *const b)
 	if (get_mode_sort(mode) == irms_internal_boolean)
 		return a == tarval_b_true || b == tarval_b_false ? tarval_b_true
 		                                                 : tarval_b_false;
+	if (mode_is_vector(mode))
+		return vector_binop(a, b, tarval_ornot);
+
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_ornot(a->value, b->value, buffer);
@@ -962,6 +1133,9 @@ ir_tarval *tarval_eor(ir_tarval const *const a, ir_tarval const *const b)
 	if (get_mode_sort(mode) == irms_internal_boolean)
 		return a == b ? tarval_b_false : tarval_b_true;
 
+	if (mode_is_vector(mode))
+		return vector_binop(a, b, tarval_eor);
+
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_xor(a->value, b->value, buffer);
@@ -1102,6 +1276,19 @@ int tarval_snprintf(char *buf, size_t len, ir_tarval const *tv)
 		return snprintf(buf, len, "%s",
 		                (tv == tarval_b_true) ? "true" : "false");
 
+	case irms_vector: {
+		ir_tarval *const *const lanes = get_vector_lanes(tv);
+		int                     res   = 0;
+		for (unsigned i = 0, n = get_mode_n_lanes(tv->mode); i < n; ++i) {
+			size_t const pos = MIN((size_t)res, len);
+			res += snprintf(buf + pos, len - pos, i == 0 ? "<" : ",");
+			size_t const lane_pos = MIN((size_t)res, len);
+			res += tarval_snprintf(buf + lane_pos, len - lane_pos, lanes[i]);
+		}
+		size_t const pos = MIN((size_t)res, len);
+		return res + snprintf(buf + pos, len - pos, ">");
+	}
+
 	default:
 		if (tv == tarval_bad)
 			return snprintf(buf, len, "<TV_BAD>");
@@ -1147,6 +1334,23 @@ const char *ir_tarval_to_ascii(char *buf, size_t len, ir_tarval const *tv)
 		buf[size*2] = '\0';
 		return buf;
 	}
+	case irms_vector: {
+		/* lanes separated by ',' */
+		ir_tarval *const *const lanes = get_vector_lanes(tv);
+		size_t                  pos   = 0;
+		for (unsigned i = 0, n = get_mode_n_lanes(mode); i < n; ++i) {
+			if (i > 0)
+				buf[pos++] = ',';
+			assert(pos < len);
+			/* the result does not necessarily start at the buffer */
+			char const *const lane = ir_tarval_to_ascii(buf + pos, len - pos,
+			                                            lanes[i]);
+			size_t      const n    = strlen(lane);
+			memmove(buf + pos, lane, n + 1);
+			pos += n;
+		}
+		return buf;
+	}
 	case irms_data:
 	case irms_auxiliary:
 		if (tv == tarval_bad)
@@ -1177,6 +1381,25 @@ ir_tarval *ir_tarval_from_ascii(const char *buf, ir_mode *mode)
 		fc_val_from_bytes(buffer, temp, get_descriptor(mode));
 		return get_fp_tarval(buffer, mode);
 	}
+	case irms_vector: {
+		ir_mode    *const element = get_mode_element_mode(mode);
+		unsigned    const n_lanes = get_mode_n_lanes(mode);
+		ir_tarval **const lanes   = ALLOCAN(ir_tarval*, n_lanes);
+		char       *const copy    = ALLOCAN(char, len + 1);
+		memcpy(copy, buf, len + 1);
+		char *lane = copy;
+		for (unsigned i = 0; i < n_lanes; ++i) {
+			char *const end = strchr(lane, ',');
+			if ((end == NULL) != (i == n_lanes - 1))
+				panic("wrong number of lanes in vector tarval");
+			if (end != NULL)
+				*end = '\0';
+			lanes[i] = ir_tarval_from_ascii(lane, element);
+			if (end != NULL)
+				lane = end + 1;
+		}
+		return get_vector_tarval(lanes, mode);
+	}
 	case irms_data:
 	case irms_auxiliary:
 		if (streq(buf, "bad"))
@@ -1190,6 +1413,14 @@ ir_tarval *ir_tarval_from_ascii(const char *buf, ir_mode *mode)
 
 unsigned char get_tarval_sub_bits(ir_tarval const *tv, unsigned byte_ofs)
 {
+	if (mode_is_vector(tv->mode)) {
+		unsigned const lane_bytes
+			= get_mode_size_bytes(get_mode_element_mode(tv->mode));
+		ir_tarval const *const lane
+			= get_vector_lanes(tv)[byte_ofs / lane_bytes];
+		return get_tarval_sub_bits(lane, byte_ofs % lane_bytes);
+	}
+
 	switch (get_mode_arithmetic(tv->mode)) {
 	case irma_twos_complement:
 		return sc_sub_bits(tv->value, get_mode_size_bits(tv->mode), byte_ofs);
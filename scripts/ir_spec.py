@@ -226,6 +226,15 @@ class Block(Node):
 	}
 	'''
 
+@op
+class Broadcast(Node):
+	"""returns a vector with all lanes set to the value of its operand. The
+	operand must have the element mode of the vector mode."""
+	ins   = [
+		("op", "value copied into each lane"),
+	]
+	flags = []
+
 @op
 class Builtin(Node):
 	"""performs a backend-specific builtin."""
@@ -469,6 +478,20 @@ class Eor(Binop):
 	mode  = "get_irn_mode(irn_left)"
 	flags = [ "commutative" ]
 
+@op
+class Extract(Node):
+	"""returns a single lane of a vector value"""
+	ins   = [
+		("vector", "vector value"),
+	]
+	mode  = "get_mode_element_mode(get_irn_mode(irn_vector))"
+	flags = []
+	attrs = [
+		Attribute("lane", type="unsigned", comment="number of the lane"),
+	]
+	attr_struct = "lane_attr"
+	attrs_name  = "lane"
+
 @op
 class Free(Node):
 	"""Frees a block of memory previously allocated by an Alloc node"""
@@ -504,6 +527,22 @@ class IJmp(Node):
 	]
 	flags    = [ "cfopcode", "forking", "keep", "unknown_jump" ]
 
+@op
+class Insert(Node):
+	"""returns a copy of a vector value with a single lane replaced by the
+	value operand"""
+	ins   = [
+		("vector", "vector value"),
+		("value",  "value for the lane, of the element mode of the vector"),
+	]
+	mode  = "get_irn_mode(irn_vector)"
+	flags = []
+	attrs = [
+		Attribute("lane", type="unsigned", comment="number of the lane"),
+	]
+	attr_struct = "lane_attr"
+	attrs_name  = "lane"
+
 @op
 class Jmp(Node):
 	"""Jumps to the block connected through the out-value"""
@@ -782,6 +821,24 @@ class Shrs(Binop):
 	mode  = "get_irn_mode(irn_left)"
 	flags = []
 
+@op
+class Shuffle(Node):
+	"""returns a vector whose lanes are selected from the lanes of both
+	operands. The lanes of left are numbered 0 to n-1 and the lanes of right
+	n to 2n-1, lane i of the result is the lane numbered by lane i of the
+	mask."""
+	ins   = [
+		("left",  "first vector"),
+		("right", "second vector"),
+	]
+	mode  = "get_irn_mode(irn_left)"
+	flags = []
+	attrs = [
+		Attribute("mask", type="ir_tarval*",
+		          comment="integer vector selecting the lanes"),
+	]
+	attr_struct = "shuffle_attr"
+
 @op
 class Start(Node):
 	"""The first node of a graph. Execution starts with this node."""
@@ -0,0 +1,132 @@
+/**
+ * Runs the standard optimization pipeline on large generated graphs and
+ * reports the node memory of the graphs and the time spent.
+ * This file is a supplement to libFirm. It is public domain.
+ *
+ * Usage: node_arena_bench [n_graphs [n_diamonds]]
+ *
+ * Each graph is a chain of n_diamonds if-then-else diamonds of straight-line
+ * integer code, whose values are merged by Phis.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "firm.h"
+
+static ir_graph *build_graph(ir_type *method_type, unsigned index,
+                             unsigned n_diamonds)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "f%u", index);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str(name),
+	                                   method_type, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, 2);
+	set_current_ir_graph(irg);
+
+	ir_mode *Is = get_modeIs();
+	set_value(0, new_Proj(get_irg_args(irg), Is, 0));
+	set_value(1, new_Proj(get_irg_args(irg), Is, 1));
+	for (unsigned i = 0; i < n_diamonds; ++i) {
+		ir_node *x    = get_value(0, Is);
+		ir_node *y    = get_value(1, Is);
+		ir_node *cond = new_Cond(new_Cmp(x, y, ir_relation_less));
+		ir_node *t    = new_Proj(cond, mode_X, pn_Cond_true);
+		ir_node *f    = new_Proj(cond, mode_X, pn_Cond_false);
+
+		ir_node *then_block = new_immBlock();
+		add_immBlock_pred(then_block, t);
+		mature_immBlock(then_block);
+		set_cur_block(then_block);
+		/* redundant and foldable code for the optimizations to work on */
+		ir_node *c3 = new_Const_long(Is, 3);
+		ir_node *m  = new_Mul(new_Add(x, new_Const_long(Is, i)), c3);
+		ir_node *m2 = new_Mul(new_Add(x, new_Const_long(Is, i)), c3);
+		set_value(0, new_Sub(new_Add(m, y), new_Sub(m2, m)));
+		ir_node *then_jmp = new_Jmp();
+
+		ir_node *else_block = new_immBlock();
+		add_immBlock_pred(else_block, f);
+		mature_immBlock(else_block);
+		set_cur_block(else_block);
+		ir_node *e = new_Eor(y, new_And(x, new_Const_long(Is, 0xff)));
+		set_value(1, new_Add(new_Sub(e, new_Const_long(Is, 7)),
+		                     new_Mul(x, new_Const_long(Is, 0))));
+		ir_node *else_jmp = new_Jmp();
+
+		ir_node *join = new_immBlock();
+		add_immBlock_pred(join, then_jmp);
+		add_immBlock_pred(join, else_jmp);
+		mature_immBlock(join);
+		set_cur_block(join);
+	}
+	ir_node *res[] = { new_Eor(get_value(0, Is), get_value(1, Is)) };
+	ir_node *ret   = new_Return(get_store(), 1, res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+static double to_mib(size_t bytes)
+{
+	return bytes / (1024.0 * 1024.0);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned const n_graphs   = argc > 1 ? (unsigned)atoi(argv[1]) : 8;
+	unsigned const n_diamonds = argc > 2 ? (unsigned)atoi(argv[2]) : 400;
+
+	ir_init();
+	ir_type *t_int = new_type_primitive(get_modeIs());
+	ir_type *mt    = new_type_method(2, 1, false);
+	set_method_param_type(mt, 0, t_int);
+	set_method_param_type(mt, 1, t_int);
+	set_method_res_type(mt, 0, t_int);
+	for (unsigned i = 0; i < n_graphs; ++i)
+		build_graph(mt, i, n_diamonds);
+
+	size_t built = 0;
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i)
+		built += get_irg_node_memory(get_irp_irg(i));
+
+	ir_timer_t *timer = ir_timer_new();
+	ir_timer_start(timer);
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i) {
+		ir_graph *const irg = get_irp_irg(i);
+		optimize_graph_df(irg);
+		combo(irg);
+		optimize_cf(irg);
+		opt_jumpthreading(irg);
+		optimize_reassociation(irg);
+		optimize_graph_df(irg);
+		place_code(irg);
+	}
+	ir_timer_stop(timer);
+
+	size_t peak  = 0;
+	size_t after = 0;
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i) {
+		peak  += get_irg_node_memory_peak(get_irp_irg(i));
+		after += get_irg_node_memory(get_irp_irg(i));
+	}
+	size_t live = 0;
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i) {
+		ir_graph *const irg = get_irp_irg(i);
+		dead_node_elimination(irg);
+		live += get_irg_node_memory(irg);
+	}
+
+	printf("graphs                     %u x %u diamonds\n", n_graphs,
+	       n_diamonds);
+	printf("node memory after building %10.1f MiB\n", to_mib(built));
+	printf("peak node memory           %10.1f MiB\n", to_mib(peak));
+	printf("node memory after pipeline %10.1f MiB\n", to_mib(after));
+	printf("live after dead node elim. %10.1f MiB\n", to_mib(live));
+	printf("optimization time          %10.3f s\n", ir_timer_elapsed_sec(timer));
+
+	ir_timer_free(timer);
+	ir_finish();
+	return 0;
+}
@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+#
+# This file is part of libFirm.
+# Copyright (C) 2016 Karlsruhe Institute of Technology.
+"""
+Aggregates statev event files into a CSV table.
+
+Reads binary streams written by stat_ev_begin_binary() (.evb) as well as the
+text format written by stat_ev_begin() (.ev, optionally gzip compressed).
+For each context and event key the number of events and the sum, minimum,
+maximum and mean of their values are reported.  A context is the set of
+context keys pushed when the event happened, --group restricts it to some
+context keys, so events of all other contexts are summed up.
+"""
+import argparse
+import csv
+import gzip
+import re
+import struct
+import sys
+
+BINARY_MAGIC = b"FIRMSTEV"
+BINARY_VERSION = 1
+BINARY_BYTE_ORDER = 0x01020304
+CHUNK_STRINGS = ord('S')
+CHUNK_EVENTS = ord('E')
+TYPE_PUSH = ord('P')
+TYPE_POP = ord('O')
+TYPE_INT = ord('I')
+TYPE_UNSIGNED = ord('U')
+TYPE_DOUBLE = ord('D')
+
+
+class Aggregator:
+	def __init__(self, group, event_filter):
+		self.group = group
+		self.event_filter = event_filter
+		self.ctx_keys = []
+		self.ctx_key_set = set()
+		self.ctx_ids = {}
+		self.contexts = []
+		self.stats = {}
+		self.stack = []
+		self.ctx = self.context_id()
+		self.key_ok = {}
+
+	def context_id(self):
+		"""Returns the id of the current (grouped) context."""
+		if self.group is None:
+			items = tuple(self.stack)
+		else:
+			items = tuple(kv for kv in self.stack if kv[0] in self.group)
+		ctx = self.ctx_ids.get(items)
+		if ctx is None:
+			ctx = len(self.contexts)
+			self.ctx_ids[items] = ctx
+			self.contexts.append(dict(items))
+		return ctx
+
+	def push(self, key, value):
+		if key not in self.ctx_key_set:
+			self.ctx_key_set.add(key)
+			self.ctx_keys.append(key)
+		self.stack.append((key, value))
+		self.ctx = self.context_id()
+
+	def pop(self, key, where):
+		if not self.stack:
+			sys.stderr.write("%s: pop of '%s' without push\n" % (where, key))
+			return
+		pushed = self.stack.pop()[0]
+		if pushed != key:
+			sys.stderr.write("%s: unmatched pop, push key '%s', pop key '%s'\n"
+			                 % (where, pushed, key))
+		self.ctx = self.context_id()
+
+	def matches(self, key):
+		ok = self.key_ok.get(key)
+		if ok is None:
+			ok = self.event_filter is None or \
+			     self.event_filter.search(key) is not None
+			self.key_ok[key] = ok
+		return ok
+
+	def event(self, key, value):
+		if not self.matches(key):
+			return
+		entry = (self.ctx, key)
+		stat = self.stats.get(entry)
+		if stat is None:
+			self.stats[entry] = [1, value, value, value]
+		else:
+			stat[0] += 1
+			stat[1] += value
+			if value < stat[2]:
+				stat[2] = value
+			if value > stat[3]:
+				stat[3] = value
+
+	def read_binary(self, name, data):
+		if data[:len(BINARY_MAGIC)] != BINARY_MAGIC:
+			raise ValueError("%s: not a statev binary stream" % name)
+		pos = len(BINARY_MAGIC)
+		for order in "<>":
+			version, marker = struct.unpack_from(order + "II", data, pos)
+			if marker == BINARY_BYTE_ORDER:
+				break
+		else:
+			raise ValueError("%s: unknown byte order" % name)
+		if version != BINARY_VERSION:
+			raise ValueError("%s: unsupported version %d" % (name, version))
+		pos += 8
+
+		chunk_header = struct.Struct(order + "II")
+		string_header = struct.Struct(order + "II")
+		record = struct.Struct(order + "B3xIq")
+		double = struct.Struct(order + "8xd")
+		strings = {}
+		event = self.event
+		size = len(data)
+		while pos < size:
+			kind, length = chunk_header.unpack_from(data, pos)
+			pos += chunk_header.size
+			end = pos + length
+			if end > size:
+				sys.stderr.write("%s: truncated chunk\n" % name)
+				break
+			if kind == CHUNK_STRINGS:
+				while pos < end:
+					sid, slen = string_header.unpack_from(data, pos)
+					pos += string_header.size
+					strings[sid] = data[pos:pos + slen].decode("utf-8", "replace")
+					pos += slen
+				continue
+			if kind != CHUNK_EVENTS:
+				sys.stderr.write("%s: unknown chunk kind %d\n" % (name, kind))
+				pos = end
+				continue
+
+			chunk = data[pos:end]
+			pos = end
+			doubles = double.iter_unpack(chunk)
+			for (t, k, v), (d,) in zip(record.iter_unpack(chunk), doubles):
+				if t == TYPE_INT:
+					event(strings[k], v)
+				elif t == TYPE_DOUBLE:
+					event(strings[k], d)
+				elif t == TYPE_UNSIGNED:
+					event(strings[k], v & 0xFFFFFFFFFFFFFFFF)
+				elif t == TYPE_PUSH:
+					self.push(strings[k], strings[v])
+				elif t == TYPE_POP:
+					self.pop(strings[k], name)
+
+	def read_text(self, name, lines):
+		event = self.event
+		for lineno, line in enumerate(lines, 1):
+			fields = line.rstrip("\n").split(";")
+			op = fields[0]
+			if op == "E":
+				for i in range(1, len(fields) - 1, 2):
+					event(fields[i], float(fields[i + 1]))
+			elif op == "P":
+				for i in range(1, len(fields) - 1, 2):
+					self.push(fields[i], fields[i + 1])
+			elif op == "O":
+				for key in reversed(fields[1:]):
+					self.pop(key, "%s:%d" % (name, lineno))
+
+	def read(self, name):
+		with open(name, "rb") as f:
+			data = f.read()
+		if data[:2] == b"\x1f\x8b":
+			data = gzip.decompress(data)
+		if data[:len(BINARY_MAGIC)] == BINARY_MAGIC:
+			self.read_binary(name, data)
+		else:
+			self.read_text(name, data.decode("utf-8", "replace").splitlines())
+		if self.stack:
+			sys.stderr.write("%s: %d context keys still pushed at the end\n"
+			                 % (name, len(self.stack)))
+			self.stack = []
+			self.ctx = self.context_id()
+
+	def write(self, out):
+		columns = self.ctx_keys if self.group is None else \
+		          [k for k in self.ctx_keys if k in self.group]
+		writer = csv.writer(out, lineterminator="\n")
+		writer.writerow(columns + ["event", "count", "sum", "min", "max",
+		                           "mean"])
+		rows = []
+		for (ctx, key), (count, total, lo, hi) in self.stats.items():
+			context = self.contexts[ctx]
+			rows.append([context.get(c, "") for c in columns] +
+			            [key, count, total, lo, hi, total / count])
+		rows.sort(key=lambda row: row[:len(columns) + 1])
+		writer.writerows(rows)
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__.strip(),
+		formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument("files", nargs="+", metavar="FILE",
+	                    help="statev event file (.ev or .evb)")
+	parser.add_argument("-f", "--filter", metavar="REGEXP",
+	                    help="only aggregate events whose key matches REGEXP")
+	parser.add_argument("-g", "--group", metavar="KEYS",
+	                    help="comma separated context keys to group by, "
+	                         "default is the full context")
+	parser.add_argument("-o", "--output", metavar="FILE",
+	                    help="write the CSV table to FILE instead of stdout")
+	args = parser.parse_args()
+
+	group = None
+	if args.group is not None:
+		group = frozenset(k for k in args.group.split(",") if k)
+	event_filter = re.compile(args.filter) if args.filter else None
+
+	aggregator = Aggregator(group, event_filter)
+	for name in args.files:
+		try:
+			aggregator.read(name)
+		except (OSError, ValueError) as e:
+			sys.stderr.write("%s\n" % e)
+			return 1
+
+	if args.output:
+		with open(args.output, "w") as out:
+			aggregator.write(out)
+	else:
+		aggregator.write(sys.stdout)
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
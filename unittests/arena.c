@@ -0,0 +1,90 @@
+#include "arena.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+int main(void)
+{
+	arena_t arena;
+	arena_init(&arena);
+	assert(arena.used == 0 && arena.peak == 0 && arena.reserved == 0);
+
+	/* sizes are rounded up to their size class */
+	void *a = arena_alloc(&arena, 1);
+	void *b = arena_alloc(&arena, ARENA_ALIGN);
+	void *c = arena_alloc(&arena, ARENA_ALIGN + 1);
+	assert(arena.used == 4 * ARENA_ALIGN);
+	assert(arena_size_class(1) == arena_size_class(ARENA_ALIGN));
+	assert(arena_size_class(ARENA_ALIGN + 1) == 1);
+	assert(arena_size_class(ARENA_MAX_SIZE) == ARENA_N_CLASSES - 1);
+	assert((uintptr_t)a % ARENA_ALIGN == 0);
+	assert((uintptr_t)b % ARENA_ALIGN == 0);
+	assert((uintptr_t)c % ARENA_ALIGN == 0);
+	assert((char*)b - (char*)a == ARENA_ALIGN);
+	assert((char*)c - (char*)b == ARENA_ALIGN);
+	memset(c, 0x55, ARENA_ALIGN + 1);
+	assert(arena_contains(&arena, a));
+	assert(arena_contains(&arena, c));
+
+	/* released objects are reused by their size class only */
+	arena_free(&arena, b, ARENA_ALIGN);
+	assert(arena.used == 3 * ARENA_ALIGN);
+	void *d = arena_alloc(&arena, 2 * ARENA_ALIGN);
+	assert(d != b);
+	void *e = arena_alloc(&arena, 7);
+	assert(e == b);
+	arena_free(&arena, c, ARENA_ALIGN + 1);
+	void *f = arena_alloc(&arena, 2 * ARENA_ALIGN);
+	assert(f == c);
+	/* the free lists are LIFO */
+	arena_free(&arena, a, 1);
+	arena_free(&arena, e, 1);
+	assert(arena_alloc(&arena, 1) == e);
+	assert(arena_alloc(&arena, 1) == a);
+
+	/* the peak is kept when objects are released */
+	size_t const used = arena.used;
+	assert(arena.peak == used);
+	void *objects[64];
+	for (int i = 0; i < 64; ++i)
+		objects[i] = arena_alloc(&arena, 100);
+	size_t const rounded = (arena_size_class(100) + 1) * ARENA_ALIGN;
+	assert(arena.used == used + 64 * rounded);
+	assert(arena.peak == arena.used);
+	for (int i = 0; i < 64; ++i)
+		arena_free(&arena, objects[i], 100);
+	assert(arena.used == used);
+	assert(arena.peak == used + 64 * rounded);
+	/* reusing the released objects does not grow the arena */
+	size_t const reserved = arena.reserved;
+	for (int i = 0; i < 64; ++i)
+		objects[i] = arena_alloc(&arena, 97);
+	assert(arena.reserved == reserved);
+	assert(arena.peak == arena.used);
+
+	/* objects larger than ARENA_MAX_SIZE are allocated separately */
+	void *large = arena_alloc(&arena, ARENA_MAX_SIZE + 1);
+	assert((uintptr_t)large % ARENA_ALIGN == 0);
+	assert(arena.used == used + 64 * rounded + ARENA_MAX_SIZE + 1);
+	assert(arena.reserved > reserved + ARENA_MAX_SIZE);
+	assert(arena_contains(&arena, large));
+	memset(large, 0x55, ARENA_MAX_SIZE + 1);
+	arena_free(&arena, large, ARENA_MAX_SIZE + 1);
+	assert(arena.used == used + 64 * rounded);
+	assert(arena.reserved == reserved);
+	assert(!arena_contains(&arena, large));
+
+	/* many chunks */
+	size_t const peak = arena.peak;
+	for (int i = 0; i < 10000; ++i) {
+		void *p = arena_alloc(&arena, ARENA_MAX_SIZE);
+		assert(arena_contains(&arena, p));
+	}
+	assert(arena.used == used + 64 * rounded + 10000 * (size_t)ARENA_MAX_SIZE);
+	assert(arena.peak == arena.used && arena.peak > peak);
+	assert(arena.reserved >= arena.used);
+
+	arena_destroy(&arena);
+	assert(arena.used == 0 && arena.peak == 0 && arena.reserved == 0);
+	return 0;
+}
@@ -0,0 +1,182 @@
+#include <assert.h>
+#include <stdbool.h>
+#include "firm.h"
+#include "belive.h"
+#include "irgraph_t.h"
+#include "irnode_t.h"
+
+#define N_ADDED 100
+
+typedef struct graph_t {
+	ir_graph *irg;
+	ir_node  *header;
+	ir_node  *body;
+	ir_node  *exit;
+	ir_node  *i;
+	ir_node  *a;
+} graph_t;
+
+/* long f(long a, long b)
+ * {
+ *   long x = a * b, y = a - b;
+ *   for (long i = 0; i < b; ++i)
+ *     x += y ^ i;
+ *   if (x < a) x = x * y;
+ *   return x + a;
+ * } */
+static graph_t build_graph(void)
+{
+	ir_mode *Ls     = get_modeLs();
+	ir_type *t_long = new_type_primitive(Ls);
+	ir_type *mt     = new_type_method(2, 1, false);
+	set_method_param_type(mt, 0, t_long);
+	set_method_param_type(mt, 1, t_long);
+	set_method_res_type(mt, 0, t_long);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str("f"),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	graph_t g;
+	g.irg = new_ir_graph(ent, 2);
+	set_current_ir_graph(g.irg);
+
+	ir_node *a = new_Proj(get_irg_args(g.irg), Ls, 0);
+	ir_node *b = new_Proj(get_irg_args(g.irg), Ls, 1);
+	ir_node *y = new_Sub(a, b);
+	set_value(0, new_Const_long(Ls, 0));
+	set_value(1, new_Mul(a, b));
+	ir_node *entry_jmp = new_Jmp();
+
+	g.header = new_immBlock();
+	add_immBlock_pred(g.header, entry_jmp);
+	set_cur_block(g.header);
+	g.i = get_value(0, Ls);
+	ir_node *loop = new_Cond(new_Cmp(g.i, b, ir_relation_less));
+
+	ir_node *body = g.body = new_immBlock();
+	add_immBlock_pred(body, new_Proj(loop, mode_X, pn_Cond_true));
+	mature_immBlock(body);
+	set_cur_block(body);
+	set_value(1, new_Add(get_value(1, Ls), new_Eor(y, g.i)));
+	set_value(0, new_Add(g.i, new_Const_long(Ls, 1)));
+	add_immBlock_pred(g.header, new_Jmp());
+	mature_immBlock(g.header);
+
+	g.exit = new_immBlock();
+	add_immBlock_pred(g.exit, new_Proj(loop, mode_X, pn_Cond_false));
+	mature_immBlock(g.exit);
+	set_cur_block(g.exit);
+	ir_node *x    = get_value(1, Ls);
+	ir_node *cond = new_Cond(new_Cmp(x, a, ir_relation_less));
+	ir_node *then = new_immBlock();
+	add_immBlock_pred(then, new_Proj(cond, mode_X, pn_Cond_true));
+	mature_immBlock(then);
+	set_cur_block(then);
+	set_value(1, new_Mul(x, y));
+	ir_node *then_jmp = new_Jmp();
+
+	ir_node *join = new_immBlock();
+	add_immBlock_pred(join, new_Proj(cond, mode_X, pn_Cond_false));
+	add_immBlock_pred(join, then_jmp);
+	mature_immBlock(join);
+	set_cur_block(join);
+	ir_node *in[] = { new_Add(get_value(1, Ls), a) };
+	ir_node *ret  = new_Return(get_store(), 1, in);
+	add_immBlock_pred(get_irg_end_block(g.irg), ret);
+	mature_immBlock(get_irg_end_block(g.irg));
+	irg_finalize_cons(g.irg);
+	g.a = a;
+	return g;
+}
+
+static void collect_node(ir_node *node, void *env)
+{
+	ir_node ***const nodes = (ir_node***)env;
+	ARR_APP1(ir_node*, *nodes, node);
+}
+
+/* both representations answer every query the same, returns the number of
+ * live states found */
+static unsigned compare(ir_graph *irg, be_lv_t const *sorted,
+                        be_lv_t const *dense)
+{
+	ir_node **blocks = NEW_ARR_F(ir_node*, 0);
+	ir_node **nodes  = NEW_ARR_F(ir_node*, 0);
+	irg_block_walk_graph(irg, collect_node, NULL, &blocks);
+	irg_walk_graph(irg, collect_node, NULL, &nodes);
+	unsigned n_live = 0;
+	for (size_t b = 0; b < ARR_LEN(blocks); ++b) {
+		for (size_t n = 0; n < ARR_LEN(nodes); ++n) {
+			be_lv_state_t const state
+				= be_get_live_state(sorted, blocks[b], nodes[n]);
+			assert(be_get_live_state(dense, blocks[b], nodes[n]) == state);
+			if (state != be_lv_state_none)
+				++n_live;
+		}
+	}
+	DEL_ARR_F(nodes);
+	DEL_ARR_F(blocks);
+	return n_live;
+}
+
+int main(void)
+{
+	ir_init();
+	/* the option has to be given before the backend is initialized */
+	int res = be_parse_arg("livesets=dense");
+	assert(res);
+	(void)res;
+	graph_t const g = build_graph();
+	ir_graph *const irg = g.irg;
+	assure_edges(irg);
+	be_lv_t *const dense = be_liveness_new(irg);
+	assert(dense->dense);
+	/* the sorted representation for comparison */
+	be_lv_t *const sorted = be_liveness_new(irg);
+	sorted->dense = false;
+	be_liveness_compute_sets(sorted);
+	be_liveness_compute_sets(dense);
+	unsigned const n_live = compare(irg, sorted, dense);
+	assert(n_live > 0);
+	/* the loop counter lives around the loop */
+	assert(be_is_live_out(dense, g.header, g.i));
+	assert(be_is_live_in(dense, g.body, g.i));
+	assert(!be_is_live_in(dense, g.exit, g.i));
+
+	/* values created after the analysis grow the bitsets */
+	unsigned const last_idx = get_irg_last_idx(irg);
+	ir_node *added[N_ADDED];
+	for (long k = 0; k < N_ADDED; ++k) {
+		ir_node *const c = new_r_Const_long(irg, get_modeLs(), k);
+		added[k] = new_r_Add(g.header, g.i, c);
+		ir_node *const user = new_r_Eor(g.exit, added[k], g.a);
+		add_End_keepalive(get_irg_end(irg), user);
+		be_liveness_introduce(sorted, c);
+		be_liveness_introduce(dense, c);
+		be_liveness_introduce(sorted, added[k]);
+		be_liveness_introduce(dense, added[k]);
+	}
+	be_liveness_update(sorted, g.a);
+	be_liveness_update(dense, g.a);
+	assert(get_irn_idx(added[N_ADDED - 1]) >= last_idx + 2 * N_ADDED);
+	assert(be_is_live_in(dense, g.exit, added[N_ADDED - 1]));
+	assert(be_is_live_out(dense, g.header, added[N_ADDED - 1]));
+	assert(compare(irg, sorted, dense) > n_live);
+
+	/* removed values are gone from the bitsets */
+	be_liveness_remove(sorted, added[N_ADDED / 2]);
+	be_liveness_remove(dense, added[N_ADDED / 2]);
+	assert(!be_is_live_in(dense, g.exit, added[N_ADDED / 2]));
+	assert(!be_is_live_out(dense, g.header, added[N_ADDED / 2]));
+	compare(irg, sorted, dense);
+
+	/* recomputing gives the same sets */
+	be_liveness_invalidate_sets(dense);
+	be_liveness_compute_sets(dense);
+	be_liveness_remove(dense, added[N_ADDED / 2]);
+	compare(irg, sorted, dense);
+
+	be_liveness_free(dense);
+	be_liveness_free(sorted);
+	ir_finish();
+	return 0;
+}
@@ -0,0 +1,124 @@
+#include <assert.h>
+#include <stdbool.h>
+#include "firm.h"
+#include "irgraph_t.h"
+
+static void check_idx(ir_node *node, void *env)
+{
+	ir_graph *irg = (ir_graph*)env;
+	assert(get_irn_idx(node) < get_irg_last_idx(irg));
+	assert(get_idx_irn(irg, get_irn_idx(node)) == node);
+}
+
+/* int f(int a, int b) {
+ *   int c = a < b;
+ *   int x = c ? a + b : a - b;
+ *   if (c) x *= 3;
+ *   return x;
+ * }
+ * The second condition is threaded through the first one. */
+static ir_graph *build_graph(void)
+{
+	ir_mode *Is = get_modeIs();
+	ir_type *t_int = new_type_primitive(Is);
+	ir_type *mt    = new_type_method(2, 1, false);
+	set_method_param_type(mt, 0, t_int);
+	set_method_param_type(mt, 1, t_int);
+	set_method_res_type(mt, 0, t_int);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str("f"),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, 2);
+	set_current_ir_graph(irg);
+
+	ir_node *args = get_irg_args(irg);
+	ir_node *a    = new_Proj(args, Is, 0);
+	ir_node *b    = new_Proj(args, Is, 1);
+	ir_node *cmp  = new_Cmp(a, b, ir_relation_less);
+	ir_node *cond = new_Cond(cmp);
+	ir_node *t    = new_Proj(cond, mode_X, pn_Cond_true);
+	ir_node *f    = new_Proj(cond, mode_X, pn_Cond_false);
+
+	ir_node *then_block = new_immBlock();
+	add_immBlock_pred(then_block, t);
+	mature_immBlock(then_block);
+	set_cur_block(then_block);
+	set_value(0, new_Add(a, b));
+	set_value(1, new_Const_long(Is, 1));
+	ir_node *then_jmp = new_Jmp();
+
+	ir_node *else_block = new_immBlock();
+	add_immBlock_pred(else_block, f);
+	mature_immBlock(else_block);
+	set_cur_block(else_block);
+	set_value(0, new_Sub(a, b));
+	set_value(1, new_Const_long(Is, 0));
+	ir_node *else_jmp = new_Jmp();
+
+	ir_node *join = new_immBlock();
+	add_immBlock_pred(join, then_jmp);
+	add_immBlock_pred(join, else_jmp);
+	mature_immBlock(join);
+	set_cur_block(join);
+	ir_node *c     = get_value(1, Is);
+	ir_node *cmp2  = new_Cmp(c, new_Const_long(Is, 0), ir_relation_less_greater);
+	ir_node *cond2 = new_Cond(cmp2);
+	ir_node *t2    = new_Proj(cond2, mode_X, pn_Cond_true);
+	ir_node *f2    = new_Proj(cond2, mode_X, pn_Cond_false);
+
+	ir_node *mul_block = new_immBlock();
+	add_immBlock_pred(mul_block, t2);
+	mature_immBlock(mul_block);
+	set_cur_block(mul_block);
+	set_value(0, new_Mul(get_value(0, Is), new_Const_long(Is, 3)));
+	ir_node *mul_jmp = new_Jmp();
+
+	ir_node *ret_block = new_immBlock();
+	add_immBlock_pred(ret_block, mul_jmp);
+	add_immBlock_pred(ret_block, f2);
+	mature_immBlock(ret_block);
+	set_cur_block(ret_block);
+	ir_node *res[] = { get_value(0, Is) };
+	ir_node *ret   = new_Return(get_store(), 1, res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+int main(void)
+{
+	ir_init();
+
+	ir_graph *irg = build_graph();
+	assert(irg_verify(irg));
+
+	optimize_graph_df(irg);
+	opt_jumpthreading(irg);
+	/* leave analysis results behind, which must be invalidated */
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUTS
+	                         | IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
+
+	dead_node_elimination_in_place(irg);
+	assert(!irg_has_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUTS));
+	assert(irg_verify(irg));
+
+	/* the indices of the remaining nodes are dense */
+	irg_walk_anchors(irg, check_idx, NULL, irg);
+	unsigned const last_idx = get_irg_last_idx(irg);
+	for (unsigned idx = 0; idx < last_idx; ++idx) {
+		ir_node *const node = get_idx_irn(irg, idx);
+		assert(node != NULL);
+		assert(get_irn_idx(node) == idx);
+	}
+
+	/* the graph is still usable */
+	optimize_graph_df(irg);
+	opt_jumpthreading(irg);
+	dead_node_elimination_in_place(irg);
+	assert(irg_verify(irg));
+
+	ir_finish();
+	return 0;
+}
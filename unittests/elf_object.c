@@ -0,0 +1,251 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "firm.h"
+
+#ifdef __linux__
+#include <elf.h>
+
+/* int counter = 42;
+ * static const char message[] = "hello";
+ * int f(int a)
+ * {
+ *   return g(message, a) + counter;
+ * } */
+static void build_program(void)
+{
+	ir_mode *Is    = get_modeIs();
+	ir_type *t_int = new_type_primitive(Is);
+	ir_type *t_chr = new_type_primitive(get_modeBs());
+	ir_type *t_ptr = new_type_pointer(t_chr);
+
+	ir_entity *counter = new_global_entity(get_glob_type(),
+	                                       new_id_from_str("counter"), t_int,
+	                                       ir_visibility_external,
+	                                       IR_LINKAGE_DEFAULT);
+	set_entity_initializer(counter,
+	                       create_initializer_tarval(new_tarval_from_long(42, Is)));
+
+	static const char text[] = "hello";
+	size_t const   len       = sizeof(text);
+	ir_type       *t_text    = new_type_array(t_chr, len);
+	ir_entity     *message   = new_global_entity(get_glob_type(),
+	                                             new_id_from_str("message"),
+	                                             t_text, ir_visibility_local,
+	                                             IR_LINKAGE_CONSTANT);
+	ir_initializer_t *init = create_initializer_compound(len);
+	for (size_t i = 0; i < len; ++i) {
+		ir_tarval *tv = new_tarval_from_long(text[i], get_modeBs());
+		set_initializer_compound_value(init, i, create_initializer_tarval(tv));
+	}
+	set_entity_initializer(message, init);
+
+	ir_type *gt = new_type_method(2, 1, false);
+	set_method_param_type(gt, 0, t_ptr);
+	set_method_param_type(gt, 1, t_int);
+	set_method_res_type(gt, 0, t_int);
+	ir_entity *g = new_global_entity(get_glob_type(), new_id_from_str("g"), gt,
+	                                 ir_visibility_external,
+	                                 IR_LINKAGE_DEFAULT);
+
+	ir_type *ft = new_type_method(1, 1, false);
+	set_method_param_type(ft, 0, t_int);
+	set_method_res_type(ft, 0, t_int);
+	ir_entity *f = new_global_entity(get_glob_type(), new_id_from_str("f"), ft,
+	                                 ir_visibility_external,
+	                                 IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(f, 0);
+	set_current_ir_graph(irg);
+
+	ir_node *a    = new_Proj(get_irg_args(irg), Is, 0);
+	ir_node *in[] = { new_Address(message), a };
+	ir_node *call = new_Call(get_store(), new_Address(g), 2, in, gt);
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	ir_node *r    = new_Proj(new_Proj(call, mode_T, pn_Call_T_result), Is, 0);
+	ir_node *ld   = new_Load(get_store(), new_Address(counter), Is, t_int,
+	                         cons_none);
+	set_store(new_Proj(ld, mode_M, pn_Load_M));
+	ir_node *res[] = { new_Add(r, new_Proj(ld, Is, pn_Load_res)) };
+	ir_node *ret   = new_Return(get_store(), 1, res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+}
+
+typedef struct object_t {
+	unsigned char    *data;
+	size_t            size;
+	Elf64_Ehdr const *header;
+	Elf64_Shdr const *sections;
+	char const       *section_names;
+} object_t;
+
+static Elf64_Shdr const *find_section(object_t const *obj, char const *name)
+{
+	for (unsigned i = 0; i < obj->header->e_shnum; ++i) {
+		Elf64_Shdr const *const section = &obj->sections[i];
+		if (strcmp(obj->section_names + section->sh_name, name) == 0)
+			return section;
+	}
+	return NULL;
+}
+
+static unsigned section_index(object_t const *obj, Elf64_Shdr const *section)
+{
+	return (unsigned)(section - obj->sections);
+}
+
+static Elf64_Sym const *find_symbol(object_t const *obj, char const *name,
+                                    unsigned *index)
+{
+	Elf64_Shdr const *const symtab = find_section(obj, ".symtab");
+	Elf64_Sym  const *const syms   = (Elf64_Sym const*)(obj->data + symtab->sh_offset);
+	char const       *const names
+		= (char const*)obj->data + obj->sections[symtab->sh_link].sh_offset;
+	for (unsigned i = 0, n = symtab->sh_size / sizeof(*syms); i < n; ++i) {
+		if (strcmp(names + syms[i].st_name, name) == 0) {
+			if (index != NULL)
+				*index = i;
+			return &syms[i];
+		}
+	}
+	return NULL;
+}
+
+/* returns whether .rela.text has a relocation against symbol */
+static bool has_relocation(object_t const *obj, unsigned symbol)
+{
+	Elf64_Shdr const *const rela_text = find_section(obj, ".rela.text");
+	assert(rela_text != NULL);
+	assert(rela_text->sh_type == SHT_RELA);
+	assert(rela_text->sh_entsize == sizeof(Elf64_Rela));
+	assert(rela_text->sh_info == section_index(obj, find_section(obj, ".text")));
+	Elf64_Rela const *const relas
+		= (Elf64_Rela const*)(obj->data + rela_text->sh_offset);
+	for (unsigned i = 0, n = rela_text->sh_size / sizeof(*relas); i < n; ++i) {
+		if (ELF64_R_SYM(relas[i].r_info) == symbol)
+			return true;
+	}
+	return false;
+}
+
+int main(void)
+{
+	ir_init();
+	if (!be_parse_arg("isa=amd64") || !be_parse_arg("amd64-object=1"))
+		return 1;
+	build_program();
+	be_lower_for_target();
+
+	FILE *const file = tmpfile();
+	assert(file != NULL);
+	be_main(file, "elf_object");
+	object_t obj;
+	long const size = ftell(file);
+	assert(size > (long)sizeof(Elf64_Ehdr));
+	obj.size = (size_t)size;
+	obj.data = (unsigned char*)malloc(obj.size);
+	rewind(file);
+	size_t const n_read = fread(obj.data, 1, obj.size, file);
+	assert(n_read == obj.size);
+	(void)n_read;
+	fclose(file);
+
+	/* the file header */
+	obj.header = (Elf64_Ehdr const*)obj.data;
+	Elf64_Ehdr const *const eh = obj.header;
+	assert(memcmp(eh->e_ident, ELFMAG, SELFMAG) == 0);
+	assert(eh->e_ident[EI_CLASS] == ELFCLASS64);
+	assert(eh->e_ident[EI_DATA] == ELFDATA2LSB);
+	assert(eh->e_ident[EI_VERSION] == EV_CURRENT);
+	assert(eh->e_type == ET_REL);
+	assert(eh->e_machine == EM_X86_64);
+	assert(eh->e_version == EV_CURRENT);
+	assert(eh->e_ehsize == sizeof(Elf64_Ehdr));
+	assert(eh->e_shentsize == sizeof(Elf64_Shdr));
+	assert(eh->e_shoff + eh->e_shnum * sizeof(Elf64_Shdr) <= obj.size);
+	assert(eh->e_shstrndx < eh->e_shnum);
+
+	/* the section headers */
+	obj.sections      = (Elf64_Shdr const*)(obj.data + eh->e_shoff);
+	obj.section_names = (char const*)obj.data
+	                  + obj.sections[eh->e_shstrndx].sh_offset;
+	assert(obj.sections[0].sh_type == SHT_NULL);
+	for (unsigned i = 1; i < eh->e_shnum; ++i) {
+		Elf64_Shdr const *const section = &obj.sections[i];
+		assert(section->sh_type == SHT_NOBITS
+		       || section->sh_offset + section->sh_size <= obj.size);
+	}
+	Elf64_Shdr const *const text = find_section(&obj, ".text");
+	assert(text != NULL && text->sh_type == SHT_PROGBITS);
+	assert(text->sh_flags == (SHF_ALLOC | SHF_EXECINSTR));
+	Elf64_Shdr const *const data = find_section(&obj, ".data");
+	assert(data != NULL && data->sh_type == SHT_PROGBITS);
+	assert(data->sh_flags == (SHF_ALLOC | SHF_WRITE));
+	Elf64_Shdr const *const symtab = find_section(&obj, ".symtab");
+	assert(symtab != NULL && symtab->sh_type == SHT_SYMTAB);
+	assert(symtab->sh_entsize == sizeof(Elf64_Sym));
+	assert(obj.sections[symtab->sh_link].sh_type == SHT_STRTAB);
+
+	/* the symbols */
+	unsigned               f_index;
+	Elf64_Sym const *const f = find_symbol(&obj, "f", &f_index);
+	assert(f != NULL);
+	assert(ELF64_ST_BIND(f->st_info) == STB_GLOBAL);
+	assert(ELF64_ST_TYPE(f->st_info) == STT_FUNC);
+	assert(f->st_shndx == section_index(&obj, text));
+	assert(f->st_size > 0 && f->st_value + f->st_size <= text->sh_size);
+
+	unsigned               counter_index;
+	Elf64_Sym const *const counter = find_symbol(&obj, "counter",
+	                                             &counter_index);
+	assert(counter != NULL);
+	assert(ELF64_ST_BIND(counter->st_info) == STB_GLOBAL);
+	assert(ELF64_ST_TYPE(counter->st_info) == STT_OBJECT);
+	assert(counter->st_shndx == section_index(&obj, data));
+	assert(counter->st_size == 4);
+	int32_t value;
+	memcpy(&value, obj.data + data->sh_offset + counter->st_value,
+	       sizeof(value));
+	assert(value == 42);
+
+	Elf64_Sym const *const message = find_symbol(&obj, "message", NULL);
+	assert(message != NULL);
+	assert(ELF64_ST_BIND(message->st_info) == STB_LOCAL);
+	assert(ELF64_ST_TYPE(message->st_info) == STT_OBJECT);
+	Elf64_Shdr const *const rodata = &obj.sections[message->st_shndx];
+	assert(!(rodata->sh_flags & SHF_WRITE));
+	assert(memcmp(obj.data + rodata->sh_offset + message->st_value, "hello",
+	              sizeof("hello")) == 0);
+	/* local symbols come first */
+	Elf64_Sym const *const syms
+		= (Elf64_Sym const*)(obj.data + symtab->sh_offset);
+	assert(message < syms + symtab->sh_info);
+	assert(f >= syms + symtab->sh_info && counter >= syms + symtab->sh_info);
+
+	unsigned               g_index;
+	Elf64_Sym const *const g = find_symbol(&obj, "g", &g_index);
+	assert(g != NULL);
+	assert(ELF64_ST_BIND(g->st_info) == STB_GLOBAL);
+	assert(g->st_shndx == SHN_UNDEF);
+
+	/* the code refers to g and counter through relocations */
+	assert(has_relocation(&obj, g_index));
+	assert(has_relocation(&obj, counter_index));
+	assert(!has_relocation(&obj, f_index));
+
+	free(obj.data);
+	ir_finish();
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	return 0;
+}
+
+#endif
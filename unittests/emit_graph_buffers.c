@@ -0,0 +1,188 @@
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "firm.h"
+
+#if defined(__unix__)
+#include <sys/wait.h>
+#include <unistd.h>
+
+static ir_type *t_int;
+
+static ir_graph *new_graph(const char *name, int n_params, int n_loc)
+{
+	ir_type *mt = new_type_method(n_params, 1, false);
+	for (int i = 0; i < n_params; ++i)
+		set_method_param_type(mt, i, t_int);
+	set_method_res_type(mt, 0, t_int);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str(name),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, n_loc);
+	set_current_ir_graph(irg);
+	return irg;
+}
+
+static void finish_graph(ir_graph *irg)
+{
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+}
+
+static void add_return(ir_graph *irg, ir_node *res)
+{
+	ir_node *in[] = { res };
+	ir_node *ret  = new_Return(get_store(), 1, in);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+}
+
+/* int loop(int n) { int s = 0; for (int i = 0; i < n; ++i) s += i * 3; return s; } */
+static void build_loop(void)
+{
+	ir_mode  *Is  = get_modeIs();
+	ir_graph *irg = new_graph("loop", 1, 2);
+	set_value(0, new_Const_long(Is, 0));
+	set_value(1, new_Const_long(Is, 0));
+	ir_node *jmp  = new_Jmp();
+	ir_node *head = new_immBlock();
+	add_immBlock_pred(head, jmp);
+	set_cur_block(head);
+	ir_node *n    = new_Proj(get_irg_args(irg), Is, 0);
+	ir_node *cmp  = new_Cmp(get_value(1, Is), n, ir_relation_less);
+	ir_node *cond = new_Cond(cmp);
+	ir_node *body = new_immBlock();
+	add_immBlock_pred(body, new_Proj(cond, mode_X, pn_Cond_true));
+	mature_immBlock(body);
+	set_cur_block(body);
+	ir_node *i = get_value(1, Is);
+	set_value(0, new_Add(get_value(0, Is), new_Mul(i, new_Const_long(Is, 3))));
+	set_value(1, new_Add(i, new_Const_long(Is, 1)));
+	add_immBlock_pred(head, new_Jmp());
+	mature_immBlock(head);
+	ir_node *exit = new_immBlock();
+	add_immBlock_pred(exit, new_Proj(cond, mode_X, pn_Cond_false));
+	mature_immBlock(exit);
+	set_cur_block(exit);
+	add_return(irg, get_value(0, Is));
+	finish_graph(irg);
+}
+
+/* int sw(int x) { switch (x) { case 0..7: return table[x]; default: return -1; } } */
+static void build_switch(void)
+{
+	ir_mode         *Is    = get_modeIs();
+	ir_graph        *irg   = new_graph("sw", 1, 0);
+	ir_switch_table *table = ir_new_switch_table(irg, 8);
+	for (int i = 0; i < 8; ++i) {
+		ir_tarval *tv = new_tarval_from_long(i, Is);
+		ir_switch_table_set(table, i, tv, tv, i + 1);
+	}
+	ir_node *sw = new_Switch(new_Proj(get_irg_args(irg), Is, 0), 9, table);
+	for (int i = 0; i < 9; ++i) {
+		ir_node *block = new_immBlock();
+		add_immBlock_pred(block, new_Proj(sw, mode_X, i));
+		mature_immBlock(block);
+		set_cur_block(block);
+		add_return(irg, new_Const_long(Is, i == 0 ? -1 : i * i * 7));
+	}
+	finish_graph(irg);
+}
+
+/* int mix(int a, int b) { return (a ^ counter) * b - (a & b); } */
+static void build_mix(ir_entity *counter)
+{
+	ir_mode  *Is  = get_modeIs();
+	ir_graph *irg = new_graph("mix", 2, 0);
+	ir_node  *a   = new_Proj(get_irg_args(irg), Is, 0);
+	ir_node  *b   = new_Proj(get_irg_args(irg), Is, 1);
+	ir_node  *ld  = new_Load(get_store(), new_Address(counter), Is, t_int,
+	                         cons_none);
+	set_store(new_Proj(ld, mode_M, pn_Load_M));
+	ir_node *c   = new_Proj(ld, Is, pn_Load_res);
+	ir_node *res = new_Sub(new_Mul(new_Eor(a, c), b), new_And(a, b));
+	add_return(irg, res);
+	finish_graph(irg);
+}
+
+/** Compiles the test program in a child process and returns its output. */
+static char *compile(const char *isa, bool graph_buffers)
+{
+	FILE *out = tmpfile();
+	assert(out != NULL);
+	fflush(NULL);
+	pid_t const pid = fork();
+	assert(pid >= 0);
+	if (pid == 0) {
+		ir_init();
+		char isa_arg[64];
+		snprintf(isa_arg, sizeof(isa_arg), "isa=%s", isa);
+		if (!be_parse_arg(isa_arg))
+			_exit(2);
+		if (!be_parse_arg(graph_buffers ? "graphbuffers=true"
+		                                : "graphbuffers=false"))
+			_exit(2);
+		if (strcmp(isa, "ia32") == 0)
+			be_parse_arg("ia32-fpmath=softfloat");
+		t_int = new_type_primitive(get_modeIs());
+		ir_entity *counter = new_global_entity(get_glob_type(),
+		                                       new_id_from_str("counter"),
+		                                       t_int, ir_visibility_external,
+		                                       IR_LINKAGE_DEFAULT);
+		set_entity_initializer(counter, create_initializer_tarval(
+			new_tarval_from_long(42, get_modeIs())));
+		build_loop();
+		build_switch();
+		build_mix(counter);
+		be_lower_for_target();
+		be_main(out, "emit_graph_buffers.c");
+		fflush(out);
+		ir_finish();
+		_exit(0);
+	}
+	int status;
+	waitpid(pid, &status, 0);
+	assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	fseek(out, 0, SEEK_END);
+	long const size = ftell(out);
+	assert(size > 0);
+	char *text = (char*)malloc(size + 1);
+	rewind(out);
+	size_t const n_read = fread(text, 1, size, out);
+	assert(n_read == (size_t)size);
+	text[size] = '\0';
+	fclose(out);
+	(void)n_read;
+	(void)status;
+	return text;
+}
+
+int main(void)
+{
+	static const char *const isas[] = { "amd64", "ia32", "arm", "sparc" };
+	for (size_t i = 0; i < sizeof(isas) / sizeof(isas[0]); ++i) {
+		char *const buffered = compile(isas[i], true);
+		char *const direct   = compile(isas[i], false);
+		assert(strstr(buffered, "loop") != NULL);
+		assert(strstr(buffered, "mix") != NULL);
+		if (strcmp(buffered, direct) != 0) {
+			fprintf(stderr, "%s: output differs with graph buffers\n", isas[i]);
+			return 1;
+		}
+		free(buffered);
+		free(direct);
+	}
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	return 0;
+}
+
+#endif
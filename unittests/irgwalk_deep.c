@@ -0,0 +1,164 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "firm.h"
+
+/* Deep enough that a recursive walk needs far more than the stack of the
+ * walking thread. */
+#define DEPTH      100000
+#define STACK_SIZE (128 * 1024)
+
+typedef struct walk_env_t {
+	bool    *entered;
+	bool    *left;
+	unsigned n_pre;
+	unsigned n_post;
+	bool     outs;   /**< walking the outs */
+	bool     blocks; /**< walking the control flow */
+} walk_env_t;
+
+/* long f(long a, long b)
+ * {
+ *   goto l1; l1: goto l2; ... lDEPTH:
+ *   return a + b + b + ... + b;
+ * } */
+static ir_graph *build_graph(void)
+{
+	ir_mode *Ls     = get_modeLs();
+	ir_type *t_long = new_type_primitive(Ls);
+	ir_type *mt     = new_type_method(2, 1, false);
+	set_method_param_type(mt, 0, t_long);
+	set_method_param_type(mt, 1, t_long);
+	set_method_res_type(mt, 0, t_long);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str("f"),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+
+	ir_node *a = new_Proj(get_irg_args(irg), Ls, 0);
+	ir_node *b = new_Proj(get_irg_args(irg), Ls, 1);
+	/* looking the memory up through all blocks would recurse as deep */
+	ir_node *mem = get_store();
+	for (unsigned i = 0; i < DEPTH; ++i) {
+		ir_node *jmp   = new_Jmp();
+		ir_node *block = new_immBlock();
+		add_immBlock_pred(block, jmp);
+		mature_immBlock(block);
+		set_cur_block(block);
+		set_store(mem);
+	}
+	ir_node *sum = a;
+	for (unsigned i = 0; i < DEPTH; ++i)
+		sum = new_Add(sum, b);
+	ir_node *in[] = { sum };
+	ir_node *ret  = new_Return(get_store(), 1, in);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+static void enter(ir_node *node, void *ctx)
+{
+	walk_env_t *const env = (walk_env_t*)ctx;
+	unsigned    const idx = get_irn_idx(node);
+	assert(!env->entered[idx]);
+	env->entered[idx] = true;
+	++env->n_pre;
+}
+
+/* every node is left after the nodes it reaches */
+static void leave(ir_node *node, void *ctx)
+{
+	walk_env_t *const env = (walk_env_t*)ctx;
+	unsigned    const idx = get_irn_idx(node);
+	assert(!env->left[idx]);
+	/* the graph has no loops */
+	if (env->outs) {
+		for (unsigned i = 0, n = get_irn_n_outs(node); i < n; ++i)
+			assert(env->left[get_irn_idx(get_irn_out(node, i))]);
+	} else {
+		for (int i = 0, n = get_irn_arity(node); i < n; ++i) {
+			ir_node *pred = get_irn_n(node, i);
+			if (env->blocks)
+				pred = get_nodes_block(pred);
+			assert(env->left[get_irn_idx(pred)]);
+		}
+	}
+	env->left[idx] = true;
+	++env->n_post;
+}
+
+static void reset_env(walk_env_t *env, ir_graph *irg, bool outs, bool blocks)
+{
+	unsigned const n = get_irg_last_idx(irg);
+	free(env->entered);
+	free(env->left);
+	env->entered = (bool*)calloc(n, sizeof(bool));
+	env->left    = (bool*)calloc(n, sizeof(bool));
+	env->n_pre   = 0;
+	env->n_post  = 0;
+	env->outs    = outs;
+	env->blocks  = blocks;
+}
+
+static void *walk_deep(void *data)
+{
+	ir_graph  *irg = (ir_graph*)data;
+	walk_env_t env = { NULL, NULL, 0, 0, false, false };
+
+	reset_env(&env, irg, false, false);
+	irg_walk_graph(irg, enter, leave, &env);
+	assert(env.n_pre == env.n_post && env.n_pre >= 2 * DEPTH);
+	unsigned const n_nodes = env.n_pre;
+
+	reset_env(&env, irg, false, false);
+	irg_walk_graph(irg, enter, NULL, &env);
+	assert(env.n_pre == n_nodes);
+	reset_env(&env, irg, false, false);
+	irg_walk_graph(irg, NULL, leave, &env);
+	assert(env.n_post == n_nodes);
+	reset_env(&env, irg, false, false);
+	irg_walk_in_or_dep_graph(irg, enter, leave, &env);
+	assert(env.n_pre == n_nodes && env.n_post == n_nodes);
+
+	reset_env(&env, irg, false, true);
+	irg_block_walk_graph(irg, enter, leave, &env);
+	assert(env.n_pre == env.n_post && env.n_pre >= DEPTH);
+	unsigned const n_blocks = env.n_pre;
+
+	assure_irg_outs(irg);
+	reset_env(&env, irg, true, false);
+	irg_out_walk(get_irg_start(irg), enter, leave, &env);
+	assert(env.n_pre == env.n_post && env.n_pre >= DEPTH);
+	reset_env(&env, irg, true, true);
+	irg_out_block_walk(get_irg_start_block(irg), enter, NULL, &env);
+	assert(env.n_pre == n_blocks);
+
+	free(env.entered);
+	free(env.left);
+	return NULL;
+}
+
+int main(void)
+{
+	ir_init();
+	ir_graph *irg = build_graph();
+
+	/* walk on a thread with a small stack */
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, STACK_SIZE);
+	pthread_t thread;
+	int res = pthread_create(&thread, &attr, walk_deep, irg);
+	assert(res == 0);
+	res = pthread_join(thread, NULL);
+	assert(res == 0);
+	(void)res;
+	pthread_attr_destroy(&attr);
+
+	ir_finish();
+	return 0;
+}
@@ -0,0 +1,168 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "firm.h"
+
+/* int counter = 42;
+ * const char message[] = "say \"hi\"\n";
+ * int f(int a, int b)
+ * {
+ *   int r = a / (b | 1) + counter;
+ *   if (a < b) r = g(message, r);
+ *   return r;
+ * } */
+static void build_program(void)
+{
+	ir_mode *Is    = get_modeIs();
+	ir_type *t_int = new_type_primitive(Is);
+	ir_type *t_chr = new_type_primitive(get_modeBs());
+	ir_type *t_ptr = new_type_pointer(t_chr);
+
+	ir_entity *counter = new_global_entity(get_glob_type(),
+	                                       new_id_from_str("counter"), t_int,
+	                                       ir_visibility_external,
+	                                       IR_LINKAGE_DEFAULT);
+	set_entity_initializer(counter,
+	                       create_initializer_tarval(new_tarval_from_long(42, Is)));
+
+	static const char text[] = "say \"hi\"\n";
+	size_t const   len       = sizeof(text);
+	ir_type       *t_text    = new_type_array(t_chr, len);
+	ir_entity     *message   = new_global_entity(get_glob_type(),
+	                                             new_id_from_str("message"),
+	                                             t_text, ir_visibility_local,
+	                                             IR_LINKAGE_CONSTANT);
+	ir_initializer_t *init = create_initializer_compound(len);
+	for (size_t i = 0; i < len; ++i) {
+		ir_tarval *tv = new_tarval_from_long(text[i], get_modeBs());
+		set_initializer_compound_value(init, i, create_initializer_tarval(tv));
+	}
+	set_entity_initializer(message, init);
+
+	ir_type *gt = new_type_method(2, 1, false);
+	set_method_param_type(gt, 0, t_ptr);
+	set_method_param_type(gt, 1, t_int);
+	set_method_res_type(gt, 0, t_int);
+	ir_entity *g = new_global_entity(get_glob_type(), new_id_from_str("g"), gt,
+	                                 ir_visibility_external,
+	                                 IR_LINKAGE_DEFAULT);
+
+	ir_type *ft = new_type_method(2, 1, false);
+	set_method_param_type(ft, 0, t_int);
+	set_method_param_type(ft, 1, t_int);
+	set_method_res_type(ft, 0, t_int);
+	ir_entity *f = new_global_entity(get_glob_type(), new_id_from_str("f"), ft,
+	                                 ir_visibility_external,
+	                                 IR_LINKAGE_DEFAULT);
+	set_entity_ld_ident(f, new_id_from_str("f$binary"));
+	ir_graph *irg = new_ir_graph(f, 1);
+	set_current_ir_graph(irg);
+
+	ir_node *a   = new_Proj(get_irg_args(irg), Is, 0);
+	ir_node *b   = new_Proj(get_irg_args(irg), Is, 1);
+	ir_node *div = new_Div(get_store(), a, new_Or(b, new_Const_long(Is, 1)),
+	                       false);
+	set_store(new_Proj(div, mode_M, pn_Div_M));
+	ir_node *ld  = new_Load(get_store(), new_Address(counter), Is, t_int,
+	                        cons_none);
+	set_store(new_Proj(ld, mode_M, pn_Load_M));
+	set_value(0, new_Add(new_Proj(div, Is, pn_Div_res),
+	                     new_Proj(ld, Is, pn_Load_res)));
+
+	ir_node *cond = new_Cond(new_Cmp(a, b, ir_relation_less));
+	ir_node *then = new_immBlock();
+	add_immBlock_pred(then, new_Proj(cond, mode_X, pn_Cond_true));
+	mature_immBlock(then);
+	set_cur_block(then);
+	ir_node *in[]  = { new_Address(message), get_value(0, Is) };
+	ir_node *call  = new_Call(get_store(), new_Address(g), 2, in, gt);
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	set_value(0, new_Proj(new_Proj(call, mode_T, pn_Call_T_result), Is, 0));
+	ir_node *jmp = new_Jmp();
+
+	ir_node *join = new_immBlock();
+	add_immBlock_pred(join, new_Proj(cond, mode_X, pn_Cond_false));
+	add_immBlock_pred(join, jmp);
+	mature_immBlock(join);
+	set_cur_block(join);
+	ir_node *res[] = { get_value(0, Is) };
+	ir_node *ret   = new_Return(get_store(), 1, res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	assert(irg_verify(irg));
+}
+
+/* returns the contents of file as zero terminated string */
+static char *read_all(FILE *file)
+{
+	long const size = ftell(file);
+	assert(size > 0);
+	rewind(file);
+	char *buffer = (char*)malloc(size + 1);
+	size_t const n_read = fread(buffer, 1, size, file);
+	assert(n_read == (size_t)size);
+	(void)n_read;
+	buffer[size] = '\0';
+	return buffer;
+}
+
+static char *export_text(void)
+{
+	FILE *file = tmpfile();
+	assert(file != NULL);
+	ir_export_file(file);
+	char *text = read_all(file);
+	fclose(file);
+	return text;
+}
+
+/* imports the program from file into a new ir_prog and returns its textual
+ * form */
+static char *reimport(FILE *file, bool binary)
+{
+	set_irp(new_ir_prog("roundtrip"));
+	rewind(file);
+	int const res = binary ? ir_import_binary_file(file, "binary")
+	                       : ir_import_file(file, "text");
+	assert(res == 0);
+	(void)res;
+	char *const text = export_text();
+	/* the node number of the const graph depends on the nodes created
+	 * while reading */
+	char *const constirg = strstr(text, "\nconstirg ");
+	assert(constirg != NULL);
+	for (char *c = constirg + strlen("\nconstirg "); *c != ' '; ++c)
+		*c = '0';
+	return text;
+}
+
+int main(void)
+{
+	ir_init();
+	build_program();
+	char *const text = export_text();
+	FILE *const text_file = tmpfile();
+	assert(text_file != NULL);
+	fputs(text, text_file);
+	FILE *const binary_file = tmpfile();
+	assert(binary_file != NULL);
+	ir_export_binary_file(binary_file);
+	assert(!ferror(binary_file));
+
+	/* reading the binary form gives the same program as the textual one */
+	char *const text_text   = reimport(text_file, false);
+	char *const binary_text = reimport(binary_file, true);
+	if (strcmp(text_text, binary_text) != 0) {
+		fprintf(stderr, "binary roundtrip differs from the textual one\n");
+		return 1;
+	}
+	fclose(binary_file);
+	fclose(text_file);
+	free(binary_text);
+	free(text_text);
+	free(text);
+	return 0;
+}
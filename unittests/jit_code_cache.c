@@ -0,0 +1,228 @@
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "firm.h"
+#include "jit.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+
+#define N_CHAIN 4000
+
+typedef long (*func2)(long a, long b);
+
+static ir_graph *new_graph(const char *name, ir_node **a, ir_node **b)
+{
+	ir_type *t_long = new_type_primitive(get_modeLs());
+	ir_type *mt     = new_type_method(2, 1, false);
+	set_method_param_type(mt, 0, t_long);
+	set_method_param_type(mt, 1, t_long);
+	set_method_res_type(mt, 0, t_long);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str(name),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+	*a = new_Proj(get_irg_args(irg), get_modeLs(), 0);
+	*b = new_Proj(get_irg_args(irg), get_modeLs(), 1);
+	return irg;
+}
+
+static void finish_graph(ir_graph *irg, ir_node *res)
+{
+	ir_node *in[] = { res };
+	ir_node *ret  = new_Return(get_store(), 1, in);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+}
+
+/* long small(long a, long b) { return a * b + 7; } */
+static ir_graph *build_small(void)
+{
+	ir_node  *a;
+	ir_node  *b;
+	ir_graph *irg = new_graph("small", &a, &b);
+	finish_graph(irg, new_Add(new_Mul(a, b),
+	                          new_Const_long(get_modeLs(), 7)));
+	return irg;
+}
+
+static long ref_small(long a, long b)
+{
+	return a * b + 7;
+}
+
+/* long large(long a, long b)
+ * {
+ *   for (long i = 0; i < N_CHAIN; ++i) a = (a ^ b) + i;
+ *   return a;
+ * } fully unrolled, so it needs a mapping of its own */
+static ir_graph *build_large(void)
+{
+	ir_node  *a;
+	ir_node  *b;
+	ir_graph *irg = new_graph("large", &a, &b);
+	for (long i = 0; i < N_CHAIN; ++i)
+		a = new_Add(new_Eor(a, b), new_Const_long(get_modeLs(), i));
+	finish_graph(irg, a);
+	return irg;
+}
+
+static long ref_large(long a, long b)
+{
+	for (long i = 0; i < N_CHAIN; ++i)
+		a = (long)(((unsigned long)a ^ (unsigned long)b) + (unsigned long)i);
+	return a;
+}
+
+static void check(func2 small, func2 large)
+{
+	static const long values[] = { 0, 1, -3, 1000003, -0x7fffffffffffffffl };
+	size_t const n_values = sizeof(values) / sizeof(values[0]);
+	for (size_t i = 0; i < n_values; ++i) {
+		for (size_t j = 0; j < n_values; ++j) {
+			long const a = values[i];
+			long const b = values[j];
+			if (small != NULL)
+				assert(small(a, b) == ref_small(a, b));
+			if (large != NULL)
+				assert(large(a, b) == ref_large(a, b));
+		}
+	}
+}
+
+static bool is_page_aligned(void *code)
+{
+	return (uintptr_t)code % (uintptr_t)sysconf(_SC_PAGESIZE) == 0;
+}
+
+/* returns whether the page at code can be read, written or executed */
+static bool is_accessible(void *code)
+{
+	FILE *maps = fopen("/proc/self/maps", "r");
+	assert(maps != NULL);
+	char line[512];
+	bool found      = false;
+	bool accessible = false;
+	while (fgets(line, sizeof(line), maps) != NULL) {
+		unsigned long begin;
+		unsigned long end;
+		char          perms[5];
+		if (sscanf(line, "%lx-%lx %4s", &begin, &end, perms) != 3)
+			continue;
+		if ((uintptr_t)code < begin || (uintptr_t)code >= end)
+			continue;
+		found      = true;
+		accessible = strncmp(perms, "---", 3) != 0;
+		break;
+	}
+	fclose(maps);
+	assert(found);
+	(void)found;
+	return accessible;
+}
+
+int main(void)
+{
+	ir_init();
+	if (!be_parse_arg("isa=amd64"))
+		return 1;
+	ir_graph *small_irg = build_small();
+	ir_graph *large_irg = build_large();
+	be_lower_for_target();
+
+	ir_jit_segment_t  *segment = be_new_jit_segment();
+	ir_jit_function_t *small   = be_jit_compile(segment, small_irg);
+	ir_jit_function_t *large   = be_jit_compile(segment, large_irg);
+	assert(small != NULL && large != NULL);
+	unsigned const small_size = be_get_function_size(small);
+	unsigned const large_size = be_get_function_size(large);
+
+	ir_jit_code_cache_t      *cache = be_new_jit_code_cache();
+	ir_jit_code_cache_stats_t stats;
+
+	/* every function has pages of its own */
+	enum { N_FUNCS = 100 };
+	void *code[N_FUNCS];
+	for (int i = 0; i < N_FUNCS; ++i) {
+		code[i] = be_jit_code_cache_add(cache, small);
+		assert(code[i] != NULL && is_page_aligned(code[i]));
+		check((func2)code[i], NULL);
+	}
+	void *large_code = be_jit_code_cache_add(cache, large);
+	assert(large_code != NULL && is_page_aligned(large_code));
+	check((func2)code[0], (func2)large_code);
+	be_jit_code_cache_get_stats(cache, &stats);
+	assert(stats.n_functions == N_FUNCS + 1);
+	assert(stats.n_added == N_FUNCS + 1);
+	assert(stats.code_bytes == N_FUNCS * small_size + large_size);
+
+	/* released blocks are inaccessible and reused */
+	be_jit_code_cache_free(cache, code[7]);
+	be_jit_code_cache_free(cache, large_code);
+	assert(!is_accessible(code[7]));
+	assert(is_accessible(code[6]) && is_accessible(code[8]));
+	be_jit_code_cache_get_stats(cache, &stats);
+	assert(stats.n_functions == N_FUNCS - 1);
+	assert(stats.code_bytes == (N_FUNCS - 1) * small_size);
+	size_t const mapped = stats.mapped_bytes;
+	code[7] = be_jit_code_cache_add(cache, small);
+	assert(code[7] != NULL);
+	for (int i = 0; i < N_FUNCS; ++i)
+		check((func2)code[i], NULL);
+	be_jit_code_cache_get_stats(cache, &stats);
+	assert(stats.mapped_bytes == mapped);
+
+	/* a reset releases all functions but keeps the chunks */
+	be_jit_code_cache_reset(cache);
+	for (int i = 0; i < N_FUNCS; ++i)
+		assert(!is_accessible(code[i]));
+	be_jit_code_cache_get_stats(cache, &stats);
+	assert(stats.n_functions == 0);
+	assert(stats.code_bytes == 0 && stats.block_bytes == 0);
+	assert(stats.free_bytes == stats.mapped_bytes);
+	assert(stats.mapped_bytes == mapped);
+
+	/* adding functions again reuses the memory */
+	for (int i = 0; i < N_FUNCS; ++i) {
+		code[i] = be_jit_code_cache_add(cache, small);
+		assert(code[i] != NULL && is_page_aligned(code[i]));
+	}
+	large_code = be_jit_code_cache_add(cache, large);
+	assert(large_code != NULL);
+	for (int i = 0; i < N_FUNCS; ++i)
+		check((func2)code[i], (func2)large_code);
+	be_jit_code_cache_get_stats(cache, &stats);
+	assert(stats.n_functions == N_FUNCS + 1);
+	assert(stats.n_added == 2 * N_FUNCS + 3);
+	/* only the large function needed new memory */
+	size_t const page_size = (size_t)sysconf(_SC_PAGESIZE);
+	assert(stats.mapped_bytes
+	       == mapped + stats.block_bytes - N_FUNCS * page_size);
+
+	/* everything released one by one leaves no function behind */
+	for (int i = 0; i < N_FUNCS; ++i)
+		be_jit_code_cache_free(cache, code[i]);
+	be_jit_code_cache_free(cache, large_code);
+	be_jit_code_cache_get_stats(cache, &stats);
+	assert(stats.n_functions == 0 && stats.code_bytes == 0);
+	assert(stats.free_bytes == stats.mapped_bytes);
+
+	be_destroy_jit_code_cache(cache);
+	be_destroy_jit_segment(segment);
+	ir_finish();
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	return 0;
+}
+
+#endif
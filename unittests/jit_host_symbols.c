@@ -0,0 +1,132 @@
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "firm.h"
+#include "jit.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+
+/* The jit compiled code is placed by mmap, usually far away from the data
+ * and code of this program. */
+static int host_counter = 5;
+
+static long host_add(long a, long b)
+{
+	return a * 10 + b;
+}
+
+static ir_entity *new_method_entity(const char *name, ir_type *type, int n_params)
+{
+	ir_type *mt = new_type_method(n_params, 1, false);
+	for (int i = 0; i < n_params; ++i)
+		set_method_param_type(mt, i, type);
+	set_method_res_type(mt, 0, type);
+	return new_global_entity(get_glob_type(), new_id_from_str(name), mt,
+	                         ir_visibility_external, IR_LINKAGE_DEFAULT);
+}
+
+static void finish_graph(ir_graph *irg, ir_node *res)
+{
+	ir_node *in[] = { res };
+	ir_node *ret  = new_Return(get_store(), 1, in);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+}
+
+/* long f(long x) { host_counter += x; return host_add(x, host_counter); } */
+static ir_graph *build_host_access(ir_type *type, ir_entity *counter,
+                                   ir_entity *add)
+{
+	ir_mode  *Ls    = get_modeLs();
+	ir_mode  *Is    = get_modeIs();
+	ir_type  *t_int = get_entity_type(counter);
+	ir_graph *irg   = new_ir_graph(new_method_entity("f", type, 1), 0);
+	set_current_ir_graph(irg);
+
+	ir_node *x    = new_Proj(get_irg_args(irg), Ls, 0);
+	ir_node *addr = new_Address(counter);
+	ir_node *ld   = new_Load(get_store(), addr, Is, t_int, cons_none);
+	set_store(new_Proj(ld, mode_M, pn_Load_M));
+	ir_node *sum  = new_Add(new_Proj(ld, Is, pn_Load_res), new_Conv(x, Is));
+	ir_node *st   = new_Store(get_store(), addr, sum, t_int, cons_none);
+	set_store(new_Proj(st, mode_M, pn_Store_M));
+
+	ir_node *in[] = { x, new_Conv(sum, Ls) };
+	ir_node *call = new_Call(get_store(), new_Address(add), 2, in,
+	                         get_entity_type(add));
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	ir_node *res  = new_Proj(new_Proj(call, mode_T, pn_Call_T_result), Ls, 0);
+	finish_graph(irg, res);
+	return irg;
+}
+
+/* long g(long x) { asm("nop"); return x; } */
+static ir_graph *build_asm(ir_type *type)
+{
+	ir_graph *irg = new_ir_graph(new_method_entity("g", type, 1), 0);
+	set_current_ir_graph(irg);
+	ir_node *asmn = new_ASM(get_store(), 0, NULL, NULL, 0, NULL, 0, NULL,
+	                        new_id_from_str("nop"));
+	keep_alive(asmn);
+	finish_graph(irg, new_Proj(get_irg_args(irg), get_modeLs(), 0));
+	return irg;
+}
+
+int main(void)
+{
+	ir_init();
+	if (!be_parse_arg("isa=amd64"))
+		return 1;
+
+	ir_type   *t_long  = new_type_primitive(get_modeLs());
+	ir_type   *t_int   = new_type_primitive(get_modeIs());
+	ir_entity *counter = new_global_entity(get_glob_type(),
+	                                       new_id_from_str("host_counter"),
+	                                       t_int, ir_visibility_external,
+	                                       IR_LINKAGE_DEFAULT);
+	ir_entity *add     = new_method_entity("host_add", t_long, 2);
+	be_jit_set_entity_addr(counter, &host_counter);
+	be_jit_set_entity_addr(add, (void const*)host_add);
+
+	ir_graph *host_access = build_host_access(t_long, counter, add);
+	ir_graph *with_asm    = build_asm(t_long);
+	be_lower_for_target();
+
+	ir_jit_segment_t  *segment  = be_new_jit_segment();
+	ir_jit_function_t *function = be_jit_compile(segment, host_access);
+	assert(function != NULL);
+	unsigned const size   = be_get_function_size(function);
+	char          *buffer = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE,
+	                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	assert(buffer != MAP_FAILED);
+	be_emit_function(buffer, function);
+	int res = mprotect(buffer, size, PROT_READ | PROT_EXEC);
+	assert(res == 0);
+
+	long (*const f)(long) = (long (*)(long))(void*)buffer;
+	assert(f(3) == 38);
+	assert(host_counter == 8);
+	assert(f(-8) == -80);
+	assert(host_counter == 0);
+
+	/* inline assembler is reported as an error instead of a panic */
+	assert(be_jit_compile(segment, with_asm) == NULL);
+
+	munmap(buffer, size);
+	be_destroy_jit_segment(segment);
+	ir_finish();
+	(void)res;
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,292 @@
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "firm.h"
+#include "jit.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+
+/* more values than amd64 has registers */
+#define N_VALUES 20
+
+typedef unsigned long (*func2)(unsigned long a, unsigned long b);
+
+/* The Phis of the loop swap their values, which needs a permutation at the
+ * end of the loop. */
+static unsigned long ref_swap(unsigned long a, unsigned long b)
+{
+	unsigned long const n = b & 15;
+	unsigned long       c = a ^ b;
+	for (unsigned long i = 0; i < n; ++i) {
+		unsigned long const t = a;
+		a = b + i;
+		b = c;
+		c = t;
+	}
+	return a * 3 + b * 5 + c;
+}
+
+/* Division, remainder and shifts need their operands in fixed registers. */
+static unsigned long ref_constrained(unsigned long a, unsigned long b)
+{
+	unsigned long const q = a / (b | 1);
+	unsigned long const r = a % (b | 3);
+	return q + r + (a << (b & 63)) + (b >> (a & 63)) + (q ^ r);
+}
+
+/* The values are live across the loop and have to be spilled. */
+static unsigned long ref_pressure(unsigned long a, unsigned long b)
+{
+	unsigned long v[N_VALUES];
+	for (unsigned long k = 0; k < N_VALUES; ++k)
+		v[k] = (a + k) * (b | 1);
+	unsigned long acc = a;
+	for (unsigned long i = 0; i < (b & 7) + 1; ++i) {
+		for (unsigned long k = 0; k < N_VALUES; ++k)
+			acc += v[k] ^ i;
+	}
+	return acc;
+}
+
+/* Floating point values are allocated in a register class of their own. */
+static unsigned long ref_float(unsigned long a, unsigned long b)
+{
+	double const x = (double)(a & 0xffff) + 0.5;
+	double const y = (double)(b & 0xff) + 1.25;
+	return (unsigned long)((x * y - x / y) * (x + 3.0)) + a;
+}
+
+static ir_node *new_Const_ulong(unsigned long value)
+{
+	return new_Const(new_tarval_from_long((long)value, get_modeLu()));
+}
+
+static ir_graph *new_graph(const char *name, ir_node **a, ir_node **b,
+                           int n_locs)
+{
+	ir_type *t_long = new_type_primitive(get_modeLu());
+	ir_type *mt     = new_type_method(2, 1, false);
+	set_method_param_type(mt, 0, t_long);
+	set_method_param_type(mt, 1, t_long);
+	set_method_res_type(mt, 0, t_long);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str(name),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, n_locs);
+	set_current_ir_graph(irg);
+	*a = new_Proj(get_irg_args(irg), get_modeLu(), 0);
+	*b = new_Proj(get_irg_args(irg), get_modeLu(), 1);
+	return irg;
+}
+
+static void finish_graph(ir_graph *irg, ir_node *res)
+{
+	ir_node *in[] = { res };
+	ir_node *ret  = new_Return(get_store(), 1, in);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+}
+
+/* Starts a loop running n times with the counter in local 0.  Returns the
+ * loop header, the loop body is the current block afterwards. */
+static ir_node *begin_loop(ir_node *n, ir_node **cond)
+{
+	set_value(0, new_Const_ulong(0));
+	ir_node *entry_jmp = new_Jmp();
+	ir_node *header    = new_immBlock();
+	add_immBlock_pred(header, entry_jmp);
+	set_cur_block(header);
+	*cond = new_Cond(new_Cmp(get_value(0, get_modeLu()), n, ir_relation_less));
+	ir_node *body = new_immBlock();
+	add_immBlock_pred(body, new_Proj(*cond, mode_X, pn_Cond_true));
+	mature_immBlock(body);
+	set_cur_block(body);
+	return header;
+}
+
+static void end_loop(ir_node *header, ir_node *cond)
+{
+	ir_node *i = get_value(0, get_modeLu());
+	set_value(0, new_Add(i, new_Const_ulong(1)));
+	add_immBlock_pred(header, new_Jmp());
+	mature_immBlock(header);
+	ir_node *exit = new_immBlock();
+	add_immBlock_pred(exit, new_Proj(cond, mode_X, pn_Cond_false));
+	mature_immBlock(exit);
+	set_cur_block(exit);
+}
+
+static ir_graph *build_swap(const char *name)
+{
+	ir_mode  *Lu = get_modeLu();
+	ir_node  *a;
+	ir_node  *b;
+	ir_graph *irg = new_graph(name, &a, &b, 4);
+	set_value(1, a);
+	set_value(2, b);
+	set_value(3, new_Eor(a, b));
+	ir_node *cond;
+	ir_node *header = begin_loop(new_And(b, new_Const_ulong(15)), &cond);
+	ir_node *i = get_value(0, Lu);
+	ir_node *t = get_value(1, Lu);
+	set_value(1, new_Add(get_value(2, Lu), i));
+	set_value(2, get_value(3, Lu));
+	set_value(3, t);
+	end_loop(header, cond);
+	ir_node *res = new_Add(new_Add(new_Mul(get_value(1, Lu), new_Const_ulong(3)),
+	                               new_Mul(get_value(2, Lu), new_Const_ulong(5))),
+	                       get_value(3, Lu));
+	finish_graph(irg, res);
+	return irg;
+}
+
+static ir_node *new_divmod(ir_node *a, ir_node *b, bool mod)
+{
+	if (mod) {
+		ir_node *node = new_Mod(get_store(), a, b, false);
+		set_store(new_Proj(node, mode_M, pn_Mod_M));
+		return new_Proj(node, get_modeLu(), pn_Mod_res);
+	}
+	ir_node *node = new_Div(get_store(), a, b, false);
+	set_store(new_Proj(node, mode_M, pn_Div_M));
+	return new_Proj(node, get_modeLu(), pn_Div_res);
+}
+
+static ir_graph *build_constrained(const char *name)
+{
+	ir_mode  *Iu = get_modeIu();
+	ir_node  *a;
+	ir_node  *b;
+	ir_graph *irg = new_graph(name, &a, &b, 0);
+	ir_node  *q   = new_divmod(a, new_Or(b, new_Const_ulong(1)), false);
+	ir_node  *r   = new_divmod(a, new_Or(b, new_Const_ulong(3)), true);
+	ir_node  *shl = new_Shl(a, new_Conv(new_And(b, new_Const_ulong(63)), Iu));
+	ir_node  *shr = new_Shr(b, new_Conv(new_And(a, new_Const_ulong(63)), Iu));
+	ir_node  *res = new_Add(new_Add(new_Add(new_Add(q, r), shl), shr),
+	                        new_Eor(q, r));
+	finish_graph(irg, res);
+	return irg;
+}
+
+static ir_graph *build_pressure(const char *name)
+{
+	ir_mode  *Lu = get_modeLu();
+	ir_node  *a;
+	ir_node  *b;
+	ir_graph *irg = new_graph(name, &a, &b, 2);
+	ir_node  *v[N_VALUES];
+	for (unsigned long k = 0; k < N_VALUES; ++k)
+		v[k] = new_Mul(new_Add(a, new_Const_ulong(k)),
+		               new_Or(b, new_Const_ulong(1)));
+	set_value(1, a);
+	ir_node *n = new_Add(new_And(b, new_Const_ulong(7)), new_Const_ulong(1));
+	ir_node *cond;
+	ir_node *header = begin_loop(n, &cond);
+	ir_node *i   = get_value(0, Lu);
+	ir_node *acc = get_value(1, Lu);
+	for (unsigned long k = 0; k < N_VALUES; ++k)
+		acc = new_Add(acc, new_Eor(v[k], i));
+	set_value(1, acc);
+	end_loop(header, cond);
+	finish_graph(irg, get_value(1, Lu));
+	return irg;
+}
+
+static ir_graph *build_float(const char *name)
+{
+	ir_mode  *Lu = get_modeLu();
+	ir_node  *a;
+	ir_node  *b;
+	ir_graph *irg = new_graph(name, &a, &b, 0);
+	ir_node  *x   = new_Add(new_Conv(new_And(a, new_Const_ulong(0xffff)), mode_D),
+	                        new_Const(new_tarval_from_double(0.5, mode_D)));
+	ir_node  *y   = new_Add(new_Conv(new_And(b, new_Const_ulong(0xff)), mode_D),
+	                        new_Const(new_tarval_from_double(1.25, mode_D)));
+	ir_node  *div = new_Div(get_store(), x, y, false);
+	set_store(new_Proj(div, mode_M, pn_Div_M));
+	ir_node  *d   = new_Sub(new_Mul(x, y), new_Proj(div, mode_D, pn_Div_res));
+	ir_node  *m   = new_Mul(d, new_Add(x, new_Const(new_tarval_from_double(3.0, mode_D))));
+	finish_graph(irg, new_Add(new_Conv(m, Lu), a));
+	return irg;
+}
+
+static void *emit(ir_jit_function_t *function)
+{
+	assert(function != NULL);
+	unsigned const size   = be_get_function_size(function);
+	char          *buffer = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE,
+	                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	assert(buffer != MAP_FAILED);
+	be_emit_function(buffer, function);
+	int res = mprotect(buffer, size, PROT_READ | PROT_EXEC);
+	assert(res == 0);
+	(void)res;
+	return buffer;
+}
+
+int main(void)
+{
+	ir_init();
+	if (!be_parse_arg("isa=amd64") || !be_parse_arg("regalloc=linear")
+	    || !be_parse_arg("verify=1"))
+		return 1;
+
+	/* each tier compiles its own copy of the graphs */
+	enum { N_KERNELS = 4, N_TIERS = 2 };
+	static const ir_jit_tier_t tiers[N_TIERS] = {
+		ir_jit_tier_fast, ir_jit_tier_optimize,
+	};
+	static func2 const refs[N_KERNELS] = {
+		ref_swap, ref_constrained, ref_pressure, ref_float,
+	};
+	ir_graph *graphs[N_TIERS][N_KERNELS];
+	for (int t = 0; t < N_TIERS; ++t) {
+		char name[32];
+		snprintf(name, sizeof(name), "swap%d", t);
+		graphs[t][0] = build_swap(name);
+		snprintf(name, sizeof(name), "constrained%d", t);
+		graphs[t][1] = build_constrained(name);
+		snprintf(name, sizeof(name), "pressure%d", t);
+		graphs[t][2] = build_pressure(name);
+		snprintf(name, sizeof(name), "float%d", t);
+		graphs[t][3] = build_float(name);
+	}
+	be_lower_for_target();
+
+	static const unsigned long values[] = {
+		0, 1, 6, 7, 13, 1000003, 0x8000000000000000ul, 0xfffffffffffffffful,
+	};
+	size_t const n_values = sizeof(values) / sizeof(values[0]);
+
+	ir_jit_segment_t *segment = be_new_jit_segment();
+	for (int t = 0; t < N_TIERS; ++t) {
+		for (int k = 0; k < N_KERNELS; ++k) {
+			func2 const f = (func2)emit(be_jit_compile_tier(segment,
+			                                                graphs[t][k],
+			                                                tiers[t]));
+			for (size_t i = 0; i < n_values; ++i) {
+				for (size_t j = 0; j < n_values; ++j) {
+					unsigned long const a = values[i];
+					unsigned long const b = values[j];
+					assert(f(a, b) == refs[k](a, b));
+				}
+			}
+		}
+	}
+	be_destroy_jit_segment(segment);
+
+	ir_finish();
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	return 0;
+}
+
+#endif
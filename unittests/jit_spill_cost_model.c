@@ -0,0 +1,149 @@
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "firm.h"
+#include "jit.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+
+/* more values than amd64 has registers */
+#define N_VALUES 24
+
+typedef unsigned long (*func2)(unsigned long a, unsigned long b);
+
+/* The values are live across the loop, so the spiller has to evict some of
+ * them in the loop.  The constants can be rematerialized for free and half of
+ * the values die after the loop. */
+static unsigned long ref_pressure(unsigned long a, unsigned long b)
+{
+	unsigned long v[N_VALUES];
+	for (unsigned long k = 0; k < N_VALUES; ++k)
+		v[k] = (a + k) * (b | 1);
+	long const    n   = (long)(b & 7) + 1;
+	unsigned long acc = a;
+	for (long i = 0; i < n; ++i) {
+		for (unsigned long k = 0; k < N_VALUES; ++k)
+			acc += (v[k] ^ (unsigned long)i) * (1000 + k * k);
+	}
+	for (unsigned long k = 0; k < N_VALUES / 2; ++k)
+		acc += v[k] * (k + 1);
+	return acc;
+}
+
+static ir_node *new_Const_ulong(unsigned long value)
+{
+	return new_Const(new_tarval_from_long((long)value, get_modeLu()));
+}
+
+static ir_graph *build_pressure(void)
+{
+	ir_mode *Lu     = get_modeLu();
+	ir_type *t_long = new_type_primitive(Lu);
+	ir_type *mt     = new_type_method(2, 1, false);
+	set_method_param_type(mt, 0, t_long);
+	set_method_param_type(mt, 1, t_long);
+	set_method_res_type(mt, 0, t_long);
+	ir_entity *ent = new_global_entity(get_glob_type(),
+	                                   new_id_from_str("pressure"), mt,
+	                                   ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, 2);
+	set_current_ir_graph(irg);
+
+	ir_node *a = new_Proj(get_irg_args(irg), Lu, 0);
+	ir_node *b = new_Proj(get_irg_args(irg), Lu, 1);
+	ir_node *v[N_VALUES];
+	for (unsigned long k = 0; k < N_VALUES; ++k)
+		v[k] = new_Mul(new_Add(a, new_Const_ulong(k)),
+		               new_Or(b, new_Const_ulong(1)));
+	ir_node *n = new_Conv(new_Add(new_And(b, new_Const_ulong(7)),
+	                              new_Const_ulong(1)), get_modeLs());
+	set_value(0, new_Const_long(get_modeLs(), 0));
+	set_value(1, a);
+	ir_node *entry_jmp = new_Jmp();
+
+	ir_node *header = new_immBlock();
+	add_immBlock_pred(header, entry_jmp);
+	set_cur_block(header);
+	ir_node *i    = get_value(0, get_modeLs());
+	ir_node *cond = new_Cond(new_Cmp(i, n, ir_relation_less));
+
+	ir_node *body = new_immBlock();
+	add_immBlock_pred(body, new_Proj(cond, mode_X, pn_Cond_true));
+	mature_immBlock(body);
+	set_cur_block(body);
+	ir_node *acc = get_value(1, Lu);
+	ir_node *iu  = new_Conv(i, Lu);
+	for (unsigned long k = 0; k < N_VALUES; ++k)
+		acc = new_Add(acc, new_Mul(new_Eor(v[k], iu),
+		                           new_Const_ulong(1000 + k * k)));
+	set_value(1, acc);
+	set_value(0, new_Add(i, new_Const_long(get_modeLs(), 1)));
+	add_immBlock_pred(header, new_Jmp());
+	mature_immBlock(header);
+
+	ir_node *exit = new_immBlock();
+	add_immBlock_pred(exit, new_Proj(cond, mode_X, pn_Cond_false));
+	mature_immBlock(exit);
+	set_cur_block(exit);
+	ir_node *res = get_value(1, Lu);
+	for (unsigned long k = 0; k < N_VALUES / 2; ++k)
+		res = new_Add(res, new_Mul(v[k], new_Const_ulong(k + 1)));
+	ir_node *in[] = { res };
+	ir_node *ret  = new_Return(get_store(), 1, in);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+static void *emit(ir_jit_function_t *function)
+{
+	assert(function != NULL);
+	unsigned const size   = be_get_function_size(function);
+	char          *buffer = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE,
+	                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	assert(buffer != MAP_FAILED);
+	be_emit_function(buffer, function);
+	int res = mprotect(buffer, size, PROT_READ | PROT_EXEC);
+	assert(res == 0);
+	(void)res;
+	return buffer;
+}
+
+int main(void)
+{
+	ir_init();
+	if (!be_parse_arg("isa=amd64") || !be_parse_arg("spill-algo=remat")
+	    || !be_parse_arg("verify=1"))
+		return 1;
+	ir_graph *irg = build_pressure();
+	be_lower_for_target();
+
+	ir_jit_segment_t *segment = be_new_jit_segment();
+	func2 const       f       = (func2)emit(be_jit_compile(segment, irg));
+
+	static const unsigned long values[] = {
+		0, 1, 6, 7, 1000003, 0x8000000000000000ul, 0xfffffffffffffffful,
+	};
+	size_t const n_values = sizeof(values) / sizeof(values[0]);
+	for (size_t i = 0; i < n_values; ++i) {
+		for (size_t j = 0; j < n_values; ++j)
+			assert(f(values[i], values[j]) == ref_pressure(values[i], values[j]));
+	}
+
+	be_destroy_jit_segment(segment);
+	ir_finish();
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,167 @@
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "firm.h"
+#include "jit.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+
+/* The amd64 backend implements these with two-address instructions whose
+ * second operand is read after the result register was written: punpckldq
+ * and subpd for the unsigned conversion, sub, divs and the shifts. */
+static unsigned long ref_convert(unsigned long a, unsigned long b)
+{
+	unsigned long d = ((a >> (b & 63)) ^ (b << 13)) / (b | 1);
+	return (unsigned long)(double)d + a % (b | 3) + ~a;
+}
+
+static double ref_divide(double a, double b, unsigned long c)
+{
+	return (a / b - (double)c) / ((double)c + 1.5) - a;
+}
+
+static ir_graph *new_graph(const char *name, ir_type *res, int n_params,
+                           ir_type **params)
+{
+	ir_type *mt = new_type_method(n_params, 1, false);
+	for (int i = 0; i < n_params; ++i)
+		set_method_param_type(mt, i, params[i]);
+	set_method_res_type(mt, 0, res);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str(name),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+	return irg;
+}
+
+static void finish_graph(ir_graph *irg, ir_node *res)
+{
+	ir_node *in[] = { res };
+	ir_node *ret  = new_Return(get_store(), 1, in);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+}
+
+static ir_node *new_div(ir_node *a, ir_node *b)
+{
+	ir_node *div = new_Div(get_store(), a, b, false);
+	set_store(new_Proj(div, mode_M, pn_Div_M));
+	return new_Proj(div, get_irn_mode(a), pn_Div_res);
+}
+
+static ir_graph *build_convert(const char *name, ir_type *t_ulong)
+{
+	ir_mode  *Lu       = get_modeLu();
+	ir_type  *params[] = { t_ulong, t_ulong };
+	ir_graph *irg      = new_graph(name, t_ulong, 2, params);
+	ir_node  *a        = new_Proj(get_irg_args(irg), Lu, 0);
+	ir_node  *b        = new_Proj(get_irg_args(irg), Lu, 1);
+	ir_node  *count    = new_Conv(new_And(b, new_Const_long(Lu, 63)),
+	                              get_modeIu());
+	ir_node  *s        = new_Shr(a, count);
+	ir_node  *t        = new_Shl(b, new_Const_long(get_modeIu(), 13));
+	ir_node  *d        = new_div(new_Eor(s, t),
+	                             new_Or(b, new_Const_long(Lu, 1)));
+	ir_node  *mod      = new_Mod(get_store(), a,
+	                             new_Or(b, new_Const_long(Lu, 3)), false);
+	set_store(new_Proj(mod, mode_M, pn_Mod_M));
+	ir_node  *m        = new_Proj(mod, Lu, pn_Mod_res);
+	ir_node  *c        = new_Conv(new_Conv(d, mode_D), Lu);
+	finish_graph(irg, new_Add(new_Sub(c, new_Minus(m)), new_Not(a)));
+	return irg;
+}
+
+static ir_graph *build_divide(const char *name, ir_type *t_double,
+                              ir_type *t_ulong)
+{
+	ir_type  *params[] = { t_double, t_double, t_ulong };
+	ir_graph *irg      = new_graph(name, t_double, 3, params);
+	ir_node  *a        = new_Proj(get_irg_args(irg), mode_D, 0);
+	ir_node  *b        = new_Proj(get_irg_args(irg), mode_D, 1);
+	ir_node  *c        = new_Conv(new_Proj(get_irg_args(irg), get_modeLu(), 2),
+	                              mode_D);
+	ir_node  *num      = new_Sub(new_div(a, b), c);
+	ir_node  *den      = new_Add(c, new_Const(new_tarval_from_double(1.5, mode_D)));
+	finish_graph(irg, new_Sub(new_div(num, den), a));
+	return irg;
+}
+
+static void *emit(ir_jit_function_t *function)
+{
+	assert(function != NULL);
+	unsigned const size   = be_get_function_size(function);
+	char          *buffer = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE,
+	                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	assert(buffer != MAP_FAILED);
+	be_emit_function(buffer, function);
+	int res = mprotect(buffer, size, PROT_READ | PROT_EXEC);
+	assert(res == 0);
+	(void)res;
+	return buffer;
+}
+
+int main(void)
+{
+	ir_init();
+	if (!be_parse_arg("isa=amd64"))
+		return 1;
+
+	ir_type *t_ulong  = new_type_primitive(get_modeLu());
+	ir_type *t_double = new_type_primitive(mode_D);
+	/* each tier compiles its own copy of the graphs with its own register
+	 * allocator */
+	ir_graph *convert[] = {
+		build_convert("convert_fast", t_ulong),
+		build_convert("convert_optimize", t_ulong),
+	};
+	ir_graph *divide[] = {
+		build_divide("divide_fast", t_double, t_ulong),
+		build_divide("divide_optimize", t_double, t_ulong),
+	};
+	be_lower_for_target();
+
+	static const unsigned long values[] = {
+		0, 1, 7, 64, 1000003, 0x8000000000000000ul, 0xfffffffffffffffful,
+	};
+	size_t const n_values = sizeof(values) / sizeof(values[0]);
+
+	ir_jit_segment_t *segment = be_new_jit_segment();
+	static const ir_jit_tier_t tiers[] = {
+		ir_jit_tier_fast, ir_jit_tier_optimize,
+	};
+	for (size_t t = 0; t < sizeof(tiers) / sizeof(tiers[0]); ++t) {
+		unsigned long (*const f)(unsigned long, unsigned long)
+			= (unsigned long (*)(unsigned long, unsigned long))
+			  emit(be_jit_compile_tier(segment, convert[t], tiers[t]));
+		double (*const g)(double, double, unsigned long)
+			= (double (*)(double, double, unsigned long))
+			  emit(be_jit_compile_tier(segment, divide[t], tiers[t]));
+		for (size_t i = 0; i < n_values; ++i) {
+			for (size_t j = 0; j < n_values; ++j) {
+				unsigned long const a = values[i];
+				unsigned long const b = values[j];
+				assert(f(a, b) == ref_convert(a, b));
+				double const x = (double)a - 17.25;
+				double const y = (double)b + 0.5;
+				assert(g(x, y, a) == ref_divide(x, y, a));
+			}
+		}
+	}
+	be_destroy_jit_segment(segment);
+
+	ir_finish();
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,242 @@
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "firm.h"
+#include "jit.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+
+/* Each kernel is compiled once vectorized and once scalar. Both versions run
+ * on the same data for trip counts that leave every possible number of
+ * iterations to the scalar epilogue. */
+typedef enum kernel_t {
+	K_SAXPY, /* y[i] = a * x[i] + y[i], y = x + 64 */
+	K_SUM,   /* r += x[i] * 3 + i */
+	K_XOR,   /* d[i] = d[i + 64] ^ 0x5a, bytes */
+	K_FAR,   /* x[i] = x[i + 8] * 2 */
+	K_DEP,   /* x[i + 1] = x[i] + 1, must stay scalar */
+	K_COUNT,
+} kernel_t;
+
+static ir_mode *offset_mode;
+static ir_type *t_int;
+static ir_type *t_byte;
+
+static ir_node *load(ir_node *ptr, ir_mode *mode, ir_type *type)
+{
+	ir_node *ld = new_Load(get_store(), ptr, mode, type, cons_none);
+	set_store(new_Proj(ld, mode_M, pn_Load_M));
+	return new_Proj(ld, mode, pn_Load_res);
+}
+
+static void store(ir_node *ptr, ir_node *value, ir_type *type)
+{
+	ir_node *st = new_Store(get_store(), ptr, value, type, cons_none);
+	set_store(new_Proj(st, mode_M, pn_Store_M));
+}
+
+/* returns the address of base[i * size + offset] */
+static ir_node *element(ir_node *base, ir_node *i, long size, long offset)
+{
+	ir_node *off = new_Mul(new_Conv(i, offset_mode),
+	                       new_Const_long(offset_mode, size));
+	if (offset != 0)
+		off = new_Add(off, new_Const_long(offset_mode, offset));
+	return new_Add(base, off);
+}
+
+/* int kernel(void *p, int a, int n)
+ * {
+ *   int r = 7;
+ *   if (0 < n) { int i = 0; do { ... } while (++i < n); }
+ *   return r;
+ * } */
+static ir_graph *build_kernel(kernel_t kernel, const char *name)
+{
+	ir_type *mt = new_type_method(3, 1, false);
+	set_method_param_type(mt, 0, new_type_pointer(t_int));
+	set_method_param_type(mt, 1, t_int);
+	set_method_param_type(mt, 2, t_int);
+	set_method_res_type(mt, 0, t_int);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str(name),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, 2);
+	set_current_ir_graph(irg);
+
+	ir_mode *Is   = get_modeIs();
+	ir_node *args = get_irg_args(irg);
+	ir_node *p    = new_Proj(args, get_modeP(), 0);
+	ir_node *a    = new_Proj(args, Is, 1);
+	ir_node *n    = new_Proj(args, Is, 2);
+	set_value(0, new_Const_long(Is, 0));
+	set_value(1, new_Const_long(Is, 7));
+	ir_node *guard = new_Cond(new_Cmp(new_Const_long(Is, 0), n,
+	                                  ir_relation_less));
+
+	ir_node *body = new_immBlock();
+	add_immBlock_pred(body, new_Proj(guard, mode_X, pn_Cond_true));
+	set_cur_block(body);
+	ir_node *i    = get_value(0, Is);
+	ir_node *next = new_Add(i, new_Const_long(Is, 1));
+	switch (kernel) {
+	case K_SAXPY: {
+		ir_node *x = load(element(p, i, 4, 0), Is, t_int);
+		ir_node *y = element(p, i, 4, 256);
+		store(y, new_Add(new_Mul(a, x), load(y, Is, t_int)), t_int);
+		break;
+	}
+	case K_SUM: {
+		ir_node *x = load(element(p, i, 4, 0), Is, t_int);
+		ir_node *v = new_Add(new_Mul(x, new_Const_long(Is, 3)), i);
+		set_value(1, new_Add(get_value(1, Is), v));
+		break;
+	}
+	case K_XOR: {
+		ir_mode *Bu = get_modeBu();
+		ir_node *s  = load(element(p, i, 1, 64), Bu, t_byte);
+		store(element(p, i, 1, 0), new_Eor(s, new_Const_long(Bu, 0x5a)), t_byte);
+		break;
+	}
+	case K_FAR: {
+		ir_node *x = load(element(p, i, 4, 32), Is, t_int);
+		store(element(p, i, 4, 0), new_Mul(x, new_Const_long(Is, 2)), t_int);
+		break;
+	}
+	case K_DEP: {
+		ir_node *x = load(element(p, i, 4, 0), Is, t_int);
+		store(element(p, next, 4, 0), new_Add(x, new_Const_long(Is, 1)), t_int);
+		break;
+	}
+	case K_COUNT:
+		assert(false);
+	}
+	set_value(0, next);
+	ir_node *cond = new_Cond(new_Cmp(next, n, ir_relation_less));
+	add_immBlock_pred(body, new_Proj(cond, mode_X, pn_Cond_true));
+	mature_immBlock(body);
+
+	ir_node *exit = new_immBlock();
+	add_immBlock_pred(exit, new_Proj(guard, mode_X, pn_Cond_false));
+	add_immBlock_pred(exit, new_Proj(cond, mode_X, pn_Cond_false));
+	mature_immBlock(exit);
+	set_cur_block(exit);
+	ir_node *res[] = { get_value(1, Is) };
+	ir_node *ret   = new_Return(get_store(), 1, res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+static void find_vector(ir_node *node, void *env)
+{
+	bool *found = (bool*)env;
+	if (mode_is_vector(get_irn_mode(node)))
+		*found = true;
+}
+
+static bool has_vectors(ir_graph *irg)
+{
+	bool found = false;
+	irg_walk_graph(irg, find_vector, NULL, &found);
+	return found;
+}
+
+typedef int (*kernel_func)(void *p, int a, int n);
+
+static kernel_func compile(ir_jit_segment_t *segment, ir_graph *irg)
+{
+	ir_jit_function_t *function = be_jit_compile(segment, irg);
+	assert(function != NULL);
+	unsigned const size   = be_get_function_size(function);
+	char          *buffer = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE,
+	                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	assert(buffer != MAP_FAILED);
+	be_emit_function(buffer, function);
+	int res = mprotect(buffer, size, PROT_READ | PROT_EXEC);
+	assert(res == 0);
+	(void)res;
+	return (kernel_func)(void*)buffer;
+}
+
+static void fill(int *data, size_t n)
+{
+	unsigned seed = 12345;
+	for (size_t i = 0; i < n; ++i) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = (int)(seed >> 8) - (1 << 22);
+	}
+}
+
+int main(void)
+{
+	static const char *const names[K_COUNT][2] = {
+		{ "saxpy_vector", "saxpy_scalar" },
+		{ "sum_vector",   "sum_scalar"   },
+		{ "xor_vector",   "xor_scalar"   },
+		{ "far_vector",   "far_scalar"   },
+		{ "dep_vector",   "dep_scalar"   },
+	};
+
+	ir_init();
+	if (!be_parse_arg("isa=amd64"))
+		return 1;
+	be_get_backend_param();
+	offset_mode = get_reference_offset_mode(get_modeP());
+	t_int       = new_type_primitive(get_modeIs());
+	t_byte      = new_type_primitive(get_modeBu());
+
+	ir_graph *graphs[K_COUNT][2];
+	for (kernel_t k = 0; k < K_COUNT; ++k) {
+		for (int v = 0; v < 2; ++v) {
+			ir_graph *irg = build_kernel(k, names[k][v]);
+			optimize_graph_df(irg);
+			if (v == 0) {
+				do_loop_vectorization(irg);
+				assert(has_vectors(irg) == (k != K_DEP));
+				optimize_graph_df(irg);
+			}
+			assert(irg_verify(irg));
+			graphs[k][v] = irg;
+		}
+	}
+	be_lower_for_target();
+
+	ir_jit_segment_t *segment = be_new_jit_segment();
+	for (kernel_t k = 0; k < K_COUNT; ++k) {
+		kernel_func const vector = compile(segment, graphs[k][0]);
+		kernel_func const scalar = compile(segment, graphs[k][1]);
+		for (int n = 0; n <= 40; ++n) {
+			int data_vector[128];
+			int data_scalar[128];
+			fill(data_vector, 128);
+			memcpy(data_scalar, data_vector, sizeof(data_scalar));
+			int const a = n * 7 - 5;
+			int const res_vector = vector(data_vector, a, n);
+			int const res_scalar = scalar(data_scalar, a, n);
+			if (res_vector != res_scalar
+			    || memcmp(data_vector, data_scalar, sizeof(data_vector)) != 0) {
+				fprintf(stderr, "%s: different results for n=%d\n",
+				        names[k][0], n);
+				return 1;
+			}
+		}
+	}
+	be_destroy_jit_segment(segment);
+
+	ir_finish();
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,63 @@
+#include <assert.h>
+#include <stdbool.h>
+#include "firm.h"
+#include "irnode_t.h"
+
+/* int f(int a, int b) { return (a + b) * b; } */
+static ir_graph *build_graph(ir_node **add)
+{
+	ir_mode *Is    = get_modeIs();
+	ir_type *t_int = new_type_primitive(Is);
+	ir_type *mt    = new_type_method(2, 1, false);
+	set_method_param_type(mt, 0, t_int);
+	set_method_param_type(mt, 1, t_int);
+	set_method_res_type(mt, 0, t_int);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str("f"),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+
+	ir_node *a = new_Proj(get_irg_args(irg), Is, 0);
+	ir_node *b = new_Proj(get_irg_args(irg), Is, 1);
+	*add = new_Add(a, b);
+	ir_node *res[] = { new_Mul(*add, b) };
+	ir_node *ret   = new_Return(get_store(), 1, res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+int main(void)
+{
+	ir_init();
+
+	ir_node  *add;
+	ir_graph *irg = build_graph(&add);
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
+
+	/* a pass replaces a node and still holds the old one */
+	ir_node *const block = get_nodes_block(add);
+	ir_node *const eor   = new_r_Eor(block, get_Add_left(add),
+	                                 get_Add_right(add));
+	exchange(add, eor);
+	assert(is_Deleted(add));
+	size_t const memory = get_irg_node_memory(irg);
+
+	/* remove_tuples() confirms the properties in the middle of the pass and
+	 * must not release the deleted node */
+	clear_irg_properties(irg, IR_GRAPH_PROPERTY_NO_TUPLES);
+	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
+	                         | IR_GRAPH_PROPERTY_NO_TUPLES);
+	assert(get_irg_node_memory(irg) == memory);
+	assert(is_Deleted(add));
+
+	/* the end of the pass releases it */
+	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_ALL);
+	assert(get_irg_node_memory(irg) < memory);
+	assert(irg_verify(irg));
+
+	ir_finish();
+	return 0;
+}
@@ -0,0 +1,226 @@
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "firm.h"
+#include "jit.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+
+/* Each kernel is compiled once with and once without slp_vectorize() and
+ * both versions run on the same data. */
+typedef enum kernel_t {
+	K_ADD,   /* p[i] = p[i + 8] + p[i + 16] for i < 4 */
+	K_SPLAT, /* p[i] = p[i + 8] * a for i < 4 */
+	K_CONST, /* p[i] = p[i + 8] - (i + 1) for i < 4 */
+	K_BYTES, /* b[i] = b[i + 64] & 0x3c for i < 8, bytes */
+	K_CHAIN, /* p[i + 1] = p[i] + a for i < 4, must stay scalar */
+	K_MIXED, /* p[0] = p[8] + a, p[1] = p[9] * a, not isomorphic */
+	K_COUNT,
+} kernel_t;
+
+static ir_mode *offset_mode;
+static ir_type *t_int;
+static ir_type *t_byte;
+
+static ir_node *load(ir_node *ptr, ir_mode *mode, ir_type *type)
+{
+	ir_node *ld = new_Load(get_store(), ptr, mode, type, cons_none);
+	set_store(new_Proj(ld, mode_M, pn_Load_M));
+	return new_Proj(ld, mode, pn_Load_res);
+}
+
+static void store(ir_node *ptr, ir_node *value, ir_type *type)
+{
+	ir_node *st = new_Store(get_store(), ptr, value, type, cons_none);
+	set_store(new_Proj(st, mode_M, pn_Store_M));
+}
+
+/* returns the address of base + offset */
+static ir_node *element(ir_node *base, long offset)
+{
+	if (offset == 0)
+		return base;
+	return new_Add(base, new_Const_long(offset_mode, offset));
+}
+
+/* int kernel(void *p, int a) { ...; return a; } */
+static ir_graph *build_kernel(kernel_t kernel, const char *name)
+{
+	ir_type *mt = new_type_method(2, 1, false);
+	set_method_param_type(mt, 0, new_type_pointer(t_int));
+	set_method_param_type(mt, 1, t_int);
+	set_method_res_type(mt, 0, t_int);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str(name),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+
+	ir_mode *Is   = get_modeIs();
+	ir_mode *Bu   = get_modeBu();
+	ir_node *args = get_irg_args(irg);
+	ir_node *p    = new_Proj(args, get_modeP(), 0);
+	ir_node *a    = new_Proj(args, Is, 1);
+	switch (kernel) {
+	case K_ADD:
+		for (long i = 0; i < 4; ++i) {
+			ir_node *x = load(element(p, 4 * (i + 8)), Is, t_int);
+			ir_node *y = load(element(p, 4 * (i + 16)), Is, t_int);
+			store(element(p, 4 * i), new_Add(x, y), t_int);
+		}
+		break;
+	case K_SPLAT:
+		for (long i = 0; i < 4; ++i) {
+			ir_node *x = load(element(p, 4 * (i + 8)), Is, t_int);
+			store(element(p, 4 * i), new_Mul(x, a), t_int);
+		}
+		break;
+	case K_CONST:
+		for (long i = 0; i < 4; ++i) {
+			ir_node *x = load(element(p, 4 * (i + 8)), Is, t_int);
+			store(element(p, 4 * i), new_Sub(x, new_Const_long(Is, i + 1)),
+			      t_int);
+		}
+		break;
+	case K_BYTES:
+		for (long i = 0; i < 8; ++i) {
+			ir_node *x = load(element(p, i + 64), Bu, t_byte);
+			store(element(p, i), new_And(x, new_Const_long(Bu, 0x3c)), t_byte);
+		}
+		break;
+	case K_CHAIN:
+		for (long i = 0; i < 4; ++i) {
+			ir_node *x = load(element(p, 4 * i), Is, t_int);
+			store(element(p, 4 * (i + 1)), new_Add(x, a), t_int);
+		}
+		break;
+	case K_MIXED: {
+		ir_node *x = load(element(p, 32), Is, t_int);
+		ir_node *y = load(element(p, 36), Is, t_int);
+		store(element(p, 0), new_Add(x, a), t_int);
+		store(element(p, 4), new_Mul(y, a), t_int);
+		break;
+	}
+	case K_COUNT:
+		assert(false);
+	}
+	ir_node *res[] = { a };
+	ir_node *ret   = new_Return(get_store(), 1, res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+static void count_store(ir_node *node, void *env)
+{
+	unsigned *n_stores = (unsigned*)env;
+	if (is_Store(node))
+		++*n_stores;
+}
+
+static unsigned count_stores(ir_graph *irg)
+{
+	unsigned n_stores = 0;
+	irg_walk_graph(irg, count_store, NULL, &n_stores);
+	return n_stores;
+}
+
+typedef int (*kernel_func)(void *p, int a);
+
+static kernel_func compile(ir_jit_segment_t *segment, ir_graph *irg)
+{
+	ir_jit_function_t *function = be_jit_compile(segment, irg);
+	assert(function != NULL);
+	unsigned const size   = be_get_function_size(function);
+	char          *buffer = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE,
+	                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	assert(buffer != MAP_FAILED);
+	be_emit_function(buffer, function);
+	int res = mprotect(buffer, size, PROT_READ | PROT_EXEC);
+	assert(res == 0);
+	(void)res;
+	return (kernel_func)(void*)buffer;
+}
+
+static void fill(int *data, size_t n, unsigned seed)
+{
+	for (size_t i = 0; i < n; ++i) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = (int)(seed >> 8) - (1 << 22);
+	}
+}
+
+int main(void)
+{
+	static const char *const names[K_COUNT][2] = {
+		{ "add_slp",   "add_scalar"   },
+		{ "splat_slp", "splat_scalar" },
+		{ "const_slp", "const_scalar" },
+		{ "bytes_slp", "bytes_scalar" },
+		{ "chain_slp", "chain_scalar" },
+		{ "mixed_slp", "mixed_scalar" },
+	};
+	/* number of Stores left after slp_vectorize() */
+	static const unsigned n_packed[K_COUNT] = { 1, 1, 1, 1, 4, 2 };
+
+	ir_init();
+	if (!be_parse_arg("isa=amd64"))
+		return 1;
+	be_get_backend_param();
+	offset_mode = get_reference_offset_mode(get_modeP());
+	t_int       = new_type_primitive(get_modeIs());
+	t_byte      = new_type_primitive(get_modeBu());
+
+	ir_graph *graphs[K_COUNT][2];
+	for (kernel_t k = 0; k < K_COUNT; ++k) {
+		for (int v = 0; v < 2; ++v) {
+			ir_graph *irg = build_kernel(k, names[k][v]);
+			optimize_graph_df(irg);
+			if (v == 0) {
+				slp_vectorize(irg);
+				assert(count_stores(irg) == n_packed[k]);
+				optimize_graph_df(irg);
+			}
+			assert(irg_verify(irg));
+			graphs[k][v] = irg;
+		}
+	}
+	be_lower_for_target();
+
+	ir_jit_segment_t *segment = be_new_jit_segment();
+	for (kernel_t k = 0; k < K_COUNT; ++k) {
+		kernel_func const packed = compile(segment, graphs[k][0]);
+		kernel_func const scalar = compile(segment, graphs[k][1]);
+		for (unsigned seed = 1; seed <= 8; ++seed) {
+			int data_packed[32];
+			int data_scalar[32];
+			fill(data_packed, 32, seed);
+			memcpy(data_scalar, data_packed, sizeof(data_scalar));
+			int const a = (int)seed * 7 - 20;
+			packed(data_packed, a);
+			scalar(data_scalar, a);
+			if (memcmp(data_packed, data_scalar, sizeof(data_packed)) != 0) {
+				fprintf(stderr, "%s: different results for seed %u\n",
+				        names[k][0], seed);
+				return 1;
+			}
+		}
+	}
+	be_destroy_jit_segment(segment);
+
+	ir_finish();
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,337 @@
+#define _DEFAULT_SOURCE
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "firm.h"
+#include "statev.h"
+
+/* longer than any fixed size buffer for context values */
+#define LONG_VALUE_LEN 3000
+#define N_LOOP_EVENTS  5000
+#define N_RECORDS      (N_LOOP_EVENTS + 10)
+
+/* the layout of an event in the binary stream */
+typedef struct record_t {
+	uint8_t  type;
+	uint8_t  pad[3];
+	uint32_t key;
+	union {
+		int64_t  i;
+		uint64_t u;
+		double   d;
+		uint64_t str;
+	} value;
+} record_t;
+
+static char long_value[LONG_VALUE_LEN + 1];
+
+/* Emits the same events in both formats.  Keys containing a '.' are removed
+ * by the filter. */
+static void emit_events(void)
+{
+	stat_ev_ctx_push_str("irg", "f");
+	stat_ev_int("n", 3);
+	stat_ev_int("n", -5);
+	stat_ev_ull("big", 1ull << 40);
+	stat_ev_dbl("time", 0.5);
+	stat_ev("mark");
+	stat_ev_ctx_push_fmt("phase", "%s", long_value);
+	for (int k = 0; k < N_LOOP_EVENTS; ++k)
+		stat_ev_int("i", k);
+	stat_ev_int("filtered.out", 1);
+	stat_ev_ctx_pop("phase");
+	stat_ev_int("n", 7);
+	stat_ev_ctx_pop("irg");
+}
+
+static char *read_file(const char *name, size_t *size)
+{
+	FILE *const file = fopen(name, "rb");
+	assert(file != NULL);
+	fseek(file, 0, SEEK_END);
+	long const length = ftell(file);
+	assert(length >= 0);
+	rewind(file);
+	char *const data = (char*)malloc((size_t)length + 1);
+	size_t const n_read = fread(data, 1, (size_t)length, file);
+	assert(n_read == (size_t)length);
+	(void)n_read;
+	fclose(file);
+	data[length] = '\0';
+	*size = (size_t)length;
+	return data;
+}
+
+static void check_record(record_t const *record, char type, char const *key,
+                         char const *const *strings, size_t n_strings)
+{
+	assert(record->type == (uint8_t)type);
+	assert(record->key < n_strings && strings[record->key] != NULL);
+	assert(strcmp(strings[record->key], key) == 0);
+}
+
+static char const *string_value(record_t const *record,
+                                char const *const *strings, size_t n_strings)
+{
+	assert(record->value.str < n_strings && strings[record->value.str] != NULL);
+	return strings[record->value.str];
+}
+
+/* reads the binary stream back and checks it has exactly the events of
+ * emit_events() */
+static void check_binary(const char *name)
+{
+	size_t      size;
+	char *const data = read_file(name, &size);
+	assert(size >= 16 && memcmp(data, "FIRMSTEV", 8) == 0);
+	uint32_t header[2];
+	memcpy(header, data + 8, sizeof(header));
+	assert(header[0] == 1 && header[1] == 0x01020304);
+
+	char const **strings   = NULL;
+	size_t       n_strings = 0;
+	record_t    *records   = (record_t*)malloc(N_RECORDS * sizeof(*records));
+	size_t       n_records = 0;
+	unsigned     n_chunks  = 0;
+	for (size_t pos = 16; pos < size;) {
+		uint32_t chunk[2];
+		assert(pos + sizeof(chunk) <= size);
+		memcpy(chunk, data + pos, sizeof(chunk));
+		pos += sizeof(chunk);
+		size_t const end = pos + chunk[1];
+		assert(end <= size);
+		if (chunk[0] == 'S') {
+			while (pos < end) {
+				uint32_t entry[2];
+				memcpy(entry, data + pos, sizeof(entry));
+				pos += sizeof(entry);
+				if (entry[0] >= n_strings) {
+					size_t const n = entry[0] + 1;
+					strings = (char const**)realloc(strings, n * sizeof(*strings));
+					memset(strings + n_strings, 0,
+					       (n - n_strings) * sizeof(*strings));
+					n_strings = n;
+				}
+				/* every string is defined once */
+				assert(strings[entry[0]] == NULL);
+				char *const str = (char*)malloc(entry[1] + 1);
+				memcpy(str, data + pos, entry[1]);
+				str[entry[1]] = '\0';
+				strings[entry[0]] = str;
+				pos += entry[1];
+			}
+		} else {
+			assert(chunk[0] == 'E');
+			assert(chunk[1] % sizeof(record_t) == 0);
+			size_t const n = chunk[1] / sizeof(record_t);
+			assert(n_records + n <= N_RECORDS);
+			memcpy(records + n_records, data + pos, chunk[1]);
+			/* strings are defined before the events referring to them */
+			for (size_t r = n_records; r < n_records + n; ++r) {
+				assert(records[r].key < n_strings);
+				assert(strings[records[r].key] != NULL);
+			}
+			n_records += n;
+			++n_chunks;
+			pos = end;
+		}
+		assert(pos == end);
+	}
+	assert(n_records == N_RECORDS);
+	/* the events did not fit into one buffer */
+	assert(n_chunks >= 2);
+
+	record_t const *r = records;
+	check_record(r, 'P', "irg", strings, n_strings);
+	assert(strcmp(string_value(r++, strings, n_strings), "f") == 0);
+	check_record(r, 'I', "n", strings, n_strings);
+	assert((r++)->value.i == 3);
+	check_record(r, 'I', "n", strings, n_strings);
+	assert((r++)->value.i == -5);
+	check_record(r, 'U', "big", strings, n_strings);
+	assert((r++)->value.u == 1ull << 40);
+	check_record(r, 'D', "time", strings, n_strings);
+	assert((r++)->value.d == 0.5);
+	check_record(r, 'D', "mark", strings, n_strings);
+	assert((r++)->value.d == 0.0);
+	check_record(r, 'P', "phase", strings, n_strings);
+	assert(strcmp(string_value(r++, strings, n_strings), long_value) == 0);
+	for (int k = 0; k < N_LOOP_EVENTS; ++k) {
+		check_record(r, 'I', "i", strings, n_strings);
+		assert((r++)->value.i == k);
+	}
+	check_record(r++, 'O', "phase", strings, n_strings);
+	check_record(r, 'I', "n", strings, n_strings);
+	assert((r++)->value.i == 7);
+	check_record(r++, 'O', "irg", strings, n_strings);
+	assert(r == records + N_RECORDS);
+
+	for (size_t i = 0; i < n_strings; ++i)
+		free((char*)strings[i]);
+	free(strings);
+	free(records);
+	free(data);
+}
+
+/* the rows of a CSV table, fields separated by '\0' */
+typedef struct table_t {
+	char    *data;
+	char   **rows;
+	unsigned n_rows;
+} table_t;
+
+static table_t read_table(const char *name)
+{
+	table_t table;
+	size_t  size;
+	table.data   = read_file(name, &size);
+	table.rows   = NULL;
+	table.n_rows = 0;
+	for (char *line = table.data; *line != '\0';) {
+		char *const nl = strchr(line, '\n');
+		assert(nl != NULL);
+		*nl = '\0';
+		table.rows = (char**)realloc(table.rows,
+		                             (table.n_rows + 1) * sizeof(*table.rows));
+		table.rows[table.n_rows++] = line;
+		for (char *c = line; c != nl; ++c) {
+			if (*c == ',')
+				*c = '\0';
+		}
+		line = nl + 1;
+	}
+	return table;
+}
+
+static char const *field(table_t const *table, unsigned row, unsigned column)
+{
+	char const *f = table->rows[row];
+	for (unsigned c = 0; c < column; ++c)
+		f += strlen(f) + 1;
+	return f;
+}
+
+static bool same_field(char const *a, char const *b)
+{
+	if (strcmp(a, b) == 0)
+		return true;
+	/* the text format stores all values as floating point numbers */
+	char  *end_a;
+	char  *end_b;
+	double const da = strtod(a, &end_a);
+	double const db = strtod(b, &end_b);
+	return *a != '\0' && *end_a == '\0' && *end_b == '\0' && da == db;
+}
+
+/* Aggregates both streams with support/statev_aggregate.py, which has to
+ * report the same table for both. */
+static void check_aggregate(const char *srcdir, const char *dir)
+{
+	char command[1024];
+	snprintf(command, sizeof(command), "python3 -c '' 2>/dev/null");
+	if (system(command) != 0) {
+		fprintf(stderr, "statev_binary: python3 not found, skipping "
+		        "statev_aggregate.py\n");
+		return;
+	}
+	static const char *const formats[] = { "evb", "ev" };
+	table_t tables[2];
+	for (int f = 0; f < 2; ++f) {
+		snprintf(command, sizeof(command),
+		         "python3 %ssupport/statev_aggregate.py -o %s/%s.csv "
+		         "%s/events.%s", srcdir, dir, formats[f], dir, formats[f]);
+		int const res = system(command);
+		assert(res == 0);
+		(void)res;
+		char name[512];
+		snprintf(name, sizeof(name), "%s/%s.csv", dir, formats[f]);
+		tables[f] = read_table(name);
+		remove(name);
+	}
+
+	/* irg, phase, event, count, sum, min, max, mean */
+	table_t const *const table = &tables[0];
+	assert(table->n_rows == 6);
+	assert(strcmp(table->rows[0], "irg") == 0);
+	assert(strcmp(field(table, 0, 1), "phase") == 0);
+	assert(strcmp(field(table, 0, 2), "event") == 0);
+	unsigned n_found = 0;
+	for (unsigned r = 1; r < table->n_rows; ++r) {
+		assert(strcmp(field(table, r, 0), "f") == 0);
+		char const *const event = field(table, r, 2);
+		if (strcmp(event, "i") == 0) {
+			assert(strcmp(field(table, r, 1), long_value) == 0);
+			assert(atol(field(table, r, 3)) == N_LOOP_EVENTS);
+			assert(atol(field(table, r, 4))
+			       == (long)N_LOOP_EVENTS * (N_LOOP_EVENTS - 1) / 2);
+			++n_found;
+		} else if (strcmp(event, "n") == 0) {
+			assert(field(table, r, 1)[0] == '\0');
+			assert(atol(field(table, r, 3)) == 3);
+			assert(atol(field(table, r, 4)) == 5);
+			assert(atol(field(table, r, 5)) == -5);
+			assert(atol(field(table, r, 6)) == 7);
+			++n_found;
+		} else if (strcmp(event, "big") == 0) {
+			assert(strtod(field(table, r, 4), NULL) == (double)(1ull << 40));
+			++n_found;
+		}
+	}
+	assert(n_found == 3);
+
+	assert(tables[1].n_rows == table->n_rows);
+	for (unsigned r = 0; r < table->n_rows; ++r) {
+		for (unsigned c = 0; c < 8; ++c)
+			assert(same_field(field(&tables[0], r, c), field(&tables[1], r, c)));
+	}
+
+	for (int f = 0; f < 2; ++f) {
+		free(tables[f].rows);
+		free(tables[f].data);
+	}
+}
+
+int main(void)
+{
+	ir_init();
+	for (int i = 0; i < LONG_VALUE_LEN; ++i)
+		long_value[i] = (char)('a' + i % 26);
+
+	char dir[] = "/tmp/statevXXXXXX";
+	if (mkdtemp(dir) == NULL)
+		return 1;
+	char prefix[256];
+	snprintf(prefix, sizeof(prefix), "%s/events", dir);
+
+	stat_ev_begin_binary(prefix, "^[a-z]+$");
+	assert(stat_ev_enabled);
+	emit_events();
+	stat_ev_end();
+	stat_ev_begin(prefix, "^[a-z]+$");
+	assert(stat_ev_enabled);
+	emit_events();
+	stat_ev_end();
+
+	char name[512];
+	snprintf(name, sizeof(name), "%s.evb", prefix);
+	check_binary(name);
+
+	/* the source directory is the prefix of this file */
+	char srcdir[512];
+	snprintf(srcdir, sizeof(srcdir), "%s", __FILE__);
+	char *const base = strstr(srcdir, "unittests/statev_binary.c");
+	assert(base != NULL);
+	*base = '\0';
+	check_aggregate(srcdir, dir);
+
+	remove(name);
+	snprintf(name, sizeof(name), "%s.ev", prefix);
+	remove(name);
+	rmdir(dir);
+	ir_finish();
+	return 0;
+}
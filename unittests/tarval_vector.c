@@ -0,0 +1,187 @@
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+#include "firm.h"
+
+#define N_LANES 4
+
+static ir_tarval *vec_long(ir_mode *mode, long l0, long l1, long l2, long l3)
+{
+	ir_mode   *element = get_mode_element_mode(mode);
+	ir_tarval *lanes[] = {
+		new_tarval_from_long(l0, element),
+		new_tarval_from_long(l1, element),
+		new_tarval_from_long(l2, element),
+		new_tarval_from_long(l3, element),
+	};
+	return new_tarval_vector(mode, lanes);
+}
+
+static ir_tarval *vec_double(ir_mode *mode, double d0, double d1, double d2,
+                             double d3)
+{
+	ir_mode   *element = get_mode_element_mode(mode);
+	ir_tarval *lanes[] = {
+		new_tarval_from_double(d0, element),
+		new_tarval_from_double(d1, element),
+		new_tarval_from_double(d2, element),
+		new_tarval_from_double(d3, element),
+	};
+	return new_tarval_vector(mode, lanes);
+}
+
+typedef ir_tarval *(*binop)(ir_tarval const *a, ir_tarval const *b);
+typedef ir_tarval *(*unop)(ir_tarval const *a);
+
+/* the result of a vector operation is the vector of the scalar results */
+static void check_binop(binop op, ir_tarval *a, ir_tarval *b)
+{
+	ir_tarval *res = op(a, b);
+	assert(res != tarval_bad);
+	assert(get_tarval_mode(res) == get_tarval_mode(a));
+	for (unsigned i = 0; i < N_LANES; ++i)
+		assert(get_tarval_lane(res, i)
+		       == op(get_tarval_lane(a, i), get_tarval_lane(b, i)));
+}
+
+static void check_unop(unop op, ir_tarval *a)
+{
+	ir_tarval *res = op(a);
+	assert(res != tarval_bad);
+	for (unsigned i = 0; i < N_LANES; ++i)
+		assert(get_tarval_lane(res, i) == op(get_tarval_lane(a, i)));
+}
+
+static void test_int(ir_mode *mode)
+{
+	ir_tarval *a = vec_long(mode, 1, -2, 300, -40000);
+	ir_tarval *b = vec_long(mode, 7, 7, -3, 11);
+	assert(a == vec_long(mode, 1, -2, 300, -40000));
+	assert(a != b);
+
+	static const binop binops[] = {
+		tarval_add, tarval_sub, tarval_mul, tarval_div,
+		tarval_and, tarval_andnot, tarval_or, tarval_ornot, tarval_eor,
+	};
+	for (size_t i = 0; i < sizeof(binops) / sizeof(binops[0]); ++i) {
+		check_binop(binops[i], a, b);
+		check_binop(binops[i], b, a);
+	}
+	check_unop(tarval_neg, a);
+	check_unop(tarval_not, a);
+	assert(tarval_add(a, b) == vec_long(mode, 8, 5, 297, -39989));
+	assert(tarval_div(a, b) == vec_long(mode, 0, 0, -100, -3636));
+
+	/* a division by zero in one lane makes the whole vector bad */
+	assert(tarval_div(a, vec_long(mode, 1, 1, 0, 1)) == tarval_bad);
+
+	/* compare: all lanes equal or not, no order */
+	assert(tarval_cmp(a, a) == ir_relation_equal);
+	assert(tarval_cmp(a, b) == ir_relation_less_greater);
+	assert(tarval_cmp(a, vec_long(mode, 1, -2, 300, -39999))
+	       == ir_relation_less_greater);
+	assert(tarval_cmp(get_mode_null(mode), vec_long(mode, 0, 0, 0, 0))
+	       == ir_relation_equal);
+
+	/* overflow wraps in each lane on its own */
+	ir_tarval *max = get_mode_max(mode);
+	ir_tarval *min = get_mode_min(mode);
+	ir_tarval *one = vec_long(mode, 0, 1, 0, 0);
+	ir_tarval *sum = tarval_add(max, one);
+	assert(get_tarval_lane(sum, 0) == get_tarval_lane(max, 0));
+	assert(get_tarval_lane(sum, 1) == get_tarval_lane(min, 1));
+	assert(get_tarval_lane(tarval_sub(min, one), 1) == get_tarval_lane(max, 1));
+	assert(tarval_neg(min) == min);
+	tarval_set_wrap_on_overflow(false);
+	assert(tarval_add(max, one) == tarval_bad);
+	assert(tarval_add(max, get_mode_null(mode)) == max);
+	tarval_set_wrap_on_overflow(true);
+}
+
+static void test_unsigned(ir_mode *mode)
+{
+	ir_tarval *a = vec_long(mode, 0, 1, 254, 255);
+	ir_tarval *b = vec_long(mode, 1, 255, 2, 255);
+	assert(tarval_add(a, b) == vec_long(mode, 1, 0, 0, 254));
+	assert(tarval_sub(a, b) == vec_long(mode, 255, 2, 252, 0));
+	assert(tarval_mul(a, b) == vec_long(mode, 0, 255, 252, 1));
+	assert(tarval_neg(a) == vec_long(mode, 0, 255, 2, 1));
+	tarval_set_wrap_on_overflow(false);
+	assert(tarval_add(a, b) == tarval_bad);
+	assert(tarval_add(a, vec_long(mode, 1, 1, 1, 0))
+	       == vec_long(mode, 1, 2, 255, 255));
+	tarval_set_wrap_on_overflow(true);
+}
+
+static void test_float(ir_mode *mode)
+{
+	ir_tarval *a = vec_double(mode, 1.5, -2.0, 1e30, 0.0);
+	ir_tarval *b = vec_double(mode, 0.25, 3.0, 1e30, -0.0);
+	check_binop(tarval_add, a, b);
+	check_binop(tarval_sub, a, b);
+	check_binop(tarval_mul, a, b);
+	check_binop(tarval_div, a, vec_double(mode, 2.0, 4.0, 8.0, 16.0));
+	check_unop(tarval_neg, a);
+	assert(tarval_add(a, b) == vec_double(mode, 1.75, 1.0, 2e30, 0.0));
+
+	/* lanes overflow to infinity and divide by zero on their own */
+	ir_mode   *element = get_mode_element_mode(mode);
+	ir_tarval *inf     = get_mode_infinite(element);
+	ir_tarval *prod    = tarval_mul(get_mode_max(mode),
+	                                vec_double(mode, 2.0, 1.0, -2.0, 0.5));
+	assert(get_tarval_lane(prod, 0) == inf);
+	assert(get_tarval_lane(prod, 1) == get_mode_max(element));
+	assert(get_tarval_lane(prod, 2) == tarval_neg(inf));
+	assert(tarval_is_finite(get_tarval_lane(prod, 3)));
+	ir_tarval *quot = tarval_div(a, vec_double(mode, 0.0, 0.0, 1.0, 1.0));
+	assert(get_tarval_lane(quot, 0) == inf);
+	assert(get_tarval_lane(quot, 1) == tarval_neg(inf));
+	assert(get_tarval_lane(quot, 2) == get_tarval_lane(a, 2));
+	assert(tarval_is_nan(get_tarval_lane(tarval_div(b, b), 3)));
+
+	/* -0.0 and 0.0 compare equal, a NaN lane makes the vectors unordered */
+	assert(tarval_cmp(a, a) == ir_relation_equal);
+	assert(tarval_cmp(vec_double(mode, 1, 2, 3, 0.0),
+	                  vec_double(mode, 1, 2, 3, -0.0)) == ir_relation_equal);
+	assert(tarval_cmp(a, b) == ir_relation_less_greater);
+	ir_tarval *nan = vec_double(mode, 1.5, -2.0, NAN, 0.0);
+	assert(tarval_cmp(nan, a) == ir_relation_unordered);
+	assert(tarval_cmp(nan, nan) == ir_relation_unordered);
+}
+
+static void test_convert(ir_mode *int_mode, ir_mode *float_mode,
+                         ir_mode *byte_mode)
+{
+	ir_tarval *i = vec_long(int_mode, 1, -2, 300, -40000);
+	ir_tarval *f = tarval_convert_to(i, float_mode);
+	assert(f == vec_double(float_mode, 1, -2, 300, -40000));
+	assert(tarval_convert_to(f, int_mode) == i);
+	assert(tarval_convert_to(i, byte_mode)
+	       == vec_long(byte_mode, 1, 254, 44, 192));
+	ir_mode *pair = new_vector_mode("V2Is", get_modeIs(), 2);
+	assert(tarval_convert_to(i, pair) == tarval_bad);
+
+	unsigned char bytes[N_LANES * 4];
+	tarval_to_bytes(bytes, i);
+	assert(new_tarval_from_bytes(bytes, int_mode) == i);
+	unsigned char lane[4];
+	tarval_to_bytes(lane, get_tarval_lane(i, 2));
+	assert(memcmp(bytes + 8, lane, sizeof(lane)) == 0);
+}
+
+int main(void)
+{
+	ir_init();
+	ir_mode *v4is = new_vector_mode("V4Is", get_modeIs(), N_LANES);
+	ir_mode *v4bu = new_vector_mode("V4Bu", get_modeBu(), N_LANES);
+	ir_mode *v4f  = new_vector_mode("V4F", get_modeF(), N_LANES);
+	test_int(v4is);
+	test_int(new_vector_mode("V4Ls", get_modeLs(), N_LANES));
+	test_unsigned(v4bu);
+	test_float(v4f);
+	test_float(new_vector_mode("V4D", get_modeD(), N_LANES));
+	test_convert(v4is, v4f, v4bu);
+	ir_finish();
+	return 0;
+}
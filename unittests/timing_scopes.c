@@ -0,0 +1,189 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "firm.h"
+
+/* int f(int a, int b) { return (a + b) * (a + b) + 0 * b; } */
+static ir_graph *build_graph(void)
+{
+	ir_mode *Is    = get_modeIs();
+	ir_type *t_int = new_type_primitive(Is);
+	ir_type *mt    = new_type_method(2, 1, false);
+	set_method_param_type(mt, 0, t_int);
+	set_method_param_type(mt, 1, t_int);
+	set_method_res_type(mt, 0, t_int);
+	ir_entity *ent = new_global_entity(get_glob_type(), new_id_from_str("f"),
+	                                   mt, ir_visibility_external,
+	                                   IR_LINKAGE_DEFAULT);
+	ir_graph *irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+	ir_node *a    = new_Proj(get_irg_args(irg), Is, 0);
+	ir_node *b    = new_Proj(get_irg_args(irg), Is, 1);
+	ir_node *sum  = new_Add(a, b);
+	ir_node *zero = new_Mul(new_Const_long(Is, 0), b);
+	ir_node *in[] = { new_Add(new_Mul(sum, new_Add(a, b)), zero) };
+	ir_node *ret  = new_Return(get_store(), 1, in);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_irg_end_block(irg));
+	irg_finalize_cons(irg);
+	return irg;
+}
+
+typedef struct scope_row_t {
+	char               name[64];
+	char               graph[64];
+	unsigned           depth;
+	unsigned long long start;
+	unsigned long long duration;
+	unsigned long long self;
+	unsigned           indices_before;
+	unsigned           indices_after;
+	size_t             memory_before;
+	size_t             memory_after;
+} scope_row_t;
+
+/* reads the CSV profile, returns the number of rows */
+static size_t read_csv(FILE *file, scope_row_t *rows, size_t max_rows)
+{
+	char line[512];
+	rewind(file);
+	char *res = fgets(line, sizeof(line), file);
+	assert(res != NULL);
+	(void)res;
+	assert(strcmp(line, "name,graph,depth,start_ns,duration_ns,self_ns,"
+	                    "indices_before,indices_after,memory_before,"
+	                    "memory_after\n") == 0);
+	size_t n_rows = 0;
+	while (fgets(line, sizeof(line), file) != NULL) {
+		assert(n_rows < max_rows);
+		scope_row_t *const row = &rows[n_rows++];
+		int const n = sscanf(line, "\"%63[^\"]\",\"%63[^\"]\",%u,%llu,%llu,%llu,"
+		                     "%u,%u,%zu,%zu", row->name, row->graph,
+		                     &row->depth, &row->start, &row->duration,
+		                     &row->self, &row->indices_before,
+		                     &row->indices_after, &row->memory_before,
+		                     &row->memory_after);
+		if (n != 10) {
+			/* scope without a graph */
+			row->graph[0] = '\0';
+			int const m = sscanf(line, "\"%63[^\"]\",\"\",%u,%llu,%llu,%llu,"
+			                     "%u,%u,%zu,%zu", row->name, &row->depth,
+			                     &row->start, &row->duration, &row->self,
+			                     &row->indices_before, &row->indices_after,
+			                     &row->memory_before, &row->memory_after);
+			assert(m == 9);
+			(void)m;
+		}
+	}
+	return n_rows;
+}
+
+static scope_row_t const *find_row(scope_row_t const *rows, size_t n_rows,
+                                   char const *name)
+{
+	for (size_t i = 0; i < n_rows; ++i) {
+		if (strcmp(rows[i].name, name) == 0)
+			return &rows[i];
+	}
+	return NULL;
+}
+
+int main(void)
+{
+	ir_init();
+	ir_graph *irg = build_graph();
+
+	/* nothing is recorded while the profile is disabled */
+	assert(!ir_timing_scopes_enabled());
+	int const not_begun = ir_timing_scope_begin("disabled", NULL, 0, 0);
+	assert(!not_begun);
+
+	ir_timing_enable_scopes(true);
+	assert(ir_timing_scopes_enabled());
+	/* a driver scope around the passes, without a graph */
+	int const driver = ir_timing_scope_begin("driver", NULL, 0, 0);
+	assert(driver);
+	unsigned const indices_before = get_irg_last_idx(irg);
+	optimize_graph_df(irg);
+	unsigned const indices_after = get_irg_last_idx(irg);
+	place_code(irg);
+	ir_timing_scope_end(0, 0);
+
+	/* a scope begun while enabled is ended after the profile is disabled */
+	int const late = ir_timing_scope_begin("late", "g", 3, 4);
+	assert(late);
+	ir_timing_enable_scopes(false);
+	ir_timing_scope_end(5, 6);
+	assert(ir_timing_scope_begin("after", NULL, 0, 0) == 0);
+
+	FILE *const csv = tmpfile();
+	assert(csv != NULL);
+	ir_timing_write_scopes(csv, ir_timing_format_csv);
+	scope_row_t rows[64];
+	size_t const n_rows = read_csv(csv, rows, 64);
+	fclose(csv);
+
+	scope_row_t const *const drv = find_row(rows, n_rows, "driver");
+	assert(drv != NULL && drv->depth == 0 && drv->graph[0] == '\0');
+
+	/* the passes record their own scopes with the node indices of the graph
+	 * given by get_irg_last_idx() */
+	scope_row_t const *const opt = find_row(rows, n_rows, "optimize_graph_df");
+	assert(opt != NULL);
+	assert(opt->depth == 1 && strcmp(opt->graph, "f") == 0);
+	assert(opt->indices_before == indices_before);
+	assert(opt->indices_after == indices_after);
+	assert(opt->memory_before > 0 && opt->memory_after > 0);
+	assert(opt->start >= drv->start);
+	assert(opt->start + opt->duration <= drv->start + drv->duration);
+	assert(opt->self <= opt->duration);
+
+	scope_row_t const *const place = find_row(rows, n_rows, "place_code");
+	assert(place != NULL && place->depth == 1);
+	assert(place->start >= opt->start + opt->duration);
+	assert(place->indices_before == indices_after);
+	assert(drv->self <= drv->duration - opt->duration - place->duration);
+
+	scope_row_t const *const late_row = find_row(rows, n_rows, "late");
+	assert(late_row != NULL && late_row->depth == 0);
+	assert(strcmp(late_row->graph, "g") == 0);
+	assert(late_row->indices_before == 3 && late_row->indices_after == 5);
+	assert(late_row->memory_before == 4 && late_row->memory_after == 6);
+	assert(find_row(rows, n_rows, "disabled") == NULL);
+	assert(find_row(rows, n_rows, "after") == NULL);
+
+	/* the trace has one event per scope */
+	FILE *const trace = tmpfile();
+	assert(trace != NULL);
+	ir_timing_write_scopes(trace, ir_timing_format_trace);
+	long const size = ftell(trace);
+	assert(size > 0);
+	char *const text = (char*)malloc(size + 1);
+	rewind(trace);
+	size_t const n_read = fread(text, 1, size, trace);
+	assert(n_read == (size_t)size);
+	(void)n_read;
+	text[size] = '\0';
+	fclose(trace);
+	assert(strncmp(text, "{\"traceEvents\":[", 16) == 0);
+	size_t n_events = 0;
+	for (char const *c = text; (c = strstr(c, "\"ph\":\"X\"")) != NULL; ++c)
+		++n_events;
+	assert(n_events == n_rows);
+	assert(strstr(text, "\"name\":\"optimize_graph_df\"") != NULL);
+	assert(strstr(text, "\"graph\":\"f\",\"indices_before\"") != NULL);
+	free(text);
+
+	/* clearing discards everything recorded */
+	ir_timing_clear_scopes();
+	FILE *const empty = tmpfile();
+	assert(empty != NULL);
+	ir_timing_write_scopes(empty, ir_timing_format_csv);
+	assert(ftell(empty) == 0);
+	fclose(empty);
+
+	ir_finish();
+	return 0;
+}